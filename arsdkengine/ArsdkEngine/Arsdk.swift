@@ -55,9 +55,17 @@ class Arsdk: NSObject {
 
     /// Stop arsdk
     func stop() {
+        logLoopStats()
         arsdkCore.stop()
     }
 
+    /// Logs the utilisation statistics of the arsdk and stream loops
+    func logLoopStats() {
+        for stats in arsdkCore.loopStats() {
+            ULog.i(.tag, "Loop \(stats)")
+        }
+    }
+
     override var description: String {
         return "Arsdk"
     }
@@ -105,8 +105,16 @@ public class ArsdkEngine: EngineBaseCore {
         let controllerDescriptor = "APP,iOS,\(AppInfoCore.deviceModel),\(AppInfoCore.systemVersion)"
         let controllerVersion
             = "\(AppInfoCore.appBundle),\(AppInfoCore.appVersion),\(AppInfoCore.sdkBundle),\(AppInfoCore.sdkVersion)"
-        return ArsdkCore(backendControllers: createBackendControllers(), listener: listener,
-                         controllerDescriptor: controllerDescriptor, controllerVersion: controllerVersion)
+        let arsdkCore = ArsdkCore(backendControllers: createBackendControllers(), listener: listener,
+                                  controllerDescriptor: controllerDescriptor, controllerVersion: controllerVersion)
+        if let commandBatchLatencyMs = GroundSdkConfig.sharedInstance.commandBatchLatencyMs {
+            arsdkCore.commandBatchMaxLatencyMs = Int32(max(commandBatchLatencyMs, 0))
+        }
+        arsdkCore.noAckCmdLoopDedicatedThread = GroundSdkConfig.sharedInstance.dedicatedPilotingThread
+        arsdkCore.streamLoopCount = UInt(max(GroundSdkConfig.sharedInstance.streamLoopCount, 0))
+        arsdkCore.progressNotificationIntervalMs
+            = Int32(max(GroundSdkConfig.sharedInstance.progressNotificationIntervalMs, 0))
+        return arsdkCore
     }
 
     /// Factory function to create the backend controllers
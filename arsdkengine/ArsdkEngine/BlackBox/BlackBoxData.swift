@@ -47,10 +47,15 @@ struct BlackBoxData: Encodable {
     private var events: [BlackBoxEvent] = []
 
     /// Flight data sample buffer (limited to the last 1 minute datas)
-    private var flightDatas = BlackBoxCircularArray<BlackBoxFlightData>(size: 5 * 60)
+    private var flightDatas = BlackBoxFlightSamples(capacity: 5 * 60)
 
     /// Environment data sample buffer (limited to the last 1 minute datas)
-    private var environmentDatas = BlackBoxCircularArray<BlackBoxEnvironmentData>(size: 60)
+    private var environmentDatas = BlackBoxEnvironmentSamples(capacity: 60)
+
+    /// Memory used by the flight and environment samples, in bytes
+    var samplesMemoryUsage: Int {
+        return flightDatas.memoryUsage + environmentDatas.memoryUsage
+    }
 
     /// Constructor
     ///
@@ -118,3 +123,15 @@ struct BlackBoxData: Encodable {
         header.bootId = bootId
     }
 }
+
+/// Extension that writes the black box piece by piece when it is archived
+extension BlackBoxData: JsonStreamEncodable {
+    func write(to writer: JsonStreamWriter) throws {
+        try writer.beginObject()
+        try writer.write(header, key: CodingKeys.header.rawValue)
+        try writer.write(elements: events, key: CodingKeys.events.rawValue)
+        try flightDatas.write(to: writer, key: CodingKeys.flightDatas.rawValue)
+        try environmentDatas.write(to: writer, key: CodingKeys.environmentDatas.rawValue)
+        try writer.endObject()
+    }
+}
@@ -159,6 +159,7 @@ class BlackBoxDroneSession: NSObject, BlackBoxSession {
     func close() {
         flightDataSampler.invalidate()
         environmentDataSampler.invalidate()
+        ULog.d(.blackBoxTag, "Closing black box session, samples use \(blackBox.samplesMemoryUsage) bytes")
         didClose()
     }
 }
@@ -0,0 +1,382 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+import Foundation
+import GroundSdk
+
+/// Position of the elements stored in a fixed capacity ring.
+///
+/// Once the ring is full, each new element overwrites the oldest one.
+struct BlackBoxRingPosition {
+    /// Max number of elements
+    let capacity: Int
+    /// Number of stored elements
+    private(set) var count = 0
+    /// Index of the next element to write
+    private var head = 0
+
+    /// Constructor
+    ///
+    /// - Parameter capacity: max number of elements
+    init(capacity: Int) {
+        self.capacity = capacity
+    }
+
+    /// Moves to the next element.
+    ///
+    /// - Returns: index where the new element must be written
+    mutating func advance() -> Int {
+        let index = head
+        head += 1
+        if head == capacity {
+            head = 0
+        }
+        count = min(count + 1, capacity)
+        return index
+    }
+
+    /// Calls a closure with the index of each stored element, from the oldest to the newest.
+    ///
+    /// - Parameter body: closure called with each element index
+    /// - Throws: error thrown by the closure
+    func forEachIndex(_ body: (Int) throws -> Void) rethrows {
+        // when the ring is full, the oldest element is at the head
+        let start = count == capacity ? head : 0
+        for offset in 0..<count {
+            let index = start + offset
+            try body(index < capacity ? index : index - capacity)
+        }
+    }
+}
+
+/// Flight data samples, stored column by column in a fixed capacity ring.
+///
+/// Columns are allocated once, recording a sample does not allocate memory.
+struct BlackBoxFlightSamples: Encodable {
+
+    private typealias Keys = BlackBoxFlightData.CodingKeys
+    private typealias SpeedKeys = BlackBoxSpeedData.CodingKeys
+    private typealias AttitudeKeys = BlackBoxAttitudeData.CodingKeys
+    private typealias PcmdKeys = BlackBoxDronePilotingCommandData.CodingKeys
+
+    /// Position of the samples in the columns
+    private var position: BlackBoxRingPosition
+    /// Sample timestamps
+    private var timestamps: ContiguousArray<Double>
+    /// Altitudes
+    private var altitudes: ContiguousArray<Double>
+    /// Heights above ground
+    private var heightsAboveGround: ContiguousArray<Float>
+    /// Speeds on the X axis
+    private var speedsX: ContiguousArray<Float>
+    /// Speeds on the Y axis
+    private var speedsY: ContiguousArray<Float>
+    /// Speeds on the Z axis
+    private var speedsZ: ContiguousArray<Float>
+    /// Roll angles
+    private var rolls: ContiguousArray<Float>
+    /// Pitch angles
+    private var pitches: ContiguousArray<Float>
+    /// Yaw angles
+    private var yaws: ContiguousArray<Float>
+    /// Piloting command rolls
+    private var pcmdRolls: ContiguousArray<Int32>
+    /// Piloting command pitches
+    private var pcmdPitches: ContiguousArray<Int32>
+    /// Piloting command yaws
+    private var pcmdYaws: ContiguousArray<Int32>
+    /// Piloting command gazs
+    private var pcmdGazs: ContiguousArray<Int32>
+    /// Piloting command flags
+    private var pcmdFlags: ContiguousArray<Int32>
+
+    /// Number of recorded samples
+    var count: Int {
+        return position.count
+    }
+
+    /// Memory used by the sample columns, in bytes
+    var memoryUsage: Int {
+        return position.capacity * (2 * MemoryLayout<Double>.stride + 7 * MemoryLayout<Float>.stride
+            + 5 * MemoryLayout<Int32>.stride)
+    }
+
+    /// Constructor
+    ///
+    /// - Parameter capacity: max number of samples, older samples are dropped once reached
+    init(capacity: Int) {
+        position = BlackBoxRingPosition(capacity: capacity)
+        timestamps = ContiguousArray(repeating: 0, count: capacity)
+        altitudes = ContiguousArray(repeating: 0, count: capacity)
+        heightsAboveGround = ContiguousArray(repeating: 0, count: capacity)
+        speedsX = ContiguousArray(repeating: 0, count: capacity)
+        speedsY = ContiguousArray(repeating: 0, count: capacity)
+        speedsZ = ContiguousArray(repeating: 0, count: capacity)
+        rolls = ContiguousArray(repeating: 0, count: capacity)
+        pitches = ContiguousArray(repeating: 0, count: capacity)
+        yaws = ContiguousArray(repeating: 0, count: capacity)
+        pcmdRolls = ContiguousArray(repeating: 0, count: capacity)
+        pcmdPitches = ContiguousArray(repeating: 0, count: capacity)
+        pcmdYaws = ContiguousArray(repeating: 0, count: capacity)
+        pcmdGazs = ContiguousArray(repeating: 0, count: capacity)
+        pcmdFlags = ContiguousArray(repeating: 0, count: capacity)
+    }
+
+    /// Records a sample.
+    ///
+    /// - Parameter sample: flight data sample to record
+    mutating func append(_ sample: BlackBoxFlightData) {
+        let index = position.advance()
+        timestamps[index] = sample.timestamp
+        altitudes[index] = sample.altitude
+        heightsAboveGround[index] = sample.heightAboveGround
+        speedsX[index] = sample.speed.speedX
+        speedsY[index] = sample.speed.speedY
+        speedsZ[index] = sample.speed.speedZ
+        rolls[index] = sample.attitude.roll
+        pitches[index] = sample.attitude.pitch
+        yaws[index] = sample.attitude.yaw
+        pcmdRolls[index] = Int32(truncatingIfNeeded: sample.pcmd.roll)
+        pcmdPitches[index] = Int32(truncatingIfNeeded: sample.pcmd.pitch)
+        pcmdYaws[index] = Int32(truncatingIfNeeded: sample.pcmd.yaw)
+        pcmdGazs[index] = Int32(truncatingIfNeeded: sample.pcmd.gaz)
+        pcmdFlags[index] = Int32(truncatingIfNeeded: sample.pcmd.flag)
+    }
+
+    /// Writes the samples, from the oldest to the newest, as a JSON array.
+    ///
+    /// - Parameters:
+    ///   - writer: JSON stream writer
+    ///   - key: key of the array
+    /// - Throws: encoding or sink error
+    func write(to writer: JsonStreamWriter, key: String) throws {
+        try writer.beginArray(key: key)
+        try position.forEachIndex { index in
+            try writer.writeObject { sample in
+                try sample.write(timestamps[index], key: Keys.timestamp.rawValue)
+                try sample.write(altitudes[index], key: Keys.altitude.rawValue)
+                try sample.write(heightsAboveGround[index], key: Keys.heightAboveGround.rawValue)
+                try sample.writeObject(key: Keys.speed.rawValue) { speed in
+                    try speed.write(speedsX[index], key: SpeedKeys.speedX.rawValue)
+                    try speed.write(speedsY[index], key: SpeedKeys.speedY.rawValue)
+                    try speed.write(speedsZ[index], key: SpeedKeys.speedZ.rawValue)
+                }
+                try sample.writeObject(key: Keys.attitude.rawValue) { attitude in
+                    try attitude.write(rolls[index], key: AttitudeKeys.roll.rawValue)
+                    try attitude.write(pitches[index], key: AttitudeKeys.pitch.rawValue)
+                    try attitude.write(yaws[index], key: AttitudeKeys.yaw.rawValue)
+                }
+                sample.writeObject(key: Keys.pcmd.rawValue) { pcmd in
+                    pcmd.write(pcmdRolls[index], key: PcmdKeys.roll.rawValue)
+                    pcmd.write(pcmdPitches[index], key: PcmdKeys.pitch.rawValue)
+                    pcmd.write(pcmdYaws[index], key: PcmdKeys.yaw.rawValue)
+                    pcmd.write(pcmdGazs[index], key: PcmdKeys.gaz.rawValue)
+                    pcmd.write(pcmdFlags[index], key: PcmdKeys.flag.rawValue)
+                }
+            }
+        }
+        try writer.endArray()
+    }
+
+    func encode(to encoder: Encoder) throws {
+        var container = encoder.unkeyedContainer()
+        try position.forEachIndex { index in
+            var sample = container.nestedContainer(keyedBy: Keys.self)
+            try sample.encode(timestamps[index], forKey: .timestamp)
+            try sample.encode(altitudes[index], forKey: .altitude)
+            try sample.encode(heightsAboveGround[index], forKey: .heightAboveGround)
+            var speed = sample.nestedContainer(keyedBy: SpeedKeys.self, forKey: .speed)
+            try speed.encode(speedsX[index], forKey: .speedX)
+            try speed.encode(speedsY[index], forKey: .speedY)
+            try speed.encode(speedsZ[index], forKey: .speedZ)
+            var attitude = sample.nestedContainer(keyedBy: AttitudeKeys.self, forKey: .attitude)
+            try attitude.encode(rolls[index], forKey: .roll)
+            try attitude.encode(pitches[index], forKey: .pitch)
+            try attitude.encode(yaws[index], forKey: .yaw)
+            var pcmd = sample.nestedContainer(keyedBy: PcmdKeys.self, forKey: .pcmd)
+            try pcmd.encode(pcmdRolls[index], forKey: .roll)
+            try pcmd.encode(pcmdPitches[index], forKey: .pitch)
+            try pcmd.encode(pcmdYaws[index], forKey: .yaw)
+            try pcmd.encode(pcmdGazs[index], forKey: .gaz)
+            try pcmd.encode(pcmdFlags[index], forKey: .flag)
+        }
+    }
+}
+
+/// Environment data samples, stored column by column in a fixed capacity ring.
+///
+/// Columns are allocated once, recording a sample does not allocate memory.
+struct BlackBoxEnvironmentSamples: Encodable {
+
+    private typealias Keys = BlackBoxEnvironmentData.CodingKeys
+    private typealias LocationKeys = BlackBoxLocationData.CodingKeys
+    private typealias PcmdKeys = BlackBoxRcPilotingCommandData.CodingKeys
+
+    /// Position of the samples in the columns
+    private var position: BlackBoxRingPosition
+    /// Sample timestamps
+    private var timestamps: ContiguousArray<Double>
+    /// Drone latitudes
+    private var droneLatitudes: ContiguousArray<Double>
+    /// Drone longitudes
+    private var droneLongitudes: ContiguousArray<Double>
+    /// Drone altitudes
+    private var droneAltitudes: ContiguousArray<Double>
+    /// Controller latitudes
+    private var controllerLatitudes: ContiguousArray<Double>
+    /// Controller longitudes
+    private var controllerLongitudes: ContiguousArray<Double>
+    /// Controller altitudes
+    private var controllerAltitudes: ContiguousArray<Double>
+    /// Remote control piloting command rolls
+    private var rcPcmdRolls: ContiguousArray<Int32>
+    /// Remote control piloting command pitches
+    private var rcPcmdPitches: ContiguousArray<Int32>
+    /// Remote control piloting command yaws
+    private var rcPcmdYaws: ContiguousArray<Int32>
+    /// Remote control piloting command gazs
+    private var rcPcmdGazs: ContiguousArray<Int32>
+    /// Remote control piloting command sources
+    private var rcPcmdSources: ContiguousArray<Int32>
+    /// Wifi signal levels
+    private var rssis: ContiguousArray<Int32>
+    /// Battery voltages
+    private var batteryVoltages: ContiguousArray<Int32>
+
+    /// Number of recorded samples
+    var count: Int {
+        return position.count
+    }
+
+    /// Memory used by the sample columns, in bytes
+    var memoryUsage: Int {
+        return position.capacity * (7 * MemoryLayout<Double>.stride + 7 * MemoryLayout<Int32>.stride)
+    }
+
+    /// Constructor
+    ///
+    /// - Parameter capacity: max number of samples, older samples are dropped once reached
+    init(capacity: Int) {
+        position = BlackBoxRingPosition(capacity: capacity)
+        timestamps = ContiguousArray(repeating: 0, count: capacity)
+        droneLatitudes = ContiguousArray(repeating: 0, count: capacity)
+        droneLongitudes = ContiguousArray(repeating: 0, count: capacity)
+        droneAltitudes = ContiguousArray(repeating: 0, count: capacity)
+        controllerLatitudes = ContiguousArray(repeating: 0, count: capacity)
+        controllerLongitudes = ContiguousArray(repeating: 0, count: capacity)
+        controllerAltitudes = ContiguousArray(repeating: 0, count: capacity)
+        rcPcmdRolls = ContiguousArray(repeating: 0, count: capacity)
+        rcPcmdPitches = ContiguousArray(repeating: 0, count: capacity)
+        rcPcmdYaws = ContiguousArray(repeating: 0, count: capacity)
+        rcPcmdGazs = ContiguousArray(repeating: 0, count: capacity)
+        rcPcmdSources = ContiguousArray(repeating: 0, count: capacity)
+        rssis = ContiguousArray(repeating: 0, count: capacity)
+        batteryVoltages = ContiguousArray(repeating: 0, count: capacity)
+    }
+
+    /// Records a sample.
+    ///
+    /// - Parameter sample: environment data sample to record
+    mutating func append(_ sample: BlackBoxEnvironmentData) {
+        let index = position.advance()
+        timestamps[index] = sample.timestamp
+        droneLatitudes[index] = sample.droneLocation.latitude
+        droneLongitudes[index] = sample.droneLocation.longitude
+        droneAltitudes[index] = sample.droneLocation.altitude
+        controllerLatitudes[index] = sample.controllerLocation.latitude
+        controllerLongitudes[index] = sample.controllerLocation.longitude
+        controllerAltitudes[index] = sample.controllerLocation.altitude
+        rcPcmdRolls[index] = Int32(truncatingIfNeeded: sample.rcPcmd.roll)
+        rcPcmdPitches[index] = Int32(truncatingIfNeeded: sample.rcPcmd.pitch)
+        rcPcmdYaws[index] = Int32(truncatingIfNeeded: sample.rcPcmd.yaw)
+        rcPcmdGazs[index] = Int32(truncatingIfNeeded: sample.rcPcmd.gaz)
+        rcPcmdSources[index] = Int32(truncatingIfNeeded: sample.rcPcmd.source)
+        rssis[index] = Int32(truncatingIfNeeded: sample.rssi)
+        batteryVoltages[index] = Int32(truncatingIfNeeded: sample.batteryVoltage)
+    }
+
+    /// Writes the samples, from the oldest to the newest, as a JSON array.
+    ///
+    /// - Parameters:
+    ///   - writer: JSON stream writer
+    ///   - key: key of the array
+    /// - Throws: encoding or sink error
+    func write(to writer: JsonStreamWriter, key: String) throws {
+        try writer.beginArray(key: key)
+        try position.forEachIndex { index in
+            try writer.writeObject { sample in
+                try sample.write(timestamps[index], key: Keys.timestamp.rawValue)
+                try sample.writeObject(key: Keys.droneLocation.rawValue) { location in
+                    try location.write(droneLatitudes[index], key: LocationKeys.latitude.rawValue)
+                    try location.write(droneLongitudes[index], key: LocationKeys.longitude.rawValue)
+                    try location.write(droneAltitudes[index], key: LocationKeys.altitude.rawValue)
+                }
+                try sample.writeObject(key: Keys.controllerLocation.rawValue) { location in
+                    try location.write(controllerLatitudes[index], key: LocationKeys.latitude.rawValue)
+                    try location.write(controllerLongitudes[index], key: LocationKeys.longitude.rawValue)
+                    try location.write(controllerAltitudes[index], key: LocationKeys.altitude.rawValue)
+                }
+                sample.writeObject(key: Keys.rcPcmd.rawValue) { pcmd in
+                    pcmd.write(rcPcmdRolls[index], key: PcmdKeys.roll.rawValue)
+                    pcmd.write(rcPcmdPitches[index], key: PcmdKeys.pitch.rawValue)
+                    pcmd.write(rcPcmdYaws[index], key: PcmdKeys.yaw.rawValue)
+                    pcmd.write(rcPcmdGazs[index], key: PcmdKeys.gaz.rawValue)
+                    pcmd.write(rcPcmdSources[index], key: PcmdKeys.source.rawValue)
+                }
+                sample.write(rssis[index], key: Keys.rssi.rawValue)
+                sample.write(batteryVoltages[index], key: Keys.batteryVoltage.rawValue)
+            }
+        }
+        try writer.endArray()
+    }
+
+    func encode(to encoder: Encoder) throws {
+        var container = encoder.unkeyedContainer()
+        try position.forEachIndex { index in
+            var sample = container.nestedContainer(keyedBy: Keys.self)
+            try sample.encode(timestamps[index], forKey: .timestamp)
+            var droneLocation = sample.nestedContainer(keyedBy: LocationKeys.self, forKey: .droneLocation)
+            try droneLocation.encode(droneLatitudes[index], forKey: .latitude)
+            try droneLocation.encode(droneLongitudes[index], forKey: .longitude)
+            try droneLocation.encode(droneAltitudes[index], forKey: .altitude)
+            var controllerLocation = sample.nestedContainer(keyedBy: LocationKeys.self, forKey: .controllerLocation)
+            try controllerLocation.encode(controllerLatitudes[index], forKey: .latitude)
+            try controllerLocation.encode(controllerLongitudes[index], forKey: .longitude)
+            try controllerLocation.encode(controllerAltitudes[index], forKey: .altitude)
+            var pcmd = sample.nestedContainer(keyedBy: PcmdKeys.self, forKey: .rcPcmd)
+            try pcmd.encode(rcPcmdRolls[index], forKey: .roll)
+            try pcmd.encode(rcPcmdPitches[index], forKey: .pitch)
+            try pcmd.encode(rcPcmdYaws[index], forKey: .yaw)
+            try pcmd.encode(rcPcmdGazs[index], forKey: .gaz)
+            try pcmd.encode(rcPcmdSources[index], forKey: .source)
+            try sample.encode(rssis[index], forKey: .rssi)
+            try sample.encode(batteryVoltages[index], forKey: .batteryVoltage)
+        }
+    }
+}
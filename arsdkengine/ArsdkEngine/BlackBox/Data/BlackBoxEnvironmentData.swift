@@ -35,7 +35,7 @@ import GroundSdk
 /// Contains information such as the current drone location, controller location, wifi signal level...
 struct BlackBoxEnvironmentData: Encodable {
 
-    private enum CodingKeys: String, CodingKey {
+    enum CodingKeys: String, CodingKey {
         case timestamp
         case droneLocation = "product_gps"
         case controllerLocation = "device_gps"
@@ -110,7 +110,7 @@ struct BlackBoxEnvironmentData: Encodable {
 
 /// Piloting command sent to the drone with a remote control
 struct BlackBoxRcPilotingCommandData: Encodable, Equatable {
-    private enum CodingKeys: String, CodingKey {
+    enum CodingKeys: String, CodingKey {
         case roll
         case pitch
         case yaw
@@ -35,7 +35,7 @@ import GroundSdk
 /// Contains information about the flight such as speed, altitude, attitude received and piloting command sent
 struct BlackBoxFlightData: Encodable {
 
-    private enum CodingKeys: String, CodingKey {
+    enum CodingKeys: String, CodingKey {
         case timestamp
         case altitude = "product_alt"
         case heightAboveGround = "product_height_above_ground"
@@ -110,7 +110,7 @@ struct BlackBoxFlightData: Encodable {
 
 /// Speed information about the drone
 struct BlackBoxSpeedData: Encodable, Equatable {
-    private enum CodingKeys: String, CodingKey {
+    enum CodingKeys: String, CodingKey {
         case speedX = "vx"
         case speedY = "vy"
         case speedZ = "vz"
@@ -130,7 +130,7 @@ struct BlackBoxSpeedData: Encodable, Equatable {
 
 /// Attitude information about the drone
 struct BlackBoxAttitudeData: Encodable, Equatable {
-    private enum CodingKeys: String, CodingKey {
+    enum CodingKeys: String, CodingKey {
         case roll
         case pitch
         case yaw
@@ -150,7 +150,7 @@ struct BlackBoxAttitudeData: Encodable, Equatable {
 
 /// Piloting command sent to the drone
 struct BlackBoxDronePilotingCommandData: Encodable, Equatable {
-    private enum CodingKeys: String, CodingKey {
+    enum CodingKeys: String, CodingKey {
         case roll
         case pitch
         case yaw
@@ -31,6 +31,12 @@ import Foundation
 
 /// Location data
 struct BlackBoxLocationData: Encodable, Equatable {
+    enum CodingKeys: String, CodingKey {
+        case latitude
+        case longitude
+        case altitude
+    }
+
     var latitude = 500.0
     var longitude = 500.0
     var altitude = 500.0
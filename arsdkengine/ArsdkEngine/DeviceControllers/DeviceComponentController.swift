@@ -92,6 +92,16 @@ public class DeviceComponentController: NSObject {
     func dataSyncAllowanceChanged(allowed: Bool) {
     }
 
+    /// Identifiers of the features whose commands are handled by this component controller.
+    ///
+    /// The owning device controller only forwards to `didReceiveCommand` the commands belonging to one of these
+    /// features. `nil` (default) means that every received command is forwarded.
+    ///
+    /// - Note: this value is read once per feature by the device controller, it must not change over time.
+    var handledFeatureIds: Set<Int16>? {
+        return nil
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
@@ -360,7 +360,22 @@ class DeviceController: NSObject {
     var droneServer: DroneServer?
 
     /// All attached component controllers
-    var componentControllers = [DeviceComponentController]()
+    var componentControllers = [DeviceComponentController]() {
+        didSet {
+            commandRoutes.removeAll()
+        }
+    }
+
+    /// Component controllers to forward received commands to, by feature id.
+    ///
+    /// Lazily filled for each received feature from the `handledFeatureIds` of the component controllers.
+    private var commandRoutes = [Int16: [DeviceComponentController]]()
+
+    /// Whether per-feature command dispatch cost should be collected. Debug purpose only.
+    static var collectCommandDispatchStats = false
+
+    /// Per-feature command dispatch cost, only filled when `collectCommandDispatchStats` is `true`.
+    private(set) var commandDispatchStats = [Int16: (count: Int, duration: TimeInterval)]()
 
     /// Connection session of the controller
     private(set) var connectionSession: ControllerConnectionSession!
@@ -867,6 +882,7 @@ class DeviceController: NSObject {
     /// Device is disconnected
     func protocolDidDisconnect() {
         componentControllers.forEach { component in component.didDisconnect() }
+        logCommandDispatchStats()
         self.backend?.deleteNoAckCmdLoop()
         blackBoxSession?.close()
         blackBoxSession = nil
@@ -991,7 +1007,41 @@ extension DeviceController {
 
     final func didReceiveCommand(_ command: OpaquePointer) {
         protocolDidReceiveCommand(command)
-        componentControllers.forEach { component in component.didReceiveCommand(command) }
+        let featureId = ArsdkCommand.getFeatureId(command)
+        let route = commandRoutes[featureId] ?? buildCommandRoute(featureId: featureId)
+        if DeviceController.collectCommandDispatchStats {
+            let start = ProcessInfo.processInfo.systemUptime
+            route.forEach { component in component.didReceiveCommand(command) }
+            let stats = commandDispatchStats[featureId] ?? (count: 0, duration: 0)
+            commandDispatchStats[featureId] = (count: stats.count + 1,
+                                               duration: stats.duration + ProcessInfo.processInfo.systemUptime - start)
+        } else {
+            route.forEach { component in component.didReceiveCommand(command) }
+        }
+    }
+
+    /// Builds and stores the list of component controllers to forward the commands of a given feature to.
+    ///
+    /// - Parameter featureId: id of the feature
+    /// - Returns: component controllers handling the feature, in registration order
+    private func buildCommandRoute(featureId: Int16) -> [DeviceComponentController] {
+        let route = componentControllers.filter { component in
+            component.handledFeatureIds?.contains(featureId) ?? true
+        }
+        commandRoutes[featureId] = route
+        return route
+    }
+
+    /// Logs and resets the collected per-feature command dispatch cost.
+    private func logCommandDispatchStats() {
+        guard !commandDispatchStats.isEmpty else {
+            return
+        }
+        commandDispatchStats.sorted { $0.value.duration > $1.value.duration }.forEach { featureId, stats in
+            ULog.d(.ctrlTag, "Device \(device.uid) feature 0x\(String(UInt16(bitPattern: featureId), radix: 16)): " +
+                "\(stats.count) commands dispatched in \(Int(stats.duration * 1000)) ms")
+        }
+        commandDispatchStats.removeAll()
     }
 }
 
@@ -80,6 +80,14 @@ class AnafiAlarms: DeviceComponentController {
         alarms.unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureArdrone3PilotingstateUid,
+                kArsdkFeatureArdrone3SettingsstateUid,
+                kArsdkFeatureBatteryUid,
+                kArsdkFeatureCommonCommonstateUid,
+                kArsdkFeatureControllerInfoUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
@@ -60,6 +60,10 @@ class AnafiAltimeter: DeviceComponentController {
         altimeter.unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureArdrone3PilotingstateUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
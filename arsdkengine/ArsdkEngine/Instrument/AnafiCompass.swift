@@ -54,6 +54,10 @@ class AnafiCompass: DeviceComponentController {
         compass.unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureArdrone3PilotingstateUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
@@ -81,6 +81,10 @@ class AnafiFlightMeter: DeviceComponentController {
         flightMeter.unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureArdrone3SettingsstateUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
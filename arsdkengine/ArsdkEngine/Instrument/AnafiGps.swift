@@ -93,6 +93,12 @@ class AnafiGps: DeviceComponentController {
         gps.unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureArdrone3PilotingstateUid,
+                kArsdkFeatureArdrone3GpssettingsstateUid,
+                kArsdkFeatureArdrone3GpsstateUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
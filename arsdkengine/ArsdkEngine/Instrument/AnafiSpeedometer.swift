@@ -57,6 +57,10 @@ class AnafiSpeedometer: DeviceComponentController {
         speedometer.unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureArdrone3PilotingstateUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
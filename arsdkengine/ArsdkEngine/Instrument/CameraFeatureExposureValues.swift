@@ -69,6 +69,10 @@ class CameraFeatureExposureValues: DeviceComponentController {
         hasReceivedValues = false
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureCameraUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
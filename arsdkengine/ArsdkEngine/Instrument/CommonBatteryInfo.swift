@@ -54,6 +54,11 @@ class CommonBatteryInfo: DeviceComponentController {
         batteryInfo.unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureCommonCommonstateUid,
+                kArsdkFeatureBatteryUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
@@ -57,6 +57,11 @@ class CommonRadio: DeviceComponentController {
             .update(is4GInterfering: false)
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureCommonCommonstateUid,
+                kArsdkFeatureWifiUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
@@ -54,6 +54,10 @@ class PhotoProgressIndicatorController: DeviceComponentController {
         photoProgressIndicator.resetRemainingTime().resetRemainingDistance().unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureCameraUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
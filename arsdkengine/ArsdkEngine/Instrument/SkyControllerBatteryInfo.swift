@@ -54,6 +54,10 @@ class SkyControllerBatteryInfo: DeviceComponentController {
         batteryInfo.unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureSkyctrlSkycontrollerstateUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
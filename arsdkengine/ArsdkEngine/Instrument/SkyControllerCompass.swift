@@ -54,6 +54,10 @@ class SkyControllerCompass: DeviceComponentController {
         compass.unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureSkyctrlSkycontrollerstateUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
@@ -53,6 +53,10 @@ class AnafiBeeper: DeviceComponentController {
         beeper.unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureArdrone3SoundstateUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
@@ -59,6 +59,10 @@ class AnafiDevToolbox: DeviceComponentController, DevToolboxBackend {
         devToolbox.unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureDebugUid]
+    }
+
     /// A command has been received.
     ///
     /// - Parameter command: received command
@@ -59,6 +59,10 @@ class AnafiMagnetometer: DeviceComponentController {
         magnetometer.unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureCommonCalibrationstateUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
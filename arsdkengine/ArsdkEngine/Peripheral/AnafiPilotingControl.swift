@@ -105,6 +105,10 @@ class AnafiPilotingControl: DeviceComponentController, PilotingControlBackend {
         }
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeaturePilotingStyleUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
@@ -33,6 +33,13 @@ import GroundSdk
 /// 4Mb thumbnail cache
 private let thumbnailCacheSize = 4 * 1024 * 1024
 
+/// 32Mb persistent thumbnail cache, per drone
+private let thumbnailDiskCacheSize = 32 * 1024 * 1024
+
+/// Root directory of the persistent thumbnail caches, containing one directory per drone
+private let thumbnailDiskCacheDir = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask).first!
+    .appendingPathComponent("thumbnails", isDirectory: true)
+
 /// Media store delegate
 protocol MediaStoreDelegate: class {
 
@@ -62,6 +69,17 @@ protocol MediaStoreDelegate: class {
     /// - Returns: a request that can be canceled
     func browse(completion: @escaping (_ medias: [MediaItemCore]) -> Void) -> CancelableCore?
 
+    /// Get the list of the medias on the drone, giving them in chunks while they are received
+    ///
+    /// - Parameters:
+    ///   - chunk: closure that will be called each time new medias have been received
+    ///   - medias: medias received since the previous chunk
+    ///   - completion: closure that will be called when browsing did finish
+    ///   - allMedias: list of all the medias available on the device
+    /// - Returns: a request that can be canceled
+    func browse(chunk: @escaping (_ medias: [MediaItemCore]) -> Void,
+                completion: @escaping (_ allMedias: [MediaItemCore]) -> Void) -> CancelableCore?
+
     /// Download the thumbnail of a given media.
     ///
     /// - Parameters:
@@ -155,7 +173,11 @@ class ArsdkMediaStore: DeviceComponentController {
         super.init(deviceController: deviceController)
         mediaStore = MediaStoreCore(
             store: deviceController.device.peripheralStore,
-            thumbnailCache: MediaStoreThumbnailCacheCore(mediaStoreBackend: self, size: thumbnailCacheSize),
+            thumbnailCache: MediaStoreThumbnailCacheCore(
+                mediaStoreBackend: self, size: thumbnailCacheSize,
+                diskCacheDirectory: thumbnailDiskCacheDir.appendingPathComponent(deviceController.device.uid,
+                                                                                 isDirectory: true),
+                diskCacheSize: thumbnailDiskCacheSize),
             backend: self)
         self.delegate.mediaStore = mediaStore
     }
@@ -204,6 +226,17 @@ extension ArsdkMediaStore: MediaStoreBackend {
         return delegate.browse(completion: completion)
     }
 
+    /// Browse medias, giving them in chunks while they are received.
+    ///
+    /// - Parameters:
+    ///   - chunk: closure called each time new medias have been received
+    ///   - completion: closure called when the request is terminated
+    /// - Returns: browse request, or nil if there is an error
+    public func browse(chunk: @escaping ([MediaItemCore]) -> Void,
+                       completion: @escaping ([MediaItemCore]) -> Void) -> CancelableCore? {
+        return delegate.browse(chunk: chunk, completion: completion)
+    }
+
     /// Download a thumbnail
     ///
     /// - Parameters:
@@ -259,45 +292,41 @@ extension ArsdkMediaStore: MediaStoreBackend {
         let resourcesIterator = mediaResources.makeIterator()
         // create result request
         let task = CancelableTaskCore()
-
-        /// Notify progress with current file progress
+        // resource downloads running concurrently
+        let transfers = MediaResourceTransfers()
+        task.request = transfers
+        // maximum number of concurrent resource downloads
+        let maxTransfers = max(1, GroundSdkConfig.sharedInstance.mediaDownloadConcurrency)
+        // total size of downloaded resources
+        var downloadedSize = UInt64(0)
+        // `true` once all resources have been iterated
+        var allResourcesStarted = false
+        // `true` if a resource download failed, which stops the task
+        var failed = false
+
+        /// Notify progress with a given download progress
         ///
-        /// - Parameter percent: current file download %
-        func notifyProgress(percent: Float, currentMedia: MediaItem) {
-            progress(MediaDownloaderCore(
-                mediaResourceListIterator: resourcesIterator, currentFileProgress: percent / 100,
-                status: .running, currentMedia: currentMedia))
-        }
-
-        /// Notify progress completion with fileUrl
-        func notifyProgressCompletion(currentMedia: MediaItem, fileUrl: URL) {
-            progress(MediaDownloaderCore(
-                mediaResourceListIterator: resourcesIterator, currentFileProgress: 1.0, status: .fileDownloaded,
-                currentMedia: currentMedia, fileUrl: fileUrl))
-        }
-
-        /// Notify progress with an error
-        func notifyProgressError(currentMedia: MediaItem) {
-            progress(MediaDownloaderCore(
-                mediaResourceListIterator: resourcesIterator, currentFileProgress: 0.0,
-                status: .error, currentMedia: currentMedia))
-        }
-
-        /// Notify download terminated
-        func notifyProgressTerminated() {
+        /// - Parameters:
+        ///   - status: download status
+        ///   - transfer: resource download that progressed, nil when the whole task is terminated
+        ///   - fileUrl: url of downloaded file, if status is `.fileDownloaded`
+        func notifyProgress(status: MediaTaskStatus, transfer: MediaResourceTransfer?, fileUrl: URL? = nil) {
             progress(MediaDownloaderCore(
-                mediaResourceListIterator: resourcesIterator, currentFileProgress: 1.0, status: .complete))
+                mediaResourceListIterator: resourcesIterator, downloadedSize: downloadedSize,
+                transferredSize: transfers.transferredSize, currentFileProgress: transfer?.progress ?? 1.0,
+                currentFileThroughput: transfer?.throughput ?? 0, status: status, currentMedia: transfer?.media,
+                fileUrl: fileUrl))
         }
 
         /// Process downloaded resource
         ///
         /// - Parameters:
-        ///   - media: downloaded media
+        ///   - transfer: resource download
         ///   - filePath: local media resource path
-        func processDownloadedResource(media: MediaItem, fileUrl: URL) {
-            ULog.d(.ctrlTag, "media \(fileUrl.path) downloaded")
+        func processDownloadedResource(transfer: MediaResourceTransfer, fileUrl: URL) {
+            ULog.d(.ctrlTag, "media \(fileUrl.path) downloaded, \(Int(transfer.throughput)) B/s")
             if let galleryAdder = galleryAdder {
-                galleryAdder.addMedia(url: fileUrl, mediaType: media.type) { _ in
+                galleryAdder.addMedia(url: fileUrl, mediaType: transfer.media.type) { _ in
                     do {
                         try FileManager.default.removeItem(at: fileUrl)
                     } catch let err {
@@ -307,58 +336,91 @@ extension ArsdkMediaStore: MediaStoreBackend {
             }
         }
 
-        /// Download the next media resource in the iterator
-        func downloadNextResource() {
+        /// Stop the task after a resource download error
+        ///
+        /// - Parameter transfer: failed resource download
+        func fail(transfer: MediaResourceTransfer) {
+            failed = true
+            transfer.progress = 0
+            notifyProgress(status: .error, transfer: transfer)
+            transfers.cancel()
+        }
+
+        /// Start the download of a media resource
+        ///
+        /// - Parameters:
+        ///   - media: media of the resource
+        ///   - resource: resource to download
+        func startDownload(media: MediaItemCore, resource: MediaItemResourceCore) {
+            let transfer = MediaResourceTransfer(media: media, resource: resource)
+            let req = delegate.download(
+                resource: resource, destDirectoryPath: destDirectoryPath,
+                progress: { percent in
+                    transfer.update(progress: Float(percent) / 100)
+                    notifyProgress(status: .running, transfer: transfer)
+                },
+                completion: { fileUrl in
+                    if let fileUrl = fileUrl {
+                        transfer.update(progress: 1)
+                        processDownloadedResource(transfer: transfer, fileUrl: fileUrl)
+                        notifyProgress(status: .fileDownloaded, transfer: transfer, fileUrl: fileUrl)
+                        transfers.remove(transfer)
+                        downloadedSize += resource.size
+                        downloadNextResources()
+                    } else if !task.canceled && !failed {
+                        ULog.w(.ctrlTag, "Error downloading \(resource.uid)")
+                        transfers.remove(transfer)
+                        fail(transfer: transfer)
+                    } else {
+                        transfers.remove(transfer)
+                    }
+            })
+            // request created, update client request and notify progress
+            if let req = req {
+                // store low level request to cancel
+                transfer.request = req
+                transfers.add(transfer)
+                // progress for the new resource
+                notifyProgress(status: .running, transfer: transfer)
+            } else {
+                // error sending request
+                ULog.d(.ctrlTag, "media download error sending request, skipping media")
+                fail(transfer: transfer)
+            }
+        }
+
+        /// Download the next media resources in the iterator, up to the maximum number of concurrent downloads
+        func downloadNextResources() {
             guard !task.canceled else {
                 // don't do anything if the request has been canceled
                 return
             }
 
-            // Move to next resource
-            if let mediaResource = resourcesIterator.next() {
-                // request download
-                let req = delegate.download(
-                    resource: mediaResource.resource, destDirectoryPath: destDirectoryPath,
-                    progress: { percent in notifyProgress(percent: Float(percent), currentMedia: mediaResource.media) },
-                    completion: { fileUrl in
-                        task.request = nil
-                        if let fileUrl = fileUrl {
-                            processDownloadedResource(media: mediaResource.media, fileUrl: fileUrl)
-                            notifyProgressCompletion(currentMedia: mediaResource.media, fileUrl: fileUrl)
-                            downloadNextResource()
-                        } else if !task.canceled {
-                            ULog.w(.ctrlTag, "Error downloading \(String(describing: fileUrl?.path))")
-                            notifyProgressError(currentMedia: mediaResource.media)
-                        }
-                })
-                // request created, update client request and notify progress
-                if let req = req {
-                    // store current low level request to cancel
-                    task.request = req
-                    // progress for the new resource
-                    notifyProgress(percent: 0, currentMedia: mediaResource.media)
+            while !failed && !allResourcesStarted && transfers.count < maxTransfers {
+                // Move to next resource
+                if let mediaResource = resourcesIterator.next() {
+                    startDownload(media: mediaResource.media, resource: mediaResource.resource)
                 } else {
-                    // error sending request
-                    ULog.d(.ctrlTag, "media download error sending request, skipping media")
-                    notifyProgressError(currentMedia: mediaResource.media)
+                    allResourcesStarted = true
                 }
-            } else {
+            }
+            if allResourcesStarted && transfers.count == 0 && !failed {
                 // no more resources to download
                 if let galleryAdder = galleryAdder {
                     ULog.d(.ctrlTag, "media download terminated, waiting for media gallery completion ")
                     galleryAdder.notifyCompleted {
                         ULog.d(.ctrlTag, "media gallery update terminated")
-                        notifyProgressTerminated()
+                        notifyProgress(status: .complete, transfer: nil)
                     }
                 } else {
                     ULog.d(.ctrlTag, "media download terminated")
-                    notifyProgressTerminated()
+                    notifyProgress(status: .complete, transfer: nil)
                 }
             }
         }
 
-        // start download with the first resource
-        downloadNextResource()
+        // start download with the first resources
+        downloadNextResources()
         return task
     }
 
@@ -418,3 +480,80 @@ extension ArsdkMediaStore: MediaStoreBackend {
         return task
     }
 }
+
+/// A media resource download, running in a media download task
+private class MediaResourceTransfer {
+    /// Media of the downloaded resource
+    let media: MediaItemCore
+    /// Downloaded resource
+    let resource: MediaItemResourceCore
+    /// Low level download request
+    var request: CancelableCore?
+    /// Download progress, from 0.0 to 1.0
+    var progress: Float = 0
+    /// Download throughput, in bytes per second, 0 until known
+    private(set) var throughput: Double = 0
+    /// Date and progress of the first progress update, from which throughput is computed.
+    /// The download may have been resumed, so the progress at download start isn't used.
+    private var reference: (date: Date, progress: Float)?
+
+    /// Constructor
+    ///
+    /// - Parameters:
+    ///   - media: media of the downloaded resource
+    ///   - resource: downloaded resource
+    init(media: MediaItemCore, resource: MediaItemResourceCore) {
+        self.media = media
+        self.resource = resource
+    }
+
+    /// Updates download progress
+    ///
+    /// - Parameter progress: new download progress, from 0.0 to 1.0
+    func update(progress: Float) {
+        self.progress = progress
+        if let reference = reference {
+            let elapsed = Date().timeIntervalSince(reference.date)
+            if elapsed > 0 {
+                throughput = Double(resource.size) * Double(progress - reference.progress) / elapsed
+            }
+        } else {
+            reference = (date: Date(), progress: progress)
+        }
+    }
+}
+
+/// Media resource downloads running concurrently in a media download task
+private class MediaResourceTransfers: CancelableCore {
+    /// Running downloads
+    private var transfers: [MediaResourceTransfer] = []
+
+    /// Number of running downloads
+    var count: Int {
+        return transfers.count
+    }
+
+    /// Size of the data received by the running downloads
+    var transferredSize: Float {
+        return transfers.reduce(0) { $0 + Float($1.resource.size) * $1.progress }
+    }
+
+    /// Adds a running download
+    ///
+    /// - Parameter transfer: download to add
+    func add(_ transfer: MediaResourceTransfer) {
+        transfers.append(transfer)
+    }
+
+    /// Removes a download, when it is terminated
+    ///
+    /// - Parameter transfer: download to remove
+    func remove(_ transfer: MediaResourceTransfer) {
+        transfers = transfers.filter { $0 !== transfer }
+    }
+
+    /// Cancels all running downloads
+    func cancel() {
+        transfers.forEach { $0.request?.cancel() }
+    }
+}
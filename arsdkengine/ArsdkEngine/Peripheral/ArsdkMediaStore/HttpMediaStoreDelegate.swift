@@ -54,8 +54,12 @@ class HttpMediaStoreDelegate: NSObject, MediaStoreDelegate {
 
     func startWatchingContentChanges() {
         if let droneServer = deviceController.droneServer {
-            mediaWsApi = MediaWsApi(server: droneServer) { [unowned self] in
-                self.mediaStore?.markContentChanged().notifyUpdated()
+            mediaWsApi = MediaWsApi(server: droneServer) { [unowned self] contentChange in
+                if let contentChange = contentChange {
+                    self.mediaStore?.update(contentChange: contentChange).notifyUpdated()
+                } else {
+                    self.mediaStore?.markContentChanged().notifyUpdated()
+                }
             }
         }
     }
@@ -70,6 +74,13 @@ class HttpMediaStoreDelegate: NSObject, MediaStoreDelegate {
         }
     }
 
+    func browse(chunk: @escaping ([MediaItemCore]) -> Void,
+                completion: @escaping ([MediaItemCore]) -> Void) -> CancelableCore? {
+        return mediaRestApi?.getMediaList(chunk: chunk) { medias in
+            completion(medias ?? [])
+        }
+    }
+
     func downloadThumbnail(for owner: MediaStoreThumbnailCacheCore.ThumbnailOwner,
                            completion: @escaping (Data?) -> Void) -> CancelableCore? {
         switch owner {
@@ -61,6 +61,10 @@ class BatteryGaugeUpdaterController: DeviceComponentController, BatteryGaugeUpda
         batteryGaugeUpdater.unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureGaugeFwUpdaterUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
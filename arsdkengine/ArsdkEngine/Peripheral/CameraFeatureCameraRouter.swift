@@ -430,6 +430,10 @@ class CameraFeatureCameraRouter: DeviceComponentController {
         super.presetDidChange()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureCameraUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
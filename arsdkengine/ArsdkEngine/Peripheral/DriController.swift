@@ -334,6 +334,10 @@ class DriController: DeviceComponentController, DriBackend {
         deviceStore?.commit()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureDriUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
@@ -58,6 +58,10 @@ class DroneManagerDroneFinder: DeviceComponentController {
         droneFinder.unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureDroneManagerUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
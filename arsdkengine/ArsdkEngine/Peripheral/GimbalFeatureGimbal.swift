@@ -382,6 +382,10 @@ class GimbalFeatureGimbal: DeviceComponentController {
         super.willForget()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureGimbalUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
@@ -228,6 +228,10 @@ class LedsController: DeviceComponentController, LedsBackend {
         leds.notifyUpdated()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureLedsUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
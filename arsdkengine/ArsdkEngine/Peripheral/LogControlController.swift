@@ -95,6 +95,10 @@ class LogControlController: DeviceComponentController, LogControlBackend {
         return false
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureSecurityEditionUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
@@ -248,6 +248,10 @@ class PreciseHomeController: DeviceComponentController, PreciseHomeBackend {
         deviceStore?.commit()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeaturePreciseHomeUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
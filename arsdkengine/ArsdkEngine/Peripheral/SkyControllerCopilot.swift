@@ -191,6 +191,10 @@ class SkyControllerCopilot: DeviceComponentController, CopilotBackend {
         copilot.notifyUpdated()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureSkyctrlCopilotingstateUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
@@ -56,6 +56,10 @@ class SkyControllerMagnetometer: DeviceComponentController {
         magnetometer.unpublish()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureSkyctrlCalibrationstateUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
@@ -126,6 +126,7 @@ class StreamListenerWrapper: NSObject, SdkCoreStreamListener {
         } else if stream.isEqual(controller.pendingStream) {
             controller.pendingStream = nil
         }
+        controller.deviceController.engine.arsdk.logLoopStats()
         listener.streamDidClose(stream, reason: reason)
     }
 
@@ -102,6 +102,10 @@ class TargetTrackerController: DeviceComponentController {
         targetTracker.update(framing: requestedFraming)
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureFollowMeUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
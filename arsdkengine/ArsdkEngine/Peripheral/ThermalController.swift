@@ -408,6 +408,10 @@ class ThermalController: DeviceComponentController, ThermalControlBackend {
         deviceStore?.commit()
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureThermalUid]
+    }
+
     /// A command has been received
     /// - Parameter command: received command
     override func didReceiveCommand(_ command: OpaquePointer) {
@@ -76,6 +76,10 @@ class UserStorageRemovableUserStorage: DeviceComponentController {
         formattingTypeSupported = false
     }
 
+    override var handledFeatureIds: Set<Int16>? {
+        return [kArsdkFeatureUserStorageUid]
+    }
+
     /// A command has been received
     ///
     /// - Parameter command: received command
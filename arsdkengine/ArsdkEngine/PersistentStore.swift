@@ -28,18 +28,134 @@
 //    SUCH DAMAGE.
 
 import Foundation
+import UIKit
 
-/// A persistent store backed by a NSUserDefaults storing devices as dictionary
+/// Backend persisting the entries of a `PersistentStore`.
+///
+/// Each entry is a root dictionary (a device or a preset) identified by its type and uid, and is loaded and stored
+/// independently of the others.
+protocol PersistentStoreBackend: class {
+
+    /// Lists the uids of the entries stored for a type.
+    ///
+    /// - Parameter type: entry type
+    /// - Returns: set of stored entry uids
+    func entryUids(type: String) -> Set<String>
+
+    /// Loads an entry.
+    ///
+    /// - Parameters:
+    ///   - type: entry type
+    ///   - uid: entry uid
+    /// - Returns: entry content, nil if the entry is not stored
+    func loadEntry(type: String, uid: String) -> [String: AnyObject]?
+
+    /// Stores an entry.
+    ///
+    /// - Note: this function is called on the store background queue.
+    ///
+    /// - Parameters:
+    ///   - type: entry type
+    ///   - uid: entry uid
+    ///   - content: entry content, nil to remove the entry
+    /// - Returns: `true` if the entry has been durably written or removed, `false` otherwise
+    func storeEntry(type: String, uid: String, content: [String: AnyObject]?) -> Bool
+}
+
+/// Persistent store backend storing each entry in its own binary property list file, under `<root>/<type>/<uid>`.
+class FilePersistentStoreBackend: PersistentStoreBackend {
+
+    /// Extension of the entry files
+    private static let fileExtension = "plist"
+
+    /// Characters allowed unescaped in an entry file name
+    private static let fileNameCharacters = CharacterSet.alphanumerics.union(CharacterSet(charactersIn: "-_."))
+
+    /// Root directory of the store
+    private let rootUrl: URL
+
+    /// Constructor
+    ///
+    /// - Parameter rootUrl: root directory of the store
+    init(rootUrl: URL) {
+        self.rootUrl = rootUrl
+    }
+
+    func entryUids(type: String) -> Set<String> {
+        let fileNames = (try? FileManager.default.contentsOfDirectory(atPath: directoryUrl(type: type).path)) ?? []
+        return Set(fileNames.compactMap { fileName in
+            let url = URL(fileURLWithPath: fileName)
+            guard url.pathExtension == FilePersistentStoreBackend.fileExtension else {
+                return nil
+            }
+            return url.deletingPathExtension().lastPathComponent.removingPercentEncoding
+        })
+    }
+
+    func loadEntry(type: String, uid: String) -> [String: AnyObject]? {
+        guard let data = try? Data(contentsOf: fileUrl(type: type, uid: uid)) else {
+            return nil
+        }
+        do {
+            return try PropertyListSerialization.propertyList(from: data, format: nil) as? [String: AnyObject]
+        } catch let err {
+            ULog.w(.tag, "Failed to read persistent store entry \(type)/\(uid): \(err)")
+            return nil
+        }
+    }
+
+    func storeEntry(type: String, uid: String, content: [String: AnyObject]?) -> Bool {
+        let url = fileUrl(type: type, uid: uid)
+        do {
+            if let content = content {
+                try FileManager.default.createDirectory(
+                    at: directoryUrl(type: type), withIntermediateDirectories: true, attributes: nil)
+                try PropertyListSerialization.data(fromPropertyList: content, format: .binary, options: 0)
+                    .write(to: url, options: .atomic)
+            } else if FileManager.default.fileExists(atPath: url.path) {
+                try FileManager.default.removeItem(at: url)
+            }
+            return true
+        } catch let err {
+            ULog.e(.tag, "Failed to write persistent store entry \(type)/\(uid): \(err)")
+            return false
+        }
+    }
+
+    /// Gets the directory containing the entries of a type.
+    ///
+    /// - Parameter type: entry type
+    /// - Returns: directory url
+    private func directoryUrl(type: String) -> URL {
+        return rootUrl.appendingPathComponent(type, isDirectory: true)
+    }
+
+    /// Gets the file of an entry.
+    ///
+    /// - Parameters:
+    ///   - type: entry type
+    ///   - uid: entry uid
+    /// - Returns: file url
+    private func fileUrl(type: String, uid: String) -> URL {
+        let fileName = uid.addingPercentEncoding(withAllowedCharacters: FilePersistentStoreBackend.fileNameCharacters)
+            ?? uid
+        return directoryUrl(type: type).appendingPathComponent(fileName)
+            .appendingPathExtension(FilePersistentStoreBackend.fileExtension)
+    }
+}
+
+/// A persistent store storing devices and presets as dictionaries.
+///
+/// Entries are loaded lazily from the backend the first time they are accessed. Committed entries are kept in memory
+/// and written to the backend on a background queue, after a short delay that coalesces successive commits; only
+/// entries that changed are written.
 class PersistentStore {
 
-    /// Name of main entry in the shared preferences
+    /// Name of main entry in the shared preferences, where the whole store was saved by previous versions
     private static let storeName = "arsdkenginestore"
 
-    /// Key for the version (value associated is an int)
-    private static let versionKey = "version"
-
-    /// Current version
-    private static let currentVersion = 1
+    /// Delay, in seconds, during which commits are coalesced before being written to the backend
+    private static let defaultCommitDelay = 0.5
 
     // device keys
     /// Key of a device type (value is an int, value of DeviceModel.internalId)
@@ -57,42 +173,75 @@ class PersistentStore {
     /// Key of a device preset uid
     static let devicePresetUid = "preset"
 
-    /// UserDefault instance to back up data
+    /// Backend in which entries are persisted
+    private let backend: PersistentStoreBackend
+
+    /// Delay, in seconds, during which commits are coalesced
     ///
-    /// - note: set as internal var to be overriden by mocks
-    internal var userDefaults = UserDefaults.init()
+    /// Visibility is internal for testing purposes
+    var commitDelay = PersistentStore.defaultCommitDelay
 
-    /// Whole store content, loaded from UserDefault
+    /// Loaded store content, by entry type then by entry uid
     ///
     /// Visibility is internal for testing purposes
     var content: [String: AnyObject]!
 
+    /// Entries that have been looked up in the backend, by entry type. Entries that are not in this set and not in
+    /// `content` still have to be loaded from the backend.
+    private var loadedUids: [String: Set<String>] = [:]
+
+    /// Uids of the entries stored in the backend when they have first been listed, by entry type
+    private var storedUids: [String: Set<String>] = [:]
+
+    /// Committed entries that still have to be written to the backend, by entry type then by entry uid.
+    /// A `NSNull` content means that the entry must be removed.
+    private var pendingWrites: [String: [String: AnyObject]] = [:]
+
+    /// Whether a write of the pending entries is scheduled
+    private var writeScheduled = false
+
+    /// Serial queue on which entries are written to the backend
+    private let writeQueue = DispatchQueue(label: "com.parrot.arsdkengine.persistentstore")
+
     /// set of all root dictionaries owned by clients
     private var rootDictonnaries = Set<RootPersistentDictionaryRef>()
 
     /// Constructor
-    init() {
-        if let data = userDefaults.dictionary(forKey: PersistentStore.storeName) {
-            content = data as [String: AnyObject]
-        } else {
-            content = [:]
-        }
-        let version = content[PersistentStore.versionKey] as? Int
-        if version != PersistentStore.currentVersion {
-            content[PersistentStore.versionKey] = PersistentStore.currentVersion as AnyObject?
-            userDefaults.set(content, forKey: PersistentStore.storeName)
-        }
+    ///
+    /// - Parameters:
+    ///   - backend: backend in which entries are persisted, nil to store them in files in the application support
+    ///     directory
+    ///   - userDefaults: user defaults from which the store saved by previous versions is migrated
+    init(backend: PersistentStoreBackend? = nil, userDefaults: UserDefaults = UserDefaults.init()) {
+        self.backend = backend ?? FilePersistentStoreBackend(rootUrl: FileManager.default.urls(
+            for: .applicationSupportDirectory, in: .userDomainMask).first!.appendingPathComponent(
+                PersistentStore.storeName, isDirectory: true))
+        content = [:]
+        migrate(from: userDefaults)
+        let notificationCenter = NotificationCenter.default
+        notificationCenter.addObserver(self, selector: #selector(flushOnNotification),
+                                       name: UIApplication.didEnterBackgroundNotification, object: nil)
+        notificationCenter.addObserver(self, selector: #selector(flushOnNotification),
+                                       name: UIApplication.willTerminateNotification, object: nil)
+    }
+
+    deinit {
+        NotificationCenter.default.removeObserver(self)
+        flush()
     }
 
     /// Get the list of stored device uid
     ///
     /// - Returns: the set of stored device uids
     func getDevicesUid() -> Set<String> {
-        var keySet: Set<String>
-        if let keys = (content[RootPersistentDictionary.DictType.devices.rawValue] as? [String: AnyObject])?.keys {
-            keySet = Set(keys)
-        } else {
-            keySet = Set()
+        let type = RootPersistentDictionary.DictType.devices.rawValue
+        if storedUids[type] == nil {
+            storedUids[type] = backend.entryUids(type: type)
+        }
+        let loaded = loadedUids[type] ?? []
+        var keySet = storedUids[type]!.subtracting(loaded)
+        if let keys = (content[type] as? [String: AnyObject])?.keys {
+            keySet.formUnion(keys)
         }
         return keySet
     }
@@ -111,6 +260,85 @@ class PersistentStore {
         return dict
     }
 
+    /// Writes all committed entries that have not been written yet to the backend, without waiting for the commit
+    /// delay.
+    ///
+    /// Entries that fail to be written are queued again, and written by the next flush, unless they have been
+    /// committed again meanwhile.
+    ///
+    /// - Parameter wait: `true` to return only once the entries have been written
+    func flush(wait: Bool = false) {
+        if !pendingWrites.isEmpty {
+            let writes = pendingWrites
+            let backend = self.backend
+            pendingWrites = [:]
+            writeQueue.async { [weak self] in
+                var failedWrites: [String: [String: AnyObject]] = [:]
+                for (type, entries) in writes {
+                    for (uid, entry) in entries
+                        where !backend.storeEntry(type: type, uid: uid, content: entry as? [String: AnyObject]) {
+                            failedWrites[type, default: [:]][uid] = entry
+                    }
+                }
+                if !failedWrites.isEmpty {
+                    DispatchQueue.main.async {
+                        self?.requeue(failedWrites)
+                    }
+                }
+            }
+        }
+        if wait {
+            writeQueue.sync {}
+        }
+    }
+
+    /// Queues again entries that failed to be written to the backend.
+    ///
+    /// - Parameter failedWrites: entries that failed to be written, by entry type then by entry uid
+    private func requeue(_ failedWrites: [String: [String: AnyObject]]) {
+        for (type, entries) in failedWrites {
+            for (uid, entry) in entries where pendingWrites[type]?[uid] == nil {
+                ULog.w(.tag, "Persistent store entry \(type)/\(uid) will be written again on next flush")
+                pendingWrites[type, default: [:]][uid] = entry
+            }
+        }
+    }
+
+    /// Flushes the pending entries when the application goes to background or terminates.
+    @objc private func flushOnNotification() {
+        flush(wait: true)
+    }
+
+    /// Moves the store saved as a whole in the user defaults by previous versions into the backend.
+    ///
+    /// The store is removed from the user defaults only once all its entries have been written to the backend.
+    /// Otherwise, the migration is retried by the next store instance, skipping the entries that already are in the
+    /// backend, as they may have been changed since their migration.
+    ///
+    /// - Parameter userDefaults: user defaults containing the store to migrate
+    private func migrate(from userDefaults: UserDefaults) {
+        guard let data = userDefaults.dictionary(forKey: PersistentStore.storeName) else {
+            return
+        }
+        ULog.i(.tag, "Migrating persistent store from user defaults")
+        var migrated = true
+        for type in [RootPersistentDictionary.DictType.devices, .presets] {
+            if let entries = data[type.rawValue] as? [String: AnyObject] {
+                let storedUids = backend.entryUids(type: type.rawValue)
+                for (uid, entry) in entries where !storedUids.contains(uid) {
+                    if !backend.storeEntry(type: type.rawValue, uid: uid, content: entry as? [String: AnyObject]) {
+                        migrated = false
+                    }
+                }
+            }
+        }
+        if migrated {
+            userDefaults.removeObject(forKey: PersistentStore.storeName)
+        } else {
+            ULog.e(.tag, "Persistent store migration failed, user defaults store kept")
+        }
+    }
+
     fileprivate func registerRootDictionaryRef(_ dictionaryRef: RootPersistentDictionaryRef) {
         rootDictonnaries.insert(dictionaryRef)
     }
@@ -127,18 +355,43 @@ class PersistentStore {
     }
 
     fileprivate func getRootEntryContent(typeKey type: String, key: String) -> [String: AnyObject]? {
-        return content[type]?[key] as? [String: AnyObject]
+        if let entry = content[type]?[key] as? [String: AnyObject] {
+            return entry
+        }
+        if loadedUids[type]?.contains(key) ?? false {
+            return nil
+        }
+        let entry = backend.loadEntry(type: type, uid: key)
+        loadedUids[type, default: []].insert(key)
+        if entry != nil {
+            setRootEntry(typeKey: type, key: key, content: entry)
+        }
+        return entry
     }
 
     fileprivate func updateRootEntryContent(typeKey type: String, key: String, content data: [String: AnyObject]?) {
-        var rootEntry = content[type] as? [String: AnyObject]
-        // if no device exists, create the dictionary container
-        if rootEntry == nil {
-            rootEntry = [:]
+        setRootEntry(typeKey: type, key: key, content: data)
+        loadedUids[type, default: []].insert(key)
+        pendingWrites[type, default: [:]][key] = data as AnyObject? ?? NSNull()
+        if !writeScheduled {
+            writeScheduled = true
+            DispatchQueue.main.asyncAfter(deadline: .now() + commitDelay) { [weak self] in
+                self?.writeScheduled = false
+                self?.flush()
+            }
         }
-        rootEntry![key] = data as AnyObject?
+    }
+
+    /// Sets the loaded content of an entry.
+    ///
+    /// - Parameters:
+    ///   - type: entry type
+    ///   - key: entry uid
+    ///   - data: entry content, nil to remove the entry
+    private func setRootEntry(typeKey type: String, key: String, content data: [String: AnyObject]?) {
+        var rootEntry = content[type] as? [String: AnyObject] ?? [:]
+        rootEntry[key] = data as AnyObject?
         content[type] = rootEntry as AnyObject?
-        userDefaults.set(content, forKey: PersistentStore.storeName)
     }
 }
 
@@ -83,6 +83,54 @@ class DroneServer {
         return httpSession.getData(request: request, completion: completion)
     }
 
+    /// Download a file with a get request, resuming a previous partial download, if any
+    ///
+    /// - Note: the request is started in this function.
+    ///
+    /// - Parameters:
+    ///   - api: api to use
+    ///   - partialFileUrl: local url of the partial file, kept when the download fails or is canceled
+    ///   - destination: destination local file url
+    ///   - progress: progress callback
+    ///   - progressValue: progress percentage (from 0 to 100)
+    ///   - completion: completion callback
+    ///   - result: the request result
+    ///   - localFileUrl: the local file url of the downloaded file
+    /// - Returns: the request
+    func downloadFile(
+        api: String, partialFileUrl: URL, destination: URL, progress: @escaping (_ progressValue: Int) -> Void,
+        completion: @escaping (_ result: HttpSessionCore.Result, _ localFileUrl: URL?) -> Void) -> CancelableCore {
+
+        let request = URLRequest(url: baseHttpUrl.appendingPathComponent(api),
+                                 cachePolicy: .reloadIgnoringLocalCacheData)
+
+        return httpSession.downloadFile(
+            request: request, partialFileUrl: partialFileUrl, destination: destination, progress: progress,
+            completion: completion)
+    }
+
+    /// Get data, handing it over as it is received
+    ///
+    /// - Note: the request is started in this function.
+    ///
+    /// - Parameters:
+    ///   - api: api to use
+    ///   - didReceive: callback called in a background queue each time data is received. Throwing an error cancels
+    ///                 the request.
+    ///   - data: the received data
+    ///   - completion: completion callback
+    ///   - result: the request result
+    /// - Returns: the request
+    func streamData(
+        api: String, didReceive: @escaping (_ data: Data) throws -> Void,
+        completion: @escaping (_ result: HttpSessionCore.Result) -> Void) -> CancelableCore {
+
+        let request = URLRequest(url: baseHttpUrl.appendingPathComponent(api),
+                                 cachePolicy: .reloadIgnoringLocalCacheData)
+
+        return httpSession.streamData(request: request, didReceive: didReceive, completion: completion)
+    }
+
     /// Send a file with a put request
     ///
     /// - Note: the request is started in this function.
@@ -40,46 +40,75 @@ class MediaRestApi {
     /// Base address to access the media api
     private let baseApi = "/api/v1/media"
 
+    /// Directory where partially downloaded resources are kept until their download is resumed
+    private static let partialDownloadsDir = URL(fileURLWithPath: NSTemporaryDirectory())
+        .appendingPathComponent("mediaDownloads", isDirectory: true)
+
+    /// Deletes the partial downloads left by the previous runs, evaluated once, by the first instance
+    private static let partialDownloadsCleanUp: Void = {
+        try? FileManager.default.removeItem(at: partialDownloadsDir)
+    }()
+
     /// Constructor
     ///
     /// - Parameter server: the drone server from which medias should be accessed
     init(server: DroneServer) {
         self.server = server
+        _ = MediaRestApi.partialDownloadsCleanUp
     }
 
     /// Get the list of all medias on the drone
     ///
+    /// The list is decoded in a background queue while it is received.
+    ///
     /// - Parameters:
     ///   - runId: run id to filter the list with. If nil (default value), list won't be filtered.
+    ///   - chunk: callback called on the main thread each time at least `mediaListChunkSize` medias have been decoded
+    ///     since the previous call. Medias not given through this callback before the request completes are only
+    ///     given by the completion callback. If nil (default value), medias are only given by the completion callback.
+    ///   - medias: medias decoded since the previous call
     ///   - completion: the completion callback (called on the main thread)
-    ///   - mediaList: list of medias on the drone
+    ///   - mediaList: list of all medias on the drone, including the ones already given by `chunk`
     /// - Returns: the request
     func getMediaList(
         runId: String? = nil,
+        chunk: ((_ medias: [MediaItemCore]) -> Void)? = nil,
         completion: @escaping (_ mediaList: [MediaItemCore]?) -> Void) -> CancelableCore {
-        return server.getData(api: "\(baseApi)/medias") { result, data in
+        let streamDecoder = MediaListStreamDecoder()
+        // number of medias already given by the chunk callback, only accessed in the http session queue
+        var chunkedCount = 0
+        // whether the request is complete, only accessed on the main thread
+        var completed = false
+        return server.streamData(api: "\(baseApi)/medias", didReceive: { data in
+            try streamDecoder.process(data)
+            if let chunk = chunk, streamDecoder.medias.count - chunkedCount >= MediaRestApi.mediaListChunkSize {
+                let medias = Array(streamDecoder.medias[chunkedCount...])
+                chunkedCount = streamDecoder.medias.count
+                DispatchQueue.main.async {
+                    if !completed {
+                        chunk(medias)
+                    }
+                }
+            }
+        }, completion: { result in
+            completed = true
             switch result {
             case .success:
                 // listing medias is successful
-                if let data = data {
-                    let decoder = JSONDecoder()
-                    // need to override the way date are parsed because default format is iso8601 extended
-                    decoder.dateDecodingStrategy = .formatted(.iso8601Base)
-                    do {
-                        let mediaList = try decoder.decode([Media].self, from: data)
-                        // transform the json object media list into a `MediaItemCore` list
-                        let medias = mediaList.map { MediaItemCore.from(httpMedia: $0) }.compactMap { $0 }
-                        completion(medias)
-                    } catch let error {
-                        ULog.w(.mediaTag, "Failed to decode data \(String(data: data, encoding: .utf8) ?? ""): " +
-                            error.localizedDescription)
-                        completion(nil)
-                    }
+                do {
+                    try streamDecoder.finish()
+                    completion(streamDecoder.medias)
+                } catch let error {
+                    ULog.w(.mediaTag, "Failed to decode media list: \(error)")
+                    completion(nil)
                 }
+            case .error(let error):
+                ULog.w(.mediaTag, "Failed to get media list: \(error)")
+                completion(nil)
             default:
                 completion(nil)
             }
-        }
+        })
     }
 
     /// Fetch the thumbnail of a given media.
@@ -133,6 +162,8 @@ class MediaRestApi {
 
     /// Download a resource
     ///
+    /// A download that failed or was canceled is resumed by the next download of the same resource.
+    ///
     /// - Parameters:
     ///   - resource: the resource to download
     ///   - destDirectoryPath: the directory path where the resource should be stored
@@ -147,8 +178,12 @@ class MediaRestApi {
         completion: @escaping (_ fileUrl: URL?) -> Void) -> CancelableCore? {
 
         if let httpResource = resource.backendData as? MediaResource {
+            // size and date identify the resource content, as resource ids are only unique for a given drone
+            let partialFileName = "\(httpResource.resId)-\(httpResource.size)-" +
+                "\(Int64(httpResource.date.timeIntervalSince1970)).part"
             return server.downloadFile(
                 api: httpResource.urlStr,
+                partialFileUrl: MediaRestApi.partialDownloadsDir.appendingPathComponent(partialFileName),
                 destination: URL(fileURLWithPath: destDirectoryPath)
                     .appendingPathComponent(httpResource.resId),
                 progress: progress,
@@ -217,9 +252,154 @@ class MediaRestApi {
         }
     }
 
+    /// Minimum number of medias given at once to the chunk callback of `getMediaList`
+    static let mediaListChunkSize = 200
+
+    /// Incremental decoder of the media list returned by the REST api.
+    ///
+    /// The json array is split into its elements while bytes are received, each element being decoded as soon as it
+    /// is complete. Only the bytes of the element being received are kept.
+    class MediaListStreamDecoder {
+
+        /// Decoding error
+        enum DecodeError: Error {
+            /// Data is not a json array of objects
+            case malformed
+            /// Data ended before the end of the json array
+            case incomplete
+        }
+
+        /// Json bytes driving the element splitting
+        private enum Byte {
+            static let openBrace = UInt8(ascii: "{")
+            static let closeBrace = UInt8(ascii: "}")
+            static let openBracket = UInt8(ascii: "[")
+            static let closeBracket = UInt8(ascii: "]")
+            static let quote = UInt8(ascii: "\"")
+            static let backslash = UInt8(ascii: "\\")
+            static let comma = UInt8(ascii: ",")
+            static let space = UInt8(ascii: " ")
+            static let tab = UInt8(ascii: "\t")
+            static let lineFeed = UInt8(ascii: "\n")
+            static let carriageReturn = UInt8(ascii: "\r")
+        }
+
+        /// Medias decoded so far
+        private(set) var medias: [MediaItemCore] = []
+
+        /// Decoder of a single media
+        private let decoder = JSONDecoder()
+
+        /// Bytes of the element being received
+        private var pending = Data()
+
+        /// Nesting depth of the current byte inside an array element, 0 when between elements
+        private var depth = 0
+
+        /// `true` when the current byte is inside a json string
+        private var inString = false
+
+        /// `true` when the current byte is escaped inside a json string
+        private var escaped = false
+
+        /// `true` once the array opening bracket has been received
+        private var arrayStarted = false
+
+        /// `true` once the array closing bracket has been received
+        private var arrayEnded = false
+
+        /// Constructor
+        init() {
+            // need to override the way date are parsed because default format is iso8601 extended
+            decoder.dateDecodingStrategy = .formatted(.iso8601Base)
+        }
+
+        /// Processes received data.
+        ///
+        /// Medias completely received are decoded and appended to `medias`.
+        ///
+        /// - Parameter data: received data
+        /// - Throws: an error if data is not a valid media list
+        func process(_ data: Data) throws {
+            guard !data.isEmpty else {
+                return
+            }
+            try data.withUnsafeBytes { (bytes: UnsafePointer<UInt8>) -> Void in
+                // start of the element being received in this data, if any
+                var elementStart: Int? = depth > 0 ? 0 : nil
+                for i in 0..<data.count {
+                    let byte = bytes[i]
+                    if depth > 0 {
+                        if inString {
+                            if escaped {
+                                escaped = false
+                            } else if byte == Byte.backslash {
+                                escaped = true
+                            } else if byte == Byte.quote {
+                                inString = false
+                            }
+                        } else if byte == Byte.quote {
+                            inString = true
+                        } else if byte == Byte.openBrace || byte == Byte.openBracket {
+                            depth += 1
+                        } else if byte == Byte.closeBrace || byte == Byte.closeBracket {
+                            depth -= 1
+                            if depth == 0, let start = elementStart {
+                                pending.append(bytes + start, count: i + 1 - start)
+                                try decodeElement()
+                                elementStart = nil
+                            }
+                        }
+                    } else if byte != Byte.space && byte != Byte.lineFeed && byte != Byte.carriageReturn
+                        && byte != Byte.tab {
+                        if !arrayStarted && byte == Byte.openBracket {
+                            arrayStarted = true
+                        } else if !arrayStarted || arrayEnded {
+                            throw DecodeError.malformed
+                        } else if byte == Byte.openBrace {
+                            depth = 1
+                            elementStart = i
+                        } else if byte == Byte.closeBracket {
+                            arrayEnded = true
+                        } else if byte != Byte.comma {
+                            throw DecodeError.malformed
+                        }
+                    }
+                }
+                if let start = elementStart {
+                    // element continues in next data
+                    pending.append(bytes + start, count: data.count - start)
+                }
+            }
+        }
+
+        /// Tells that all data has been received.
+        ///
+        /// - Throws: an error if the media list is incomplete
+        func finish() throws {
+            guard arrayEnded else {
+                throw DecodeError.incomplete
+            }
+        }
+
+        /// Decodes the pending element and appends it to `medias` if it is a supported media.
+        ///
+        /// - Throws: an error if the element is not a valid media
+        private func decodeElement() throws {
+            defer {
+                pending.removeAll(keepingCapacity: true)
+            }
+            let httpMedia = try decoder.decode(Media.self, from: pending)
+            // transform the json object media into a `MediaItemCore`
+            if let media = MediaItemCore.from(httpMedia: httpMedia) {
+                medias.append(media)
+            }
+        }
+    }
+
     /// An object representing the media as the REST api describes it.
     /// This object has all the field of the json object given by the REST api.
-    fileprivate struct Media: Decodable {
+    struct Media: Decodable {
         enum CodingKeys: String, CodingKey {
             case mediaId = "media_id"
             case type
@@ -268,15 +448,16 @@ class MediaRestApi {
     }
 
     /// MediaTypes as described by the REST api.
-    fileprivate enum MediaType: String, Decodable {
+    enum MediaType: String, Decodable {
         case photo = "PHOTO"
         case video = "VIDEO"
     }
 
     /// Media resource as described by the REST api.
-    fileprivate struct MediaResource: Decodable {
+    struct MediaResource: Decodable {
         enum CodingKeys: String, CodingKey {
             case resId = "resource_id"
+            case mediaId = "media_id"
             case type
             case format
             case date = "datetime"
@@ -293,6 +474,8 @@ class MediaRestApi {
 
         /// Resource id
         let resId: String
+        /// Id of the media owning the resource
+        let mediaId: String?
         /// Type
         let type: ResourceType
         /// Format
@@ -320,27 +503,27 @@ class MediaRestApi {
     }
 
     /// Resource type as described by the REST api
-    fileprivate enum ResourceType: String, Decodable {
+    enum ResourceType: String, Decodable {
         case photo = "PHOTO"
         case video = "VIDEO"
     }
 
     /// Resource format as described by the REST api
-    fileprivate enum ResourceFormat: String, Decodable {
+    enum ResourceFormat: String, Decodable {
         case jpg = "JPG"
         case dng = "DNG"
         case mp4 = "MP4"
     }
 
     /// Location as described by the REST api
-    fileprivate struct Location: Decodable {
+    struct Location: Decodable {
         let latitude: Double
         let longitude: Double
         let altitude: Double
     }
 
     /// Photo mode as described by the REST api
-    fileprivate enum PhotoMode: String, Decodable {
+    enum PhotoMode: String, Decodable {
         case single = "SINGLE"
         case bracketing = "BRACKETING"
         case burst = "BURST"
@@ -350,7 +533,7 @@ class MediaRestApi {
     }
 
     /// Panorama Type as described by the REST api
-    fileprivate enum PanoramaType: String, Decodable {
+    enum PanoramaType: String, Decodable {
         case horizontal_180 = "HORIZONTAL_180"
         case vertical_180 = "VERTICAL_180"
         case spherical = "SPHERICAL"
@@ -358,7 +541,7 @@ class MediaRestApi {
 }
 
 /// Extension of MediaItemCore that adds creation from http media objects
-fileprivate extension MediaItemCore {
+extension MediaItemCore {
     /// Creates a media from an http media
     ///
     /// - Parameter httpMedia: the http media
@@ -386,12 +569,12 @@ fileprivate extension MediaItemCore {
     }
 
     /// Mapper that maps media type from the REST api to the `MediaItem.MediaType`
-    static let typeMapper = Mapper<MediaRestApi.MediaType, MediaItem.MediaType>([
+    fileprivate static let typeMapper = Mapper<MediaRestApi.MediaType, MediaItem.MediaType>([
         .photo: .photo,
         .video: .video])
 
     /// Mapper that maps photo mode from the REST api to the `MediaItem.PhotoMode`
-    static let photoModeMapper = Mapper<MediaRestApi.PhotoMode, MediaItem.PhotoMode>([
+    fileprivate static let photoModeMapper = Mapper<MediaRestApi.PhotoMode, MediaItem.PhotoMode>([
         .single: .single,
         .bracketing: .bracketing,
         .burst: .burst,
@@ -400,14 +583,14 @@ fileprivate extension MediaItemCore {
         .gpsLapse: .gpsLapse])
 
     /// Mapper that maps panorama type from the REST api to the `MediaItem.PanoramaType`
-    static let panoramaTypeMapper = Mapper<MediaRestApi.PanoramaType, MediaItem.PanoramaType>([
+    fileprivate static let panoramaTypeMapper = Mapper<MediaRestApi.PanoramaType, MediaItem.PanoramaType>([
         .horizontal_180: .horizontal_180,
         .vertical_180: .vertical_180,
         .spherical: .spherical])
 }
 
 /// Extension of MediaItemResourceCore that adds creation from http resource objects
-fileprivate extension MediaItemResourceCore {
+extension MediaItemResourceCore {
     /// Creates a resource from an http resource
     ///
     /// - Parameter httpResource: the http resource
@@ -435,7 +618,7 @@ fileprivate extension MediaItemResourceCore {
     }
 
     /// Mapper that maps resource format from the REST api to the `MediaItem.Format`
-    static let formatMapper = Mapper<MediaRestApi.ResourceFormat, MediaItem.Format>([
+    fileprivate static let formatMapper = Mapper<MediaRestApi.ResourceFormat, MediaItem.Format>([
         .jpg: .jpg,
         .dng: .dng,
         .mp4: .mp4])
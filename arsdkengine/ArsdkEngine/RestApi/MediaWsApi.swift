@@ -35,8 +35,9 @@ class MediaWsApi {
 
     /// Drone server
     private let server: DroneServer
-    /// closure called when the websocket notify changes of media store content
-    private let contentDidChange: () -> Void
+    /// closure called when the websocket notify changes of media store content, with the change when it can be
+    /// applied incrementally, `nil` when the whole content must be browsed again
+    private let contentDidChange: (MediaStoreContentChange?) -> Void
     /// Active websocket session
     private var webSocketSession: WebSocketSession?
 
@@ -47,8 +48,9 @@ class MediaWsApi {
     ///
     /// - Parameters:
     ///   - server: the drone server from which medias should be accessed
-    ///   - eventCb: callback called when media store content has changed
-    init(server: DroneServer, eventCb: @escaping () -> Void) {
+    ///   - eventCb: callback called when media store content has changed, with the change when it can be applied
+    ///     incrementally, `nil` when the whole content must be browsed again
+    init(server: DroneServer, eventCb: @escaping (MediaStoreContentChange?) -> Void) {
         self.server = server
         self.contentDidChange = eventCb
         startSession()
@@ -79,6 +81,63 @@ class MediaWsApi {
         }
         /// event name
         let name: EventType
+        /// event data
+        let data: EventData?
+    }
+
+    /// Notification event data.
+    private struct EventData: Decodable {
+        enum CodingKeys: String, CodingKey {
+            case media
+            case mediaId = "media_id"
+            case resource
+            case resourceId = "resource_id"
+        }
+
+        /// Created media, for `media_created` event
+        let media: MediaRestApi.Media?
+        /// Removed media id, for `media_removed` event
+        let mediaId: String?
+        /// Created resource, for `resource_created` event
+        let resource: MediaRestApi.MediaResource?
+        /// Removed resource id, for `resource_removed` event
+        let resourceId: String?
+
+        /// Constructor, ignoring malformed fields so that the event is still processed
+        ///
+        /// - Parameter decoder: decoder
+        init(from decoder: Decoder) throws {
+            let container = try decoder.container(keyedBy: CodingKeys.self)
+            media = try? container.decode(MediaRestApi.Media.self, forKey: .media)
+            mediaId = try? container.decode(String.self, forKey: .mediaId)
+            resource = try? container.decode(MediaRestApi.MediaResource.self, forKey: .resource)
+            resourceId = try? container.decode(String.self, forKey: .resourceId)
+        }
+    }
+
+    /// Converts an event to a media store content change.
+    ///
+    /// - Parameter event: the received event
+    /// - Returns: the corresponding content change, `nil` if the whole content must be browsed again
+    private func contentChange(of event: Event) -> MediaStoreContentChange? {
+        switch event.name {
+        case .mediaCreated:
+            return event.data?.media.flatMap { MediaItemCore.from(httpMedia: $0) }.map { .mediaCreated($0) }
+        case .mediaRemoved:
+            return event.data?.mediaId.map { .mediaRemoved(uid: $0) }
+        case .resourceCreated:
+            if let httpResource = event.data?.resource, let mediaId = httpResource.mediaId,
+                let resource = MediaItemResourceCore.from(httpResource: httpResource) {
+                return .resourceCreated(mediaUid: mediaId, resource: resource)
+            }
+            return nil
+        case .resourceRemoved:
+            return event.data?.resourceId.map { .resourceRemoved(uid: $0) }
+        case .allMediaRemoved:
+            return .allMediaRemoved
+        case .indexingStateChanged:
+            return nil
+        }
     }
 }
 
@@ -89,12 +148,10 @@ extension MediaWsApi: WebSocketSessionDelegate {
 
         // decode message
         do {
-            let event = try JSONDecoder().decode(Event.self, from: data)
-            switch event.name {
-            case .mediaCreated, .mediaRemoved, .resourceCreated, .resourceRemoved, .allMediaRemoved,
-                 .indexingStateChanged:
-                contentDidChange()
-            }
+            let decoder = JSONDecoder()
+            decoder.dateDecodingStrategy = .formatted(.iso8601Base)
+            let event = try decoder.decode(Event.self, from: data)
+            contentDidChange(contentChange(of: event))
         } catch let error {
             ULog.w(.mediaTag, "Failed to decode data: \(error.localizedDescription)")
         }
@@ -105,6 +162,8 @@ extension MediaWsApi: WebSocketSessionDelegate {
         webSocketSession = nil
         DispatchQueue.main.asyncAfter(deadline: .now() + .milliseconds(250)) { [weak self] in
             self?.startSession()
+            // events may have been missed while disconnected
+            self?.contentDidChange(nil)
         }
     }
 
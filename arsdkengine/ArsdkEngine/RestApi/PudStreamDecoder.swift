@@ -55,6 +55,10 @@ extension PudError: LocalizedError {
 }
 
 /// StreamDecoder in order to convert PUDs files
+///
+/// The columns description received in the header is compiled once into column readers (fixed offset in a line,
+/// binary type and role in the collected informations). Lines are then read in place from the input buffer, through
+/// a read cursor, and their values are written directly as JSON text in the output.
 class PudStreamDecoder: StreamDecoder {
 
     /// States for the decode processing
@@ -73,7 +77,7 @@ class PudStreamDecoder: StreamDecoder {
     }
 
     /// BinaryType, represents types described in the binary Pud file
-    private enum BinaryType {
+    fileprivate enum BinaryType {
         case integer
         case bool
         case float
@@ -111,6 +115,89 @@ class PudStreamDecoder: StreamDecoder {
         }
     }
 
+    /// Role of a column in the informations collected while parsing the lines
+    fileprivate enum ColumnRole {
+        /// Value is only written in the output
+        case none
+        /// Line timestamp
+        case time
+        /// One of the speed components
+        case speed
+        /// Device GPS availability
+        case productGpsAvailable
+        /// Device latitude
+        case productLatitude
+        /// Device longitude
+        case productLongitude
+        /// Controller latitude
+        case controllerLatitude
+        /// Controller longitude
+        case controllerLongitude
+        /// Alert state
+        case alertState
+        /// Flying state
+        case flyingState
+
+        init(columnName: String) {
+            switch columnName {
+            case "time": self = .time
+            case "speed_vx", "speed_vy", "speed_vz": self = .speed
+            case "product_gps_available": self = .productGpsAvailable
+            case "product_gps_latitude": self = .productLatitude
+            case "product_gps_longitude": self = .productLongitude
+            case "controller_gps_latitude": self = .controllerLatitude
+            case "controller_gps_longitude": self = .controllerLongitude
+            case "alert_state": self = .alertState
+            case "flying_state": self = .flyingState
+            default: self = .none
+            }
+        }
+    }
+
+    /// A column reader, compiled from a column description
+    fileprivate struct ColumnReader {
+        /// Offset of the column value in a line
+        let offset: Int
+        /// Size of the column value
+        let size: Int
+        /// Binary type of the column value
+        let binaryType: BinaryType
+        /// Role of the column
+        let role: ColumnRole
+    }
+
+    /// A value read from a line
+    fileprivate enum Value {
+        case integer(Int)
+        case bool(Bool)
+        case float(Float32)
+        case double(Float64)
+
+        /// Value as an integer, `nil` if it is not an integer value
+        var integer: Int? {
+            if case let .integer(value) = self {
+                return value
+            }
+            return nil
+        }
+
+        /// Value as a double, `nil` if it is not a double value
+        var double: Float64? {
+            if case let .double(value) = self {
+                return value
+            }
+            return nil
+        }
+
+        /// Value as a boolean, `nil` if it is not a boolean value
+        var bool: Bool? {
+            if case let .bool(value) = self {
+                return value
+            }
+            return nil
+        }
+    }
+
     /// Minimal allocation buffer for streamDecoder
     static private let minimalBufferSize = 2048
 
@@ -137,6 +224,8 @@ class PudStreamDecoder: StreamDecoder {
 
     /// Columns descriptions
     private var columns: [ColumnDescription]?
+    /// Column readers, compiled from the columns descriptions
+    private var readers = [ColumnReader]()
     /// Size in bytes of one line (sum of columns size)
     private var lineSize = 0
     /// count the count of written lines
@@ -214,23 +303,24 @@ class PudStreamDecoder: StreamDecoder {
                     state = state.nextState()
 
                 case .loopLines:
-                    while dataToProcess.count >= lineSize {
-                        // process \(lineSize) bytes in the buffer dataToProcess
-                        if let lineData = processALine() {
-                            // alloc a retData if none
-                            if retData == nil {
-                                retData = Data(capacity: PudStreamDecoder.minimalBufferSize)
-                            }
-                            linesCount += 1
-                            if linesCount > 1 {
-                                // add ',' if it is not the first line
-                                retData!.append((",".data(using: .utf8))!)
+                    let bufferSize = dataToProcess.count
+                    if bufferSize >= lineSize {
+                        var out = retData ?? Data()
+                        out.reserveCapacity(out.count + max(PudStreamDecoder.minimalBufferSize, bufferSize * 2))
+                        let previousLinesCount = linesCount
+                        dataToProcess.withUnsafeBytes { (bytes: UnsafePointer<UInt8>) -> Void in
+                            // read all complete lines in place, moving the read cursor
+                            var readOffset = 0
+                            while bufferSize - readOffset >= lineSize {
+                                processALine(UnsafeRawPointer(bytes + readOffset), into: &out)
+                                readOffset += lineSize
                             }
-                            // write the line
-                            retData!.append(lineData)
                         }
-                        // remove the proceed line (advance the buffer)
-                        dataToProcess.removeSubrange(0..<lineSize)
+                        if retData != nil || linesCount > previousLinesCount {
+                            retData = out
+                        }
+                        // drop the processed lines at once, only an incomplete line remains
+                        dataToProcess.removeSubrange(0..<(bufferSize - bufferSize % lineSize))
                     }
                     // no more data (empty buffer or insufficent size)
                     stop = true
@@ -276,7 +366,7 @@ class PudStreamDecoder: StreamDecoder {
     ///
     ///  - Keep all generic informations in order to write them later at the end of the output file. See
     /// `outFinalInformations`. Remove the value `detailsHeadersName` and add computed values
-    ///  - Process all columns descriptions
+    ///  - Process all columns descriptions and compile them into column readers
     ///
     /// - Parameter header: the received header in the flight data file
     /// - Returns: true if header is OK, false otherwise
@@ -290,11 +380,21 @@ class PudStreamDecoder: StreamDecoder {
         outFinalInformations?.removeValue(forKey: inDetailsHeadersName)
 
         // Process columns description in `receivedHeaders`
-        columns = receivedHeaders.compactMap { ColumnDescription(properties: $0) }
-
-        // compute the size of one line (sum of columns size)
-        lineSize =  (columns?.reduce(0) { tmpSize, entry in tmpSize + entry.size }) ?? 0
-        if lineSize <= 0 {
+        let columns = receivedHeaders.compactMap { ColumnDescription(properties: $0) }
+        self.columns = columns
+
+        // compile the column readers and compute the size of one line (sum of columns size)
+        var offset = 0
+        readers = columns.map { column in
+            let reader = ColumnReader(offset: offset, size: column.size, binaryType: column.binaryType,
+                                      role: ColumnRole(columnName: column.name))
+            offset += column.size
+            return reader
+        }
+        lineSize = offset
+        // a line must at least hold the values read by the readers
+        let readEnd = readers.reduce(0) { max($0, $1.offset + $1.readSize) }
+        if lineSize <= 0 || readEnd > lineSize {
             return false
         }
         return true
@@ -319,22 +419,20 @@ class PudStreamDecoder: StreamDecoder {
         return retData
     }
 
-    /// Reads and decodes a row of data in the global input buffer of the stream (`dataToProcess`). In addition,
-    /// some calculated data is added to the result (such as speed). Finally, some data is collected in order to be
-    /// written later at the end of the stream (such as Gps positions, flight time or alerts)
+    /// Reads and decodes a row of data and writes it as a JSON array in the output. In addition, some calculated
+    /// data is added to the result (such as speed). Finally, some data is collected in order to be written later at
+    /// the end of the stream (such as Gps positions, flight time or alerts)
     ///
-    /// - Note: `dataToProcess` must contain at least one row of data (this function does not check the actual size
-    /// of `dataToProcess`
+    /// - Note: `line` must point to at least `lineSize` bytes
     ///
-    /// - Note: The timestamp of each line is checked. In case of inconsistency the parsing is stopped and nil
-    /// is returned
+    /// - Note: The timestamp of each line is checked. In case of inconsistency the line is not written
     ///
-    /// - Returns: a JSON Data object corresponding to the decoded line, or nil in an error occurs
-    private func processALine () -> Data? {
-        /// read buffer position
-        var indexInLine = 0
-        /// values collected from binary
-        var values = [Any]()
+    /// - Parameters:
+    ///   - line: line binary data
+    ///   - out: output to write the JSON array of the line to
+    private func processALine(_ line: UnsafeRawPointer, into out: inout Data) {
+        /// output size before writing this line, to drop it if it is not valid
+        let lineStart = out.count
         /// time read in the row
         var timeRead: Int?
         /// computed speed
@@ -345,51 +443,47 @@ class PudStreamDecoder: StreamDecoder {
         var controllerLatitude: Double?
         var controllerLongitude: Double?
 
-        // For each espected column, read the value from binary
-        columns?.forEach { aColumn in
-            let addValue: Any
-            switch aColumn.binaryType {
-            case .integer:
-                addValue = dataToProcess.getInt(at: indexInLine, size: aColumn.size)
-            case .float:
-                addValue = dataToProcess.getFloat32(at: indexInLine)
-            case .double:
-                addValue = dataToProcess.getFloat64(at: indexInLine)
-            case .bool:
-                addValue = dataToProcess.getBool(at: indexInLine, size: aColumn.size)
-            }
-            indexInLine += aColumn.size
-            values.append(addValue)
+        if linesCount > 0 {
+            // add ',' if it is not the first line
+            out.append(UInt8(ascii: ","))
+        }
+        out.append(UInt8(ascii: "["))
+
+        // For each espected column, read the value from binary and write it
+        for reader in readers {
+            let value = reader.read(line)
+            out.appendJson(value)
 
             /// process computed values
-            switch aColumn.name {
-            case "time":
-                timeRead = addValue as? Int ?? 0
+            switch reader.role {
+            case .none:
+                break
 
-            case "speed_vx", "speed_vy", "speed_vz":
-                let speed = addValue as? Double ?? 0.0
-                speedSquare += pow(speed, 2)
+            case .time:
+                timeRead = value.integer ?? 0
 
-            case "product_gps_available":
-                let available =  addValue as? Bool ?? false
-                gpsAvailable = available || gpsAvailable
+            case .speed:
+                let speed = value.double ?? 0.0
+                speedSquare += speed * speed
 
-            case "product_gps_latitude":
-                productLatitude = addValue as? Double
+            case .productGpsAvailable:
+                gpsAvailable = (value.bool ?? false) || gpsAvailable
 
-            case "product_gps_longitude":
-                productLongitude = addValue as? Double
+            case .productLatitude:
+                productLatitude = value.double
 
-            case "controller_gps_latitude":
-                controllerLatitude = addValue as? Double
+            case .productLongitude:
+                productLongitude = value.double
 
-            case "controller_gps_longitude":
-                controllerLongitude = addValue as? Double
+            case .controllerLatitude:
+                controllerLatitude = value.double
 
-            case "alert_state":
-                let intValue = addValue as? Int ?? -1
+            case .controllerLongitude:
+                controllerLongitude = value.double
+
+            case .alertState:
                 let alert: ArsdkFeatureArdrone3PilotingstateAlertstatechangedState =
-                    ArsdkFeatureArdrone3PilotingstateAlertstatechangedState(rawValue: intValue) ?? .none
+                    ArsdkFeatureArdrone3PilotingstateAlertstatechangedState(rawValue: value.integer ?? -1) ?? .none
                 if alert != latestAlert {
                     switch alert {
                     case .user, .cutOut, .tooMuchAngle:
@@ -400,10 +494,10 @@ class PudStreamDecoder: StreamDecoder {
                     latestAlert = alert
                 }
 
-            case "flying_state":
-                let intValue = addValue as? Int ?? -1
+            case .flyingState:
                 let flyingState: ArsdkFeatureArdrone3PilotingstateFlyingstatechangedState =
-                    ArsdkFeatureArdrone3PilotingstateFlyingstatechangedState(rawValue: intValue) ?? .sdkCoreUnknown
+                    ArsdkFeatureArdrone3PilotingstateFlyingstatechangedState(rawValue: value.integer ?? -1)
+                        ?? .sdkCoreUnknown
                 switch flyingState {
                 case .landed:
                     if let flightStartTime = flightStartTime, let timeRead = timeRead {
@@ -417,29 +511,28 @@ class PudStreamDecoder: StreamDecoder {
                 default:
                     break
                 }
-            default:
-                break
             }
+            out.append(UInt8(ascii: ","))
         } // end parsing all columns
 
         // update latest time
         if let timeRead = timeRead {
             if timeRead < latestTime || timeRead > latestTime + PudStreamDecoder.maxTimeInterval {
-                // Error: stop parsing if time is incoherent
-                return nil
+                // Error: drop the line if time is incoherent
+                out.removeSubrange(lineStart..<out.count)
+                return
             }
             latestTime = timeRead
         }
 
         // write computed speed value
         if speedSquare.isInfinite || speedSquare.isNaN {
-            values.append(0.0)
+            out.appendJson(.double(0.0))
         } else {
-            values.append(sqrt(speedSquare))
+            out.appendJson(.double(sqrt(speedSquare)))
         }
-
-        // the new line is now ready to be Json endoded
-        let jsonObjet = try? JSONSerialization.data(withJSONObject: values, options: [])
+        out.append(UInt8(ascii: "]"))
+        linesCount += 1
 
         // Keep other "global informations" for later (processed at the end of the stream)
         // update known first device location
@@ -463,7 +556,6 @@ class PudStreamDecoder: StreamDecoder {
                 latestControllerLocation = controllerLocation
             }
         }
-        return jsonObjet
     }
 
     /// Returns the latest JSON informations (end of the file)
@@ -503,67 +595,131 @@ class PudStreamDecoder: StreamDecoder {
 
         return jsonObjet
     }
-
 }
 
-// MARK: - Extention Data to get binaries Values
-extension Data {
+// MARK: - Column readers
+private extension PudStreamDecoder.ColumnReader {
+
+    /// Number of bytes read from the line
+    var readSize: Int {
+        switch binaryType {
+        case .integer, .bool:
+            return [2, 4, 8].contains(size) ? size : 1
+        case .float:
+            return 4
+        case .double:
+            return 8
+        }
+    }
 
-    func getInt(at index: Int, size: Int ) -> Int {
+    /// Reads the column value in a line.
+    ///
+    /// Integers are read as 1, 2, 4 or 8 bytes signed values depending on the column size, NaN and infinite
+    /// floating point values are read as 0.
+    ///
+    /// - Parameter line: line binary data
+    /// - Returns: column value
+    func read(_ line: UnsafeRawPointer) -> PudStreamDecoder.Value {
+        let address = line + offset
+        switch binaryType {
+        case .integer:
+            return .integer(readInteger(address))
+        case .bool:
+            return .bool(readInteger(address) != 0)
+        case .float:
+            let value = load(address, as: Float32.self)
+            return .float(value.isFinite ? value : 0.0)
+        case .double:
+            let value = load(address, as: Float64.self)
+            return .double(value.isFinite ? value : 0.0)
+        }
+    }
+
+    /// Reads an integer value, according to the column size.
+    ///
+    /// - Parameter address: address of the value
+    /// - Returns: integer value
+    private func readInteger(_ address: UnsafeRawPointer) -> Int {
         switch size {
         case 2:
-            let ret = self.subdata(in: index ..< (index + size)).withUnsafeBytes { (ptr: UnsafePointer<Int16>)  in
-                ptr.pointee
-            }
-            return Int(ret)
+            return Int(load(address, as: Int16.self))
         case 4:
-            let ret = self.subdata(in: index ..< (index + size)).withUnsafeBytes { (ptr: UnsafePointer<Int32>)  in
-                ptr.pointee
-            }
-            return Int(ret)
+            return Int(load(address, as: Int32.self))
         case 8:
-            let ret = self.subdata(in: index ..< (index + size)).withUnsafeBytes { (ptr: UnsafePointer<Int64>)  in
-                ptr.pointee
-            }
-            return Int(ret)
+            return Int(load(address, as: Int64.self))
         default: // 1
-            let ret = self.subdata(in: index ..< (index + size)).withUnsafeBytes { (ptr: UnsafePointer<Int8>)  in
-                ptr.pointee
-            }
-            return Int(ret)
+            return Int(load(address, as: Int8.self))
         }
     }
 
-    func getBool(at index: Int, size: Int ) -> Bool {
-        let valInt = self.getInt(at: index, size: size)
-        return valInt != 0
+    /// Loads a value from an address that may not be aligned for its type.
+    ///
+    /// - Parameters:
+    ///   - address: address of the value
+    ///   - type: type of the value
+    /// - Returns: loaded value
+    private func load<T: ExpressibleByIntegerLiteral>(_ address: UnsafeRawPointer, as type: T.Type) -> T {
+        var value: T = 0
+        withUnsafeMutableBytes(of: &value) {
+            $0.copyMemory(from: UnsafeRawBufferPointer(start: address, count: MemoryLayout<T>.size))
+        }
+        return value
     }
+}
 
-    func getFloat32(at index: Int) -> Float32 {
-        let retFloat: Float32
-
-            let ret = self.subdata(in: index ..< (index + 4)).withUnsafeBytes { (ptr: UnsafePointer<Float32>)  in
-                ptr.pointee
-            }
-            retFloat = ret
+// MARK: - JSON writer
+private extension Data {
 
-        if retFloat.isNaN || retFloat.isInfinite {
-            return 0.0
+    /// Writes a value as JSON text.
+    ///
+    /// Floating point values are written with the shortest representation that reads back to the same double,
+    /// float values being widened to double first, as JSONSerialization does.
+    ///
+    /// - Parameter value: value to write
+    mutating func appendJson(_ value: PudStreamDecoder.Value) {
+        switch value {
+        case .integer(let integer):
+            appendJson(integer)
+        case .bool(let bool):
+            append(contentsOf: bool ? "true".utf8 : "false".utf8)
+        case .float(let float):
+            appendJson(Double(float))
+        case .double(let double):
+            appendJson(double)
         }
-        return retFloat
     }
 
-    func getFloat64(at index: Int) -> Float64 {
-        let retFloat: Float64
-
-        let ret = self.subdata(in: index ..< (index + 8)).withUnsafeBytes { (ptr: UnsafePointer<Float64>)  in
-            ptr.pointee
+    /// Writes a double as JSON text. Integral values are written as integers.
+    ///
+    /// - Parameter double: finite double to write
+    mutating func appendJson(_ double: Double) {
+        if double.rounded() == double && abs(double) < 1e15 {
+            appendJson(Int(double))
+        } else {
+            append(contentsOf: double.description.utf8)
         }
-        retFloat = ret
+    }
 
-        if retFloat.isNaN || retFloat.isInfinite {
-            return 0.0
+    /// Writes an integer as JSON text.
+    ///
+    /// - Parameter integer: integer to write
+    mutating func appendJson(_ integer: Int) {
+        if integer < 0 {
+            append(UInt8(ascii: "-"))
+        }
+        var magnitude = integer.magnitude
+        var digits: (UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8,
+                     UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8, UInt8) =
+            (0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+        withUnsafeMutableBytes(of: &digits) { buffer in
+            // write digits from the end of the buffer
+            var start = buffer.count
+            repeat {
+                start -= 1
+                buffer[start] = UInt8(ascii: "0") + UInt8(magnitude % 10)
+                magnitude /= 10
+            } while magnitude > 0
+            append(contentsOf: buffer[start...])
         }
-        return retFloat
     }
 }
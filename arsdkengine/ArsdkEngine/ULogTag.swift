@@ -87,4 +87,7 @@ extension ULogTag {
 
     /// Logging tag of arsdk credentials
     static let credentialTag = ULogTag(name: "arsdkengine.credential")
+
+    /// Logging tag of black box recording
+    static let blackBoxTag = ULogTag(name: "arsdkengine.blackbox")
 }
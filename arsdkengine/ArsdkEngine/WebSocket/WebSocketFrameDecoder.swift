@@ -0,0 +1,346 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+
+import Foundation
+
+/// Incremental web socket frame decoder.
+///
+/// Received data is accumulated in a growable ring buffer. Frame headers are parsed in place, and a frame payload is
+/// only copied out of the ring, and unmasked, once the whole frame has been received. Fragmented messages are
+/// reassembled from their continuation frames; control frames (ping, pong, close) may be interleaved between
+/// fragments and are returned as soon as they are received.
+class WebSocketFrameDecoder {
+
+    /// Frame opCode
+    enum OpCode: UInt8 {
+        case continuation = 0x00
+        case text = 0x01
+        case binary = 0x02
+        case connectionClose = 0x08
+        case ping = 0x09
+        case pong = 0x0a
+
+        /// Whether this is a control frame opCode
+        var isControl: Bool {
+            return rawValue & 0x08 != 0
+        }
+    }
+
+    /// Decoded event
+    enum Event: Equatable {
+        /// A complete text message, with its payload
+        case text(Data)
+        /// A complete binary message, with its payload
+        case binary(Data)
+        /// A ping, with its application data
+        case ping(Data)
+        /// A pong, with its application data
+        case pong(Data)
+        /// A close request, with its status code and reason
+        case close(Data)
+    }
+
+    /// Decoding errors. After an error, the connection must be failed.
+    enum DecodeError: Error {
+        /// Reserved bits set while no extension has been negotiated
+        case reservedBits
+        /// Unknown frame opCode
+        case unknownOpCode(UInt8)
+        /// Continuation frame received while no fragmented message is in progress
+        case unexpectedContinuation
+        /// New data frame received before the end of the fragmented message in progress
+        case unterminatedMessage
+        /// Fragmented control frame, or control frame payload longer than 125 bytes
+        case invalidControlFrame
+        /// Message larger than the decoder max message size
+        case messageTooLarge
+    }
+
+    /// Default max size of a message, fragments included
+    static let defaultMaxMessageSize = 16 * 1024 * 1024
+
+    /// Max size of a message, fragments included
+    let maxMessageSize: Int
+
+    /// Number of received bytes not decoded yet
+    var bufferedByteCount: Int {
+        return count
+    }
+
+    /// Ring buffer storage, its size is always a power of two. It only grows, so that a stream of large messages
+    /// does not reallocate it for each message
+    private var ring: [UInt8]
+    /// Index of the first buffered byte in the ring
+    private var head = 0
+    /// Number of buffered bytes
+    private var count = 0
+    /// OpCode of the fragmented message in progress, `nil` if none
+    private var fragmentedOpCode: OpCode?
+    /// Payload of the fragmented message in progress
+    private var fragments = Data()
+
+    /// Constructor
+    ///
+    /// - Parameters:
+    ///   - initialCapacity: initial capacity of the ring buffer, rounded up to a power of two
+    ///   - maxMessageSize: max size of a message, fragments included
+    init(initialCapacity: Int = 4096, maxMessageSize: Int = WebSocketFrameDecoder.defaultMaxMessageSize) {
+        self.maxMessageSize = maxMessageSize
+        ring = [UInt8](repeating: 0, count: WebSocketFrameDecoder.capacity(forAtLeast: initialCapacity))
+    }
+
+    /// Appends received data to the decoder.
+    ///
+    /// - Parameter data: received data
+    func append(_ data: Data) {
+        guard !data.isEmpty else {
+            return
+        }
+        reserve(count + data.count)
+        let mask = ring.count - 1
+        let tail = (head + count) & mask
+        let firstLen = min(data.count, ring.count - tail)
+        data.withUnsafeBytes { (src: UnsafePointer<UInt8>) -> Void in
+            ring.withUnsafeMutableBufferPointer { dst in
+                (dst.baseAddress! + tail).assign(from: src, count: firstLen)
+                if firstLen < data.count {
+                    dst.baseAddress!.assign(from: src + firstLen, count: data.count - firstLen)
+                }
+            }
+        }
+        count += data.count
+    }
+
+    /// Decodes the next event from the buffered data.
+    ///
+    /// Data frames of fragmented messages are consumed silently until the final fragment has been received.
+    ///
+    /// - Returns: next decoded event, `nil` if more data is required
+    /// - Throws: `DecodeError` if the received data does not comply with the web socket protocol
+    func nextEvent() throws -> Event? {
+        while count >= 2 {
+            let byte0 = byte(at: 0)
+            let byte1 = byte(at: 1)
+            guard byte0 & 0x70 == 0 else {
+                throw DecodeError.reservedBits
+            }
+            guard let opCode = OpCode(rawValue: byte0 & 0x0F) else {
+                throw DecodeError.unknownOpCode(byte0 & 0x0F)
+            }
+            let fin = byte0 & 0x80 != 0
+            let masked = byte1 & 0x80 != 0
+
+            var headerLen = 2
+            var payloadLen: UInt64
+            switch byte1 & 0x7F {
+            case 126:
+                headerLen += 2
+                guard count >= headerLen else {
+                    return nil
+                }
+                payloadLen = UInt64(byte(at: 2)) << 8 | UInt64(byte(at: 3))
+            case 127:
+                headerLen += 8
+                guard count >= headerLen else {
+                    return nil
+                }
+                payloadLen = (2..<10).reduce(0) { $0 << 8 | UInt64(byte(at: $1)) }
+            case let len:
+                payloadLen = UInt64(len)
+            }
+
+            if opCode.isControl {
+                guard fin && payloadLen <= 125 else {
+                    throw DecodeError.invalidControlFrame
+                }
+            } else {
+                let messageLen = opCode == .continuation ? fragments.count : 0
+                guard payloadLen <= UInt64(maxMessageSize - messageLen) else {
+                    throw DecodeError.messageTooLarge
+                }
+            }
+
+            let maskOffset = headerLen
+            if masked {
+                headerLen += 4
+            }
+            let frameLen = headerLen + Int(payloadLen)
+            guard count >= frameLen else {
+                return nil
+            }
+            let payload = copyPayload(from: headerLen, count: Int(payloadLen), maskOffset: masked ? maskOffset : nil)
+            consume(frameLen)
+
+            switch opCode {
+            case .continuation:
+                guard let messageOpCode = fragmentedOpCode else {
+                    throw DecodeError.unexpectedContinuation
+                }
+                fragments.append(payload)
+                if fin {
+                    let message = fragments
+                    fragmentedOpCode = nil
+                    fragments = Data()
+                    return messageOpCode == .text ? .text(message) : .binary(message)
+                }
+            case .text, .binary:
+                guard fragmentedOpCode == nil else {
+                    throw DecodeError.unterminatedMessage
+                }
+                if fin {
+                    return opCode == .text ? .text(payload) : .binary(payload)
+                }
+                fragmentedOpCode = opCode
+                fragments = payload
+            case .ping:
+                return .ping(payload)
+            case .pong:
+                return .pong(payload)
+            case .connectionClose:
+                return .close(payload)
+            }
+        }
+        return nil
+    }
+
+    /// Encodes a single, final, frame.
+    ///
+    /// - Parameters:
+    ///   - opCode: frame opCode
+    ///   - payload: frame payload
+    ///   - maskingKey: masking key, `nil` to send an unmasked frame. Frames sent by a client must be masked.
+    /// - Returns: encoded frame
+    static func encodeFrame(opCode: OpCode, payload: Data, maskingKey: UInt32?) -> Data {
+        var frame = Data(capacity: 14 + payload.count)
+        frame.append(0x80 | opCode.rawValue)
+        let maskBit: UInt8 = maskingKey != nil ? 0x80 : 0
+        switch payload.count {
+        case 0...125:
+            frame.append(maskBit | UInt8(payload.count))
+        case 126...0xFFFF:
+            frame.append(maskBit | 126)
+            frame.append(contentsOf: [UInt8(payload.count >> 8), UInt8(payload.count & 0xFF)])
+        default:
+            frame.append(maskBit | 127)
+            frame.append(contentsOf: (0..<8).reversed().map { UInt8(UInt64(payload.count) >> ($0 * 8) & 0xFF) })
+        }
+        if let maskingKey = maskingKey {
+            let key = (0..<4).reversed().map { UInt8(maskingKey >> ($0 * 8) & 0xFF) }
+            frame.append(contentsOf: key)
+            frame.append(contentsOf: payload.enumerated().map { $0.element ^ key[$0.offset & 3] })
+        } else {
+            frame.append(payload)
+        }
+        return frame
+    }
+
+    /// Gets a buffered byte.
+    ///
+    /// - Parameter offset: offset of the byte from the first buffered byte
+    /// - Returns: buffered byte
+    private func byte(at offset: Int) -> UInt8 {
+        return ring[(head + offset) & (ring.count - 1)]
+    }
+
+    /// Copies a frame payload out of the ring buffer and unmasks it.
+    ///
+    /// - Parameters:
+    ///   - offset: offset of the payload from the first buffered byte
+    ///   - count: payload length
+    ///   - maskOffset: offset of the masking key from the first buffered byte, `nil` if the payload is not masked
+    /// - Returns: unmasked payload
+    private func copyPayload(from offset: Int, count: Int, maskOffset: Int?) -> Data {
+        guard count > 0 else {
+            return Data()
+        }
+        let mask = ring.count - 1
+        let start = (head + offset) & mask
+        let firstLen = min(count, ring.count - start)
+        var payload = Data(count: count)
+        payload.withUnsafeMutableBytes { (dst: UnsafeMutablePointer<UInt8>) -> Void in
+            ring.withUnsafeBufferPointer { src in
+                dst.assign(from: src.baseAddress! + start, count: firstLen)
+                if firstLen < count {
+                    (dst + firstLen).assign(from: src.baseAddress!, count: count - firstLen)
+                }
+            }
+            if let maskOffset = maskOffset {
+                let key = (0..<4).map { byte(at: maskOffset + $0) }
+                for i in 0..<count {
+                    dst[i] ^= key[i & 3]
+                }
+            }
+        }
+        return payload
+    }
+
+    /// Drops bytes from the head of the ring buffer.
+    ///
+    /// - Parameter len: number of bytes to drop
+    private func consume(_ len: Int) {
+        count -= len
+        if count == 0 {
+            head = 0
+        } else {
+            head = (head + len) & (ring.count - 1)
+        }
+    }
+
+    /// Grows the ring buffer so that it can hold at least a given number of bytes.
+    ///
+    /// - Parameter capacity: required capacity
+    private func reserve(_ capacity: Int) {
+        guard capacity > ring.count else {
+            return
+        }
+        var newRing = [UInt8](repeating: 0, count: WebSocketFrameDecoder.capacity(forAtLeast: capacity))
+        let firstLen = min(count, ring.count - head)
+        newRing.withUnsafeMutableBufferPointer { dst in
+            ring.withUnsafeBufferPointer { src in
+                dst.baseAddress!.assign(from: src.baseAddress! + head, count: firstLen)
+                (dst.baseAddress! + firstLen).assign(from: src.baseAddress!, count: count - firstLen)
+            }
+        }
+        ring = newRing
+        head = 0
+    }
+
+    /// Rounds a capacity up to a power of two.
+    ///
+    /// - Parameter capacity: required capacity
+    /// - Returns: smallest power of two greater than or equal to `capacity`
+    private static func capacity(forAtLeast capacity: Int) -> Int {
+        var result = 1
+        while result < capacity {
+            result <<= 1
+        }
+        return result
+    }
+}
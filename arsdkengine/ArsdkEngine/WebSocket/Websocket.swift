@@ -66,19 +66,24 @@ class WebSocketClient: WebSocket {
 }
 
 /// A basic websocket session implementation
-/// This implementation is not compliant with the spec. Only text messages are supported
-/// Binary, Ping, Pong messages are not implemented.
-/// Messages split in multiple frames are not supported
+/// Text messages, fragmented or not, are forwarded to the delegate; binary messages are dropped. Pings are answered
+/// and close requests are acknowledged. Extensions and sub-protocols are not supported.
 class WebSocketClientSession: WebSocketSession {
 
     /// Socket connection
     private var connection: StreamSocketConnection
     /// Delegate
     private weak var delegate: WebSocketSessionDelegate?
-    /// Input buffer
+    /// Input buffer, until the http response header has been received
     private var inputBuffer = Data()
+    /// Web socket frame decoder, fed once the http response header has been received
+    private let frameDecoder = WebSocketFrameDecoder()
     /// True when websocket protocol is connected
     private var connected = false
+    /// True when a close frame has been sent
+    private var closing = false
+    /// True when a protocol error has been received, received data is then ignored
+    private var failed = false
 
     /// HTTP header separator
     private let httpHeaderSeparator = "\r\n\r\n".data(using: .utf8)!
@@ -140,39 +145,69 @@ class WebSocketClientSession: WebSocketSession {
     ///
     /// - Parameter data: received data
     private func processInputData(_ data: Data) {
+        guard !failed else {
+            return
+        }
+        // Already connected, process data as websocket frames
+        if connected {
+            frameDecoder.append(data)
+            processWebSocketFrames()
+            return
+        }
         // collect received data
         inputBuffer += data
-        // Process http header if not connect and the whole header has been received
-        if !connected, let headerSeparatorPos = inputBuffer.range(of: httpHeaderSeparator),
+        // Process http header if the whole header has been received
+        if let headerSeparatorPos = inputBuffer.range(of: httpHeaderSeparator),
             let response = String(data: inputBuffer.subdata(in: 0..<headerSeparatorPos.lowerBound), encoding: .utf8) {
             connected = processHttpResponse(response)
             if connected {
-                // connected: remove header data from input buffer
-                inputBuffer = inputBuffer.subdata(in: headerSeparatorPos.upperBound..<inputBuffer.count)
+                // connected: hand over remaining data to the frame decoder
+                frameDecoder.append(inputBuffer.subdata(in: headerSeparatorPos.upperBound..<inputBuffer.count))
+                inputBuffer = Data()
+                processWebSocketFrames()
             } else {
                 ULog.w(.wsTag, "WebSocket connection did Fail")
                 delegate?.webSocketSessionConnectionDidFail()
             }
         }
-        // Already connected, process remaining data as websocket frame
-        if connected {
-            processWebSocketFrames()
-        }
     }
 
-    /// Process all web socket frames from the input buffer
+    /// Process all complete web socket frames received by the frame decoder
     private func processWebSocketFrames() {
-        var frame: Frame?
-        repeat {
-            frame = Frame(data: inputBuffer)
-            if let frame = frame {
-                inputBuffer = inputBuffer.subdata(in: frame.len..<inputBuffer.count)
-                // only supports complete text frames
-                if frame.opCode == .text {
-                    delegate?.webSocketSessionDidReceiveMessage(frame.payload)
+        do {
+            while let event = try frameDecoder.nextEvent() {
+                switch event {
+                case .text(let payload):
+                    delegate?.webSocketSessionDidReceiveMessage(payload)
+                case .binary(let payload):
+                    ULog.d(.wsTag, "WebSocket dropping binary message of \(payload.count) bytes")
+                case .ping(let payload):
+                    send(opCode: .pong, payload: payload)
+                case .pong:
+                    break
+                case .close(let payload):
+                    // acknowledge with the received status code, the server then closes the connection
+                    if !closing {
+                        closing = true
+                        send(opCode: .connectionClose, payload: payload.prefix(2))
+                    }
                 }
             }
-        } while frame != nil
+        } catch let error {
+            ULog.w(.wsTag, "WebSocket protocol error: \(error)")
+            failed = true
+            delegate?.webSocketSessionConnectionDidFail()
+        }
+    }
+
+    /// Send a single frame to the server
+    ///
+    /// - Parameters:
+    ///   - opCode: frame opCode
+    ///   - payload: frame payload
+    private func send(opCode: WebSocketFrameDecoder.OpCode, payload: Data) {
+        connection.write(data: WebSocketFrameDecoder.encodeFrame(opCode: opCode, payload: payload,
+                                                                 maskingKey: arc4random()))
     }
 
     /// Process http response
@@ -183,83 +218,6 @@ class WebSocketClientSession: WebSocketSession {
         // only check it's "101 Switching Protocols"
         return response.starts(with: "HTTP/1.1 101")
     }
-
-    /// A Web socket frame
-    private struct Frame {
-        /// Frane opCode
-        enum OpCode: UInt8 {
-            case continuation = 0x00
-            case text = 0x01
-            case binary = 0x02
-            case connectionClose = 0x08
-            case ping = 0x09
-            case pong = 0x0a
-        }
-
-        /// frame length
-        let len: Int
-        /// Frame is complete
-        let fin: Bool
-        /// frame opCode
-        let opCode: OpCode
-        /// Frame masking data
-        let mask: UInt16?
-        /// Frame payload
-        let payload: Data
-
-        /// Create a frame from received data
-        ///
-        /// - Parameter data: received data
-        init?(data: Data) {
-            var fin: Bool?
-            var opCode: OpCode?
-            var len: Int?
-            var mask: UInt16?
-            var headerLen: Int = 2
-            if data.count > 2 {
-                fin = data[0] & 0x80 != 0
-                opCode = OpCode(rawValue: data[0] & 0x0F)
-                let maskBit = data[1] & 0x80 != 0
-                let lenBase = data[1] & 0x7F
-                switch lenBase {
-                case 0...125:
-                    len = Int(lenBase)
-                case 126:
-                    if data.count >= 4 {
-                        len = data.subdata(in: 2..<4).withUnsafeBytes {(buf: UnsafePointer<UInt16>) -> Int in
-                            return Int(buf[0].bigEndian)
-                        }
-                        headerLen += 2
-                    }
-                case 127:
-                    if data.count >= 10 {
-                        len = data.subdata(in: 2..<10).withUnsafeBytes {(buf: UnsafePointer<Int>) -> Int in
-                            return Int(bigEndian: Int(buf[0]))
-                        }
-                        headerLen += 8
-                    }
-                default: break
-                }
-
-                if maskBit {
-                    mask = data.subdata(
-                        in: headerLen..<headerLen+2).withUnsafeBytes {(buf: UnsafePointer<UInt16>) -> UInt16 in
-                            return buf[0]
-                    }
-                    headerLen += 2
-                }
-            }
-            if let fin = fin, let opCode = opCode, let len = len, data.count >= len + headerLen {
-                self.fin = fin
-                self.opCode = opCode
-                self.len = len + headerLen
-                self.mask = mask
-                self.payload = data.subdata(in: headerLen..<len+headerLen)
-            } else {
-                return nil
-            }
-        }
-    }
 }
 
 /// Socket connection delegate
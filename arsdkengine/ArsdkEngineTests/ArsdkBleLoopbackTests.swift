@@ -0,0 +1,77 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+import XCTest
+import SdkCore
+
+/// Measures the BLE transport framing throughput, looping back sent frames to the receive path.
+class ArsdkBleLoopbackTests: XCTestCase {
+
+    /// Number of frames sent by each benchmark iteration
+    private let frameCount = 10000
+
+    func testAllFramesReceived() {
+        guard let loopback = ArsdkBleLoopback() else {
+            XCTFail("loopback transport not started")
+            return
+        }
+        // more frames than sequence numbers, received in order with their type, channel and payload bytes
+        XCTAssertTrue(loopback.run(withFrameCount: 300, payloadSize: 16, timeout: 5))
+        XCTAssertEqual(loopback.receivedFrameCount, 300)
+        XCTAssertEqual(loopback.corruptedFrameCount, 0)
+        // pooled packets are bigger than the frame, check that frames bigger than the pool size go through too
+        XCTAssertTrue(loopback.run(withFrameCount: 10, payloadSize: 1024, timeout: 5))
+        XCTAssertEqual(loopback.receivedFrameCount, 10)
+        XCTAssertEqual(loopback.corruptedFrameCount, 0)
+        loopback.close()
+    }
+
+    func testSmallFramesThroughput() {
+        measureThroughput(payloadSize: 18)
+    }
+
+    func testLargeFramesThroughput() {
+        measureThroughput(payloadSize: 242)
+    }
+
+    /// Measures the time needed to loop back frames
+    ///
+    /// - Parameter payloadSize: size of each frame payload
+    private func measureThroughput(payloadSize: Int) {
+        guard let loopback = ArsdkBleLoopback() else {
+            XCTFail("loopback transport not started")
+            return
+        }
+        measure {
+            XCTAssertTrue(loopback.run(withFrameCount: frameCount, payloadSize: payloadSize, timeout: 10))
+            XCTAssertEqual(loopback.corruptedFrameCount, 0)
+        }
+        loopback.close()
+    }
+}
@@ -0,0 +1,214 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+import XCTest
+@testable import ArsdkEngine
+@testable import GroundSdk
+import SdkCore
+import SdkCoreTesting
+
+/// Checks the batching of the commands received from a device.
+class ArsdkCommandBatchTests: ArsdkEngineTestBase {
+
+    var listener: RecordingDeviceListener!
+
+    /// Events expected when the commands of the trace are received, in order
+    let traceEvents: [RecordingDeviceListener.Event] = [
+        .command(kArsdkFeatureArdrone3PilotingstateUid), .command(kArsdkFeatureArdrone3PilotingstateUid),
+        .command(kArsdkFeatureArdrone3PilotingstateUid), .command(kArsdkFeatureWifiUid),
+        .command(kArsdkFeatureCommonCommonstateUid)]
+
+    override func setUp() {
+        super.setUp()
+        listener = RecordingDeviceListener()
+        mockArsdkCore.commandBatchStats.reset()
+
+        mockArsdkCore.appendCommand(toTrace: CmdEncoder.ardrone3PilotingstateAttitudechangedEncoder(
+            roll: 0.1, pitch: 0.2, yaw: 0.3))
+        mockArsdkCore.appendCommand(toTrace: CmdEncoder.ardrone3PilotingstateSpeedchangedEncoder(
+            speedx: 1.2, speedy: 3.4, speedz: 0.5))
+        mockArsdkCore.appendCommand(toTrace: CmdEncoder.ardrone3PilotingstateAltitudechangedEncoder(altitude: 12.5))
+        mockArsdkCore.appendCommand(toTrace: CmdEncoder.wifiRssiChangedEncoder(rssi: -40))
+        mockArsdkCore.appendCommand(toTrace: CmdEncoder.commonCommonstateBatterystatechangedEncoder(percent: 60))
+    }
+
+    override func tearDown() {
+        mockArsdkCore.clearCommandTrace()
+        mockArsdkCore.commandBatchMaxLatencyMs = ARSDK_CMD_BATCH_DISABLED
+        super.tearDown()
+    }
+
+    func testCommandsAreBatched() {
+        mockArsdkCore.commandBatchMaxLatencyMs = 20
+        let receiver = mockArsdkCore.commandReceiver(forDevice: 1, deviceListener: listener)
+
+        listener.expect(events: 5, testCase: self)
+        mockArsdkCore.receiveCommandTrace(receiver)
+        waitForExpectations(timeout: 1)
+
+        assertThat(listener.events, `is`(traceEvents))
+        let stats = mockArsdkCore.commandBatchStats
+        assertThat(stats.batchCount, `is`(1))
+        assertThat(stats.commandCount, `is`(5))
+        assertThat(stats.maxBatchSize, `is`(5))
+        assertThat(stats.maxQueueDepth, `is`(5))
+        assertThat(stats.batchSizeHistogram, `is`([0, 0, 1, 0, 0, 0]))
+    }
+
+    func testBatchStats() {
+        mockArsdkCore.commandBatchMaxLatencyMs = 0
+        let receiver = mockArsdkCore.commandReceiver(forDevice: 1, deviceListener: listener)
+
+        // commands received while the main queue is busy are delivered in a single batch
+        listener.expect(events: 10, testCase: self)
+        mockArsdkCore.receiveCommandTrace(receiver)
+        mockArsdkCore.receiveCommandTrace(receiver)
+        waitForExpectations(timeout: 1)
+
+        mockArsdkCore.clearCommandTrace()
+        mockArsdkCore.appendCommand(toTrace: CmdEncoder.wifiRssiChangedEncoder(rssi: -42))
+        listener.expect(events: 1, testCase: self)
+        mockArsdkCore.receiveCommandTrace(receiver)
+        waitForExpectations(timeout: 1)
+
+        var stats = mockArsdkCore.commandBatchStats
+        assertThat(stats.batchCount, `is`(2))
+        assertThat(stats.commandCount, `is`(11))
+        assertThat(stats.maxBatchSize, `is`(10))
+        assertThat(stats.maxQueueDepth, `is`(10))
+        assertThat(stats.batchSizeHistogram, `is`([1, 0, 0, 1, 0, 0]))
+
+        mockArsdkCore.commandBatchStats.reset()
+        stats = mockArsdkCore.commandBatchStats
+        assertThat(stats.batchCount, `is`(0))
+        assertThat(stats.commandCount, `is`(0))
+        assertThat(stats.maxBatchSize, `is`(0))
+        assertThat(stats.maxQueueDepth, `is`(0))
+        assertThat(stats.batchSizeHistogram, `is`([0, 0, 0, 0, 0, 0]))
+    }
+
+    func testBatchIsDeliveredBeforeLinkDown() {
+        // latency longer than the wait: only the link loss can deliver the batch in time
+        mockArsdkCore.commandBatchMaxLatencyMs = 5000
+        let receiver = mockArsdkCore.commandReceiver(forDevice: 1, deviceListener: listener)
+
+        listener.expect(events: 6, testCase: self)
+        mockArsdkCore.receiveCommandTrace(receiver)
+        receiver.linkDown()
+        waitForExpectations(timeout: 1)
+
+        assertThat(listener.events, `is`(traceEvents + [.linkDown]))
+        assertThat(mockArsdkCore.commandBatchStats.batchCount, `is`(1))
+        assertThat(mockArsdkCore.commandBatchStats.commandCount, `is`(5))
+    }
+
+    func testBatchIsDeliveredBeforeDisconnection() {
+        mockArsdkCore.commandBatchMaxLatencyMs = 5000
+        let receiver = mockArsdkCore.commandReceiver(forDevice: 1, deviceListener: listener)
+
+        listener.expect(events: 6, testCase: self)
+        mockArsdkCore.receiveCommandTrace(receiver)
+        receiver.disconnect(false)
+        waitForExpectations(timeout: 1)
+
+        assertThat(listener.events, `is`(traceEvents + [.disconnected]))
+        assertThat(mockArsdkCore.commandBatchStats.batchCount, `is`(1))
+        assertThat(mockArsdkCore.commandBatchStats.commandCount, `is`(5))
+    }
+
+    func testUnbatchedCommandsAreNotCounted() {
+        let receiver = mockArsdkCore.commandReceiver(forDevice: 1, deviceListener: listener)
+
+        listener.expect(events: 6, testCase: self)
+        mockArsdkCore.receiveCommandTrace(receiver)
+        receiver.linkDown()
+        waitForExpectations(timeout: 1)
+
+        assertThat(listener.events, `is`(traceEvents + [.linkDown]))
+        assertThat(mockArsdkCore.commandBatchStats.batchCount, `is`(0))
+    }
+}
+
+/// Device listener recording the commands and the link events it receives.
+class RecordingDeviceListener: NSObject, ArsdkCoreDeviceListener {
+
+    /// Event received by the listener
+    enum Event: Equatable {
+        /// command received, with its feature id
+        case command(Int16)
+        /// link lost
+        case linkDown
+        /// device disconnected
+        case disconnected
+    }
+
+    /// Received events, in order
+    private(set) var events: [Event] = []
+
+    /// Expectation fulfilled when the expected number of events has been received
+    private var expectation: XCTestExpectation?
+
+    /// Expects a number of new events.
+    ///
+    /// - Parameters:
+    ///   - count: number of new events to expect
+    ///   - testCase: test case creating the expectation
+    func expect(events count: Int, testCase: XCTestCase) {
+        events = []
+        expectation = testCase.expectation(description: "\(count) events")
+        expectation!.expectedFulfillmentCount = count
+        expectation!.assertForOverFulfill = true
+    }
+
+    private func record(_ event: Event) {
+        events.append(event)
+        expectation?.fulfill()
+    }
+
+    func onConnecting() {
+    }
+
+    func onConnected(api: ArsdkApiCapabilities) {
+    }
+
+    func onDisconnected(_ removing: Bool) {
+        record(.disconnected)
+    }
+
+    func onConnectionCancel(_ reason: ArsdkConnCancelReason, removing: Bool) {
+    }
+
+    func onLinkDown() {
+        record(.linkDown)
+    }
+
+    func onCommandReceived(_ command: OpaquePointer) {
+        record(.command(ArsdkCommand.getFeatureId(command)))
+    }
+}
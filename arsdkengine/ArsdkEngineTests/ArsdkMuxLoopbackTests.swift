@@ -0,0 +1,103 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+import XCTest
+@testable import ArsdkEngine
+@testable import GroundSdk
+import SdkCore
+import SdkCoreTesting
+
+/// Checks the mux stream handling over bound stream pairs: in place and partial writes, batched reads and read
+/// buffers reuse.
+class ArsdkMuxLoopbackTests: ArsdkEngineTestBase {
+
+    /// Size of the stream pairs buffers, much smaller than the sent data so that most writes are partial
+    private let streamBufferSize = 1024
+
+    private var loopback: ArsdkMuxLoopback!
+
+    override func setUp() {
+        super.setUp()
+        mockArsdkCore.startLoops()
+        let expectation = self.expectation(description: "muxes started")
+        var started = false
+        loopback = ArsdkMuxLoopback(arsdkCore: mockArsdkCore, streamBufferSize: streamBufferSize) {
+            started = $0
+            expectation.fulfill()
+        }
+        waitForExpectations(timeout: 5)
+        XCTAssertTrue(started)
+    }
+
+    override func tearDown() {
+        loopback.close()
+        mockArsdkCore.stopLoops()
+        super.tearDown()
+    }
+
+    func testPartialWrites() {
+        let sent = pattern(size: 256 * 1024)
+        let received = loopback.send(sent, chunkSize: 16 * 1024, holdDecoding: false, timeout: 10)
+        // partial writes resume at the right offset: the data is received whole and in order
+        assertThat(received, presentAnd(`is`(sent)))
+        let senderStats = loopback.senderStats
+        assertThat(senderStats.txBytes, greaterThan(UInt64(sent.count)))
+        assertThat(loopback.receiverStats.rxBytes, `is`(senderStats.txBytes))
+    }
+
+    func testBatchedReads() {
+        let sent = pattern(size: 64 * 1024)
+        let received = loopback.send(sent, chunkSize: 4 * 1024, holdDecoding: true, timeout: 10)
+        assertThat(received, presentAnd(`is`(sent)))
+        // reads done while the pomp loop is busy are decoded together
+        let stats = loopback.receiverStats
+        assertThat(stats.maxRxBatchSize, greaterThan(1))
+        assertThat(stats.rxBatchCount, lessThan(stats.rxBufferCount))
+    }
+
+    func testReadBuffersReused() {
+        let sent = pattern(size: 256)
+        for _ in 0..<20 {
+            let received = loopback.send(sent, chunkSize: sent.count, holdDecoding: false, timeout: 5)
+            assertThat(received, presentAnd(`is`(sent)))
+        }
+        // buffers are decoded before the next send, so the pool always has a free buffer
+        let stats = loopback.receiverStats
+        assertThat(stats.rxBufferCount, greaterThanOrEqualTo(20))
+        assertThat(stats.rxPoolMissCount, `is`(0))
+    }
+
+    /// Builds data whose bytes depend on their offset, so that misplaced bytes are detected
+    ///
+    /// - Parameter size: data size
+    /// - Returns: patterned data
+    private func pattern(size: Int) -> Data {
+        return Data((0..<size).map { UInt8(truncatingIfNeeded: $0 * 7 + $0 / 256) })
+    }
+}
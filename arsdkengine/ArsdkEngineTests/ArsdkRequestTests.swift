@@ -0,0 +1,123 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+import XCTest
+import SdkCore
+import SdkCoreTesting
+
+/// Checks that progress of arsdk requests is coalesced, without losing start, end and terminal states.
+class ArsdkRequestTests: XCTestCase {
+
+    private var arsdkCore: MockArsdkCore!
+    private let listener = CoreListener()
+
+    override func setUp() {
+        super.setUp()
+        arsdkCore = MockArsdkCore(backendControllers: [], listener: listener,
+                                  controllerDescriptor: "desc", controllerVersion: "version")
+    }
+
+    func testProgressIsCoalesced() {
+        let intervalMs = 100
+        arsdkCore.progressNotificationIntervalMs = intervalMs
+        let request = ProgressRequest(arsdkCore: arsdkCore)
+        let completed = expectation(description: "completed")
+        var completedAfter: [Float] = []
+        var postDuration: TimeInterval = 0
+        // post from another thread, as the pomp loop does, every 10ms for about 1s
+        DispatchQueue.global().async {
+            let start = Date()
+            request.postProgress(0)
+            for progress in 1..<100 {
+                request.postProgress(Float(progress))
+                Thread.sleep(forTimeInterval: 0.01)
+            }
+            postDuration = Date().timeIntervalSince(start)
+            request.postProgress(100)
+            request.postEvent {
+                completedAfter = request.progresses
+                completed.fulfill()
+            }
+        }
+        waitForExpectations(timeout: 5)
+
+        XCTAssertEqual(request.progresses.first, 0)
+        XCTAssertEqual(request.progresses.last, 100)
+        XCTAssertEqual(request.progresses, request.progresses.sorted())
+        // intermediate progress is delivered about once per interval: one delivery right away, then one per elapsed
+        // interval, plus the ones flushed by the start event and by the completion
+        let intervals = Int(postDuration * 1000) / intervalMs
+        let intermediateCount = request.progresses.filter { $0 > 0 && $0 < 100 }.count
+        XCTAssertLessThanOrEqual(intermediateCount, intervals + 3)
+        // delivery timers may run late on a loaded main thread, but progress must not stall
+        XCTAssertGreaterThanOrEqual(intermediateCount, intervals / 2)
+        // completion is delivered after all progress
+        XCTAssertEqual(completedAfter, request.progresses)
+    }
+
+    func testEventsAreNotCoalesced() {
+        let request = ProgressRequest(arsdkCore: arsdkCore)
+        let completed = expectation(description: "completed")
+        var events: [Int] = []
+        DispatchQueue.global().async {
+            for event in 0..<100 {
+                request.postEvent {
+                    events.append(event)
+                }
+            }
+            request.postEvent {
+                completed.fulfill()
+            }
+        }
+        waitForExpectations(timeout: 5)
+        XCTAssertEqual(events, Array(0..<100))
+    }
+}
+
+/// Request recording delivered progress
+private class ProgressRequest: ArsdkRequest {
+
+    /// Delivered progress values
+    var progresses: [Float] = []
+
+    override func deliverProgress(_ progress: Float) {
+        progresses.append(progress)
+    }
+}
+
+/// Arsdk core listener ignoring devices
+private class CoreListener: NSObject, ArsdkCoreListener {
+
+    func onDeviceAdded(_ uid: String, type: Int, backendType: ArsdkBackendType, name: String,
+                       api: ArsdkApiCapabilities, handle: Int16) {
+    }
+
+    func onDeviceRemoved(_ uid: String, type: Int, backendType: ArsdkBackendType, handle: Int16) {
+    }
+}
@@ -0,0 +1,100 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+
+import XCTest
+@testable import ArsdkEngine
+@testable import GroundSdk
+
+/// Columnar black box samples tests
+class BlackBoxSamplesTests: XCTestCase {
+
+    func testFlightSamples() {
+        var samples = BlackBoxFlightSamples(capacity: 3)
+        assertThat(samples.memoryUsage, `is`(3 * 64))
+
+        var flightData = BlackBoxFlightData()
+        for index in 1...5 {
+            flightData.altitude = Double(index)
+            flightData.heightAboveGround = Float(index) / 2
+            flightData.speed = BlackBoxSpeedData(speedX: Float(index) / 4, speedY: 0, speedZ: -1)
+            flightData.attitude = BlackBoxAttitudeData(roll: 0.5, pitch: -0.25, yaw: Float(index))
+            flightData.pcmd = BlackBoxDronePilotingCommandData(roll: index, pitch: -index, yaw: 0, gaz: 100, flag: 1)
+            samples.append(flightData.useIfChanged()!)
+        }
+        assertThat(samples.count, `is`(3))
+
+        // oldest samples have been dropped, streamed json is the same as the encoded one
+        let streamed = streamedJson(samples.write) as? NSArray
+        assertThat(streamed?.value(forKey: "product_alt") as? [Double], presentAnd(`is`([3.0, 4.0, 5.0])))
+        XCTAssertEqual(streamed, encodedJson(samples) as? NSArray)
+    }
+
+    func testEnvironmentSamples() {
+        var samples = BlackBoxEnvironmentSamples(capacity: 2)
+        assertThat(samples.memoryUsage, `is`(2 * 84))
+
+        var environmentData = BlackBoxEnvironmentData()
+        for index in 1...3 {
+            environmentData.rssi = -40 - index
+            environmentData.batteryVoltage = 12000 - index
+            environmentData.droneLocation = BlackBoxLocationData(latitude: 48.5, longitude: 2.25, altitude: 10)
+            environmentData.rcPcmd = BlackBoxRcPilotingCommandData(roll: index, pitch: 0, yaw: 0, gaz: 0, source: 1)
+            samples.append(environmentData.useIfChanged()!)
+        }
+        assertThat(samples.count, `is`(2))
+
+        let streamed = streamedJson(samples.write) as? NSArray
+        assertThat(streamed?.value(forKey: "wifi_rssi") as? [Int], presentAnd(`is`([-42, -43])))
+        XCTAssertEqual(streamed, encodedJson(samples) as? NSArray)
+    }
+
+    /// Streams samples as json.
+    ///
+    /// - Parameter write: samples write function
+    /// - Returns: parsed streamed json
+    private func streamedJson(_ write: (JsonStreamWriter, String) throws -> Void) -> Any? {
+        var json = Data()
+        let writer = JsonStreamWriter(bufferSize: 64) { json.append($0) }
+        XCTAssertNoThrow(try writer.beginObject())
+        XCTAssertNoThrow(try write(writer, "samples"))
+        XCTAssertNoThrow(try writer.endObject())
+        XCTAssertNoThrow(try writer.flush())
+        let object = (try? JSONSerialization.jsonObject(with: json)) as? [String: Any]
+        return object?["samples"]
+    }
+
+    /// Encodes samples as json.
+    ///
+    /// - Parameter samples: samples to encode
+    /// - Returns: parsed encoded json
+    private func encodedJson<T: Encodable>(_ samples: T) -> Any? {
+        return (try? JSONEncoder().encode(samples)).flatMap { try? JSONSerialization.jsonObject(with: $0) }
+    }
+}
@@ -0,0 +1,86 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+
+import XCTest
+@testable import ArsdkEngine
+@testable import GroundSdk
+import SdkCoreTesting
+
+/// Replays a canned telemetry trace to a connected drone and reports the receive path cost.
+class CommandDispatchBenchmarkTests: ArsdkEngineTestBase {
+
+    var drone: DroneCore!
+
+    override func setUp() {
+        super.setUp()
+        mockArsdkCore.addDevice("123", type: Drone.Model.anafi4k.internalId, backendType: .net, name: "Drone1",
+                                handle: 1)
+        drone = droneStore.getDevice(uid: "123")!
+        connect(drone: drone, handle: 1)
+
+        // one telemetry period of a flying drone
+        mockArsdkCore.appendCommand(toTrace: CmdEncoder.ardrone3PilotingstateAttitudechangedEncoder(
+            roll: 0.1, pitch: 0.2, yaw: 0.3))
+        mockArsdkCore.appendCommand(toTrace: CmdEncoder.ardrone3PilotingstateSpeedchangedEncoder(
+            speedx: 1.2, speedy: 3.4, speedz: 0.5))
+        mockArsdkCore.appendCommand(toTrace: CmdEncoder.ardrone3PilotingstateAltitudechangedEncoder(altitude: 12.5))
+        mockArsdkCore.appendCommand(toTrace: CmdEncoder.ardrone3PilotingstatePositionchangedEncoder(
+            latitude: 48.8, longitude: 2.3, altitude: 50))
+        mockArsdkCore.appendCommand(toTrace: CmdEncoder.ardrone3PilotingstateGpslocationchangedEncoder(
+            latitude: 48.8, longitude: 2.3, altitude: 50, latitudeAccuracy: 1, longitudeAccuracy: 1,
+            altitudeAccuracy: 2))
+        mockArsdkCore.appendCommand(toTrace: CmdEncoder.wifiRssiChangedEncoder(rssi: -40))
+    }
+
+    override func tearDown() {
+        mockArsdkCore.clearCommandTrace()
+        super.tearDown()
+    }
+
+    func testReceivedTelemetryAllocations() {
+        // warm up caches, dispatch routes and the received commands free-list
+        _ = mockArsdkCore.replayCommandTrace(1, repeat: 10)
+        _ = mockArsdkCore.deliverCommandTrace(1, repeat: 10)
+
+        let listenerAllocations = mockArsdkCore.deliverCommandTrace(1, repeat: 1000)
+        let allocationsPerCommand = mockArsdkCore.replayCommandTrace(1, repeat: 1000)
+
+        // the receive path itself must not allocate per command once warmed up
+        assertThat(allocationsPerCommand - listenerAllocations, lessThan(0.5))
+    }
+
+    func testReceivedTelemetryDispatchTime() {
+        _ = mockArsdkCore.replayCommandTrace(1, repeat: 10)
+
+        measure {
+            _ = mockArsdkCore.replayCommandTrace(1, repeat: 1000)
+        }
+    }
+}
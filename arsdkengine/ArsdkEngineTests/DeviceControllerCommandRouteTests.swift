@@ -0,0 +1,129 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+import XCTest
+@testable import ArsdkEngine
+@testable import GroundSdk
+import SdkCore
+import SdkCoreTesting
+
+/// Checks the routing of received commands to the component controllers handling their feature.
+class DeviceControllerCommandRouteTests: ArsdkEngineTestBase {
+
+    var drone: DroneCore!
+    var deviceController: DeviceController!
+
+    override func setUp() {
+        super.setUp()
+        mockArsdkCore.addDevice("123", type: Drone.Model.anafi4k.internalId, backendType: .net, name: "Drone1",
+                                handle: 1)
+        drone = droneStore.getDevice(uid: "123")!
+        deviceController = arsdkEngine.deviceControllers["123"]!
+        connect(drone: drone, handle: 1)
+    }
+
+    func testCommandsRoutedByFeature() {
+        let pilotingStateComponent = RecordingComponentController(
+            deviceController: deviceController, handledFeatureIds: [kArsdkFeatureArdrone3PilotingstateUid])
+        let networkComponent = RecordingComponentController(
+            deviceController: deviceController,
+            handledFeatureIds: [kArsdkFeatureWifiUid, kArsdkFeatureCommonCommonstateUid])
+        let undeclaredComponent = RecordingComponentController(
+            deviceController: deviceController, handledFeatureIds: nil)
+        deviceController.componentControllers += [pilotingStateComponent, networkComponent, undeclaredComponent]
+
+        mockArsdkCore.onCommandReceived(1, encoder: CmdEncoder.ardrone3PilotingstateAltitudechangedEncoder(
+            altitude: 12.5))
+        mockArsdkCore.onCommandReceived(1, encoder: CmdEncoder.wifiRssiChangedEncoder(rssi: -40))
+        mockArsdkCore.onCommandReceived(1, encoder: CmdEncoder.commonCommonstateBatterystatechangedEncoder(
+            percent: 60))
+        mockArsdkCore.onCommandReceived(1, encoder: CmdEncoder.ardrone3PilotingstateAltitudechangedEncoder(
+            altitude: 13))
+
+        // components only receive the commands of the features they declare
+        assertThat(pilotingStateComponent.receivedFeatureIds,
+                   `is`([kArsdkFeatureArdrone3PilotingstateUid, kArsdkFeatureArdrone3PilotingstateUid]))
+        assertThat(networkComponent.receivedFeatureIds,
+                   `is`([kArsdkFeatureWifiUid, kArsdkFeatureCommonCommonstateUid]))
+        // components without declared features receive every command
+        assertThat(undeclaredComponent.receivedFeatureIds,
+                   `is`([kArsdkFeatureArdrone3PilotingstateUid, kArsdkFeatureWifiUid,
+                         kArsdkFeatureCommonCommonstateUid, kArsdkFeatureArdrone3PilotingstateUid]))
+    }
+
+    func testRoutesFollowComponentChanges() {
+        let firstComponent = RecordingComponentController(
+            deviceController: deviceController, handledFeatureIds: [kArsdkFeatureWifiUid])
+        deviceController.componentControllers.append(firstComponent)
+        mockArsdkCore.onCommandReceived(1, encoder: CmdEncoder.wifiRssiChangedEncoder(rssi: -40))
+        assertThat(firstComponent.receivedFeatureIds, `is`([kArsdkFeatureWifiUid]))
+
+        // a component attached after the route of the feature has been built receives the next commands
+        let secondComponent = RecordingComponentController(
+            deviceController: deviceController, handledFeatureIds: [kArsdkFeatureWifiUid])
+        deviceController.componentControllers.append(secondComponent)
+        mockArsdkCore.onCommandReceived(1, encoder: CmdEncoder.wifiRssiChangedEncoder(rssi: -50))
+        assertThat(firstComponent.receivedFeatureIds, `is`([kArsdkFeatureWifiUid, kArsdkFeatureWifiUid]))
+        assertThat(secondComponent.receivedFeatureIds, `is`([kArsdkFeatureWifiUid]))
+
+        // a detached component does not receive commands anymore
+        deviceController.componentControllers.removeAll { $0 === firstComponent }
+        mockArsdkCore.onCommandReceived(1, encoder: CmdEncoder.wifiRssiChangedEncoder(rssi: -60))
+        assertThat(firstComponent.receivedFeatureIds.count, `is`(2))
+        assertThat(secondComponent.receivedFeatureIds.count, `is`(2))
+    }
+}
+
+/// Component controller recording the features of the commands it receives.
+private class RecordingComponentController: DeviceComponentController {
+
+    /// Features declared as handled, `nil` to receive all commands
+    private let featureIds: Set<Int16>?
+
+    /// Feature ids of the received commands, in reception order
+    private(set) var receivedFeatureIds: [Int16] = []
+
+    /// Constructor
+    ///
+    /// - Parameters:
+    ///   - deviceController: device controller owning this component controller
+    ///   - handledFeatureIds: features declared as handled, `nil` to receive all commands
+    init(deviceController: DeviceController, handledFeatureIds: Set<Int16>?) {
+        featureIds = handledFeatureIds
+        super.init(deviceController: deviceController)
+    }
+
+    override var handledFeatureIds: Set<Int16>? {
+        return featureIds
+    }
+
+    override func didReceiveCommand(_ command: OpaquePointer) {
+        receivedFeatureIds.append(ArsdkCommand.getFeatureId(command))
+    }
+}
@@ -0,0 +1,178 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+
+
+import XCTest
+@testable import ArsdkEngine
+@testable import GroundSdk
+
+/// Checks the incremental media list decoder and compares its cost with a whole buffer decoding, on a synthetic
+/// list of 10k medias.
+class MediaListStreamDecoderTests: XCTestCase {
+
+    /// Number of medias of the synthetic media list
+    private let mediaCount = 10000
+
+    /// Size of the data chunks handed over to the streaming decoder, as received from the http session
+    private let receiveSize = 16 * 1024
+
+    /// Synthetic media list json
+    private var mediaList: Data!
+
+    override func setUp() {
+        super.setUp()
+        mediaList = MediaListStreamDecoderTests.makeMediaList(count: mediaCount)
+    }
+
+    func testDecodeInChunks() {
+        let list = MediaListStreamDecoderTests.makeMediaList(count: 50)
+        let expectedUids = (0..<50).map { "media\($0)" }
+
+        for chunkSize in [1, 7, 512, list.count] {
+            let decoder = MediaRestApi.MediaListStreamDecoder()
+            XCTAssertNoThrow(try feed(decoder, with: list, chunkSize: chunkSize))
+            XCTAssertNoThrow(try decoder.finish())
+            XCTAssertEqual(decoder.medias.map { $0.uid }, expectedUids)
+            XCTAssertEqual(decoder.medias.first?.runUid, "r\"}{\\")
+            XCTAssertEqual(decoder.medias.first?.resources.count, 2)
+        }
+    }
+
+    func testDecodeEmptyList() {
+        let decoder = MediaRestApi.MediaListStreamDecoder()
+        XCTAssertNoThrow(try decoder.process(" [\n] ".data(using: .utf8)!))
+        XCTAssertNoThrow(try decoder.finish())
+        XCTAssertTrue(decoder.medias.isEmpty)
+    }
+
+    func testDecodeErrors() {
+        // not an array
+        var decoder = MediaRestApi.MediaListStreamDecoder()
+        XCTAssertThrowsError(try decoder.process("{}".data(using: .utf8)!))
+
+        // not an array of objects
+        decoder = MediaRestApi.MediaListStreamDecoder()
+        XCTAssertThrowsError(try decoder.process("[1]".data(using: .utf8)!))
+
+        // invalid media
+        decoder = MediaRestApi.MediaListStreamDecoder()
+        XCTAssertThrowsError(try decoder.process("[{\"media_id\": \"media1\"}]".data(using: .utf8)!))
+
+        // incomplete list
+        decoder = MediaRestApi.MediaListStreamDecoder()
+        let list = MediaListStreamDecoderTests.makeMediaList(count: 2)
+        XCTAssertNoThrow(try decoder.process(list.subdata(in: 0..<list.count - 10)))
+        XCTAssertEqual(decoder.medias.count, 1)
+        XCTAssertThrowsError(try decoder.finish())
+    }
+
+    func testWholeBufferDecodeTime() {
+        measure {
+            let decoder = JSONDecoder()
+            decoder.dateDecodingStrategy = .formatted(.iso8601Base)
+            let httpMedias = try? decoder.decode([MediaRestApi.Media].self, from: mediaList)
+            let medias = httpMedias?.compactMap { MediaItemCore.from(httpMedia: $0) }
+            XCTAssertEqual(medias?.count, mediaCount)
+        }
+    }
+
+    func testStreamingDecodeTime() {
+        measure {
+            let decoder = MediaRestApi.MediaListStreamDecoder()
+            XCTAssertNoThrow(try feed(decoder, with: mediaList, chunkSize: receiveSize))
+            XCTAssertNoThrow(try decoder.finish())
+            XCTAssertEqual(decoder.medias.count, mediaCount)
+        }
+    }
+
+    func testStreamingTimeToFirstChunk() {
+        measure {
+            let decoder = MediaRestApi.MediaListStreamDecoder()
+            var offset = 0
+            while decoder.medias.count < MediaRestApi.mediaListChunkSize && offset < mediaList.count {
+                let end = min(offset + receiveSize, mediaList.count)
+                XCTAssertNoThrow(try decoder.process(mediaList.subdata(in: offset..<end)))
+                offset = end
+            }
+            XCTAssertGreaterThanOrEqual(decoder.medias.count, MediaRestApi.mediaListChunkSize)
+        }
+    }
+
+    /// Hands data over to a decoder, in chunks.
+    ///
+    /// - Parameters:
+    ///   - decoder: decoder to feed
+    ///   - data: data to hand over
+    ///   - chunkSize: size of each chunk
+    private func feed(_ decoder: MediaRestApi.MediaListStreamDecoder, with data: Data, chunkSize: Int) throws {
+        var offset = 0
+        while offset < data.count {
+            let end = min(offset + chunkSize, data.count)
+            try decoder.process(data.subdata(in: offset..<end))
+            offset = end
+        }
+    }
+
+    /// Builds a media list json, as returned by the REST api.
+    ///
+    /// Each media has a video and a photo resource. Run ids contain escaped quotes and braces.
+    ///
+    /// - Parameter count: number of medias
+    /// - Returns: media list json
+    private static func makeMediaList(count: Int) -> Data {
+        let medias = (0..<count).map { index in
+            """
+            {
+                "datetime": "20180616T141516+0100",
+                "gps": {"altitude": 10.4, "latitude": 20.0, "longitude": 30.0},
+                "size": 300,
+                "media_id": "media\(index)",
+                "thumbnail": "/data/thumb/\(index).JPG",
+                "resources": [
+                    {
+                        "format": "MP4", "height": 720, "width": 1024, "media_id": "media\(index)",
+                        "datetime": "20180616T141516+0100", "resource_id": "\(index).MP4", "size": 4294967296,
+                        "duration": 12000, "type": "VIDEO", "url": "/data/media/\(index).MP4",
+                        "thumbnail": "/data/thumb/\(index).JPG"
+                    },
+                    {
+                        "format": "JPG", "height": 720, "width": 1024, "media_id": "media\(index)",
+                        "datetime": "20180616T141516+0100", "resource_id": "\(index).JPG", "size": 1073741824,
+                        "type": "PHOTO", "url": "/data/media/\(index).JPG", "thumbnail": "/data/thumb/\(index).JPG"
+                    }
+                ],
+                "run_id": "r\\"}{\\\\",
+                "type": "VIDEO"
+            }
+            """
+        }
+        return "[\n\(medias.joined(separator: ",\n"))\n]".data(using: .utf8)!
+    }
+}
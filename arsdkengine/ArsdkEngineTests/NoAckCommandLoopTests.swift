@@ -0,0 +1,179 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+import XCTest
+@testable import ArsdkEngine
+@testable import GroundSdk
+import SdkCoreTesting
+
+/// Checks the tick scheduling and the timing statistics of the NoAck command loop.
+class NoAckCommandLoopTests: ArsdkEngineTestBase {
+
+    /// Loop period, in milliseconds
+    private let periodMs: Int32 = 10
+
+    override func setUp() {
+        super.setUp()
+        mockArsdkCore.startLoops()
+    }
+
+    override func tearDown() {
+        mockArsdkCore.stopLoops()
+        super.tearDown()
+    }
+
+    func testTimerDeadlinesDoNotDrift() {
+        let stats = run(dedicatedThread: false, duration: 1.0)
+        assertDeadlinesKept(stats, duration: 1.0)
+    }
+
+    func testThreadDeadlinesDoNotDrift() {
+        let stats = run(dedicatedThread: true, duration: 1.0)
+        assertDeadlinesKept(stats, duration: 1.0)
+    }
+
+    func testTimerMissedDeadlines() {
+        let loop = start(dedicatedThread: false)
+        Thread.sleep(forTimeInterval: 0.1)
+        // block the arsdk loop for more than 5 periods: the timer fires late, then skips the elapsed deadlines
+        mockArsdkCore.dispatch_sync {
+            usleep(55000)
+        }
+        Thread.sleep(forTimeInterval: 0.1)
+        stop(loop)
+
+        let stats = loop.stats
+        assertThat(stats.missedTicks, greaterThanOrEqualTo(4))
+        assertThat(stats.lateTicks, greaterThanOrEqualTo(1))
+        assertThat(stats.maxLatenessUs, greaterThanOrEqualTo(40000))
+        assertThat(histogramCount(stats), `is`(stats.ticks))
+    }
+
+    func testThreadMissedSends() {
+        let loop = start(dedicatedThread: true)
+        Thread.sleep(forTimeInterval: 0.1)
+        // block the arsdk loop: the thread keeps ticking on time, but batches it encoded are replaced by newer ones
+        // before they can be sent
+        mockArsdkCore.dispatch_sync {
+            usleep(55000)
+        }
+        Thread.sleep(forTimeInterval: 0.1)
+        stop(loop)
+
+        let stats = loop.stats
+        assertThat(stats.missedTicks, greaterThanOrEqualTo(4))
+        assertThat(stats.maxSendLatencyUs, greaterThanOrEqualTo(40000))
+        assertThat(histogramCount(stats), `is`(stats.ticks))
+    }
+
+    func testThreadStopDoesNotBlockArsdkLoop() {
+        let loop = NoAckCommandLoop(arsdkctrl: mockArsdkCore.ctrl, deviceHandle: 1, periodMs: 200,
+                                    dedicatedThread: true)
+        setEncoders(loop, count: 1)
+        Thread.sleep(forTimeInterval: 0.05)
+
+        // stopping must not wait for the thread, which is sleeping until its next deadline
+        let stopStart = Date()
+        setEncoders(loop, count: 0)
+        assertThat(Date().timeIntervalSince(stopStart), lessThan(0.1))
+
+        // restart while the previous thread has not exited yet
+        setEncoders(loop, count: 1)
+        Thread.sleep(forTimeInterval: 0.5)
+        stop(loop)
+        assertThat(loop.stats.ticks, greaterThanOrEqualTo(1))
+    }
+
+    /// Starts a loop sending one (empty) NoAck command.
+    ///
+    /// - Parameter dedicatedThread: `true` to encode commands on a dedicated thread
+    /// - Returns: the started loop
+    private func start(dedicatedThread: Bool) -> NoAckCommandLoop {
+        let loop = NoAckCommandLoop(arsdkctrl: mockArsdkCore.ctrl, deviceHandle: 1, periodMs: periodMs,
+                                    dedicatedThread: dedicatedThread)
+        setEncoders(loop, count: 1)
+        return loop
+    }
+
+    /// Stops a loop.
+    ///
+    /// - Parameter loop: loop to stop
+    private func stop(_ loop: NoAckCommandLoop) {
+        setEncoders(loop, count: 0)
+    }
+
+    /// Runs a loop for a given duration.
+    ///
+    /// - Parameters:
+    ///   - dedicatedThread: `true` to encode commands on a dedicated thread
+    ///   - duration: run duration, in seconds
+    /// - Returns: loop statistics
+    private func run(dedicatedThread: Bool, duration: TimeInterval) -> ArsdkNoAckLoopStats {
+        let loop = start(dedicatedThread: dedicatedThread)
+        Thread.sleep(forTimeInterval: duration)
+        stop(loop)
+        return loop.stats
+    }
+
+    /// Sets the encoder list of a loop from the arsdk loop, starting or stopping it.
+    ///
+    /// - Parameters:
+    ///   - loop: loop
+    ///   - count: number of encoders, 0 to stop the loop
+    private func setEncoders(_ loop: NoAckCommandLoop, count: Int) {
+        let encoders = (0..<count).map { _ in NoAckStorage(cmdEncoder: { nil }, type: .piloting) }
+        mockArsdkCore.dispatch_sync {
+            loop.setEncoderList(encoders)
+        }
+    }
+
+    /// Checks that each period elapsed during a run gave either a tick or a missed tick.
+    ///
+    /// A loop re-arming itself relatively to the time it woke up would accumulate its lateness and fall short.
+    ///
+    /// - Parameters:
+    ///   - stats: loop statistics
+    ///   - duration: run duration, in seconds
+    private func assertDeadlinesKept(_ stats: ArsdkNoAckLoopStats, duration: TimeInterval) {
+        let expected = UInt64(duration * 1000) / UInt64(periodMs)
+        assertThat(stats.ticks + stats.missedTicks, greaterThanOrEqualTo(expected - expected / 20))
+        assertThat(stats.ticks + stats.missedTicks, lessThanOrEqualTo(expected + expected / 20))
+        assertThat(stats.lateTicks, lessThanOrEqualTo(stats.ticks))
+        assertThat(stats.maxLatenessUs * stats.ticks, greaterThanOrEqualTo(stats.totalLatenessUs))
+        assertThat(histogramCount(stats), `is`(stats.ticks))
+    }
+
+    /// Sums the lateness histogram buckets.
+    ///
+    /// - Parameter stats: loop statistics
+    /// - Returns: number of ticks in the histogram
+    private func histogramCount(_ stats: ArsdkNoAckLoopStats) -> UInt64 {
+        return Mirror(reflecting: stats.histogram).children.compactMap { $0.value as? UInt64 }.reduce(0, +)
+    }
+}
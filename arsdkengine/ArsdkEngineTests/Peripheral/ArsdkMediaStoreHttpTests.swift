@@ -455,6 +455,67 @@ class ArsdkMediaStoreHttpTests: ArsdkEngineTestBase {
         assertThat(downloadRef.value!.currentMedia, nilValue())
     }
 
+    func testConcurrentDownload() {
+        GroundSdkConfig.sharedInstance.mediaDownloadConcurrency = 2
+        defer {
+            GroundSdkConfig.sharedInstance.mediaDownloadConcurrency = 1
+        }
+        connect(drone: drone, handle: 1)
+
+        // populate list
+        let mediaListRef: Ref<[MediaItem]>! = mediaStore!.newList { _ in }
+        let browseTask = httpSession.popLastTask() as? MockDataTask
+        browseTask?.mockCompletionSuccess(data: browseResponse.data(using: .utf8))
+
+        let resources = MediaResourceListFactory.listWith(allOf: mediaListRef.value!)
+        let downloadRef = mediaStore!.newDownloader(mediaResources: resources, destination: .tmp) { downloader in
+            if downloader?.status == .fileDownloaded {
+                self.changeDownloadedCnt += 1
+            }
+            self.changeCnt += 1
+        }
+        // expect download of the 2 resources of the first media
+        assertThat(changeCnt, `is`(2))
+        let secondTask = httpSession.popLastTask() as? MockDownloadTask
+        let firstTask = httpSession.popLastTask() as? MockDownloadTask
+        assertThat(firstTask?.request.url?.absoluteString, presentAnd(hasSuffix("100000010001.MP4")))
+        assertThat(secondTask?.request.url?.absoluteString, presentAnd(hasSuffix("100000010001.JPG")))
+        assertThat(downloadRef.value, presentAnd(allOf(
+            has(totalResourceCount: 3), has(currentResourceCount: 2), has(totalProgress: 0),
+            has(status: .running))))
+
+        // progress on both resources
+        firstTask?.mock(progress: 50)
+        secondTask?.mock(progress: 100)
+        assertThat(changeCnt, `is`(4))
+        assertThat(downloadRef.value, presentAnd(allOf(
+            has(currentFileProgress: 1.0),
+            has(totalProgress: (Float(4294967296) * 0.5 + Float(1073741824)) /
+                Float(4294967296 + 1073741824 + 858993472)),
+            has(status: .running))))
+
+        // 2nd resource completed, last resource download should start while the first one is still running
+        secondTask?.mockCompletionSuccess(localFileUrl: URL(string: "file://tmp/file2"))
+        assertThat(changeCnt, `is`(6))
+        assertThat(changeDownloadedCnt, `is`(1))
+        let thirdTask = httpSession.popLastTask() as? MockDownloadTask
+        assertThat(thirdTask?.request.url?.absoluteString, presentAnd(hasSuffix("100000190025.DNG")))
+        assertThat(downloadRef.value, presentAnd(allOf(
+            has(currentResourceCount: 3), has(currentFileProgress: 0.0), has(status: .running))))
+        assertThat(downloadRef.value!.currentMedia, presentAnd(has(uid: "media2")))
+
+        thirdTask?.mockCompletionSuccess(localFileUrl: URL(string: "file://tmp/file3"))
+        assertThat(changeCnt, `is`(7))
+        assertThat(changeDownloadedCnt, `is`(2))
+        assertThat(httpSession.popLastTask(), nilValue())
+
+        firstTask?.mockCompletionSuccess(localFileUrl: URL(string: "file://tmp/file1"))
+        assertThat(changeCnt, `is`(9))
+        assertThat(changeDownloadedCnt, `is`(3))
+        assertThat(downloadRef.value, presentAnd(allOf(
+            has(currentResourceCount: 3), has(totalProgress: 1.0), has(status: .complete))))
+    }
+
     func testDownloadCancel() {
         connect(drone: drone, handle: 1)
 
@@ -170,6 +170,29 @@ class FlightDataDecoderTests: XCTestCase {
         let resultData = getDocumentDataWithFileName(resultName)
         assertThat(resultData, nilValue())
     }
+
+    func testConvertMultiHourFlightTime() {
+        // about 3 hours of flight, made of repeated runs of the test file
+        let inData = makeMultiHourPud(repeatCount: 50)
+        let chunkSize = 64 * 1024
+
+        measure {
+            let pudDecoder = PudStreamDecoder()
+            var outSize = 0
+            var offset = 0
+            do {
+                while offset < inData.count {
+                    let end = min(offset + chunkSize, inData.count)
+                    outSize += try pudDecoder.decodeStream(inData.subdata(in: offset..<end))?.count ?? 0
+                    offset = end
+                }
+                outSize += try pudDecoder.decodeStream(nil)?.count ?? 0
+            } catch {
+                XCTFail("\(error)")
+            }
+            assertThat(outSize, greaterThan(inData.count))
+        }
+    }
 }
 
 extension FlightDataDecoderTests {
@@ -218,6 +241,39 @@ extension FlightDataDecoderTests {
         return data
     }
 
+    /// Builds a long flight data file, repeating the lines of the test file with shifted timestamps.
+    ///
+    /// - Parameter repeatCount: number of times the lines of the test file are repeated
+    /// - Returns: flight data file content
+    func makeMultiHourPud(repeatCount: Int) -> Data {
+        let data = getBundleDataWithFileName(binaryPudName)!
+        let headerEnd = data.index(of: 0)!
+        let header = try! JSONSerialization.jsonObject(with: data.subdata(in: 0..<headerEnd)) as! [String: Any]
+        let columns = header["details_headers"] as! [[String: Any]]
+        let lineSize = columns.reduce(0) { $0 + ($1["size"] as! Int) }
+        // the time column is the first one, a 4 bytes integer
+        assertThat(columns.first?["name"] as? String, `is`("time"))
+        let lines = data.subdata(in: (headerEnd + 1)..<data.count)
+        let lineCount = lines.count / lineSize
+        let runTime = lines.subdata(in: (lineCount - 1) * lineSize..<lineCount * lineSize)
+            .withUnsafeBytes { (ptr: UnsafePointer<Int32>) in ptr.pointee } + 200
+
+        var result = data.subdata(in: 0..<(headerEnd + 1))
+        result.reserveCapacity(result.count + lines.count * repeatCount)
+        for run in 0..<repeatCount {
+            var runLines = lines
+            for line in 0..<lineCount {
+                let timeRange = line * lineSize..<line * lineSize + 4
+                var time = runLines.subdata(in: timeRange).withUnsafeBytes { (ptr: UnsafePointer<Int32>) in
+                    ptr.pointee
+                } + Int32(run) * runTime
+                withUnsafeBytes(of: &time) { runLines.replaceSubrange(timeRange, with: $0) }
+            }
+            result.append(runLines)
+        }
+        return result
+    }
+
     func deleteFile(name: String) {
         let fileManager = FileManager.default
         let url = getDocumentUrlWithFileName(name)
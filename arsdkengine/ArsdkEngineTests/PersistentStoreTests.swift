@@ -92,4 +92,163 @@ class PersistentStoreTests: XCTestCase {
         assertThat(dict2.new, `is`(false))
         assertThat(dict2["substr"] as? String, presentAnd(`is`("sub string")))
     }
+
+    func testCommitsAreCoalesced() {
+        store = MockPersistentStore()
+        let dict = store.getDevice(uid: "123")
+        dict[PersistentStore.deviceName] = StorableValue("name").content
+        dict.commit()
+        dict[PersistentStore.deviceName] = StorableValue("other name").content
+        dict.commit()
+        let preset = store.getPreset(uid: "p1")
+        preset["key"] = StorableValue(1).content
+        preset.commit()
+
+        // nothing written yet
+        assertThat(store.mockBackend.storeCnt, `is`(0))
+
+        store.flush(wait: true)
+        // only the last content of each changed entry is written
+        assertThat(store.mockBackend.storeCnt, `is`(2))
+        assertThat(store.mockBackend.entries["devices"]?["123"]?[PersistentStore.deviceName] as? String,
+                   presentAnd(`is`("other name")))
+        assertThat(store.mockBackend.entries["presets"]?["p1"]?["key"] as? Int, presentAnd(`is`(1)))
+
+        // flushing again does not write anything
+        store.flush(wait: true)
+        assertThat(store.mockBackend.storeCnt, `is`(2))
+
+        // pending entries are written after the commit delay
+        store.commitDelay = 0.01
+        dict.clear().commit()
+        let expectation = self.expectation(description: "written")
+        DispatchQueue.main.asyncAfter(deadline: .now() + 0.1) {
+            expectation.fulfill()
+        }
+        waitForExpectations(timeout: 1)
+        store.flush(wait: true)
+        assertThat(store.mockBackend.storeCnt, `is`(3))
+        assertThat(store.mockBackend.entries["devices"]?["123"], nilValue())
+    }
+
+    func testFailedWritesAreRequeued() {
+        let backend = MockPersistentStoreBackend()
+        backend.failingUids = ["123"]
+        store = MockPersistentStore(mockBackend: backend)
+        let dict = store.getDevice(uid: "123")
+        dict[PersistentStore.deviceName] = StorableValue("name").content
+        dict.commit()
+        let other = store.getDevice(uid: "456")
+        other[PersistentStore.deviceName] = StorableValue("other").content
+        other.commit()
+
+        store.flush(wait: true)
+        processMainQueue()
+        assertThat(backend.storeCnt, `is`(2))
+        assertThat(backend.entries["devices"]?["123"], nilValue())
+        assertThat(backend.entries["devices"]?["456"], present())
+
+        // failed entry is written again by the next flush
+        backend.failingUids = []
+        store.flush(wait: true)
+        processMainQueue()
+        assertThat(backend.storeCnt, `is`(3))
+        assertThat(backend.entries["devices"]?["123"]?[PersistentStore.deviceName] as? String,
+                   presentAnd(`is`("name")))
+
+        // failed entry committed again before being queued again: the new content is written
+        backend.failingUids = ["123"]
+        dict[PersistentStore.deviceName] = StorableValue("other name").content
+        dict.commit()
+        store.flush(wait: true)
+        backend.failingUids = []
+        dict[PersistentStore.deviceName] = StorableValue("last name").content
+        dict.commit()
+        processMainQueue()
+        store.flush(wait: true)
+        processMainQueue()
+        assertThat(backend.storeCnt, `is`(5))
+        assertThat(backend.entries["devices"]?["123"]?[PersistentStore.deviceName] as? String,
+                   presentAnd(`is`("last name")))
+    }
+
+    func testEntriesAreLoadedLazily() {
+        let backend = MockPersistentStoreBackend()
+        backend.entries["devices"] = ["123": [PersistentStore.deviceName: "name" as AnyObject],
+                                      "456": [PersistentStore.deviceName: "other" as AnyObject]]
+        store = MockPersistentStore(mockBackend: backend)
+
+        assertThat(store.getDevicesUid(), `is`(["123", "456"]))
+        assertThat(backend.loadCnt, `is`(0))
+
+        let dict = store.getDevice(uid: "123")
+        assertThat(dict.new, `is`(false))
+        assertThat(dict[PersistentStore.deviceName] as? String, presentAnd(`is`("name")))
+        assertThat(backend.loadCnt, `is`(1))
+
+        // loaded entry is not read again
+        _ = store.getDevice(uid: "123")
+        assertThat(backend.loadCnt, `is`(1))
+
+        // missing entry is looked up only once
+        assertThat(store.getDevice(uid: "789").exist, `is`(false))
+        assertThat(store.getDevice(uid: "789").exist, `is`(false))
+        assertThat(backend.loadCnt, `is`(2))
+
+        // removed entry is not listed anymore, even before being written
+        store.getDevice(uid: "456").clear().commit()
+        assertThat(store.getDevicesUid(), `is`(["123"]))
+        assertThat(store.getDevice(uid: "456").exist, `is`(false))
+    }
+
+    func testMigrateFromUserDefaults() {
+        let userDefaults = MockUserDefaults()
+        userDefaults.store["arsdkenginestore"] = [
+            "version": 1,
+            "devices": ["123": [PersistentStore.deviceName: "name"]],
+            "presets": ["p1": ["key": 1]]] as AnyObject
+        store = MockPersistentStore(mockUserDefaults: userDefaults)
+
+        assertThat(userDefaults.store["arsdkenginestore"], nilValue())
+        assertThat(store.mockBackend.entries["devices"]?["123"]?[PersistentStore.deviceName] as? String,
+                   presentAnd(`is`("name")))
+        assertThat(store.mockBackend.entries["presets"]?["p1"]?["key"] as? Int, presentAnd(`is`(1)))
+        assertThat(store.getDevicesUid(), `is`(["123"]))
+    }
+
+    func testMigrationFailureKeepsUserDefaults() {
+        let userDefaults = MockUserDefaults()
+        userDefaults.store["arsdkenginestore"] = [
+            "version": 1,
+            "devices": ["123": [PersistentStore.deviceName: "name"], "456": [PersistentStore.deviceName: "other"]]]
+            as AnyObject
+        let backend = MockPersistentStoreBackend()
+        backend.failingUids = ["456"]
+        store = MockPersistentStore(mockBackend: backend, mockUserDefaults: userDefaults)
+
+        // one entry could not be written, the old store must be kept
+        assertThat(userDefaults.store["arsdkenginestore"], present())
+        assertThat(backend.entries["devices"]?["123"]?[PersistentStore.deviceName] as? String,
+                   presentAnd(`is`("name")))
+
+        // entry migrated by the first attempt is changed, then migration is retried
+        backend.entries["devices"]?["123"]?[PersistentStore.deviceName] = "renamed" as AnyObject
+        backend.failingUids = []
+        store = MockPersistentStore(mockBackend: backend, mockUserDefaults: userDefaults)
+
+        assertThat(userDefaults.store["arsdkenginestore"], nilValue())
+        assertThat(backend.entries["devices"]?["123"]?[PersistentStore.deviceName] as? String,
+                   presentAnd(`is`("renamed")))
+        assertThat(backend.entries["devices"]?["456"]?[PersistentStore.deviceName] as? String,
+                   presentAnd(`is`("other")))
+    }
+
+    /// Runs the blocks dispatched to the main queue.
+    private func processMainQueue() {
+        let expectation = self.expectation(description: "main queue processed")
+        DispatchQueue.main.async {
+            expectation.fulfill()
+        }
+        waitForExpectations(timeout: 1)
+    }
 }
@@ -0,0 +1,240 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+import XCTest
+import SdkCore
+
+/// Checks pomp loops running on a dispatch queue and on their own thread, and compares their dispatch throughput and
+/// wake up latency.
+class PompLoopUtilTests: XCTestCase {
+
+    /// Number of blocks dispatched by each benchmark iteration
+    private let blockCount = 10000
+
+    /// Number of synchronous round trips of the latency benchmark
+    private let roundTripCount = 1000
+
+    /// Highest accepted average wake up latency of an idle loop, in seconds
+    private let maxAverageWakeupLatency = 0.001
+
+    func testDispatchOrderOnQueue() {
+        checkDispatchOrder(dedicatedThread: false)
+    }
+
+    func testDispatchOrderOnThread() {
+        checkDispatchOrder(dedicatedThread: true)
+    }
+
+    func testDispatchSyncFromLoop() {
+        for dedicatedThread in [false, true] {
+            let loop = PompLoopUtil(name: "test", dedicatedThread: dedicatedThread)
+            loop.runLoop()
+            var executed = false
+            loop.dispatch_sync {
+                // nested synchronous dispatch runs inline
+                loop.dispatch_sync {
+                    executed = true
+                }
+            }
+            XCTAssertTrue(executed)
+            loop.stopRun()
+        }
+    }
+
+    func testDispatchSyncBeforeRunAndAfterStop() {
+        for dedicatedThread in [false, true] {
+            let loop = PompLoopUtil(name: "test", dedicatedThread: dedicatedThread)
+            // not run yet: executed, as with a queue loop
+            var executed = false
+            loop.dispatch_sync {
+                executed = true
+            }
+            XCTAssertTrue(executed)
+            loop.runLoop()
+            loop.stopRun()
+            // stopped: returns without executing the block
+            executed = false
+            loop.dispatch_sync {
+                executed = true
+            }
+            XCTAssertFalse(executed)
+        }
+    }
+
+    func testDispatchSyncRacingStop() {
+        for _ in 0..<100 {
+            let loop = PompLoopUtil(name: "test", dedicatedThread: true)
+            loop.runLoop()
+            let returned = expectation(description: "returned")
+            DispatchQueue.global().async {
+                // must never wait on a task that is not drained
+                for _ in 0..<100 {
+                    loop.dispatch_sync {}
+                }
+                returned.fulfill()
+            }
+            loop.stopRun()
+            wait(for: [returned], timeout: 5)
+        }
+    }
+
+    func testDispatchAfterStop() {
+        for dedicatedThread in [false, true] {
+            let loop = PompLoopUtil(name: "test", dedicatedThread: dedicatedThread)
+            loop.runLoop()
+            loop.stopRun()
+            // blocks dispatched to a stopped loop are executed, whatever the loop mode
+            let executed = expectation(description: "executed")
+            loop.dispatch {
+                executed.fulfill()
+            }
+            wait(for: [executed], timeout: 1)
+        }
+    }
+
+    func testConcurrentDispatchSyncBeforeRun() {
+        let loop = PompLoopUtil(name: "test", dedicatedThread: true)
+        var executing = false
+        var overlapped = false
+        var count = 0
+        // blocks executed by their dispatching threads must still be executed one at a time
+        DispatchQueue.concurrentPerform(iterations: 4) { _ in
+            for _ in 0..<1000 {
+                loop.dispatch_sync {
+                    if executing {
+                        overlapped = true
+                    }
+                    executing = true
+                    count += 1
+                    executing = false
+                }
+            }
+        }
+        XCTAssertFalse(overlapped)
+        XCTAssertEqual(count, 4000)
+    }
+
+    func testThreadLoopStats() {
+        let loop = PompLoopUtil(name: "test", dedicatedThread: true)
+        loop.runLoop()
+        let blocking = DispatchSemaphore(value: 0)
+        let blocked = DispatchSemaphore(value: 0)
+        // block the loop so that following blocks are drained by a single wake up
+        loop.dispatch {
+            blocked.signal()
+            blocking.wait()
+        }
+        blocked.wait()
+        for _ in 0..<10 {
+            loop.dispatch {}
+        }
+        blocking.signal()
+        loop.dispatch_sync {}
+
+        let stats = loop.stats()
+        XCTAssertEqual(stats.blockCount, 12)
+        XCTAssertGreaterThanOrEqual(stats.maxBlocksPerWakeup, 10)
+        XCTAssertGreaterThan(stats.averageBlocksPerWakeup, 1)
+        XCTAssertGreaterThan(stats.maxBlockLatency, 0)
+
+        loop.resetStats()
+        XCTAssertEqual(loop.stats().blockCount, 0)
+        loop.stopRun()
+    }
+
+    func testDispatchThroughputOnQueue() {
+        measureDispatchThroughput(dedicatedThread: false)
+    }
+
+    func testDispatchThroughputOnThread() {
+        measureDispatchThroughput(dedicatedThread: true)
+    }
+
+    func testWakeupLatency() {
+        for dedicatedThread in [false, true] {
+            let loop = PompLoopUtil(name: dedicatedThread ? "thread" : "queue", dedicatedThread: dedicatedThread)
+            loop.runLoop()
+            // warm up
+            loop.dispatch_sync {}
+            loop.resetStats()
+            for _ in 0..<roundTripCount {
+                loop.dispatch_sync {}
+            }
+            let stats = loop.stats()
+            XCTAssertEqual(stats.blockCount, UInt(roundTripCount))
+            // an idle loop must be woken up well within a millisecond on average
+            XCTAssertLessThan(stats.averageBlockLatency, maxAverageWakeupLatency)
+            loop.stopRun()
+        }
+    }
+
+    /// Dispatches blocks from several threads and checks that each thread's blocks are executed in dispatch order.
+    ///
+    /// - Parameter dedicatedThread: whether the loop runs on its own thread
+    private func checkDispatchOrder(dedicatedThread: Bool) {
+        let loop = PompLoopUtil(name: "test", dedicatedThread: dedicatedThread)
+        loop.runLoop()
+        let producerCount = 4
+        var lastValues = [Int](repeating: -1, count: producerCount)
+        var outOfOrder = false
+        DispatchQueue.concurrentPerform(iterations: producerCount) { producer in
+            for value in 0..<blockCount {
+                loop.dispatch {
+                    if lastValues[producer] != value - 1 {
+                        outOfOrder = true
+                    }
+                    lastValues[producer] = value
+                }
+            }
+        }
+        loop.dispatch_sync {}
+        XCTAssertFalse(outOfOrder)
+        XCTAssertEqual(lastValues, [Int](repeating: blockCount - 1, count: producerCount))
+        loop.stopRun()
+    }
+
+    /// Measures the time to dispatch blocks to a loop and wait for their execution.
+    ///
+    /// - Parameter dedicatedThread: whether the loop runs on its own thread
+    private func measureDispatchThroughput(dedicatedThread: Bool) {
+        let loop = PompLoopUtil(name: dedicatedThread ? "thread" : "queue", dedicatedThread: dedicatedThread)
+        loop.runLoop()
+        var counter = 0
+        measure {
+            for _ in 0..<blockCount {
+                loop.dispatch {
+                    counter += 1
+                }
+            }
+            loop.dispatch_sync {}
+        }
+        XCTAssertEqual(counter % blockCount, 0)
+        loop.stopRun()
+    }
+}
@@ -0,0 +1,96 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+import XCTest
+import SdkCore
+import SdkCoreTesting
+
+/// Compares the cost of copying decoded frames to the cost of referencing them (zero-copy).
+class SdkCoreFrameBenchmarkTests: XCTestCase {
+
+    /// Size of a 720p I420 frame
+    private let frameSize = 1280 * 720 * 3 / 2
+
+    /// Number of frames handled in each measure
+    private let frameCount = 100
+
+    /// Decoded frame
+    private var source: MockVideoBuffer!
+
+    override func setUp() {
+        super.setUp()
+        source = MockVideoBuffer(size: frameSize, fill: 0x80)
+    }
+
+    func testReferenceSharesDecodedBuffer() {
+        let ref1 = SdkCoreFrame(ref: source.vbuf, metaKey: source.metaKey)
+        let ref2 = SdkCoreFrame(ref: source.vbuf, metaKey: source.metaKey)
+        let copy = SdkCoreFrame(copy: source.vbuf, metaKey: source.metaKey)
+        assertThat(ref1, present())
+        assertThat(copy, present())
+        XCTAssertTrue(ref1?.data == ref2?.data)
+        XCTAssertFalse(ref1?.data == copy?.data)
+        assertThat(copy?.len, presentAnd(`is`(frameSize)))
+        let content: (SdkCoreFrame?) -> Data? = { frame in frame.map { Data(bytes: $0.data!, count: $0.len) } }
+        XCTAssertTrue(content(ref1) == content(copy))
+    }
+
+    func testCopyTime() {
+        measure {
+            for _ in 0..<frameCount {
+                autoreleasepool {
+                    XCTAssertNotNil(SdkCoreFrame(copy: source.vbuf, metaKey: source.metaKey))
+                }
+            }
+        }
+    }
+
+    func testPooledCopyTime() {
+        let pool = SdkCoreFramePool(maxFreeBuffers: 2)
+        measure {
+            for _ in 0..<frameCount {
+                autoreleasepool {
+                    XCTAssertNotNil(SdkCoreFrame(copy: source.vbuf, metaKey: source.metaKey, pool: pool))
+                }
+            }
+        }
+        // after the first frame, every copy reuses the same buffer
+        assertThat(pool.stats.misses, `is`(1))
+    }
+
+    func testReferenceTime() {
+        measure {
+            for _ in 0..<frameCount {
+                autoreleasepool {
+                    XCTAssertNotNil(SdkCoreFrame(ref: source.vbuf, metaKey: source.metaKey))
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,106 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+import XCTest
+import SdkCore
+import SdkCoreTesting
+
+/// Checks the recycling of frame copy buffers by SdkCoreFramePool.
+class SdkCoreFramePoolTests: XCTestCase {
+
+    /// Frame size
+    private let frameSize = 100_000
+
+    func testBuffersAreRecycled() {
+        let pool = SdkCoreFramePool(maxFreeBuffers: 1)
+        let source = MockVideoBuffer(size: frameSize, fill: 1)!
+
+        var frame1 = copy(source, pool: pool)
+        var frame2 = copy(source, pool: pool)
+        assertThat(pool.stats.hits, `is`(0))
+        assertThat(pool.stats.misses, `is`(2))
+        // buffer capacity wastes less than 1/8 of the frame size
+        let capacity = pool.stats.residentBytes / 2
+        assertThat(capacity, greaterThanOrEqualTo(UInt64(frameSize)))
+        assertThat(capacity, lessThan(UInt64(frameSize + frameSize / 8)))
+        assertThat(pool.stats.peakResidentBytes, `is`(2 * capacity))
+
+        // one buffer is kept, the other one is freed
+        frame1 = nil
+        frame2 = nil
+        assertThat(pool.stats.residentBytes, `is`(capacity))
+        assertThat(pool.stats.peakResidentBytes, `is`(2 * capacity))
+
+        // a slightly bigger frame reuses the free buffer
+        let biggerSource = MockVideoBuffer(size: frameSize + 1000, fill: 2)!
+        frame1 = copy(biggerSource, pool: pool)
+        assertThat(pool.stats.hits, `is`(1))
+        assertThat(pool.stats.misses, `is`(2))
+        assertThat(pool.stats.residentBytes, `is`(capacity))
+        assertThat(frame1?.len, presentAnd(`is`(frameSize + 1000)))
+        assertThat(frame1.map { Array(UnsafeBufferPointer(start: $0.data, count: $0.len)) },
+                   presentAnd(`is`([UInt8](repeating: 2, count: frameSize + 1000))))
+
+        // a much smaller frame gets its own buffer
+        frame2 = copy(MockVideoBuffer(size: frameSize / 2, fill: 3)!, pool: pool)
+        assertThat(pool.stats.hits, `is`(1))
+        assertThat(pool.stats.misses, `is`(3))
+        assertThat(pool.stats.residentBytes, greaterThanOrEqualTo(capacity + UInt64(frameSize / 2)))
+        assertThat(pool.stats.peakResidentBytes, `is`(2 * capacity))
+        _ = frame1
+        _ = frame2
+    }
+
+    func testRecycledBufferGetsNewMetadata() {
+        let pool = SdkCoreFramePool(maxFreeBuffers: 1)
+        let source = MockVideoBuffer(size: frameSize, fill: 1)!
+
+        var frame = copy(source, pool: pool)
+        let firstData = frame?.data
+        frame = nil
+
+        // the recycled buffer only carries the metadata of the new frame, pointing into its own data
+        frame = copy(source, pool: pool)
+        assertThat(pool.stats.hits, `is`(1))
+        assertThat(frame?.data == firstData, `is`(true))
+        assertThat(frame?.pdrawFrame, present())
+    }
+
+    /// Copies a mock video buffer into a pooled frame.
+    ///
+    /// - Parameters:
+    ///   - source: buffer to copy
+    ///   - pool: frame pool
+    /// - Returns: the frame copy
+    private func copy(_ source: MockVideoBuffer, pool: SdkCoreFramePool) -> SdkCoreFrame? {
+        return autoreleasepool {
+            SdkCoreFrame(copy: source.vbuf, metaKey: source.metaKey, pool: pool)
+        }
+    }
+}
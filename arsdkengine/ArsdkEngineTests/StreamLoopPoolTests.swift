@@ -0,0 +1,119 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+import XCTest
+@testable import ArsdkEngine
+@testable import GroundSdk
+import SdkCoreTesting
+
+/// Checks the assignment of live video streams to the dedicated stream loops of ArsdkCore.
+class StreamLoopPoolTests: ArsdkEngineTestBase {
+
+    /// Name of the arsdk loop
+    private let arsdkLoopName = "arsdkcore.pomloop"
+
+    override func setUp() {
+        super.setUp()
+        mockArsdkCore.addDevice("123", type: Drone.Model.anafi4k.internalId, backendType: .net, name: "Wifi",
+                                handle: 1)
+        mockArsdkCore.addDevice("456", type: Drone.Model.anafi4k.internalId, backendType: .mux, name: "Mux",
+                                handle: 2)
+    }
+
+    func testWifiStreamsDistributedOnStreamLoops() {
+        mockArsdkCore.streamLoopCount = 2
+
+        let loop1 = mockArsdkCore.streamLoop(forDevice: 1)
+        let loop2 = mockArsdkCore.streamLoop(forDevice: 1)
+        let loop3 = mockArsdkCore.streamLoop(forDevice: 1)
+
+        assertThat(loop1.name, `is`("arsdkcore.stream0"))
+        assertThat(loop2.name, `is`("arsdkcore.stream1"))
+        // pool is full, next stream goes back to the first loop
+        XCTAssertTrue(loop3 === loop1)
+        assertThat(mockArsdkCore.loopStats().map { $0.name },
+                   `is`([arsdkLoopName, "arsdkcore.stream0", "arsdkcore.stream1"]))
+    }
+
+    func testOtherStreamsStayOnArsdkLoop() {
+        mockArsdkCore.streamLoopCount = 2
+
+        // streams over a usb mux run on the loop owning the mux
+        assertThat(mockArsdkCore.streamLoop(forDevice: 2).name, `is`(arsdkLoopName))
+        // unknown device
+        assertThat(mockArsdkCore.streamLoop(forDevice: 3).name, `is`(arsdkLoopName))
+        // removed device
+        mockArsdkCore.removeDevice(1)
+        assertThat(mockArsdkCore.streamLoop(forDevice: 1).name, `is`(arsdkLoopName))
+        // no stream loop has been created
+        assertThat(mockArsdkCore.loopStats().count, `is`(1))
+    }
+
+    func testNoStreamLoop() {
+        mockArsdkCore.streamLoopCount = 0
+
+        assertThat(mockArsdkCore.streamLoop(forDevice: 1).name, `is`(arsdkLoopName))
+        assertThat(mockArsdkCore.streamLoop(forDevice: 1).name, `is`(arsdkLoopName))
+        assertThat(mockArsdkCore.loopStats().count, `is`(1))
+    }
+
+    func testStreamLoopsStoppedOnStop() {
+        mockArsdkCore.streamLoopCount = 2
+
+        // a loop created before start is run on start, a loop created after start is run immediately
+        let loop1 = mockArsdkCore.streamLoop(forDevice: 1)
+        mockArsdkCore.startLoops()
+        let loop2 = mockArsdkCore.streamLoop(forDevice: 1)
+        assertThat(isRunning(loop1), `is`(true))
+        assertThat(isRunning(loop2), `is`(true))
+
+        mockArsdkCore.stopLoops()
+        assertThat(isRunning(loop1), `is`(false))
+        assertThat(isRunning(loop2), `is`(false))
+
+        // loops are kept and run again on next start
+        mockArsdkCore.startLoops()
+        XCTAssertTrue(mockArsdkCore.streamLoop(forDevice: 1) === loop1)
+        assertThat(isRunning(loop1), `is`(true))
+        assertThat(isRunning(loop2), `is`(true))
+        mockArsdkCore.stopLoops()
+    }
+
+    /// Checks whether a loop executes the blocks dispatched to it.
+    ///
+    /// - Parameter loop: loop to check
+    /// - Returns: `true` if the loop executed a synchronously dispatched block, `false` if it has been stopped
+    private func isRunning(_ loop: PompLoopUtil) -> Bool {
+        var executed = false
+        loop.dispatch_sync {
+            executed = true
+        }
+        return executed
+    }
+}
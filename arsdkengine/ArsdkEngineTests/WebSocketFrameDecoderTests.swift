@@ -0,0 +1,279 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+
+import XCTest
+@testable import ArsdkEngine
+
+/// Checks the incremental web socket frame decoder against a recorded frame stream, split at every possible
+/// position, and against random data.
+class WebSocketFrameDecoderTests: XCTestCase {
+
+    typealias Event = WebSocketFrameDecoder.Event
+
+    /// Size of the data chunks handed over by the socket connection
+    private let receiveSize = 1024
+
+    func testDecodeInChunks() {
+        let (stream, expectedEvents) = WebSocketFrameDecoderTests.syntheticStream()
+        for chunkSize in [1, 2, 3, 7, 125, 1024, stream.count] {
+            let decoder = WebSocketFrameDecoder(initialCapacity: 16)
+            var events = [Event]()
+            XCTAssertNoThrow(events = try feed(decoder, with: stream, chunkSize: chunkSize))
+            XCTAssertEqual(events, expectedEvents)
+            XCTAssertEqual(decoder.bufferedByteCount, 0)
+        }
+    }
+
+    func testFragmentedMessage() {
+        let decoder = WebSocketFrameDecoder()
+        // first fragment, ping, continuation, pong, final fragment
+        decoder.append(Data([0x01, 0x03]) + "Hel".data(using: .utf8)!)
+        decoder.append(Data([0x89, 0x01, 0x2a]))
+        decoder.append(Data([0x00, 0x02]) + "lo".data(using: .utf8)!)
+        decoder.append(Data([0x8a, 0x00]))
+        decoder.append(Data([0x80, 0x01]) + "!".data(using: .utf8)!)
+
+        XCTAssertEqual(try decoder.nextEvent(), .ping(Data([0x2a])))
+        XCTAssertEqual(try decoder.nextEvent(), .pong(Data()))
+        XCTAssertEqual(try decoder.nextEvent(), .text("Hello!".data(using: .utf8)!))
+        XCTAssertNil(try decoder.nextEvent())
+    }
+
+    func testMaskedFrame() {
+        let payload = "{\"name\": \"media_created\"}".data(using: .utf8)!
+        let frame = WebSocketFrameDecoder.encodeFrame(opCode: .text, payload: payload, maskingKey: 0x12345678)
+        XCTAssertEqual(frame.count, 2 + 4 + payload.count)
+        XCTAssertEqual(frame[1], 0x80 | UInt8(payload.count))
+        XCTAssertNotEqual(frame.subdata(in: 6..<frame.count), payload)
+
+        let decoder = WebSocketFrameDecoder()
+        decoder.append(frame)
+        XCTAssertEqual(try decoder.nextEvent(), .text(payload))
+    }
+
+    func testDecodeErrors() {
+        // reserved bits
+        XCTAssertThrowsError(try decode(Data([0xc1, 0x00])))
+        // unknown opCode
+        XCTAssertThrowsError(try decode(Data([0x83, 0x00])))
+        // continuation without a fragmented message
+        XCTAssertThrowsError(try decode(Data([0x80, 0x00])))
+        // new message before the end of the fragmented message
+        XCTAssertThrowsError(try decode(Data([0x01, 0x00, 0x81, 0x00])))
+        // fragmented control frame
+        XCTAssertThrowsError(try decode(Data([0x09, 0x00])))
+        // control frame too large
+        XCTAssertThrowsError(try decode(Data([0x89, 0x7e, 0x00, 0x7e])))
+        // message too large, rejected from its header
+        XCTAssertThrowsError(try decode(Data([0x82, 0x7f, 0x80, 0, 0, 0, 0, 0, 0, 0])))
+        let decoder = WebSocketFrameDecoder(maxMessageSize: 4)
+        decoder.append(Data([0x02, 0x03, 1, 2, 3, 0x80, 0x02, 4, 5]))
+        XCTAssertThrowsError(try decoder.nextEvent())
+    }
+
+    func testFuzzChunkSplits() {
+        let (stream, expectedEvents) = WebSocketFrameDecoderTests.syntheticStream()
+        var generator = XorShiftGenerator(seed: 0x5eed)
+        for _ in 0..<200 {
+            let decoder = WebSocketFrameDecoder(initialCapacity: 64)
+            var events = [Event]()
+            var offset = 0
+            while offset < stream.count {
+                let end = min(offset + Int.random(in: 1...300, using: &generator), stream.count)
+                decoder.append(stream.subdata(in: offset..<end))
+                XCTAssertNoThrow(try drain(decoder, into: &events))
+                offset = end
+            }
+            XCTAssertEqual(events, expectedEvents)
+            XCTAssertEqual(decoder.bufferedByteCount, 0)
+        }
+    }
+
+    func testFuzzRandomData() {
+        var generator = XorShiftGenerator(seed: 0xf00d)
+        for _ in 0..<2000 {
+            let decoder = WebSocketFrameDecoder(initialCapacity: 16, maxMessageSize: 64 * 1024)
+            let data = Data((0..<Int.random(in: 0...512, using: &generator)).map { _ in
+                UInt8.random(in: 0...255, using: &generator)
+            })
+            decoder.append(data)
+            var events = [Event]()
+            // either decodes events, waits for more data or rejects the data, but never crashes
+            if (try? drain(decoder, into: &events)) != nil {
+                XCTAssertLessThanOrEqual(decoder.bufferedByteCount, data.count)
+            }
+        }
+    }
+
+    func testDecodeThroughput() {
+        let (stream, expectedEvents) = WebSocketFrameDecoderTests.syntheticStream()
+        let repeatCount = 200
+        let bigStream = Data((0..<repeatCount).map { _ in stream }.joined())
+        measure {
+            let decoder = WebSocketFrameDecoder()
+            var eventCount = 0
+            var offset = 0
+            while offset < bigStream.count {
+                let end = min(offset + receiveSize, bigStream.count)
+                decoder.append(bigStream.subdata(in: offset..<end))
+                do {
+                    while try decoder.nextEvent() != nil {
+                        eventCount += 1
+                    }
+                } catch let error {
+                    XCTFail("\(error)")
+                }
+                offset = end
+            }
+            XCTAssertEqual(eventCount, expectedEvents.count * repeatCount)
+        }
+    }
+
+    /// Decodes all events of some data.
+    ///
+    /// - Parameter data: data to decode
+    /// - Returns: decoded events
+    /// - Throws: the decoder error
+    @discardableResult
+    private func decode(_ data: Data) throws -> [Event] {
+        let decoder = WebSocketFrameDecoder()
+        decoder.append(data)
+        var events = [Event]()
+        try drain(decoder, into: &events)
+        return events
+    }
+
+    /// Hands data over to a decoder, in chunks, and collects decoded events.
+    ///
+    /// - Parameters:
+    ///   - decoder: decoder to feed
+    ///   - data: data to hand over
+    ///   - chunkSize: size of each chunk
+    /// - Returns: decoded events
+    /// - Throws: the decoder error
+    private func feed(_ decoder: WebSocketFrameDecoder, with data: Data, chunkSize: Int) throws -> [Event] {
+        var events = [Event]()
+        var offset = 0
+        while offset < data.count {
+            let end = min(offset + chunkSize, data.count)
+            decoder.append(data.subdata(in: offset..<end))
+            try drain(decoder, into: &events)
+            offset = end
+        }
+        return events
+    }
+
+    /// Collects all events that the decoder can decode from its buffered data.
+    ///
+    /// - Parameters:
+    ///   - decoder: decoder
+    ///   - events: array to append the decoded events to
+    /// - Throws: the decoder error
+    private func drain(_ decoder: WebSocketFrameDecoder, into events: inout [Event]) throws {
+        while let event = try decoder.nextEvent() {
+            events.append(event)
+        }
+    }
+
+    /// Builds a synthetic frame stream, covering the frame kinds the media web socket may send, and the events it
+    /// should decode into.
+    ///
+    /// The stream contains media events with 7 and 16 bit payload lengths, a large message with a 64 bit payload
+    /// length, a fragmented message with interleaved ping and pong, a masked frame and a final close frame.
+    ///
+    /// - Returns: the frame stream and its expected events
+    private static func syntheticStream() -> (Data, [Event]) {
+        var stream = Data()
+        var events = [Event]()
+
+        func add(_ opCode: WebSocketFrameDecoder.OpCode, _ payload: Data, fin: Bool = true, mask: UInt32? = nil) {
+            var frame = WebSocketFrameDecoder.encodeFrame(opCode: opCode, payload: payload, maskingKey: mask)
+            if !fin {
+                frame[0] &= 0x7f
+            }
+            stream.append(frame)
+        }
+
+        for index in 0..<20 {
+            let event = """
+                {"name": "media_created", "data": {"media": {"media_id": "media\(index)", "type": "PHOTO", \
+                "datetime": "20180616T141516+0100", "size": \(index * 1000), "run_id": "run\(index % 3)", \
+                "resources": [{"resource_id": "\(index).JPG", "type": "PHOTO", "format": "JPG", \
+                "url": "/data/media/\(index).JPG", "size": \(index * 1000)}]}}}
+                """.data(using: .utf8)!
+            add(.text, event)
+            events.append(.text(event))
+        }
+
+        let shortEvent = "{\"name\": \"media_removed\", \"data\": {\"media_id\": \"media1\"}}".data(using: .utf8)!
+        add(.text, shortEvent)
+        events.append(.text(shortEvent))
+
+        let largeMessage = Data((0..<70000).map { UInt8($0 & 0x7f) })
+        add(.binary, largeMessage)
+        events.append(.binary(largeMessage))
+
+        add(.text, "{\"name\": \"all_media_".data(using: .utf8)!, fin: false)
+        add(.ping, "ping".data(using: .utf8)!)
+        events.append(.ping("ping".data(using: .utf8)!))
+        add(.continuation, "removed\"}".data(using: .utf8)!, fin: false)
+        add(.pong, Data())
+        events.append(.pong(Data()))
+        add(.continuation, Data())
+        events.append(.text("{\"name\": \"all_media_removed\"}".data(using: .utf8)!))
+
+        add(.text, shortEvent, mask: 0xdeadbeef)
+        events.append(.text(shortEvent))
+
+        add(.connectionClose, Data([0x03, 0xe8]))
+        events.append(.close(Data([0x03, 0xe8])))
+        return (stream, events)
+    }
+}
+
+/// Seeded random number generator, so that fuzz tests are reproducible.
+private struct XorShiftGenerator: RandomNumberGenerator {
+    /// Generator state
+    private var state: UInt64
+
+    /// Constructor
+    ///
+    /// - Parameter seed: generator seed, must not be 0
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state ^= state << 13
+        state ^= state >> 7
+        state ^= state << 17
+        return state
+    }
+}
@@ -211,6 +211,9 @@ public class MediaDownloader: NSObject {
     /// Current file download between 0.0 (0%) and 1.0 (100%).
     public let currentFileProgress: Float
 
+    /// Current file download throughput, in bytes per second. 0 when unknown.
+    public let currentFileThroughput: Double
+
     /// Total download progress between 0.0 (0%) and 1.0 (100%).
     public let totalProgress: Float
 
@@ -231,17 +234,19 @@ public class MediaDownloader: NSObject {
     ///   - totalResources: total number of resources to download
     ///   - countResources: number of already downloaded resources
     ///   - currentFileProgress: current file download between 0.0 (0%) and 1.0 (100%)
+    ///   - currentFileThroughput: current file download throughput, in bytes per second
     ///   - progress: total download progress between 0.0 (0%) and 1.0 (100%)
     ///   - status: download progress status
     ///   - fileUrl : url of downloaded file when progress is at 1.0, nil in other cases
     init(totalMedia: Int, countMedia: Int, totalResources: Int, countResources: Int,
-         currentFileProgress: Float, progress: Float, status: MediaTaskStatus,
+         currentFileProgress: Float, currentFileThroughput: Double = 0, progress: Float, status: MediaTaskStatus,
          currentMedia: MediaItem? = nil, fileUrl: URL? = nil) {
         self.totalMediaCount = totalMedia
         self.currentMediaCount = countMedia
         self.totalResourceCount = totalResources
         self.currentResourceCount = countResources
         self.currentFileProgress = currentFileProgress
+        self.currentFileThroughput = currentFileThroughput
         self.totalProgress = progress
         self.status = status
         self.fileUrl = fileUrl
@@ -86,6 +86,26 @@ import Foundation
 ///
 ///  - `DevToolbox` (Bool): enable development toolbox. Default is `false`.
 ///
+///  - `CommandBatchLatencyMs` (Int): maximum time, in milliseconds, commands received from a device may be batched
+///      before being processed on the main thread. Default is no batching: each command is processed individually.
+///
+///  - `DedicatedPilotingThread` (Bool): encode piloting commands on a dedicated high priority thread, so that their
+///      period is not affected by other processing of the device communication loop. Default is `false`.
+///
+///  - `MediaDownloadConcurrency` (Int): maximum number of media resources downloaded concurrently from a device.
+///      Default is `1`.
+///
+///  - `InstrumentNotificationIntervalMs` (Int): minimum interval, in milliseconds, between two notifications of
+///      instrument changes. Successive changes in between are notified once, with the latest instrument state. `0`
+///      notifies them once per run loop turn. Default is no coalescing: each change is notified immediately.
+///
+///  - `StreamLoopCount` (Int): number of dedicated threads running live video streams of devices connected through
+///      wifi. Default is `0`: streams run on the device communication loop.
+///
+///  - `ProgressNotificationIntervalMs` (Int): minimum interval, in milliseconds, between two progress notifications of
+///      an upload or a download with a device. Progress values reported in between are coalesced. Start, end and
+///      completion are always notified. Default is `100`.
+///
 /// Example: Enable Usb debug and disable offline settings
 ///
 ///     <key>GroundSdk</key>
@@ -292,6 +312,57 @@ public class GroundSdkConfig: NSObject {
         }
     }
 
+    /// Maximum latency, in milliseconds, of received commands batches.
+    ///
+    /// When set, commands received from a device are accumulated and processed on the main thread in a single batch,
+    /// at most `commandBatchLatencyMs` after the first command of the batch has been received. `0` processes them as
+    /// soon as the main thread is available. `nil` disables batching.
+    public var commandBatchLatencyMs: Int? {
+        willSet(newValue) {
+            checkLocked()
+        }
+    }
+
+    /// Whether piloting commands are encoded on a dedicated high priority thread.
+    public var dedicatedPilotingThread = false {
+        willSet(newValue) {
+            checkLocked()
+        }
+    }
+
+    /// Maximum number of media resources downloaded concurrently from a device.
+    public var mediaDownloadConcurrency = 1 {
+        willSet(newValue) {
+            checkLocked()
+        }
+    }
+
+    /// Minimum interval, in milliseconds, between two notifications of instrument changes.
+    ///
+    /// When set, changes of an instrument are notified to its observers on the main thread, at most once per
+    /// interval, with the latest instrument state. `0` notifies them once per run loop turn. `nil` notifies each
+    /// change immediately.
+    public var instrumentNotificationIntervalMs: Int? {
+        willSet(newValue) {
+            checkLocked()
+        }
+    }
+
+    /// Number of dedicated threads running live video streams, `0` to run them on the device communication loop.
+    public var streamLoopCount = 0 {
+        willSet(newValue) {
+            checkLocked()
+        }
+    }
+
+    /// Minimum interval, in milliseconds, between two progress notifications of an upload or a download with a
+    /// device. `0` notifies the latest progress once per run loop turn.
+    public var progressNotificationIntervalMs = 100 {
+        willSet(newValue) {
+            checkLocked()
+        }
+    }
+
     /// List of all supported devices.
     /// This API is ObjC only. For Swift, please use `supportedDevices`.
     @objc(supportedDevices)
@@ -437,6 +508,24 @@ public class GroundSdkConfig: NSObject {
         if let enableDevToolbox = config?[Keys.enableDevToolbox.rawValue] as? Bool {
             self.enableDevToolbox = enableDevToolbox
         }
+        if let commandBatchLatencyMs = config?[Keys.commandBatchLatencyMs.rawValue] as? Int {
+            self.commandBatchLatencyMs = commandBatchLatencyMs
+        }
+        if let dedicatedPilotingThread = config?[Keys.dedicatedPilotingThread.rawValue] as? Bool {
+            self.dedicatedPilotingThread = dedicatedPilotingThread
+        }
+        if let mediaDownloadConcurrency = config?[Keys.mediaDownloadConcurrency.rawValue] as? Int {
+            self.mediaDownloadConcurrency = mediaDownloadConcurrency
+        }
+        if let instrumentNotificationIntervalMs = config?[Keys.instrumentNotificationIntervalMs.rawValue] as? Int {
+            self.instrumentNotificationIntervalMs = instrumentNotificationIntervalMs
+        }
+        if let streamLoopCount = config?[Keys.streamLoopCount.rawValue] as? Int {
+            self.streamLoopCount = streamLoopCount
+        }
+        if let progressNotificationIntervalMs = config?[Keys.progressNotificationIntervalMs.rawValue] as? Int {
+            self.progressNotificationIntervalMs = progressNotificationIntervalMs
+        }
     }
 
     /// Settings info.plist keys.
@@ -469,6 +558,12 @@ public class GroundSdkConfig: NSObject {
         case crashReportQuotaMb = "CrashReportQuotaMb"
         case blackboxPublicFolder = "BlackboxPublicFolder"
         case enableDevToolbox = "DevToolbox"
+        case commandBatchLatencyMs = "CommandBatchLatencyMs"
+        case dedicatedPilotingThread = "DedicatedPilotingThread"
+        case mediaDownloadConcurrency = "MediaDownloadConcurrency"
+        case instrumentNotificationIntervalMs = "InstrumentNotificationIntervalMs"
+        case streamLoopCount = "StreamLoopCount"
+        case progressNotificationIntervalMs = "ProgressNotificationIntervalMs"
     }
 
     /// `true` if configuration is locked, i.e. the first ground sdk instance has already been created.
@@ -66,6 +66,34 @@ public class ComponentStoreCore {
     /// Listeners lists by component id
     private var listeners: [Int: Set<Listener>] = [:]
 
+    /// Minimum interval, in seconds, between two deliveries of component update notifications.
+    ///
+    /// When set, `notifyUpdated` does not notify listeners immediately: pending updates are delivered on the main
+    /// queue, on the next run loop turn when `0`, at most once per interval otherwise. Successive updates of a
+    /// component in between are merged into a single notification, listeners getting the latest component state.
+    /// Additions and removals of components are always notified immediately.
+    ///
+    /// `nil` (default) notifies listeners synchronously on each update.
+    public var notificationInterval: TimeInterval? {
+        didSet {
+            if notificationInterval == nil {
+                deliverPendingUpdates()
+            }
+        }
+    }
+
+    /// Number of update notifications that have been merged into a pending one instead of being delivered
+    public private(set) var coalescedNotificationCount = 0
+
+    /// Components with a pending update notification, by component id
+    private var pendingUpdates: [Int: Component] = [:]
+
+    /// Whether a delivery of the pending update notifications is scheduled
+    private var deliveryScheduled = false
+
+    /// System uptime of the last delivery of pending update notifications
+    private var lastDeliveryTime: TimeInterval = 0
+
     /// Register a listener on a component
     ///
     /// - Parameters:
@@ -119,7 +147,13 @@ public class ComponentStoreCore {
     /// - Parameter component: component that has been updated
     func notifyUpdated(_ component: Component) {
         if components[component.desc.uid] != nil {
-            notifyChanged(component)
+            if notificationInterval == nil {
+                notifyChanged(component)
+            } else if pendingUpdates.updateValue(component, forKey: component.desc.uid) != nil {
+                coalescedNotificationCount += 1
+            } else {
+                scheduleDelivery()
+            }
         }
     }
 
@@ -153,6 +187,7 @@ public class ComponentStoreCore {
             // one or more listeners were present before the add of the component
             components[component.desc.uid]?.didRegisterFirstListenerCallback()
         }
+        pendingUpdates[component.desc.uid] = nil
         notifyChanged(component)
     }
 
@@ -165,6 +200,7 @@ public class ComponentStoreCore {
             components[desc!.uid] = nil
             desc = desc?.parent
         }
+        pendingUpdates[component.desc.uid] = nil
         notifyChanged(component)
     }
 
@@ -213,8 +249,39 @@ public class ComponentStoreCore {
         }
     }
 
+    /// Schedules the delivery of the pending update notifications, if not already scheduled.
+    private func scheduleDelivery() {
+        guard !deliveryScheduled, let interval = notificationInterval else {
+            return
+        }
+        deliveryScheduled = true
+        let delay = lastDeliveryTime + interval - ProcessInfo.processInfo.systemUptime
+        let deliver: () -> Void = { [weak self] in
+            self?.deliverPendingUpdates()
+        }
+        if delay > 0 {
+            DispatchQueue.main.asyncAfter(deadline: .now() + delay, execute: deliver)
+        } else {
+            DispatchQueue.main.async(execute: deliver)
+        }
+    }
+
+    /// Notifies the listeners of all components with a pending update.
+    private func deliverPendingUpdates() {
+        deliveryScheduled = false
+        lastDeliveryTime = ProcessInfo.processInfo.systemUptime
+        let updates = pendingUpdates
+        pendingUpdates.removeAll()
+        updates.values.forEach { component in
+            if components[component.desc.uid] != nil {
+                notifyChanged(component)
+            }
+        }
+    }
+
     /// Clear the store: remove all components and all observers
     func clear() {
+        pendingUpdates.removeAll()
         components.forEach {key, component in
             self.components.removeValue(forKey: key)
             notifyChanged(component)
@@ -99,6 +99,9 @@ public class DeviceCore: CustomStringConvertible, Equatable {
         stateHolder = DeviceStateHolderCore()
         firmwareVersionHolder = FirmwareVersionHolderCore()
         boardIdHolder = BoardIdHolderCore()
+        if let intervalMs = GroundSdkConfig.sharedInstance.instrumentNotificationIntervalMs {
+            instrumentStore.notificationInterval = Double(max(intervalMs, 0)) / 1000
+        }
     }
 
     /// Get the device name and register an observer notified each time it changes
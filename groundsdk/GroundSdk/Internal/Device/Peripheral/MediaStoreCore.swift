@@ -259,6 +259,27 @@ public class MediaDownloaderCore: MediaDownloader {
                    currentFileProgress: currentFileProgress,
                    progress: progress, status: status, currentMedia: currentMedia, fileUrl: fileUrl)
     }
+
+    /// Construct a new media downloader of resources downloaded concurrently
+    ///
+    /// - Parameters:
+    ///   - iterator: media list iterator providing progress information on overall resource list download
+    ///   - downloadedSize: total size of the completely downloaded resources
+    ///   - transferredSize: size of the data received by the resource downloads in progress
+    ///   - currentFileProgress: progress on the current file download (0.0 to 1.0)
+    ///   - currentFileThroughput: current file download throughput, in bytes per second
+    ///   - status: download status
+    ///   - currentMedia : current downloading media
+    ///   - fileUrl : url of downloaded file when progress is at 1.0, nil in other cases
+    public init(mediaResourceListIterator iterator: MediaResourceListCore.Iterator, downloadedSize: UInt64,
+                transferredSize: Float, currentFileProgress: Float, currentFileThroughput: Double,
+                status: MediaTaskStatus, currentMedia: MediaItem? = nil, fileUrl: URL? = nil) {
+        let progress = (Float(downloadedSize) + transferredSize) / Float(iterator.totalSize)
+        super.init(totalMedia: iterator.mediaCount, countMedia: iterator.currentMediaIdx,
+                   totalResources: iterator.resourceCount, countResources: iterator.currentResourceIdx,
+                   currentFileProgress: currentFileProgress, currentFileThroughput: currentFileThroughput,
+                   progress: progress, status: status, currentMedia: currentMedia, fileUrl: fileUrl)
+    }
 }
 
 /// Media deleter core that makes `Core` constructor public
@@ -289,13 +310,27 @@ public class AllMediasDeleterCore: AllMediasDeleter {
     }
 }
 
+/// Incremental change of the media store content, reported by the backend while watching content changes.
+public enum MediaStoreContentChange {
+    /// A new media has been created
+    case mediaCreated(MediaItemCore)
+    /// A media and all its resources have been removed
+    case mediaRemoved(uid: String)
+    /// A new resource of an existing media has been created
+    case resourceCreated(mediaUid: String, resource: MediaItemResourceCore)
+    /// A resource has been removed
+    case resourceRemoved(uid: String)
+    /// All media have been removed
+    case allMediaRemoved
+}
+
 /// MediaStore backend.
 public protocol MediaStoreBackend: class {
 
     /// Start watching media store content.
     ///
-    /// When content watching is started, backend must call `markContentChanged()` when the content of
-    /// the media store changes.
+    /// When content watching is started, backend must call `update(contentChange:)` when it knows precisely how the
+    /// content of the media store changed, or `markContentChanged()` when the whole content must be browsed again.
     func startWatchingContentChanges()
 
     /// Stop watching media store content.
@@ -309,6 +344,17 @@ public protocol MediaStoreBackend: class {
     /// - Returns: browse request, or nil if the request can't be send
     func browse(completion: @escaping (_ medias: [MediaItemCore]) -> Void) -> CancelableCore?
 
+    /// Browse medias, giving them in chunks while they are received.
+    ///
+    /// - Parameters:
+    ///   - chunk: closure called each time new medias have been received, before the request is terminated.
+    ///   - medias: medias received since the previous chunk
+    ///   - completion: closure called when the request is terminated.
+    ///   - allMedias: list of all medias, including the ones already given in chunks
+    /// - Returns: browse request, or nil if the request can't be send
+    func browse(chunk: @escaping (_ medias: [MediaItemCore]) -> Void,
+                completion: @escaping (_ allMedias: [MediaItemCore]) -> Void) -> CancelableCore?
+
     /// Download a thumbnail
     ///
     /// - Parameters:
@@ -346,6 +392,14 @@ public protocol MediaStoreBackend: class {
 
 }
 
+/// Default implementation of MediaStoreBackend for backends that can't give medias in chunks
+extension MediaStoreBackend {
+    public func browse(chunk: @escaping (_ medias: [MediaItemCore]) -> Void,
+                       completion: @escaping (_ allMedias: [MediaItemCore]) -> Void) -> CancelableCore? {
+        return browse(completion: completion)
+    }
+}
+
 /// Internal MediaStore implementation
 public class MediaStoreCore: PeripheralCore, MediaStore {
     /// Listener notified when the media store content changes
@@ -376,9 +430,32 @@ public class MediaStoreCore: PeripheralCore, MediaStore {
     private(set) public var photoResourceCount = 0
     private(set) public var videoResourceCount = 0
 
-    /// `true` if the mediastore content has changed.
+    /// `true` if the mediastore content has changed and must be browsed again.
     private var storeContentChanged = false
 
+    /// `true` if the media index has been incrementally updated since last notification.
+    private var mediaIndexChanged = false
+
+    /// Local index of the media store content, `nil` when it has to be loaded with a full browse.
+    ///
+    /// Only maintained while at least one listener is registered.
+    private(set) var mediaIndex: [MediaItemCore]?
+
+    /// Running full browse request, `nil` if there is none
+    private var browseRequest: CancelableCore?
+
+    /// Identifies the current browse request, to discard the completion of cancelled requests
+    private var browseGeneration = 0
+
+    /// `true` if the content changed while a full browse was running, so the browse result may be outdated
+    private var contentChangedDuringBrowse = false
+
+    /// Number of full browses of the media store content. Debug purpose only.
+    private(set) public var fullRefreshCount = 0
+
+    /// Number of incremental updates applied to the media index. Debug purpose only.
+    private(set) public var incrementalRefreshCount = 0
+
     /// Constructor
     ///
     /// - Parameters:
@@ -476,10 +553,112 @@ public class MediaStoreCore: PeripheralCore, MediaStore {
 
     /// Reset component state. Called when the component is unpublished.
     override func reset() {
+        dropMediaIndex()
         listeners.forEach {$0.didChange()}
         thumbnailCache.clear()
     }
 
+    /// Loads the media index with a full browse of the media store content, unless a browse is already running.
+    ///
+    /// Listeners are notified when the index has been loaded. When there is no index yet, they are also notified each
+    /// time a chunk of medias has been received, the index then containing the medias received so far.
+    func loadMediaIndex() {
+        guard browseRequest == nil else {
+            return
+        }
+        browseGeneration += 1
+        let generation = browseGeneration
+        contentChangedDuringBrowse = false
+        fullRefreshCount += 1
+        var completed = false
+        // when there is no index yet, publish medias as soon as they are received
+        let progressive = mediaIndex == nil
+        var partialIndex: [MediaItemCore] = []
+        let request = backend.browse(chunk: { [weak self] medias in
+            guard let `self` = self, generation == `self`.browseGeneration, progressive,
+                !`self`.contentChangedDuringBrowse else {
+                return
+            }
+            partialIndex.append(contentsOf: medias)
+            `self`.mediaIndex = partialIndex
+            `self`.listeners.forEach {$0.didChange()}
+        }, completion: { [weak self] medias in
+            // backend may call the completion after the request has been cancelled
+            guard let `self` = self, generation == `self`.browseGeneration else {
+                return
+            }
+            completed = true
+            `self`.browseRequest = nil
+            if `self`.contentChangedDuringBrowse {
+                // result may miss the latest changes, browse again
+                `self`.loadMediaIndex()
+                return
+            }
+            // copy user data into the new items
+            if let currentIndex = `self`.mediaIndex {
+                let currentMedias = Dictionary(currentIndex.map { ($0.uid, $0) }, uniquingKeysWith: { $1 })
+                for media in medias {
+                    media.userData = currentMedias[media.uid]?.userData
+                }
+            }
+            `self`.mediaIndex = medias
+            `self`.listeners.forEach {$0.didChange()}
+        })
+        if !completed {
+            browseRequest = request
+        }
+    }
+
+    /// Drops the media index and cancels the running browse, if any.
+    private func dropMediaIndex() {
+        browseRequest?.cancel()
+        browseRequest = nil
+        browseGeneration += 1
+        mediaIndex = nil
+        mediaIndexChanged = false
+    }
+
+    /// Applies an incremental content change to the media index.
+    ///
+    /// - Parameter change: content change to apply
+    /// - Returns: `false` if the change does not match the index, which must then be fully reloaded
+    private func applyToMediaIndex(_ change: MediaStoreContentChange) -> Bool {
+        guard var index = mediaIndex else {
+            return true
+        }
+        switch change {
+        case .mediaCreated(let media):
+            if let idx = index.index(where: { $0.uid == media.uid }) {
+                media.userData = index[idx].userData
+                index[idx] = media
+            } else {
+                index.append(media)
+            }
+        case .mediaRemoved(let uid):
+            index.removeAll { $0.uid == uid }
+        case .resourceCreated(let mediaUid, let resource):
+            guard let idx = index.index(where: { $0.uid == mediaUid }) else {
+                return false
+            }
+            let resources = index[idx].resources.filter { $0.uid != resource.uid } as! [MediaItemResourceCore]
+            index[idx] = index[idx].copy(resources: resources + [resource])
+        case .resourceRemoved(let uid):
+            guard let idx = index.index(where: { media in media.resources.contains { $0.uid == uid } }) else {
+                return false
+            }
+            let resources = index[idx].resources.filter { $0.uid != uid } as! [MediaItemResourceCore]
+            if resources.isEmpty {
+                index.remove(at: idx)
+            } else {
+                index[idx] = index[idx].copy(resources: resources)
+            }
+        case .allMediaRemoved:
+            index.removeAll()
+        }
+        mediaIndex = index
+        return true
+    }
+
     /// Register a mediaStore listener
     ///
     /// - Parameter didChange: closure to call when the store content changes
@@ -500,14 +679,23 @@ public class MediaStoreCore: PeripheralCore, MediaStore {
         listeners.remove(listener)
         if listeners.isEmpty {
             backend.stopWatchingContentChanges()
+            // content is not watched anymore, the index would get outdated
+            dropMediaIndex()
         }
     }
 
     /// Notify changes made by previously called setters
     public override func notifyUpdated() {
-        // store content changed, notify listeners
         if storeContentChanged {
+            // store content changed, browse it again; listeners are notified once the index is loaded
             storeContentChanged = false
+            mediaIndexChanged = false
+            if !listeners.isEmpty {
+                loadMediaIndex()
+            }
+        } else if mediaIndexChanged {
+            // index incrementally updated, notify listeners
+            mediaIndexChanged = false
             listeners.forEach {$0.didChange()}
         }
         super.notifyUpdated()
@@ -650,8 +838,37 @@ extension MediaStoreCore {
     /// - Note: Changes are not notified until notifyUpdated() is called.
     @discardableResult
     public func markContentChanged() -> MediaStoreCore {
-        storeContentChanged = true
+        if browseRequest != nil {
+            contentChangedDuringBrowse = true
+        } else {
+            mediaIndex = nil
+            storeContentChanged = true
+        }
         markChanged()
         return self
     }
+
+    /// Applies an incremental change of the media store content.
+    ///
+    /// The change is applied to the local media index. If the change cannot be applied, for instance because it
+    /// refers to an unknown media, the whole content is browsed again, like after `markContentChanged()`.
+    ///
+    /// - Parameter contentChange: content change
+    /// - Returns: self to allow call chaining
+    /// - Note: Changes are not notified until notifyUpdated() is called.
+    @discardableResult
+    public func update(contentChange: MediaStoreContentChange) -> MediaStoreCore {
+        if browseRequest != nil {
+            contentChangedDuringBrowse = true
+        } else if mediaIndex != nil {
+            if applyToMediaIndex(contentChange) {
+                incrementalRefreshCount += 1
+                mediaIndexChanged = true
+                markChanged()
+            } else {
+                markContentChanged()
+            }
+        }
+        return self
+    }
 }
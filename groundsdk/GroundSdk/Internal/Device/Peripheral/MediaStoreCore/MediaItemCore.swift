@@ -65,6 +65,21 @@ public class MediaItemCore: MediaItem {
                    resources: resources, metadataTypes: metadataTypes)
         resources.forEach { ($0 as! MediaItemResourceCore).media = self }
     }
+
+    /// Creates a copy of this media with another set of resources.
+    ///
+    /// User data are kept in the copy.
+    ///
+    /// - Parameter resources: resources of the copy
+    /// - Returns: a new media, identical to this one except for its resources
+    func copy(resources: [MediaItemResourceCore]) -> MediaItemCore {
+        let media = MediaItemCore(
+            uid: uid, name: name, type: type, runUid: runUid, creationDate: creationDate, expectedCount: expectedCount,
+            photoMode: photoMode, panoramaType: panoramaType, streamUrl: streamUrl, resources: resources,
+            backendData: backendData, metadataTypes: metadataTypes)
+        media.userData = userData
+        return media
+    }
 }
 
 /// MediaItem.Resource implementation. Add `core` public constructor
@@ -35,8 +35,6 @@ class MediaListRefCore: Ref<[MediaItem]> {
     private let mediaStore: MediaStoreCore
     /// Media store listener
     private var mediaStoreListener: MediaStoreCore.Listener!
-    /// Running media browse request, nil if there are no queries running
-    private var request: CancelableCore?
 
     /// Constructor
     ///
@@ -52,37 +50,22 @@ class MediaListRefCore: Ref<[MediaItem]> {
             self.updateMediaList()
         }
         setup(value: nil)
-        // send the initial query
+        // get the initial list
         updateMediaList()
     }
 
     /// destructor
     deinit {
-        if let request = request {
-            request.cancel()
-        }
         mediaStore.unregister(listener: mediaStoreListener)
     }
 
-    /// Send a request to load media list
+    /// Updates the media list from the media store index, loading the index if needed
     private func updateMediaList() {
         if mediaStore.published {
-            if request == nil {
-                request = mediaStore.backend.browse { [weak self] medias in
-
-                    // weak self in case backend call callback after cancelling request
-                    if let `self` = self {
-                        `self`.request = nil
-                        // copy user data into the new items
-                        if let currentList = self.value as? [MediaItemCore] {
-                            for media in medias {
-                                media.userData = currentList.first(where: {return $0.uid == media.uid})?.userData
-                            }
-                        }
-                        // update the ref with the new list
-                        `self`.update(newValue: medias)
-                    }
-                }
+            if let medias = mediaStore.mediaIndex {
+                update(newValue: medias)
+            } else {
+                mediaStore.loadMediaIndex()
             }
         } else {
             // not published, set the media list to nil
@@ -47,6 +47,26 @@ public class MediaStoreThumbnailCacheCore {
             case .resource(let media, let resource): return media.uid + resource.uid
             }
         }
+
+        /// Key of the thumbnail in the disk cache.
+        /// Made of the owner uid and of a fingerprint of the owner content, so that a media recreated with the same
+        /// uid doesn't get the thumbnail of the previous one. This key is only unique for a given drone.
+        var diskKey: String {
+            let key: String
+            switch self {
+            case .media(let media):
+                key = "\(media.uid)-\(Int64(media.creationDate.timeIntervalSince1970))-" +
+                    "\(media.resources.reduce(0) { $0 + $1.size })"
+            case .resource(let media, let resource):
+                key = "\(media.uid)-\(resource.uid)-\(Int64(resource.creationDate.timeIntervalSince1970))-" +
+                    "\(resource.size)"
+            }
+            return key.addingPercentEncoding(withAllowedCharacters: ThumbnailOwner.diskKeyAllowedCharacters) ?? key
+        }
+
+        /// Characters that are not escaped in disk keys, which are used as file names
+        private static let diskKeyAllowedCharacters = CharacterSet.alphanumerics
+            .union(CharacterSet(charactersIn: "-_."))
     }
 
     /// A request for a thumbnail
@@ -101,20 +121,50 @@ public class MediaStoreThumbnailCacheCore {
     private let downloadRequests = LinkedList<ThumbnailOwner>()
     /// Current download requests
     private var currentDownloadRequest: CancelableCore?
+    /// Identifier of the current download request, changed when the cache is cleared so that completions of canceled
+    /// requests are ignored
+    private var downloadGeneration = 0
+
+    /// Persistent cache, where downloaded thumbnails are stored and looked up before downloading them
+    private let diskCache: MediaStoreThumbnailDiskCache?
+
+    /// Number of thumbnails found in the disk cache. Debug purpose only.
+    private(set) public var diskHitCount = 0
+
+    /// Number of thumbnails not found in the disk cache. Debug purpose only.
+    private(set) public var diskMissCount = 0
+
+    /// Number of thumbnail bytes loaded from the disk cache instead of being downloaded. Debug purpose only.
+    private(set) public var diskBytesSaved = 0
+
+    /// Ratio of thumbnails found in the disk cache, from 0 to 1. Debug purpose only.
+    public var diskHitRate: Double {
+        let lookupCount = diskHitCount + diskMissCount
+        return lookupCount > 0 ? Double(diskHitCount) / Double(lookupCount) : 0
+    }
 
     /// Constructor
     ///
     /// - Parameters:
     ///   - mediaStoreBackend: media store backend
     ///   - size: maximum cache size
-    public init(mediaStoreBackend: MediaStoreBackend, size: Int) {
+    ///   - diskCacheDirectory: directory of the persistent cache, nil (default value) to only cache in memory. As
+    ///     thumbnail keys are only unique for a given drone, each drone must have its own directory.
+    ///   - diskCacheSize: maximum persistent cache size
+    public init(mediaStoreBackend: MediaStoreBackend, size: Int, diskCacheDirectory: URL? = nil,
+                diskCacheSize: Int = 0) {
         self.mediaStoreBackend = mediaStoreBackend
         self.maxSize = size
+        diskCache = diskCacheDirectory.map { MediaStoreThumbnailDiskCache(directory: $0, maxSize: diskCacheSize) }
     }
 
     /// Clear cache content, stop all pending requests
+    ///
+    /// The persistent cache content is kept.
     func clear() {
         currentDownloadRequest?.cancel()
+        currentDownloadRequest = nil
+        downloadGeneration += 1
         downloadRequests.reset()
         cacheLru.reset()
         cache.removeAll()
@@ -212,21 +262,62 @@ public class MediaStoreThumbnailCacheCore {
     }
 
     /// Send the request to download the next thumbnail if there are no active request
+    ///
+    /// The thumbnail is looked up in the persistent cache first, if any.
     private func downloadNextThumbnail() {
         if currentDownloadRequest == nil {
             if let downloadRequest = downloadRequests.pop() {
-                ULog.d(.coreMediaTag, "downloading thumbnail \(downloadRequest.content!.uid)")
-                currentDownloadRequest = mediaStoreBackend
-                    .downloadThumbnail(for: downloadRequest.content!) { [unowned self] thumbnailData in
-                        self.insertThumbnailInCache(
-                            mediaUid: downloadRequest.content!.uid, thumbnailData: thumbnailData)
+                let owner = downloadRequest.content!
+                if let diskCache = diskCache {
+                    let generation = downloadGeneration
+                    currentDownloadRequest = diskCache.load(key: owner.diskKey) { [weak self] thumbnailData in
+                        // ignore the load if the cache has been deleted or cleared meanwhile: the owner may have been
+                        // requested again, and is then already queued
+                        guard let `self` = self, generation == self.downloadGeneration else {
+                            return
+                        }
                         self.currentDownloadRequest = nil
-                        self.downloadNextThumbnail()
+                        if let thumbnailData = thumbnailData {
+                            ULog.d(.coreMediaTag, "loaded stored thumbnail \(owner.uid)")
+                            self.diskHitCount += 1
+                            self.diskBytesSaved += thumbnailData.count
+                            self.insertThumbnailInCache(mediaUid: owner.uid, thumbnailData: thumbnailData)
+                            self.downloadNextThumbnail()
+                        } else if self.cache[owner.uid] != nil {
+                            self.diskMissCount += 1
+                            self.downloadThumbnail(for: owner)
+                        } else {
+                            // cache cleared while looking up the thumbnail
+                            self.downloadNextThumbnail()
+                        }
+                    }
+                } else {
+                    downloadThumbnail(for: owner)
                 }
             }
         }
     }
 
+    /// Send the request to download a thumbnail
+    ///
+    /// - Parameter owner: owner to download the thumbnail for
+    private func downloadThumbnail(for owner: ThumbnailOwner) {
+        ULog.d(.coreMediaTag, "downloading thumbnail \(owner.uid)")
+        let generation = downloadGeneration
+        currentDownloadRequest = mediaStoreBackend.downloadThumbnail(for: owner) { [unowned self] thumbnailData in
+            guard generation == self.downloadGeneration else {
+                // download canceled by a cache clear
+                return
+            }
+            if let thumbnailData = thumbnailData {
+                self.diskCache?.store(key: owner.diskKey, data: thumbnailData)
+            }
+            self.insertThumbnailInCache(mediaUid: owner.uid, thumbnailData: thumbnailData)
+            self.currentDownloadRequest = nil
+            self.downloadNextThumbnail()
+        }
+    }
+
     /// Insert a downloaded thumbnail into the cache
     ///
     /// - Parameters:
@@ -0,0 +1,202 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+
+import Foundation
+
+/// Persistent media store thumbnail cache.
+///
+/// Thumbnails are stored as files in a directory, up to a maximum total size. Least recently used thumbnails are
+/// removed first when this size is exceeded. The index of stored thumbnails is loaded from the directory on first
+/// access.
+///
+/// Files are accessed in a background queue, completion callbacks are called on the main thread.
+class MediaStoreThumbnailDiskCache {
+
+    /// A stored thumbnail
+    private struct Entry {
+        /// Thumbnail key, also used as file name
+        let key: String
+        /// Thumbnail size, in bytes
+        let size: Int
+    }
+
+    /// A thumbnail load request
+    private class LoadRequest: CancelableCore {
+        /// `true` if the request has been canceled
+        var canceled = false
+
+        func cancel() {
+            canceled = true
+        }
+    }
+
+    /// Directory where thumbnails are stored
+    private let directory: URL
+    /// Maximum total size of the stored thumbnails
+    private let maxSize: Int
+    /// Queue where files and index are accessed
+    private let ioQueue = DispatchQueue(label: "MediaStoreThumbnailDiskCache")
+    /// Stored thumbnails, by key. Nil until loaded from the directory. Only accessed in `ioQueue`.
+    private var index: [String: LinkedListNode<Entry>]?
+    /// Stored thumbnails, by usage order. Only accessed in `ioQueue`.
+    private let lru = LinkedList<Entry>()
+    /// Total size of the stored thumbnails. Only accessed in `ioQueue`.
+    private var totalSize = 0
+
+    /// Constructor
+    ///
+    /// - Parameters:
+    ///   - directory: directory where thumbnails are stored
+    ///   - maxSize: maximum total size of the stored thumbnails
+    init(directory: URL, maxSize: Int) {
+        self.directory = directory
+        self.maxSize = maxSize
+    }
+
+    /// Loads a thumbnail.
+    ///
+    /// - Parameters:
+    ///   - key: thumbnail key
+    ///   - completion: callback called on the main thread with the thumbnail data, nil if the thumbnail is not stored
+    ///     or if the request has been canceled
+    ///   - data: thumbnail data
+    /// - Returns: the request
+    func load(key: String, completion: @escaping (_ data: Data?) -> Void) -> CancelableCore {
+        let request = LoadRequest()
+        ioQueue.async {
+            var data: Data?
+            if !request.canceled, let node = self.loadIndex()[key] {
+                let fileUrl = self.directory.appendingPathComponent(key)
+                data = try? Data(contentsOf: fileUrl)
+                if data != nil {
+                    // move to the top of the lru, and keep the order for next index load
+                    self.lru.remove(node)
+                    self.lru.push(node)
+                    try? FileManager.default.setAttributes(
+                        [.modificationDate: Date()], ofItemAtPath: fileUrl.path)
+                } else {
+                    self.remove(node)
+                }
+            }
+            DispatchQueue.main.async {
+                completion(request.canceled ? nil : data)
+            }
+        }
+        return request
+    }
+
+    /// Stores a thumbnail.
+    ///
+    /// - Parameters:
+    ///   - key: thumbnail key
+    ///   - data: thumbnail data
+    func store(key: String, data: Data) {
+        guard data.count <= maxSize else {
+            return
+        }
+        ioQueue.async {
+            if let node = self.loadIndex()[key] {
+                self.remove(node)
+            }
+            do {
+                try FileManager.default.createDirectory(at: self.directory, withIntermediateDirectories: true,
+                                                        attributes: nil)
+                try data.write(to: self.directory.appendingPathComponent(key), options: .atomic)
+            } catch let error {
+                ULog.w(.coreMediaTag, "Failed to store thumbnail \(key): \(error.localizedDescription)")
+                return
+            }
+            let node = LinkedListNode(content: Entry(key: key, size: data.count))
+            self.index?[key] = node
+            self.lru.push(node)
+            self.totalSize += data.count
+            self.cleanOldEntries()
+        }
+    }
+
+    /// Gets the index of stored thumbnails, loading it from the directory if not loaded yet.
+    ///
+    /// Must be called in `ioQueue`.
+    ///
+    /// - Returns: the index
+    private func loadIndex() -> [String: LinkedListNode<Entry>] {
+        if let index = index {
+            return index
+        }
+        var index = [String: LinkedListNode<Entry>]()
+        let files = (try? FileManager.default.contentsOfDirectory(
+            at: directory, includingPropertiesForKeys: [.fileSizeKey, .contentModificationDateKey])) ?? []
+        let entries: [(key: String, size: Int, date: Date)] = files.compactMap { fileUrl in
+            guard let values = try? fileUrl.resourceValues(forKeys: [.fileSizeKey, .contentModificationDateKey]),
+                let size = values.fileSize, let date = values.contentModificationDate else {
+                return nil
+            }
+            return (key: fileUrl.lastPathComponent, size: size, date: date)
+        }
+        // push from the least to the most recently used
+        for entry in entries.sorted(by: { $0.date < $1.date }) {
+            let node = LinkedListNode(content: Entry(key: entry.key, size: entry.size))
+            index[entry.key] = node
+            lru.push(node)
+            totalSize += entry.size
+        }
+        self.index = index
+        ULog.d(.coreMediaTag, "loaded thumbnail disk cache: \(index.count) thumbnails, \(totalSize) bytes")
+        cleanOldEntries()
+        return self.index!
+    }
+
+    /// Removes a stored thumbnail.
+    ///
+    /// Must be called in `ioQueue`, once the index is loaded.
+    ///
+    /// - Parameter node: node of the thumbnail to remove
+    private func remove(_ node: LinkedListNode<Entry>) {
+        let entry = node.content!
+        lru.remove(node)
+        index?[entry.key] = nil
+        totalSize -= entry.size
+        try? FileManager.default.removeItem(at: directory.appendingPathComponent(entry.key))
+    }
+
+    /// Removes least recently used thumbnails until the total size is lower than the maximum size.
+    ///
+    /// Must be called in `ioQueue`, once the index is loaded.
+    private func cleanOldEntries() {
+        lru.reverseWalk { node in
+            guard totalSize > maxSize else {
+                return false
+            }
+            ULog.d(.coreMediaTag, "removing stored thumbnail \(node.content!.key)")
+            remove(node)
+            return true
+        }
+    }
+}
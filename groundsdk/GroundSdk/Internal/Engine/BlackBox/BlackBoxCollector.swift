@@ -55,6 +55,9 @@ class BlackBoxCollector {
     /// File extension of a non finalized report
     fileprivate static let nonFinalizedFileExtension = "tmp"
 
+    /// Size of the json and compressed chunks written when archiving a black box
+    private static let archiveChunkSize = 16 * 1024
+
     /// Blackbox public folder
     private var blackboxPublicFolder: String? = GroundSdkConfig.sharedInstance.blackboxPublicFolder
 
@@ -139,6 +142,10 @@ class BlackBoxCollector {
 
     /// Archive a black box data on the file system (onto a black box report file).
     ///
+    /// The data is written as a gzip compressed json file, named by its md5 hash. Data conforming to
+    /// `JsonStreamEncodable` is encoded and compressed piece by piece, so that memory usage does not grow with the
+    /// black box size.
+    ///
     /// - Parameters:
     ///   - blackBoxData: the black box encodable data
     ///   - blackBoxArchived: the callback that will be called if the archive task succeed.
@@ -153,23 +160,39 @@ class BlackBoxCollector {
                 return
             }
 
-            let encodedBlackBoxData: Data
+            // stream the json text through gzip to a temporary file, the md5 naming the report is only known at the end
+            let tmpFileUrl = self.workDir.appendingPathComponent(UUID().uuidString)
+                .appendingPathExtension(BlackBoxCollector.nonFinalizedFileExtension)
+            guard let gzipWriter = GzipFileWriter(fileUrl: tmpFileUrl, chunkSize: BlackBoxCollector.archiveChunkSize)
+                else {
+                    ULog.e(.blackBoxEngineTag, "Failed to create file at \(tmpFileUrl.path)")
+                    return
+            }
+            let jsonWriter = JsonStreamWriter(
+                encoder: self.jsonEncoder, bufferSize: BlackBoxCollector.archiveChunkSize) {
+                guard gzipWriter.write($0) else {
+                    throw StreamWriterError.write
+                }
+            }
             do {
-                encodedBlackBoxData = try self.jsonEncoder.encode(blackBoxData)
+                if let streamEncodable = blackBoxData as? JsonStreamEncodable {
+                    try streamEncodable.write(to: jsonWriter)
+                } else {
+                    try jsonWriter.write(blackBoxData)
+                }
+                try jsonWriter.flush()
             } catch let err {
+                gzipWriter.abort()
                 ULog.e(.blackBoxEngineTag, "Failed to encode data: \(err)")
                 return
             }
 
-            guard let gzipedBlackBox = (encodedBlackBoxData as NSData).compress() else {
+            guard gzipWriter.finish(), let blackBoxMd5 = gzipWriter.md5 else {
                 ULog.e(.blackBoxEngineTag, "Failed to gzip blackbox data.")
                 return
             }
 
-            let blackBoxMd5 = (gzipedBlackBox as NSData).computeMd5()
             let finalizedFileUrl = self.workDir.appendingPathComponent(blackBoxMd5)
-            let tmpFileUrl = finalizedFileUrl.appendingPathExtension(BlackBoxCollector.nonFinalizedFileExtension)
-            FileManager.default.createFile(atPath: tmpFileUrl.path, contents: gzipedBlackBox, attributes: nil)
             do {
                 try FileManager.default.moveItem(at: tmpFileUrl, to: finalizedFileUrl)
             } catch let err {
@@ -70,6 +70,32 @@ public class HttpSessionCore: NSObject {
         let callback: (_ result: Result, _ localFileUrl: URL?) -> Void
     }
 
+    /// An object representing the callbacks of a data stream task
+    private class DataStreamCb {
+        /// The callback to call, in the delegate queue, when the response is received
+        let didReceiveResponse: ((_ response: HTTPURLResponse) throws -> Void)?
+        /// The callback to call, in the delegate queue, each time data is received
+        let didReceive: (_ data: Data) throws -> Void
+        /// The callback to call when the request is complete or fails
+        let completion: (_ result: Result) -> Void
+        /// `true` if `didReceive` failed; the request is then already completed with an error.
+        /// Only accessed in the delegate queue.
+        var failed = false
+
+        /// Constructor
+        ///
+        /// - Parameters:
+        ///   - didReceiveResponse: callback called in the delegate queue when the response is received
+        ///   - didReceive: callback called in the delegate queue each time data is received
+        ///   - completion: callback called when the request is complete or fails
+        init(didReceiveResponse: ((_ response: HTTPURLResponse) throws -> Void)?,
+             didReceive: @escaping (_ data: Data) throws -> Void, completion: @escaping (_ result: Result) -> Void) {
+            self.didReceiveResponse = didReceiveResponse
+            self.didReceive = didReceive
+            self.completion = completion
+        }
+    }
+
     /// Url session
     private var session: URLSession!
     /// Map of progress callbacks indexed by task identifier
@@ -83,6 +109,12 @@ public class HttpSessionCore: NSObject {
     /// Map of streamWriter objects indexed by task identifier. This dictionary contains streamWriter object for
     /// task created with 'downloadFile(withStreamReader: _)` function
     private var streamWriters: [Int: StreamWriter] = [:]
+    /// Map of data stream callbacks indexed by task identifier. This dictionary contains callbacks for tasks created
+    /// with 'streamData' function
+    private var dataStreamCbs: [Int: DataStreamCb] = [:]
+
+    /// Http status codes of successful data stream tasks: complete or partial (range request) content
+    private static let dataStreamSuccessCodes: Set<Int> = [200, 206]
 
     /// Error raised when request has been canceled
     ///
@@ -155,6 +187,41 @@ public class HttpSessionCore: NSObject {
         return task
     }
 
+    /// Get data, handing it over as it is received instead of buffering the whole response
+    ///
+    /// - Note: The request is started in this function.
+    ///
+    /// - Parameters:
+    ///   - request: request to use
+    ///   - didReceiveResponse: callback called when the response is received. It is called in a background serial
+    ///                 queue, only when the response status is `200` or `206`. If it throws, the request is canceled
+    ///                 and completes with the thrown error. Default is nil.
+    ///   - response: the received response
+    ///   - didReceive: callback called each time data is received. It is called in a background serial queue, only
+    ///                 when the response status is `200` or `206`. If it throws, the request is canceled and completes
+    ///                 with the thrown error.
+    ///   - data: the received data
+    ///   - completion: completion callback, called on the main thread
+    ///   - result: the request result
+    /// - Returns: the request
+    public func streamData(
+        request: URLRequest, didReceiveResponse: ((_ response: HTTPURLResponse) throws -> Void)? = nil,
+        didReceive: @escaping (_ data: Data) throws -> Void,
+        completion: @escaping (_ result: Result) -> Void) -> CancelableCore {
+
+        var request = request
+        request.httpMethod = "GET"
+
+        var task: URLSessionTask!
+        task = session.dataTask(with: request)
+
+        dataStreamCbs[task.taskIdentifier] = DataStreamCb(
+            didReceiveResponse: didReceiveResponse, didReceive: didReceive, completion: completion)
+        task.resume()
+
+        return task
+    }
+
     /// Send data
     ///
     /// - Note: The request is started in this function.
@@ -323,6 +390,121 @@ public class HttpSessionCore: NSObject {
         return task
     }
 
+    /// Download a file with a get request, resuming a previous partial download, if any
+    ///
+    /// Received data is written in a partial file, which is kept when the request fails or is canceled. When this
+    /// partial file exists, only the missing bytes are requested, with a `Range` header. The whole file is received
+    /// again if the server does not honor this header. If the server rejects the range, the partial file is deleted
+    /// and the request completes with an `.httpError(416)`, so that the next request downloads the whole file. The
+    /// partial file is deleted too when it cannot be written, for example when the disk is full.
+    ///
+    /// - Note: The request is started in this function.
+    ///
+    /// - Parameters:
+    ///   - request: request to use
+    ///   - partialFileUrl: local url of the partial file
+    ///   - destination: destination local file url, where the partial file is moved once complete
+    ///   - progress: progress callback
+    ///   - progressValue: progress percentage of the whole file (from 0 to 100)
+    ///   - completion: completion callback
+    ///   - result: the request result
+    ///   - localFileUrl: the local file url of the downloaded file, nil if the download failed
+    /// - Returns: the request
+    public func downloadFile(
+        request: URLRequest, partialFileUrl: URL, destination: URL,
+        progress: @escaping (_ progressValue: Int) -> Void,
+        completion: @escaping (_ result: Result, _ localFileUrl: URL?) -> Void) -> CancelableCore {
+
+        var request = request
+        let partialSize = ((try? FileManager.default.attributesOfItem(atPath: partialFileUrl.path))?[.size]
+            as? NSNumber)?.int64Value ?? 0
+        if partialSize > 0 {
+            request.setValue("bytes=\(partialSize)-", forHTTPHeaderField: "Range")
+        }
+
+        // following variables are accessed in the delegate queue, then on completion
+        var outputStream: OutputStream?
+        var writeFailed = false
+        var receivedSize: Int64 = 0
+        var expectedSize: Int64 = 0
+        var lastProgress = -1
+
+        return streamData(request: request, didReceiveResponse: { response in
+            let fileManager = FileManager.default
+            if response.statusCode == 206 {
+                receivedSize = partialSize
+            } else {
+                // range not honored, the whole file is received
+                receivedSize = 0
+                try? fileManager.removeItem(at: partialFileUrl)
+            }
+            expectedSize = response.expectedContentLength >= 0 ? receivedSize + response.expectedContentLength : 0
+            try fileManager.createDirectory(
+                at: partialFileUrl.deletingLastPathComponent(), withIntermediateDirectories: true, attributes: nil)
+            // unlike FileHandle, output streams report write errors instead of raising exceptions
+            guard let stream = OutputStream(url: partialFileUrl, append: true) else {
+                throw StreamWriterError.openFile
+            }
+            stream.open()
+            guard stream.streamStatus == .open else {
+                throw stream.streamError ?? StreamWriterError.openFile
+            }
+            outputStream = stream
+        }, didReceive: { data in
+            if let outputStream = outputStream {
+                try data.withUnsafeBytes { (bytes: UnsafePointer<UInt8>) in
+                    var offset = 0
+                    while offset < data.count {
+                        let written = outputStream.write(bytes + offset, maxLength: data.count - offset)
+                        guard written > 0 else {
+                            writeFailed = true
+                            throw outputStream.streamError ?? StreamWriterError.write
+                        }
+                        offset += written
+                    }
+                }
+            }
+            receivedSize += Int64(data.count)
+            if expectedSize > 0 {
+                let progressValue = Int(receivedSize * 100 / expectedSize)
+                if progressValue != lastProgress {
+                    lastProgress = progressValue
+                    // as we are in the delegateQueue, executes the call back in main thread
+                    DispatchQueue.main.async {
+                        progress(progressValue)
+                    }
+                }
+            }
+        }, completion: { result in
+            outputStream?.close()
+            outputStream = nil
+
+            var localFileUrl: URL?
+            switch result {
+            case .success:
+                do {
+                    try? FileManager.default.removeItem(at: destination)
+                    try FileManager.default.createDirectory(
+                        at: destination.deletingLastPathComponent(), withIntermediateDirectories: true,
+                        attributes: nil)
+                    try FileManager.default.moveItem(at: partialFileUrl, to: destination)
+                    localFileUrl = destination
+                } catch let error {
+                    ULog.w(.httpClientTag, "Failed to move file at \(destination): " + error.localizedDescription)
+                }
+            case .httpError(416):
+                // partial file doesn't match the requested file
+                try? FileManager.default.removeItem(at: partialFileUrl)
+            default:
+                if writeFailed {
+                    try? FileManager.default.removeItem(at: partialFileUrl)
+                }
+                // otherwise keep the partial file to resume the download later
+            }
+            completion(result, localFileUrl)
+        })
+    }
+
     /// Request a delete
     ///
     /// - Parameters:
@@ -391,6 +573,52 @@ extension HttpSessionCore: URLSessionDelegate, URLSessionDataDelegate, URLSessio
                     }
                 }
             }
+        } else if let dataStreamCb = dataStreamCbs[dataTask.taskIdentifier], !dataStreamCb.failed {
+            // http error bodies are not handed over, the status is given by the completion
+            if let response = dataTask.response as? HTTPURLResponse,
+                !HttpSessionCore.dataStreamSuccessCodes.contains(response.statusCode) {
+                return
+            }
+            do {
+                try dataStreamCb.didReceive(data)
+            } catch {
+                fail(dataStreamCb, of: dataTask, with: error)
+            }
+        }
+    }
+
+    public func urlSession(
+        _ session: URLSession, dataTask: URLSessionDataTask, didReceive response: URLResponse,
+        completionHandler: @escaping (URLSession.ResponseDisposition) -> Void) {
+
+        if let dataStreamCb = dataStreamCbs[dataTask.taskIdentifier],
+            let didReceiveResponse = dataStreamCb.didReceiveResponse, let response = response as? HTTPURLResponse,
+            HttpSessionCore.dataStreamSuccessCodes.contains(response.statusCode) {
+            do {
+                try didReceiveResponse(response)
+            } catch {
+                fail(dataStreamCb, of: dataTask, with: error)
+            }
+        }
+        completionHandler(.allow)
+    }
+
+    /// Stops a data stream task after an error raised by one of its callbacks.
+    ///
+    /// Must be called in the delegate queue.
+    ///
+    /// - Parameters:
+    ///   - dataStreamCb: data stream task callbacks
+    ///   - dataTask: data stream task
+    ///   - error: raised error
+    private func fail(_ dataStreamCb: DataStreamCb, of dataTask: URLSessionDataTask, with error: Error) {
+        dataStreamCb.failed = true
+        dataTask.cancel()
+        // as we are in the delegateQueue, executes the call back in main thread
+        DispatchQueue.main.async {
+            ULog.e(.httpClientTag, "Data stream \(error.localizedDescription)")
+            self.dataStreamCbs[dataTask.taskIdentifier] = nil
+            dataStreamCb.completion(.error(error))
         }
     }
 
@@ -413,7 +641,7 @@ extension HttpSessionCore: URLSessionDelegate, URLSessionDataDelegate, URLSessio
 
     public func urlSession(_ session: URLSession, task: URLSessionTask, didCompleteWithError error: Error?) {
         // this function is only called when no completion closure is directly passed to the task, that happens
-        // on download tasks or for streamDownload Tasks
+        // on download tasks, for streamDownload Tasks or for dataStream tasks
 
         // if error is nil AND if the task is a `downloadTask', the result has already been handled by
         // `urlSession(:downloadTask:didFinishDownloadingTo:)`
@@ -478,6 +706,17 @@ extension HttpSessionCore: URLSessionDelegate, URLSessionDataDelegate, URLSessio
                 self.streamDlCompletionCbs[task.taskIdentifier] = nil
                 self.streamWriters[task.taskIdentifier] = nil
                 streamDownloadCb.callback(result, resultUrl)
+            } else if let dataStreamCb = self.dataStreamCbs[task.taskIdentifier] {
+                // The task is a "dataStream task", unlike download tasks http errors are not reported as errors
+                if case .success = result, let response = task.response as? HTTPURLResponse {
+                    if HttpSessionCore.dataStreamSuccessCodes.contains(response.statusCode) {
+                        result = .success(response.statusCode)
+                    } else {
+                        result = .httpError(response.statusCode)
+                    }
+                }
+                self.dataStreamCbs[task.taskIdentifier] = nil
+                dataStreamCb.completion(result)
             } else {
                 ULog.e(.httpClientTag, "Completion callback not found for task \(task.taskIdentifier)")
             }
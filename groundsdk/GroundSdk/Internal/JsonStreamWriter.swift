@@ -0,0 +1,400 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+
+import Foundation
+
+/// An encodable object that can be written piece by piece to a JSON stream, instead of being encoded at once.
+public protocol JsonStreamEncodable: Encodable {
+    /// Writes this object to a JSON stream.
+    ///
+    /// - Parameter writer: JSON stream writer
+    /// - Throws: encoding or sink error
+    func write(to writer: JsonStreamWriter) throws
+}
+
+/// Writes JSON text incrementally.
+///
+/// Objects and arrays are opened and closed explicitly, and values are encoded one at a time with a `JSONEncoder`.
+/// Written text is buffered and handed over to a sink each time the buffer is full, so that the whole JSON text is
+/// never held in memory.
+public class JsonStreamWriter {
+
+    /// Writer errors
+    public enum WriterError: Error {
+        /// Value encoded to an unexpected JSON text
+        case badEncoding
+    }
+
+    /// Encoder of the written values
+    private let encoder: JSONEncoder
+    /// Size over which the buffered text is handed over to the sink
+    private let bufferSize: Int
+    /// Sink receiving the JSON text
+    private let sink: (Data) throws -> Void
+    /// Buffered JSON text
+    private var buffer = Data()
+    /// For each open object or array, whether it already contains a value
+    private var containers = [Bool]()
+    /// JSON text of the non finite floating point values written by objects, `nil` if they can't be encoded
+    private let nonFiniteTexts: JsonObjectWriter.NonFiniteTexts?
+
+    /// Constructor
+    ///
+    /// - Parameters:
+    ///   - encoder: encoder of the written values
+    ///   - bufferSize: size over which the buffered text is handed over to the sink
+    ///   - sink: sink receiving the JSON text
+    public init(encoder: JSONEncoder = JSONEncoder(), bufferSize: Int = 16 * 1024,
+                sink: @escaping (Data) throws -> Void) {
+        self.encoder = encoder
+        self.bufferSize = bufferSize
+        self.sink = sink
+        buffer.reserveCapacity(bufferSize)
+        if case let .convertToString(positiveInfinity, negativeInfinity, nan) =
+            encoder.nonConformingFloatEncodingStrategy,
+            let positiveInfinityText = JsonStreamWriter.encode(string: positiveInfinity),
+            let negativeInfinityText = JsonStreamWriter.encode(string: negativeInfinity),
+            let nanText = JsonStreamWriter.encode(string: nan) {
+            nonFiniteTexts = JsonObjectWriter.NonFiniteTexts(
+                positiveInfinity: positiveInfinityText, negativeInfinity: negativeInfinityText, nan: nanText)
+        } else {
+            nonFiniteTexts = nil
+        }
+    }
+
+    /// Opens an object.
+    ///
+    /// - Parameter key: key of the object in the enclosing object, `nil` at top level or in an array
+    /// - Throws: sink error
+    public func beginObject(key: String? = nil) throws {
+        try begin(key: key, container: UInt8(ascii: "{"))
+    }
+
+    /// Closes the current object.
+    ///
+    /// - Throws: sink error
+    public func endObject() throws {
+        try end(container: UInt8(ascii: "}"))
+    }
+
+    /// Opens an array.
+    ///
+    /// - Parameter key: key of the array in the enclosing object, `nil` at top level or in an array
+    /// - Throws: sink error
+    public func beginArray(key: String? = nil) throws {
+        try begin(key: key, container: UInt8(ascii: "["))
+    }
+
+    /// Closes the current array.
+    ///
+    /// - Throws: sink error
+    public func endArray() throws {
+        try end(container: UInt8(ascii: "]"))
+    }
+
+    /// Writes a value.
+    ///
+    /// - Parameters:
+    ///   - value: value to write
+    ///   - key: key of the value in the enclosing object, `nil` at top level or in an array
+    /// - Throws: encoding or sink error
+    public func write<T: Encodable>(_ value: T, key: String? = nil) throws {
+        try writeSeparator(key: key)
+        try append(encode(value))
+    }
+
+    /// Writes a sequence as an array, encoding its elements one at a time.
+    ///
+    /// - Parameters:
+    ///   - elements: elements to write
+    ///   - key: key of the array in the enclosing object, `nil` at top level or in an array
+    /// - Throws: encoding or sink error
+    public func write<S: Sequence>(elements: S, key: String? = nil) throws where S.Element: Encodable {
+        try beginArray(key: key)
+        for element in elements {
+            try write(element)
+        }
+        try endArray()
+    }
+
+    /// Writes an object whose members are written directly as JSON text, without encoder.
+    ///
+    /// - Parameters:
+    ///   - key: key of the object in the enclosing object, `nil` at top level or in an array
+    ///   - body: closure writing the object members
+    /// - Throws: encoding or sink error
+    public func writeObject(key: String? = nil, _ body: (inout JsonObjectWriter) throws -> Void) throws {
+        try writeSeparator(key: key)
+        // hand over the buffer to the object writer, so that it is appended in place
+        var object = JsonObjectWriter(text: buffer, nonFiniteTexts: nonFiniteTexts)
+        buffer = Data()
+        object.begin()
+        do {
+            try body(&object)
+        } catch {
+            buffer = object.text
+            throw error
+        }
+        object.end()
+        buffer = object.text
+        if buffer.count >= bufferSize {
+            try flush()
+        }
+    }
+
+    /// Hands over the buffered text to the sink.
+    ///
+    /// - Throws: sink error
+    public func flush() throws {
+        if !buffer.isEmpty {
+            try sink(buffer)
+            buffer.removeAll(keepingCapacity: true)
+        }
+    }
+
+    /// Opens a container.
+    ///
+    /// - Parameters:
+    ///   - key: key of the container in the enclosing object, `nil` at top level or in an array
+    ///   - container: container opening character
+    /// - Throws: sink error
+    private func begin(key: String?, container: UInt8) throws {
+        try writeSeparator(key: key)
+        buffer.append(container)
+        containers.append(false)
+    }
+
+    /// Closes the current container.
+    ///
+    /// - Parameter container: container closing character
+    /// - Throws: sink error
+    private func end(container: UInt8) throws {
+        _ = containers.popLast()
+        try append(Data([container]))
+    }
+
+    /// Writes the separator from the previous value of the current container and the key of the next value.
+    ///
+    /// - Parameter key: key of the next value, `nil` at top level or in an array
+    /// - Throws: encoding error
+    private func writeSeparator(key: String?) throws {
+        if let hasValue = containers.last {
+            if hasValue {
+                buffer.append(UInt8(ascii: ","))
+            }
+            containers[containers.count - 1] = true
+        }
+        if let key = key {
+            buffer.append(try encode(key))
+            buffer.append(UInt8(ascii: ":"))
+        }
+    }
+
+    /// Encodes a value to JSON text.
+    ///
+    /// The value is encoded inside an array, since `JSONEncoder` rejects top level fragments such as numbers or
+    /// strings, and the enclosing brackets are removed.
+    ///
+    /// - Parameter value: value to encode
+    /// - Returns: JSON text of the value
+    /// - Throws: encoding error
+    private func encode<T: Encodable>(_ value: T) throws -> Data {
+        let data = try encoder.encode([value])
+        guard data.count >= 2 && data.first == UInt8(ascii: "[") && data.last == UInt8(ascii: "]") else {
+            throw WriterError.badEncoding
+        }
+        return data.subdata(in: 1..<data.count - 1)
+    }
+
+    /// Encodes a string to JSON text.
+    ///
+    /// - Parameter string: string to encode
+    /// - Returns: JSON text of the string, `nil` if it could not be encoded
+    private static func encode(string: String) -> Data? {
+        guard let data = try? JSONEncoder().encode([string]), data.count >= 2 else {
+            return nil
+        }
+        return data.subdata(in: 1..<data.count - 1)
+    }
+
+    /// Appends text to the buffer, handing over the buffer to the sink once full.
+    ///
+    /// - Parameter data: text to append
+    /// - Throws: sink error
+    private func append(_ data: Data) throws {
+        buffer.append(data)
+        if buffer.count >= bufferSize {
+            try flush()
+        }
+    }
+}
+
+/// Writes the members of a JSON object directly as JSON text.
+///
+/// Keys are written without escaping, they must not contain quotes, backslashes or control characters.
+///
+/// Non finite floating point values follow the `nonConformingFloatEncodingStrategy` of the `JsonStreamWriter`
+/// encoder, like encoded values. Finite ones are written in their shortest form that reads back to the same value,
+/// which may have fewer digits than the `JSONEncoder` text: a float member `0.1` is written `0.1`, whereas the
+/// encoder may write the digits of its double conversion.
+public struct JsonObjectWriter {
+
+    /// JSON text of the non finite floating point values
+    struct NonFiniteTexts {
+        /// Positive infinity text
+        let positiveInfinity: Data
+        /// Negative infinity text
+        let negativeInfinity: Data
+        /// Not a number text
+        let nan: Data
+    }
+
+    /// JSON text
+    fileprivate var text: Data
+    /// JSON text of the non finite floating point values, `nil` if they can't be encoded
+    private let nonFiniteTexts: NonFiniteTexts?
+    /// Whether a member has already been written in the object
+    private var hasMember = false
+
+    /// Constructor
+    ///
+    /// - Parameters:
+    ///   - text: JSON text to append the object to
+    ///   - nonFiniteTexts: JSON text of the non finite floating point values, `nil` if they can't be encoded
+    fileprivate init(text: Data, nonFiniteTexts: NonFiniteTexts?) {
+        self.text = text
+        self.nonFiniteTexts = nonFiniteTexts
+    }
+
+    /// Writes a double member.
+    ///
+    /// - Parameters:
+    ///   - value: member value
+    ///   - key: member key
+    /// - Throws: `EncodingError.invalidValue` if the value is not finite and can't be encoded
+    public mutating func write(_ value: Double, key: String) throws {
+        if value.isFinite {
+            writeKey(key)
+            text.append(contentsOf: value.description.utf8)
+        } else {
+            try writeNonFinite(value, key: key)
+        }
+    }
+
+    /// Writes a float member.
+    ///
+    /// - Parameters:
+    ///   - value: member value
+    ///   - key: member key
+    /// - Throws: `EncodingError.invalidValue` if the value is not finite and can't be encoded
+    public mutating func write(_ value: Float, key: String) throws {
+        if value.isFinite {
+            writeKey(key)
+            text.append(contentsOf: value.description.utf8)
+        } else {
+            try writeNonFinite(value, key: key)
+        }
+    }
+
+    /// Writes an integer member.
+    ///
+    /// - Parameters:
+    ///   - value: member value
+    ///   - key: member key
+    public mutating func write<T: BinaryInteger>(_ value: T, key: String) {
+        writeKey(key)
+        text.append(contentsOf: String(value).utf8)
+    }
+
+    /// Writes an object member.
+    ///
+    /// - Parameters:
+    ///   - key: member key
+    ///   - body: closure writing the object members
+    /// - Throws: error thrown by `body`
+    public mutating func writeObject(key: String, _ body: (inout JsonObjectWriter) throws -> Void) rethrows {
+        writeKey(key)
+        var object = JsonObjectWriter(text: text, nonFiniteTexts: nonFiniteTexts)
+        text = Data()
+        object.begin()
+        do {
+            try body(&object)
+        } catch {
+            text = object.text
+            throw error
+        }
+        object.end()
+        text = object.text
+    }
+
+    /// Opens the object.
+    fileprivate mutating func begin() {
+        text.append(UInt8(ascii: "{"))
+    }
+
+    /// Closes the object.
+    fileprivate mutating func end() {
+        text.append(UInt8(ascii: "}"))
+    }
+
+    /// Writes a non finite floating point member, as `JSONEncoder` does.
+    ///
+    /// - Parameters:
+    ///   - value: member value
+    ///   - key: member key
+    /// - Throws: `EncodingError.invalidValue` if non finite values can't be encoded
+    private mutating func writeNonFinite<T: FloatingPoint>(_ value: T, key: String) throws {
+        guard let nonFiniteTexts = nonFiniteTexts else {
+            throw EncodingError.invalidValue(value, EncodingError.Context(
+                codingPath: [], debugDescription: "Unable to encode \(value) directly in JSON."))
+        }
+        writeKey(key)
+        if value.isNaN {
+            text.append(nonFiniteTexts.nan)
+        } else if value < 0 {
+            text.append(nonFiniteTexts.negativeInfinity)
+        } else {
+            text.append(nonFiniteTexts.positiveInfinity)
+        }
+    }
+
+    /// Writes the separator from the previous member and the key of the next member.
+    ///
+    /// - Parameter key: member key
+    private mutating func writeKey(_ key: String) {
+        if hasMember {
+            text.append(UInt8(ascii: ","))
+        }
+        hasMember = true
+        text.append(UInt8(ascii: "\""))
+        text.append(contentsOf: key.utf8)
+        text.append(contentsOf: "\":".utf8)
+    }
+}
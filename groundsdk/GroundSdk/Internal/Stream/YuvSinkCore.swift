@@ -29,7 +29,19 @@
 
 import Foundation
 
+/// YUV sink consumer frame counters.
+public struct YuvSinkConsumerStats {
+    /// Number of frames delivered to the consumer listener.
+    public internal(set) var delivered = 0
+    /// Number of frames dropped because the consumer queue was full, or because the sink was closed or the consumer
+    /// listener released before they could be delivered.
+    public internal(set) var dropped = 0
+}
+
 /// Internal YuvSink implementation.
+///
+/// The sink opens a single PDRAW sink and shares each received frame between all its consumers. Each consumer owns a
+/// bounded frame queue, drained on its own dispatch queue, so that a slow consumer only drops its own frames.
 public class YuvSinkCore: SinkCore {
 
     /// YUV sink configuration.
@@ -41,14 +53,33 @@ public class YuvSinkCore: SinkCore {
         /// Sink listener.
         public private(set) weak var listener: YuvSinkListener?
 
+        /// `true` if delivered frames reference the decoder buffers instead of being copied.
+        ///
+        /// Avoids copying each decoded frame, but frames must then be released as soon as they are processed, the
+        /// decoder being unable to output new frames while all its buffers are retained.
+        public private(set) var zeroCopy: Bool
+
+        /// Maximum number of frames waiting to be processed, in the sink and in each consumer queue.
+        public private(set) var queueSize: UInt32
+
+        /// Policy applied when a frame is received while a queue is full.
+        public private(set) var policy: SdkCoreSinkQueueFullPolicy
+
         /// Constructor
         ///
         /// - Parameters:
         ///    - queue: queue into which callback are dispatched
         ///    - listener: sink listener
-        public init(queue: DispatchQueue, listener: YuvSinkListener) {
+        ///    - zeroCopy: `true` if delivered frames reference the decoder buffers instead of being copied
+        ///    - queueSize: maximum number of frames waiting to be processed
+        ///    - policy: policy applied when a frame is received while a queue is full
+        public init(queue: DispatchQueue, listener: YuvSinkListener, zeroCopy: Bool = false, queueSize: UInt32 = 1,
+                    policy: SdkCoreSinkQueueFullPolicy = .dropEldest) {
             self.queue = queue
             self.listener = listener
+            self.zeroCopy = zeroCopy
+            self.queueSize = max(queueSize, 1)
+            self.policy = policy
         }
 
         public func openSink(stream: StreamCore) -> SinkCore {
@@ -56,6 +87,146 @@ public class YuvSinkCore: SinkCore {
         }
     }
 
+    /// A sink consumer, receiving frames on its own dispatch queue.
+    private class Consumer {
+
+        /// Queue into which callback are dispatched.
+        let queue: DispatchQueue
+
+        /// Consumer listener.
+        private(set) weak var listener: YuvSinkListener?
+
+        /// Maximum number of pending frames.
+        private let capacity: Int
+
+        /// Policy applied when a frame is received while `pending` is full.
+        private let policy: SdkCoreSinkQueueFullPolicy
+
+        /// Lock protecting `pending`, `pendingHead`, `pendingCount`, `drainScheduled` and `stats`.
+        private let lock = NSLock()
+
+        /// Frames waiting to be delivered, ring buffer of `capacity` slots starting at `pendingHead`.
+        private var pending: [SdkCoreFrame?]
+
+        /// Index in `pending` of the eldest frame waiting to be delivered.
+        private var pendingHead = 0
+
+        /// Number of frames waiting to be delivered.
+        private var pendingCount = 0
+
+        /// `true` when a drain block has been dispatched on `queue` and has not finished yet.
+        private var drainScheduled = false
+
+        /// Frame counters.
+        private var _stats = YuvSinkConsumerStats()
+
+        /// Frame counters.
+        var stats: YuvSinkConsumerStats {
+            lock.lock()
+            defer { lock.unlock() }
+            return _stats
+        }
+
+        /// Constructor
+        ///
+        /// - Parameters:
+        ///    - queue: queue into which callback are dispatched
+        ///    - listener: consumer listener
+        ///    - capacity: maximum number of pending frames
+        ///    - policy: policy applied when a frame is received while the consumer queue is full
+        init(queue: DispatchQueue, listener: YuvSinkListener, capacity: Int, policy: SdkCoreSinkQueueFullPolicy) {
+            self.queue = queue
+            self.listener = listener
+            self.capacity = capacity
+            self.policy = policy
+            pending = [SdkCoreFrame?](repeating: nil, count: capacity)
+        }
+
+        /// Queues a frame for delivery.
+        ///
+        /// Called in pomp thread.
+        ///
+        /// - Parameters:
+        ///    - frame: frame to deliver
+        ///    - sink: sink delivering the frame
+        func push(frame: SdkCoreFrame, sink: YuvSinkCore) {
+            lock.lock()
+            if pendingCount >= capacity {
+                _stats.dropped += 1
+                if policy == .dropEldest {
+                    // overwrite the eldest frame, the next one becomes the eldest
+                    pending[pendingHead] = frame
+                    pendingHead = (pendingHead + 1) % capacity
+                }
+            } else {
+                pending[(pendingHead + pendingCount) % capacity] = frame
+                pendingCount += 1
+            }
+            let scheduleDrain = !drainScheduled
+            drainScheduled = true
+            lock.unlock()
+
+            if scheduleDrain {
+                queue.async { [weak sink] in
+                    self.drain(sink: sink)
+                }
+            }
+        }
+
+        /// Delivers all pending frames to the listener.
+        ///
+        /// Pending frames are dropped if the sink is closed or if the listener has been released.
+        ///
+        /// Called on `queue`.
+        ///
+        /// - Parameter sink: sink delivering the frames, `nil` if closed
+        private func drain(sink: YuvSinkCore?) {
+            while true {
+                lock.lock()
+                guard pendingCount > 0, let sink = sink, let listener = listener else {
+                    _stats.dropped += pendingCount
+                    for index in 0..<capacity {
+                        pending[index] = nil
+                    }
+                    pendingHead = 0
+                    pendingCount = 0
+                    drainScheduled = false
+                    lock.unlock()
+                    return
+                }
+                let frame = pending[pendingHead]!
+                pending[pendingHead] = nil
+                pendingHead = (pendingHead + 1) % capacity
+                pendingCount -= 1
+                _stats.delivered += 1
+                lock.unlock()
+                listener.frameReady(sink: sink, frame: frame)
+            }
+        }
+
+        /// Notifies the listener that the sink has started.
+        ///
+        /// - Parameter sink: started sink
+        func notifyStart(sink: YuvSinkCore) {
+            queue.async { [weak sink] in
+                if let sink = sink {
+                    self.listener?.didStart(sink: sink)
+                }
+            }
+        }
+
+        /// Notifies the listener that the sink has stopped.
+        ///
+        /// - Parameter sink: stopped sink
+        func notifyStop(sink: YuvSinkCore) {
+            queue.async { [weak sink] in
+                if let sink = sink {
+                    self.listener?.didStop(sink: sink)
+                }
+            }
+        }
+    }
+
     /// Sink config.
     private let config: Config
 
@@ -68,6 +239,15 @@ public class YuvSinkCore: SinkCore {
     /// Listener notified of stream YUV media availability.
     private var mediaListener: YuvMediaListener!
 
+    /// Lock protecting `consumers` and `started`, accessed from the pomp thread when frames are received.
+    private let consumersLock = NSLock()
+
+    /// Sink consumers.
+    private var consumers: [Consumer] = []
+
+    /// `true` when the sink has started, and until it stops. Consumers added meanwhile are notified of the start.
+    private var started = false
+
     /// Constructor
     ///
     /// - Parameters:
@@ -76,11 +256,15 @@ public class YuvSinkCore: SinkCore {
     public init(stream: StreamCore, config: Config) {
         self.config = config
         super.init(streamCore: stream)
-        sdkCoreSink = SdkCoreSink(queueSize: 1,
-                                  policy: .dropEldest,
+        sdkCoreSink = SdkCoreSink(queueSize: config.queueSize,
+                                  policy: config.policy,
                                   format: .unspecified,
+                                  frameMode: config.zeroCopy ? .reference : .copy,
                                   listener: self)
         mediaListener = YuvMediaListener(sinkCore: self)
+        if let listener = config.listener {
+            addListener(queue: config.queue, listener: listener)
+        }
     }
 
     /// Create a YUV sink configuration.
@@ -88,9 +272,77 @@ public class YuvSinkCore: SinkCore {
     /// - Parameters:
     ///    - queue: queue into which callback are dispatched
     ///    - listener: sink listener
+    ///    - zeroCopy: `true` if delivered frames reference the decoder buffers instead of being copied
+    ///    - queueSize: maximum number of frames waiting to be processed
+    ///    - policy: policy applied when a frame is received while a queue is full
     /// - Returns: the YUV sink configuration
-    public static func config(queue: DispatchQueue, listener: YuvSinkListener) -> StreamSinkConfig {
-        return YuvSinkCore.Config(queue: queue, listener: listener)
+    public static func config(queue: DispatchQueue, listener: YuvSinkListener, zeroCopy: Bool = false,
+                              queueSize: UInt32 = 1,
+                              policy: SdkCoreSinkQueueFullPolicy = .dropEldest) -> StreamSinkConfig {
+        return YuvSinkCore.Config(queue: queue, listener: listener, zeroCopy: zeroCopy, queueSize: queueSize,
+                                  policy: policy)
+    }
+
+    /// Adds a consumer to this sink.
+    ///
+    /// The consumer receives the same frames as the other consumers of the sink, on its own queue, with its own
+    /// bounded frame queue configured by the sink config `queueSize` and `policy`. If the sink has already started,
+    /// the consumer is notified of it right away.
+    ///
+    /// - Parameters:
+    ///    - queue: queue into which callback are dispatched
+    ///    - listener: consumer listener
+    public func addListener(queue: DispatchQueue, listener: YuvSinkListener) {
+        let consumer = Consumer(queue: queue, listener: listener, capacity: Int(config.queueSize),
+                                policy: config.policy)
+        consumersLock.lock()
+        consumers.append(consumer)
+        if started {
+            consumer.notifyStart(sink: self)
+        }
+        consumersLock.unlock()
+    }
+
+    /// Removes a consumer from this sink.
+    ///
+    /// - Parameter listener: consumer listener to remove
+    public func removeListener(_ listener: YuvSinkListener) {
+        consumersLock.lock()
+        consumers = consumers.filter { $0.listener != nil && $0.listener !== listener }
+        consumersLock.unlock()
+    }
+
+    /// Gets the frame counters of a consumer.
+    ///
+    /// - Parameter listener: consumer listener
+    /// - Returns: consumer frame counters, `nil` if the listener is not a consumer of this sink
+    public func stats(listener: YuvSinkListener) -> YuvSinkConsumerStats? {
+        consumersLock.lock()
+        defer { consumersLock.unlock() }
+        return consumers.first { $0.listener === listener }?.stats
+    }
+
+    /// Current consumers.
+    private var currentConsumers: [Consumer] {
+        consumersLock.lock()
+        defer { consumersLock.unlock() }
+        return consumers
+    }
+
+    /// Updates the started state, and notifies all consumers of the change.
+    ///
+    /// - Parameter started: `true` if the sink has started, `false` if it has stopped
+    private func update(started: Bool) {
+        consumersLock.lock()
+        defer { consumersLock.unlock() }
+        self.started = started
+        for consumer in consumers {
+            if started {
+                consumer.notifyStart(sink: self)
+            } else {
+                consumer.notifyStop(sink: self)
+            }
+        }
     }
 
     override public func close() {
@@ -117,12 +369,7 @@ public class YuvSinkCore: SinkCore {
         private unowned let sinkCore: YuvSinkCore
 
         override func onMediaAvailable(mediaInfo: SdkCoreMediaInfo) {
-            sinkCore.config.queue.async { [weak self] in
-                guard let self = self else {
-                    return
-                }
-                self.sinkCore.config.listener?.didStart(sink: self.sinkCore)
-            }
+            sinkCore.update(started: true)
             if let sdkCoreSink = sinkCore.sdkCoreSink {
                 sinkCore.sdkCoreStream?.start(sdkCoreSink, mediaId: UInt32(mediaInfo.mediaId))
             }
@@ -145,20 +392,13 @@ public class YuvSinkCore: SinkCore {
 extension YuvSinkCore: SdkCoreSinkListener {
 
     public func onFrame(_ frame: SdkCoreFrame) {
-        config.queue.async { [weak self] in
-            guard let self = self else {
-                return
-            }
-            self.config.listener?.frameReady(sink: self, frame: frame)
+        // the same frame instance is shared by all consumers, and released when the last one is done with it
+        for consumer in currentConsumers {
+            consumer.push(frame: frame, sink: self)
         }
     }
 
     public func onStop() {
-        config.queue.async { [weak self] in
-            guard let self = self else {
-                return
-            }
-            self.config.listener?.didStop(sink: self)
-        }
+        update(started: false)
     }
 }
@@ -192,6 +192,84 @@ class MediaStoreTests: XCTestCase {
         assertThat(backend.browseCnt, `is`(2))
     }
 
+    func testMediaListIncrementalUpdate() {
+        impl.publish()
+        var cnt = 0
+        var mediaList: [MediaItem]?
+        let mediaStore = store.get(Peripherals.mediaStore)!
+
+        var request: Ref<[MediaItem]>! = mediaStore.newList { medias in
+            mediaList = medias
+            cnt += 1
+        }
+        assertThat(backend.browseCnt, `is`(1))
+
+        backend.browseCompletion!([
+            MediaItemCore(
+                uid: "1", name: "media1", type: .photo, runUid: "r1",
+                creationDate: dateFormatter.date(from: "2016-01-02")!, expectedCount: nil, photoMode: .single,
+                panoramaType: nil,
+                resources: [MediaItemResourceCore(uid: "1-1", format: .jpg, size: 20, location: nil,
+                                                  creationDate: Date())],
+                backendData: "A")])
+        assertThat(cnt, `is`(1))
+        assertThat(mediaList, presentAnd(hasCount(1)))
+        assertThat(impl.fullRefreshCount, `is`(1))
+        mediaList![0].userData = "user"
+
+        // media created
+        impl.update(contentChange: .mediaCreated(MediaItemCore(
+            uid: "2", name: "media2", type: .photo, runUid: "r1",
+            creationDate: dateFormatter.date(from: "2016-01-03")!, expectedCount: nil, photoMode: .single,
+            panoramaType: nil,
+            resources: [MediaItemResourceCore(uid: "2-1", format: .jpg, size: 20, location: nil,
+                                              creationDate: Date())],
+            backendData: "B"))).notifyUpdated()
+        assertThat(backend.browseCnt, `is`(1))
+        assertThat(cnt, `is`(2))
+        assertThat(mediaList, presentAnd(hasCount(2)))
+        assertThat(mediaList![1].uid, `is`("2"))
+
+        // resource created
+        impl.update(contentChange: .resourceCreated(
+            mediaUid: "1", resource: MediaItemResourceCore(uid: "1-2", format: .dng, size: 100, location: nil,
+                                                           creationDate: Date()))).notifyUpdated()
+        assertThat(backend.browseCnt, `is`(1))
+        assertThat(cnt, `is`(3))
+        assertThat(mediaList![0].resources.map { $0.uid }, `is`(["1-1", "1-2"]))
+        assertThat(mediaList![0].userData as? String, presentAnd(`is`("user")))
+
+        // resource removed
+        impl.update(contentChange: .resourceRemoved(uid: "1-1")).notifyUpdated()
+        assertThat(cnt, `is`(4))
+        assertThat(mediaList![0].resources.map { $0.uid }, `is`(["1-2"]))
+
+        // media removed
+        impl.update(contentChange: .mediaRemoved(uid: "2")).notifyUpdated()
+        assertThat(cnt, `is`(5))
+        assertThat(mediaList, presentAnd(hasCount(1)))
+        assertThat(impl.incrementalRefreshCount, `is`(4))
+
+        // change that does not match the index, should trig a full browse
+        impl.update(contentChange: .resourceRemoved(uid: "unknown")).notifyUpdated()
+        assertThat(backend.browseCnt, `is`(2))
+        assertThat(impl.fullRefreshCount, `is`(2))
+        assertThat(cnt, `is`(5))
+
+        // changes received while browsing are not applied, browse is done again instead
+        impl.update(contentChange: .allMediaRemoved).notifyUpdated()
+        backend.browseCompletion!([])
+        assertThat(backend.browseCnt, `is`(3))
+        assertThat(cnt, `is`(5))
+
+        backend.browseCompletion!([])
+        assertThat(cnt, `is`(6))
+        assertThat(mediaList, presentAnd(empty()))
+
+        request = nil
+        assertThat(backend.watchingCnt, `is`(0))
+    }
+
     func testThumbnail() {
         let testImg = UIImage(named: "testImg", in: Bundle(for: MediaStoreTests.self), compatibleWith: nil)!
 
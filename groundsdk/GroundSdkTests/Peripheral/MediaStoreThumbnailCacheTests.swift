@@ -258,6 +258,127 @@ class MediaStoreThumbnailCacheTests: XCTestCase {
         backend.downloadThumbnailCompletion!(testImgData)
         assertThat(image5, present())
     }
+
+    func testDiskCache() {
+        typealias ThumbnailOwner = MediaStoreThumbnailCacheCore.ThumbnailOwner
+        let diskCacheDir = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent(UUID().uuidString)
+        defer {
+            try? FileManager.default.removeItem(at: diskCacheDir)
+        }
+        cache = MediaStoreThumbnailCacheCore(mediaStoreBackend: backend, size: 3 * testImgData.count,
+                                             diskCacheDirectory: diskCacheDir, diskCacheSize: 2 * testImgData.count)
+
+        // thumbnail not stored yet, expect a request to load thumbnail
+        var image1: UIImage?
+        let req1 = cache.getThumbnail(for: .media(medias[0])) { image1 = $0 }
+        assertThat(req1, present())
+        waitUntil { self.backend.downloadThumbnailCnt == 1 }
+        backend.downloadThumbnailCompletion!(testImgData)
+        assertThat(image1, present())
+        assertThat(cache.diskMissCount, `is`(1))
+        waitUntil { self.storedKeys(in: diskCacheDir) == [ThumbnailOwner.media(self.medias[0]).diskKey] }
+
+        // new cache, as after an app restart: thumbnail loaded from disk
+        cache = MediaStoreThumbnailCacheCore(mediaStoreBackend: backend, size: 3 * testImgData.count,
+                                             diskCacheDirectory: diskCacheDir, diskCacheSize: 2 * testImgData.count)
+        var image2: UIImage?
+        let req2 = cache.getThumbnail(for: .media(medias[0])) { image2 = $0 }
+        assertThat(req2, present())
+        waitUntil { image2 != nil }
+        assertThat(backend.downloadThumbnailCnt, `is`(1))
+        assertThat(cache.diskHitCount, `is`(1))
+        assertThat(cache.diskBytesSaved, `is`(testImgData.count))
+
+        // store 2 other thumbnails, the least recently used one should be removed from disk
+        _ = cache.getThumbnail(for: .media(medias[1])) { _ in }
+        waitUntil { self.backend.downloadThumbnailCnt == 2 }
+        backend.downloadThumbnailCompletion!(testImgData)
+        _ = cache.getThumbnail(for: .media(medias[2])) { _ in }
+        waitUntil { self.backend.downloadThumbnailCnt == 3 }
+        backend.downloadThumbnailCompletion!(testImgData)
+        assertThat(cache.diskMissCount, `is`(2))
+        assertThat(cache.diskHitRate, `is`(1.0 / 3.0))
+        waitUntil {
+            self.storedKeys(in: diskCacheDir) == [ThumbnailOwner.media(self.medias[1]).diskKey,
+                                                  ThumbnailOwner.media(self.medias[2]).diskKey]
+        }
+
+        cache = MediaStoreThumbnailCacheCore(mediaStoreBackend: backend, size: 3 * testImgData.count,
+                                             diskCacheDirectory: diskCacheDir, diskCacheSize: 2 * testImgData.count)
+        _ = cache.getThumbnail(for: .media(medias[0])) { _ in }
+        waitUntil { self.backend.downloadThumbnailCnt == 4 }
+        assertThat(cache.diskMissCount, `is`(1))
+    }
+
+    func testRequestAgainAfterClear() {
+        _ = cache.getThumbnail(for: .media(medias[0])) { _ in }
+        assertThat(backend.downloadThumbnailCnt, `is`(1))
+        let canceledCompletion = backend.downloadThumbnailCompletion!
+
+        cache.clear()
+        var image1: UIImage?
+        var callbackCnt = 0
+        let req1 = cache.getThumbnail(for: .media(medias[0])) {
+            image1 = $0
+            callbackCnt += 1
+        }
+        assertThat(req1, present())
+        // the canceled download doesn't delay the new one
+        assertThat(backend.downloadThumbnailCnt, `is`(2))
+
+        // completion of the canceled download is ignored
+        canceledCompletion(nil)
+        assertThat(callbackCnt, `is`(0))
+        assertThat(backend.downloadThumbnailCnt, `is`(2))
+
+        backend.downloadThumbnailCompletion!(testImgData)
+        assertThat(image1, present())
+        assertThat(callbackCnt, `is`(1))
+        assertThat(backend.downloadThumbnailCnt, `is`(2))
+    }
+
+    func testDiskLookupAgainAfterClear() {
+        let diskCacheDir = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent(UUID().uuidString)
+        defer {
+            try? FileManager.default.removeItem(at: diskCacheDir)
+        }
+        cache = MediaStoreThumbnailCacheCore(mediaStoreBackend: backend, size: 3 * testImgData.count,
+                                             diskCacheDirectory: diskCacheDir, diskCacheSize: 2 * testImgData.count)
+
+        // clear while the thumbnail is looked up on disk, then request it again
+        _ = cache.getThumbnail(for: .media(medias[0])) { _ in }
+        cache.clear()
+        var image1: UIImage?
+        _ = cache.getThumbnail(for: .media(medias[0])) { image1 = $0 }
+
+        // the canceled lookup doesn't download the thumbnail, only the new one does
+        waitUntil { self.backend.downloadThumbnailCnt == 1 }
+        backend.downloadThumbnailCompletion!(testImgData)
+        assertThat(image1, present())
+        RunLoop.main.run(until: Date(timeIntervalSinceNow: 0.1))
+        assertThat(backend.downloadThumbnailCnt, `is`(1))
+        assertThat(cache.diskMissCount, `is`(1))
+    }
+
+    /// Gets the keys of the thumbnails stored in a disk cache directory.
+    ///
+    /// - Parameter directory: disk cache directory
+    /// - Returns: stored thumbnail keys
+    private func storedKeys(in directory: URL) -> Set<String> {
+        let files = (try? FileManager.default.contentsOfDirectory(atPath: directory.path)) ?? []
+        return Set(files)
+    }
+
+    /// Runs the main loop until a condition is met, or fails after a timeout.
+    ///
+    /// - Parameter condition: condition to wait for
+    private func waitUntil(_ condition: () -> Bool) {
+        let timeout = Date(timeIntervalSinceNow: 2)
+        while !condition() && Date() < timeout {
+            RunLoop.main.run(until: Date(timeIntervalSinceNow: 0.01))
+        }
+        XCTAssertTrue(condition())
+    }
 }
 
 private class Backend: MediaStoreBackend {
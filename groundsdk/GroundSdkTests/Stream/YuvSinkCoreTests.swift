@@ -0,0 +1,191 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+import XCTest
+@testable import GroundSdk
+
+/// Test YuvSinkCore frame fan-out to its consumers
+class YuvSinkCoreTests: XCTestCase {
+
+    private var stream: StreamCore!
+    private var sink: YuvSinkCore!
+    private let queue1 = DispatchQueue(label: "YuvSinkCoreTests.1")
+    private let queue2 = DispatchQueue(label: "YuvSinkCoreTests.2")
+    private let listener1 = Listener()
+    private let listener2 = Listener()
+
+    override func setUp() {
+        super.setUp()
+        stream = StreamCore()
+    }
+
+    override func tearDown() {
+        sink?.close()
+        sink = nil
+        super.tearDown()
+    }
+
+    func testFramesAreSharedByConsumers() {
+        openSink(queueSize: 1, policy: .dropEldest)
+        sink.addListener(queue: queue2, listener: listener2)
+
+        let frames = [SdkCoreFrame(), SdkCoreFrame(), SdkCoreFrame()]
+        for frame in frames {
+            sink.onFrame(frame)
+            // let consumers process the frame before the next one
+            queue1.sync {}
+            queue2.sync {}
+        }
+
+        // both consumers get the same frame instances
+        XCTAssertTrue(listener1.frames.elementsEqual(frames, by: ===))
+        XCTAssertTrue(listener2.frames.elementsEqual(frames, by: ===))
+        assertThat(sink.stats(listener: listener1)?.delivered, presentAnd(`is`(3)))
+        assertThat(sink.stats(listener: listener1)?.dropped, presentAnd(`is`(0)))
+        assertThat(sink.stats(listener: listener2)?.delivered, presentAnd(`is`(3)))
+        assertThat(sink.stats(listener: listener2)?.dropped, presentAnd(`is`(0)))
+
+        // removed consumer does not get frames anymore
+        sink.removeListener(listener2)
+        sink.onFrame(SdkCoreFrame())
+        queue1.sync {}
+        queue2.sync {}
+        assertThat(listener1.frames.count, `is`(4))
+        assertThat(listener2.frames.count, `is`(3))
+        assertThat(sink.stats(listener: listener2), nilValue())
+    }
+
+    func testSlowConsumerDropsEldestFrames() {
+        openSink(queueSize: 2, policy: .dropEldest)
+        sink.addListener(queue: queue2, listener: listener2)
+
+        let frames = [SdkCoreFrame(), SdkCoreFrame(), SdkCoreFrame(), SdkCoreFrame()]
+        pushWhileBlocked(queue2, frames: frames)
+
+        // only the slow consumer drops frames, keeping the latest ones
+        XCTAssertTrue(listener1.frames.elementsEqual(frames, by: ===))
+        XCTAssertTrue(listener2.frames.elementsEqual(frames[2...], by: ===))
+        assertThat(sink.stats(listener: listener1)?.delivered, presentAnd(`is`(4)))
+        assertThat(sink.stats(listener: listener1)?.dropped, presentAnd(`is`(0)))
+        assertThat(sink.stats(listener: listener2)?.delivered, presentAnd(`is`(2)))
+        assertThat(sink.stats(listener: listener2)?.dropped, presentAnd(`is`(2)))
+    }
+
+    func testSlowConsumerDropsNewFrames() {
+        openSink(queueSize: 2, policy: .dropNew)
+        sink.addListener(queue: queue2, listener: listener2)
+
+        let frames = [SdkCoreFrame(), SdkCoreFrame(), SdkCoreFrame(), SdkCoreFrame()]
+        pushWhileBlocked(queue2, frames: frames)
+
+        // only the slow consumer drops frames, keeping the eldest ones
+        XCTAssertTrue(listener1.frames.elementsEqual(frames, by: ===))
+        XCTAssertTrue(listener2.frames.elementsEqual(frames[..<2], by: ===))
+        assertThat(sink.stats(listener: listener2)?.delivered, presentAnd(`is`(2)))
+        assertThat(sink.stats(listener: listener2)?.dropped, presentAnd(`is`(2)))
+    }
+
+    func testConsumerAddedAfterStart() {
+        openSink(queueSize: 1, policy: .dropEldest)
+        // the sink subscribes to the stream media, and starts when a YUV media is available
+        sink.onSdkCoreStreamAvailable(stream: SdkCoreStream())
+        stream.mediaAdded(SdkCoreStream(), mediaInfo: SdkCoreYuvInfo(mediaId: 1))
+        queue1.sync {}
+        assertThat(listener1.startCnt, `is`(1))
+
+        // consumer added to a started sink is notified of the start
+        sink.addListener(queue: queue2, listener: listener2)
+        queue2.sync {}
+        assertThat(listener2.startCnt, `is`(1))
+
+        sink.onStop()
+        queue1.sync {}
+        queue2.sync {}
+        assertThat(listener1.stopCnt, `is`(1))
+        assertThat(listener2.stopCnt, `is`(1))
+
+        // consumer added to a stopped sink is not
+        let listener3 = Listener()
+        sink.addListener(queue: queue2, listener: listener3)
+        queue2.sync {}
+        assertThat(listener3.startCnt, `is`(0))
+        assertThat(listener1.startCnt, `is`(1))
+    }
+
+    /// Opens the tested sink, with `listener1` as first consumer on `queue1`.
+    ///
+    /// - Parameters:
+    ///   - queueSize: consumers queue size
+    ///   - policy: policy applied when a consumer queue is full
+    private func openSink(queueSize: UInt32, policy: SdkCoreSinkQueueFullPolicy) {
+        sink = YuvSinkCore(stream: stream, config: YuvSinkCore.Config(
+            queue: queue1, listener: listener1, queueSize: queueSize, policy: policy))
+    }
+
+    /// Pushes frames to the sink while a consumer queue is blocked, then waits until all consumers are done.
+    ///
+    /// - Parameters:
+    ///   - queue: consumer queue to block
+    ///   - frames: frames to push
+    private func pushWhileBlocked(_ queue: DispatchQueue, frames: [SdkCoreFrame]) {
+        let unblock = DispatchSemaphore(value: 0)
+        queue.async {
+            unblock.wait()
+        }
+        for frame in frames {
+            sink.onFrame(frame)
+            queue1.sync {}
+        }
+        unblock.signal()
+        queue1.sync {}
+        queue2.sync {}
+    }
+}
+
+/// YUV sink listener recording the received events
+private class Listener: YuvSinkListener {
+    /// Received frames
+    var frames: [SdkCoreFrame] = []
+    /// Number of didStart calls
+    var startCnt = 0
+    /// Number of didStop calls
+    var stopCnt = 0
+
+    func frameReady(sink: StreamSink, frame: SdkCoreFrame) {
+        frames.append(frame)
+    }
+
+    func didStart(sink: StreamSink) {
+        startCnt += 1
+    }
+
+    func didStop(sink: StreamSink) {
+        stopCnt += 1
+    }
+}
@@ -201,6 +201,121 @@ class ComponentStoreCoreTests: XCTestCase {
         componentStore!.unregister(listener: mainListener)
         componentStore!.unregister(listener: subListener)
     }
+
+    func testCoalescedUpdates() {
+        componentStore!.notificationInterval = 0
+        var mainDidChangeCnt = 0
+        let mainListener = componentStore!.register(desc: mainComDesc, didChange: {
+            mainDidChangeCnt += 1
+        })
+        var subDidChangeCnt = 0
+        let subListener = componentStore!.register(desc: subComDesc, didChange: {
+            subDidChangeCnt += 1
+        })
+
+        // add is notified immediately
+        let comp = SubCompImpl()
+        componentStore!.add(comp)
+        assertThat(mainDidChangeCnt, `is`(1))
+        assertThat(subDidChangeCnt, `is`(1))
+
+        // updates are notified once, on next run loop turn
+        componentStore!.notifyUpdated(comp)
+        componentStore!.notifyUpdated(comp)
+        componentStore!.notifyUpdated(comp)
+        assertThat(mainDidChangeCnt, `is`(1))
+        assertThat(subDidChangeCnt, `is`(1))
+        assertThat(componentStore!.coalescedNotificationCount, `is`(2))
+
+        var expectation = self.expectation(description: "delivered")
+        DispatchQueue.main.async {
+            expectation.fulfill()
+        }
+        waitForExpectations(timeout: 1)
+        assertThat(mainDidChangeCnt, `is`(2))
+        assertThat(subDidChangeCnt, `is`(2))
+
+        // pending update is dropped when the component is removed
+        componentStore!.notifyUpdated(comp)
+        componentStore!.remove(comp)
+        assertThat(mainDidChangeCnt, `is`(3))
+        assertThat(subDidChangeCnt, `is`(3))
+        expectation = self.expectation(description: "nothing delivered")
+        DispatchQueue.main.async {
+            expectation.fulfill()
+        }
+        waitForExpectations(timeout: 1)
+        assertThat(mainDidChangeCnt, `is`(3))
+        assertThat(subDidChangeCnt, `is`(3))
+
+        // disabling coalescing delivers pending updates and notifies next ones immediately
+        componentStore!.add(comp)
+        componentStore!.notifyUpdated(comp)
+        componentStore!.notificationInterval = nil
+        assertThat(mainDidChangeCnt, `is`(5))
+        componentStore!.notifyUpdated(comp)
+        assertThat(mainDidChangeCnt, `is`(6))
+        assertThat(componentStore!.coalescedNotificationCount, `is`(2))
+
+        componentStore!.unregister(listener: mainListener)
+        componentStore!.unregister(listener: subListener)
+    }
+
+    func testCoalescedUpdatesWithInterval() {
+        let interval = 0.3
+        componentStore!.notificationInterval = interval
+        let comp = SubCompImpl()
+        var notifiedValues: [Int] = []
+        var notificationTimes: [TimeInterval] = []
+        let listener = componentStore!.register(desc: subComDesc, didChange: {
+            notifiedValues.append((self.componentStore!.get(subComDesc) as? SubCompImpl)?.value ?? -1)
+            notificationTimes.append(ProcessInfo.processInfo.systemUptime)
+        })
+        componentStore!.add(comp)
+        assertThat(notifiedValues, `is`([0]))
+
+        // first updates are delivered on next run loop turn, with the latest state
+        comp.value = 1
+        componentStore!.notifyUpdated(comp)
+        comp.value = 2
+        componentStore!.notifyUpdated(comp)
+        comp.value = 3
+        componentStore!.notifyUpdated(comp)
+        assertThat(notifiedValues, `is`([0]))
+        assertThat(componentStore!.coalescedNotificationCount, `is`(2))
+
+        var expectation = self.expectation(description: "first delivery")
+        DispatchQueue.main.async {
+            expectation.fulfill()
+        }
+        waitForExpectations(timeout: 1)
+        assertThat(notifiedValues, `is`([0, 3]))
+
+        // next updates are delayed until the interval has elapsed since the previous delivery
+        comp.value = 4
+        componentStore!.notifyUpdated(comp)
+        comp.value = 5
+        componentStore!.notifyUpdated(comp)
+        assertThat(componentStore!.coalescedNotificationCount, `is`(3))
+
+        expectation = self.expectation(description: "next run loop turn")
+        DispatchQueue.main.async {
+            expectation.fulfill()
+        }
+        waitForExpectations(timeout: 1)
+        assertThat(notifiedValues, `is`([0, 3]))
+
+        expectation = self.expectation(description: "second delivery")
+        DispatchQueue.main.asyncAfter(deadline: .now() + interval * 2) {
+            expectation.fulfill()
+        }
+        waitForExpectations(timeout: 2)
+        assertThat(notifiedValues, `is`([0, 3, 5]))
+        assertThat(notificationTimes[2] - notificationTimes[1], greaterThan(interval * 0.9))
+        assertThat(componentStore!.coalescedNotificationCount, `is`(3))
+
+        componentStore!.unregister(listener: listener)
+    }
 }
 
 class ComponentRefCoreTests: XCTestCase {
@@ -303,6 +418,9 @@ class MainCompImpl: ComponentCore, MainComp {
 }
 
 class SubCompImpl: ComponentCore, SubComp {
+    /// Component state, changed by tests before notifying updates
+    var value = 0
+
     init(didRegisterFirstListenerCallback: @escaping ListenersDidChangeCallback = {},
          didUnregisterLastListenerCallback: @escaping ListenersDidChangeCallback = {}) {
         super.init(desc: subComDesc, store: ComponentStoreCore(),
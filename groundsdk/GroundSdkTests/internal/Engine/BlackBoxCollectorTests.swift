@@ -0,0 +1,188 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+
+import XCTest
+import Compression
+import SdkCore
+@testable import GroundSdk
+
+/// Checks that black boxes are archived as streamed gzip json files.
+class BlackBoxCollectorTests: XCTestCase {
+
+    /// Root directory of the collector
+    private var rootDir: URL!
+
+    override func setUp() {
+        super.setUp()
+        rootDir = URL(fileURLWithPath: NSTemporaryDirectory()).appendingPathComponent(UUID().uuidString)
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: rootDir)
+        super.tearDown()
+    }
+
+    func testArchive() {
+        let workDir = rootDir.appendingPathComponent("work")
+        let collector = BlackBoxCollector(rootDir: rootDir, workDir: workDir)
+
+        let blackBox = TestBlackBox(sampleCount: 20000)
+        var report: BlackBox?
+        let archived = expectation(description: "archived")
+        collector.archive(blackBoxData: blackBox) {
+            report = $0
+            archived.fulfill()
+        }
+        waitForExpectations(timeout: 10)
+
+        // report is a gzip file named by its md5
+        let data = report.flatMap { try? Data(contentsOf: $0.url) }
+        assertThat(data?.prefix(2), presentAnd(`is`(Data([0x1f, 0x8b]))))
+        assertThat(report?.md5, presentAnd(`is`((data! as NSData).computeMd5())))
+        // archived json is the same as the whole object encoding
+        let json = data.flatMap { gunzip($0) }
+        assertThat(json, present())
+        let archivedJson = json.flatMap { try? JSONSerialization.jsonObject(with: $0) } as? NSDictionary
+        let encoded = (try? JSONSerialization.jsonObject(with: JSONEncoder().encode(blackBox))) as? NSDictionary
+        assertThat(archivedJson, present())
+        XCTAssertEqual(archivedJson, encoded)
+        // no temporary file is left
+        let files = try? FileManager.default.contentsOfDirectory(at: workDir, includingPropertiesForKeys: nil)
+        assertThat(files?.map { $0.lastPathComponent }, presentAnd(`is`([report!.md5])))
+    }
+
+    func testJsonStreamWriter() {
+        let blackBox = TestBlackBox(sampleCount: 1000)
+        var json = Data()
+        var sinkCount = 0
+        let writer = JsonStreamWriter(bufferSize: 256) {
+            json.append($0)
+            sinkCount += 1
+        }
+        XCTAssertNoThrow(try blackBox.write(to: writer))
+        XCTAssertNoThrow(try writer.flush())
+
+        // json is handed over in pieces and is the same as the whole object encoding
+        assertThat(sinkCount, greaterThan(1))
+        let streamed = (try? JSONSerialization.jsonObject(with: json)) as? NSDictionary
+        let encoded = (try? JSONSerialization.jsonObject(with: JSONEncoder().encode(blackBox))) as? NSDictionary
+        assertThat(streamed, present())
+        XCTAssertEqual(streamed, encoded)
+    }
+
+    func testJsonObjectWriterNonFiniteValues() {
+        var json = Data()
+        // non finite values are rejected, as by the default encoder
+        var writer = JsonStreamWriter { json.append($0) }
+        XCTAssertThrowsError(try writer.writeObject { object in
+            try object.write(Double.nan, key: "value")
+        }) { error in
+            XCTAssertTrue(error is EncodingError)
+        }
+
+        // or converted to strings, as by the encoder
+        let encoder = JSONEncoder()
+        encoder.nonConformingFloatEncodingStrategy = .convertToString(
+            positiveInfinity: "+inf", negativeInfinity: "-inf", nan: "nan")
+        json = Data()
+        writer = JsonStreamWriter(encoder: encoder) { json.append($0) }
+        XCTAssertNoThrow(try writer.writeObject { object in
+            try object.write(Double.infinity, key: "positive")
+            try object.write(-Float.infinity, key: "negative")
+            try object.write(Float.nan, key: "nan")
+            try object.write(Float(0.5), key: "finite")
+        })
+        XCTAssertNoThrow(try writer.flush())
+
+        let streamed = (try? JSONSerialization.jsonObject(with: json)) as? NSDictionary
+        let encoded = (try? JSONSerialization.jsonObject(with: encoder.encode(
+            ["positive": Double.infinity, "negative": -Double.infinity, "nan": Double.nan, "finite": 0.5])))
+            as? NSDictionary
+        assertThat(streamed, present())
+        XCTAssertEqual(streamed, encoded)
+    }
+
+    /// Decompresses a gzip file content.
+    ///
+    /// - Parameter data: gzip file content, without optional header fields, as written by zlib
+    /// - Returns: decompressed data, `nil` if it could not be decompressed
+    private func gunzip(_ data: Data) -> Data? {
+        // 10 bytes header, deflate stream, then crc32 and uncompressed size (little endian) in a 8 bytes trailer
+        guard data.count > 18, data[0] == 0x1f, data[1] == 0x8b, data[3] == 0 else {
+            return nil
+        }
+        let size = data.suffix(4).reversed().reduce(0) { $0 << 8 | Int($1) }
+        let deflated = data.subdata(in: 10..<data.count - 8)
+        var output = Data(count: size)
+        let decodedSize = output.withUnsafeMutableBytes { (dst: UnsafeMutablePointer<UInt8>) in
+            deflated.withUnsafeBytes { (src: UnsafePointer<UInt8>) in
+                compression_decode_buffer(dst, size, src, deflated.count, nil, COMPRESSION_ZLIB)
+            }
+        }
+        return decodedSize == size ? output : nil
+    }
+}
+
+/// Black box that is written piece by piece
+private struct TestBlackBox: JsonStreamEncodable {
+
+    enum CodingKeys: String, CodingKey {
+        case header
+        case samples = "datas"
+        case count
+    }
+
+    /// A black box sample
+    struct Sample: Encodable {
+        let timestamp: Int
+        let altitude: Double
+        let state: String
+    }
+
+    /// Header
+    let header = ["version": "1", "name": "quote \" and backslash \\"]
+    /// Samples
+    let samples: [Sample]
+    /// Sample count
+    let count: Int
+
+    init(sampleCount: Int) {
+        samples = (0..<sampleCount).map { Sample(timestamp: $0 * 200, altitude: Double($0) / 3, state: "flying") }
+        count = sampleCount
+    }
+
+    func write(to writer: JsonStreamWriter) throws {
+        try writer.beginObject()
+        try writer.write(header, key: CodingKeys.header.rawValue)
+        try writer.write(elements: samples, key: CodingKeys.samples.rawValue)
+        try writer.write(count, key: CodingKeys.count.rawValue)
+        try writer.endObject()
+    }
+}
@@ -0,0 +1,249 @@
+// Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+import XCTest
+@testable import GroundSdk
+
+/// URL protocol answering every request with a canned response.
+private class StubUrlProtocol: URLProtocol {
+
+    /// Canned response.
+    struct Response {
+        /// Http status code
+        let statusCode: Int
+        /// Response body
+        let body: Data
+        /// Whether the connection is lost once the body has been sent
+        let fails: Bool
+    }
+
+    /// Response given to the next requests.
+    static var response = Response(statusCode: 200, body: Data(), fails: false)
+
+    /// `Range` header of the latest request, `nil` if it had none.
+    static var rangeHeader: String?
+
+    override class func canInit(with request: URLRequest) -> Bool {
+        return true
+    }
+
+    override class func canonicalRequest(for request: URLRequest) -> URLRequest {
+        return request
+    }
+
+    override func startLoading() {
+        let response = StubUrlProtocol.response
+        StubUrlProtocol.rangeHeader = request.value(forHTTPHeaderField: "Range")
+        let urlResponse = HTTPURLResponse(
+            url: request.url!, statusCode: response.statusCode, httpVersion: "HTTP/1.1",
+            headerFields: ["Content-Length": "\(response.body.count)"])!
+        client?.urlProtocol(self, didReceive: urlResponse, cacheStoragePolicy: .notAllowed)
+        if !response.body.isEmpty {
+            client?.urlProtocol(self, didLoad: response.body)
+        }
+        if response.fails {
+            client?.urlProtocol(self, didFailWithError: URLError(.networkConnectionLost))
+        } else {
+            client?.urlProtocolDidFinishLoading(self)
+        }
+    }
+
+    override func stopLoading() {
+    }
+}
+
+/// Test resumable file downloads of HttpSessionCore.
+class HttpSessionCoreTests: XCTestCase {
+
+    private var httpSession: HttpSessionCore!
+    private var directory: URL!
+    private var partialFileUrl: URL!
+    private var destination: URL!
+
+    private let content = "0123456789".data(using: .utf8)!
+
+    override func setUp() {
+        super.setUp()
+        let configuration = URLSessionConfiguration.ephemeral
+        configuration.protocolClasses = [StubUrlProtocol.self]
+        httpSession = HttpSessionCore(sessionConfiguration: configuration)
+        directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString)
+        partialFileUrl = directory.appendingPathComponent("media.part")
+        destination = directory.appendingPathComponent("media")
+        try! FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true, attributes: nil)
+        StubUrlProtocol.rangeHeader = nil
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: directory)
+        httpSession = nil
+        super.tearDown()
+    }
+
+    func testDownloadWithoutPartialFile() {
+        StubUrlProtocol.response = StubUrlProtocol.Response(statusCode: 200, body: content, fails: false)
+
+        let (result, localFileUrl) = download()
+
+        assertThat(StubUrlProtocol.rangeHeader, nilValue())
+        assertThat(statusCode(of: result), presentAnd(`is`(200)))
+        assertThat(localFileUrl, presentAnd(`is`(destination)))
+        assertThat(contents(of: destination), presentAnd(`is`(content)))
+        assertThat(FileManager.default.fileExists(atPath: partialFileUrl.path), `is`(false))
+    }
+
+    func testResumeWithPartialContent() {
+        FileManager.default.createFile(atPath: partialFileUrl.path, contents: content.prefix(4))
+        StubUrlProtocol.response = StubUrlProtocol.Response(statusCode: 206, body: content.suffix(from: 4),
+                                                            fails: false)
+
+        let (result, localFileUrl) = download()
+
+        assertThat(StubUrlProtocol.rangeHeader, presentAnd(`is`("bytes=4-")))
+        assertThat(statusCode(of: result), presentAnd(`is`(206)))
+        assertThat(localFileUrl, presentAnd(`is`(destination)))
+        assertThat(contents(of: destination), presentAnd(`is`(content)))
+        assertThat(FileManager.default.fileExists(atPath: partialFileUrl.path), `is`(false))
+    }
+
+    func testResumeIgnoredByServer() {
+        FileManager.default.createFile(atPath: partialFileUrl.path, contents: "abcd".data(using: .utf8)!)
+        StubUrlProtocol.response = StubUrlProtocol.Response(statusCode: 200, body: content, fails: false)
+
+        let (result, localFileUrl) = download()
+
+        // whole file is received again, partial content is dropped
+        assertThat(StubUrlProtocol.rangeHeader, presentAnd(`is`("bytes=4-")))
+        assertThat(statusCode(of: result), presentAnd(`is`(200)))
+        assertThat(localFileUrl, presentAnd(`is`(destination)))
+        assertThat(contents(of: destination), presentAnd(`is`(content)))
+        assertThat(FileManager.default.fileExists(atPath: partialFileUrl.path), `is`(false))
+    }
+
+    func testResumeRejectedByServer() {
+        FileManager.default.createFile(atPath: partialFileUrl.path, contents: content.prefix(4))
+        StubUrlProtocol.response = StubUrlProtocol.Response(statusCode: 416, body: Data(), fails: false)
+
+        let (result, localFileUrl) = download()
+
+        assertThat(StubUrlProtocol.rangeHeader, presentAnd(`is`("bytes=4-")))
+        assertThat(httpErrorCode(of: result), presentAnd(`is`(416)))
+        assertThat(localFileUrl, nilValue())
+        assertThat(FileManager.default.fileExists(atPath: destination.path), `is`(false))
+        // partial file is discarded, so that next download starts from zero
+        assertThat(FileManager.default.fileExists(atPath: partialFileUrl.path), `is`(false))
+
+        StubUrlProtocol.response = StubUrlProtocol.Response(statusCode: 200, body: content, fails: false)
+        _ = download()
+        assertThat(StubUrlProtocol.rangeHeader, nilValue())
+        assertThat(contents(of: destination), presentAnd(`is`(content)))
+    }
+
+    func testFailureKeepsPartialFile() {
+        StubUrlProtocol.response = StubUrlProtocol.Response(statusCode: 200, body: content.prefix(4), fails: true)
+
+        var (result, localFileUrl) = download()
+
+        assertThat(statusCode(of: result), nilValue())
+        assertThat(localFileUrl, nilValue())
+        assertThat(FileManager.default.fileExists(atPath: destination.path), `is`(false))
+        // received bytes are kept to resume the download
+        assertThat(contents(of: partialFileUrl), presentAnd(`is`(content.prefix(4))))
+
+        StubUrlProtocol.response = StubUrlProtocol.Response(statusCode: 206, body: content.suffix(from: 4),
+                                                            fails: false)
+        (result, localFileUrl) = download()
+
+        assertThat(StubUrlProtocol.rangeHeader, presentAnd(`is`("bytes=4-")))
+        assertThat(statusCode(of: result), presentAnd(`is`(206)))
+        assertThat(localFileUrl, presentAnd(`is`(destination)))
+        assertThat(contents(of: destination), presentAnd(`is`(content)))
+        assertThat(FileManager.default.fileExists(atPath: partialFileUrl.path), `is`(false))
+    }
+
+    func testHttpErrorKeepsPartialFile() {
+        FileManager.default.createFile(atPath: partialFileUrl.path, contents: content.prefix(4))
+        StubUrlProtocol.response = StubUrlProtocol.Response(statusCode: 500, body: Data(), fails: false)
+
+        let (result, localFileUrl) = download()
+
+        assertThat(httpErrorCode(of: result), presentAnd(`is`(500)))
+        assertThat(localFileUrl, nilValue())
+        assertThat(contents(of: partialFileUrl), presentAnd(`is`(content.prefix(4))))
+    }
+
+    /// Downloads the file and waits for the download completion.
+    ///
+    /// - Returns: download result and local file url
+    private func download() -> (HttpSessionCore.Result?, URL?) {
+        var result: HttpSessionCore.Result?
+        var localFileUrl: URL?
+        let expectation = self.expectation(description: "download")
+        _ = httpSession.downloadFile(
+            request: URLRequest(url: URL(string: "http://192.168.42.1/data/media/media.jpg")!),
+            partialFileUrl: partialFileUrl, destination: destination, progress: { _ in },
+            completion: { downloadResult, downloadUrl in
+                result = downloadResult
+                localFileUrl = downloadUrl
+                expectation.fulfill()
+        })
+        waitForExpectations(timeout: 5)
+        return (result, localFileUrl)
+    }
+
+    /// Gets the status code of a successful result.
+    ///
+    /// - Parameter result: request result
+    /// - Returns: status code, `nil` if the request did not succeed
+    private func statusCode(of result: HttpSessionCore.Result?) -> Int? {
+        if case .success(let statusCode)? = result {
+            return statusCode
+        }
+        return nil
+    }
+
+    /// Gets the status code of an http error result.
+    ///
+    /// - Parameter result: request result
+    /// - Returns: status code, `nil` if the request did not fail with an http error
+    private func httpErrorCode(of result: HttpSessionCore.Result?) -> Int? {
+        if case .httpError(let statusCode)? = result {
+            return statusCode
+        }
+        return nil
+    }
+
+    /// Gets the content of a file.
+    ///
+    /// - Parameter url: file url
+    /// - Returns: file content, `nil` if the file does not exist
+    private func contents(of url: URL) -> Data? {
+        return FileManager.default.contents(atPath: url.path)
+    }
+}
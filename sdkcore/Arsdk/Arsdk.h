@@ -28,9 +28,14 @@
 
 #include "NSData+zlib.h"
 #include "NSData+Crypto.h"
+#include "GzipFileWriter.h"
+#include "ArsdkBleLoopback.h"
+#include "ArsdkMuxStats.h"
+#include "ArsdkMuxLoopback.h"
 
 #include "FileConverterAPI.h"
 #include "NoAckStorage.h"
+#include "NoAckCommandLoop.h"
 
 #include "SdkCore+FileSource.h"
 #include "SdkCore+MediaInfo.h"
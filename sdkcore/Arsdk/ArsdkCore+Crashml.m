@@ -144,9 +144,10 @@ static void crashml_progress(struct arsdk_crashml_itf *itf,
                              void *userdata) {
     CrashmlDownloadRequest* request = (__bridge CrashmlDownloadRequest*)(userdata);
     NSString* nspath = [NSString stringWithUTF8String:path];
-    dispatch_async(dispatch_get_main_queue(), ^{
+    // each progress reports a file, they are batched but never coalesced
+    [request postEvent:^{
         request.progressBlock(nspath, (ArsdkCrashmlStatus)status);
-    });
+    }];
 }
 
 static void crashml_completed(struct arsdk_crashml_itf *itf,
@@ -156,9 +157,9 @@ static void crashml_completed(struct arsdk_crashml_itf *itf,
                               void *userdata) {
     CrashmlDownloadRequest* request = (__bridge_transfer CrashmlDownloadRequest*)(userdata);
     request->_request = NULL;
-    dispatch_async(dispatch_get_main_queue(), ^{
+    [request postEvent:^{
         request.completionBlock((ArsdkCrashmlStatus)status);
-    });
+    }];
 }
 
 @end
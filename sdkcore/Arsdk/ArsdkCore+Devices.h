@@ -60,11 +60,73 @@ typedef NS_ENUM(NSInteger, ArsdkConnCancelReason) {
     ArsdkConnCancelReasonReject =    2,
 };
 
+/** Number of buckets of the NoAck loop send lateness histogram */
+#define NOACK_LOOP_HISTOGRAM_SIZE 7
+
+/**
+ NoAck command loop timing statistics.
+
+ Lateness is the difference between the actual and the scheduled send time of a tick. Histogram buckets are:
+ < 1 ms, 1-2 ms, 2-5 ms, 5-10 ms, 10-20 ms, 20-50 ms and >= 50 ms.
+ */
+typedef struct {
+    /** Number of ticks */
+    uint64_t ticks;
+    /** Number of ticks sent later than half a period after their scheduled time */
+    uint64_t lateTicks;
+    /** Number of ticks skipped because their deadline elapsed or their commands could not be sent in time */
+    uint64_t missedTicks;
+    /** Sum of ticks lateness, in microseconds */
+    uint64_t totalLatenessUs;
+    /** Highest tick lateness, in microseconds */
+    uint64_t maxLatenessUs;
+    /** Sum of the latencies between ticks scheduled time and the send of their commands, in microseconds */
+    uint64_t totalSendLatencyUs;
+    /** Highest latency between a tick scheduled time and the send of its commands, in microseconds */
+    uint64_t maxSendLatencyUs;
+    /** Tick lateness histogram */
+    uint64_t histogram[NOACK_LOOP_HISTOGRAM_SIZE];
+} ArsdkNoAckLoopStats;
+
 /** A Tcp proxy */
 @interface ArsdkTcpProxy : NSObject
 
 @end
 
+/**
+ Receives commands for a device through the same path as the commands received from arsdk: each command is copied,
+ queued to the main queue, then passed to the device command listeners and to the device listener.
+
+ Link loss and disconnection can be signaled the same way, to check that they are notified after the commands
+ received before.
+
+ Used to replay command traces in tests and benchmarks.
+ */
+@interface ArsdkCommandReceiver : NSObject
+
+- (instancetype _Nonnull)init NS_UNAVAILABLE;
+
+/**
+ Receives a command. Delivery happens asynchronously on the main queue.
+
+ @param command: received command, copied
+ */
+- (void)receiveCommand:(const struct arsdk_cmd * _Nonnull)command;
+
+/**
+ Signals a link loss, as if reported by arsdk. Notification happens asynchronously on the main queue.
+ */
+- (void)linkDown;
+
+/**
+ Signals the device disconnection, as if reported by arsdk. Notification happens asynchronously on the main queue.
+
+ @param removing: whether the device is being removed
+ */
+- (void)disconnect:(BOOL)removing;
+
+@end
+
 /**
  Device listener, notified of device event.
  */
@@ -178,6 +240,15 @@ extern short const ARSDK_INVALID_DEVICE_HANDLE;
 - (void)setNoAckCommands:(NSArray<NoAckStorage *> *_Nullable)encoders handle:(short)handle
 NS_SWIFT_NAME(setNoAckCommands(encoders:handle:));
 
+/**
+ Retrieves the timing statistics of the NoAck command loop of a device.
+
+ @param handle: device handle
+ @param completion: completion block, called on the main queue, with the loop statistics, or with zeroed statistics if
+                    the device has no NoAck command loop
+ */
+- (void)getNoAckCmdLoopStats:(int16_t)handle completion:(void (^ _Nonnull)(ArsdkNoAckLoopStats stats))completion;
+
 
 /**
  Creates a tcp proxy on a device.
@@ -191,6 +262,18 @@ NS_SWIFT_NAME(setNoAckCommands(encoders:handle:));
 - (void)createTcpProxy:(int16_t)handle deviceType:(NSInteger)deviceType port:(uint16_t)port
             completion:(ArsdkTcpProxyCreationCompletion _Nonnull)completion;
 
+/**
+ Creates a receiver injecting commands in the receive path of a device, as if they had been received from arsdk.
+
+ Received commands are batched according to `commandBatchMaxLatencyMs`.
+
+ @param handle: the device handle
+ @param deviceListener: listener notified of the received commands
+ @return a new command receiver
+ */
+- (ArsdkCommandReceiver * _Nonnull)commandReceiverForDevice:(int16_t)handle
+                                             deviceListener:(id<ArsdkCoreDeviceListener> _Nonnull)deviceListener;
+
 @end
 
 
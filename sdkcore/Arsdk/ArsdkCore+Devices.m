@@ -36,6 +36,7 @@
 #import "NoAckCommandLoop.h"
 #import "NoAckStorage.h"
 #import <arsdkctrl/internal/arsdkctrl_internal.h>
+#import <os/lock.h>
 
 /** common loging tag */
 extern ULogTag *TAG;
@@ -102,32 +103,262 @@ short const ARSDK_INVALID_DEVICE_HANDLE = ARSDK_INVALID_HANDLE;
 @end
 
 
+/** Initial number of preallocated command slots of a received commands batch */
+#define CMD_BATCH_INITIAL_CAPACITY 32
+
+/** Maximum number of unused command containers kept in the free-list of a device */
+#define CMD_CONTAINER_MAX_FREE 64
+
+/** Received command waiting to be delivered on the main queue, recycled through a free-list */
+struct cmd_container {
+    /** Command copy */
+    struct arsdk_cmd cmd;
+    /** Handler that received the command, retained until delivery */
+    void *handler;
+    /** Next container in the free-list */
+    struct cmd_container *next;
+};
+
 /**
  * Listener object given to arsdk_ng.
  * It contains a reference to the ArsdkCoreDeviceListener, with the associated device handle.
+ *
+ * When commands batching is enabled, received commands are copied in the `pending` slots on the pomp loop and
+ * delivered to the main queue in one block. The main queue swaps `pending` with the `spare` slots before delivering,
+ * so that the pomp loop never waits for listeners and no allocation is made once both slot arrays are large enough.
+ *
+ * When commands batching is disabled, each received command is copied in a container taken from a free-list and
+ * delivered to the main queue with `dispatch_async_f`; the container goes back to the free-list after delivery.
  */
 @interface ArsdkCoreDeviceListenerHandler: NSObject
 
 @property (readonly, nonatomic, strong) id<ArsdkCoreDeviceListener> listener;
 @property (readonly, nonatomic, weak) ArsdkCore *core;
 @property (readonly, nonatomic) int16_t handle;
+/** Maximum batch latency in ms, `ARSDK_CMD_BATCH_DISABLED` if commands are not batched */
+@property (readonly, nonatomic) int batchMaxLatencyMs;
+
+- (instancetype)initWithArsdkCore:(ArsdkCore * _Nonnull)core listener:(id<ArsdkCoreDeviceListener> _Nonnull)listener
+                           handle:(int16_t)handle batchMaxLatencyMs:(int)batchMaxLatencyMs;
+
+/**
+ Queue a received command in the current batch. Called on the pomp loop.
+
+ @param command: received command, copied
+ */
+- (void)queueCommand:(const struct arsdk_cmd * _Nonnull)command;
 
-- (instancetype)initWithArsdkCore:(ArsdkCore * _Nonnull)core listener:(id<ArsdkCoreDeviceListener> _Nonnull)listener handle:(int16_t)handle;
+/**
+ Deliver all queued commands to the listeners. Called on the main queue.
+ */
+- (void)deliverCommands;
+
+/**
+ Notify the listener that the link is down, after the commands received before. Called on the main queue.
+ */
+- (void)notifyLinkDown;
+
+/**
+ Notify the listener that the device is disconnected, after the commands received before. Called on the main queue.
+
+ @param removing: whether the device is being removed
+ */
+- (void)notifyDisconnected:(BOOL)removing;
+
+/**
+ Get an empty command container, from the free-list if possible.
+
+ @return an empty command container
+ */
+- (struct cmd_container * _Nonnull)acquireCommandContainer;
+
+/**
+ Give back a command container after its command has been delivered and cleared.
+
+ @param container: container to recycle
+ */
+- (void)recycleCommandContainer:(struct cmd_container * _Nonnull)container;
 
 @end
 
-@implementation ArsdkCoreDeviceListenerHandler
+@implementation ArsdkCoreDeviceListenerHandler {
+    /** Lock protecting the batch state and the container free-list below */
+    os_unfair_lock _batchLock;
+    /** Slots being filled by the pomp loop */
+    struct arsdk_cmd *_pending;
+    /** Number of used slots in `_pending` */
+    size_t _pendingCount;
+    /** Number of allocated slots in `_pending` */
+    size_t _pendingCapacity;
+    /** Empty slots, ready to be swapped with `_pending`. NULL while a batch is being delivered */
+    struct arsdk_cmd *_spare;
+    /** Number of allocated slots in `_spare` */
+    size_t _spareCapacity;
+    /** Highest value of `_pendingCount` since last delivery */
+    size_t _maxDepth;
+    /** Whether a delivery block has been queued and has not started yet */
+    BOOL _deliveryScheduled;
+    /** Unused command containers */
+    struct cmd_container *_freeContainers;
+    /** Number of containers in `_freeContainers` */
+    size_t _freeContainerCount;
+}
 
-- (instancetype)initWithArsdkCore:(ArsdkCore * _Nonnull)core listener:(id<ArsdkCoreDeviceListener> _Nonnull)listener handle:(int16_t)handle {
+- (instancetype)initWithArsdkCore:(ArsdkCore * _Nonnull)core listener:(id<ArsdkCoreDeviceListener> _Nonnull)listener
+                           handle:(int16_t)handle batchMaxLatencyMs:(int)batchMaxLatencyMs {
     self = [super init];
     if (self) {
         _core = core;
         _listener = listener;
         _handle = handle;
+        _batchMaxLatencyMs = batchMaxLatencyMs;
+        _batchLock = OS_UNFAIR_LOCK_INIT;
+        if (_batchMaxLatencyMs != ARSDK_CMD_BATCH_DISABLED) {
+            _pendingCapacity = CMD_BATCH_INITIAL_CAPACITY;
+            _pending = calloc(_pendingCapacity, sizeof(*_pending));
+            _spareCapacity = CMD_BATCH_INITIAL_CAPACITY;
+            _spare = calloc(_spareCapacity, sizeof(*_spare));
+        }
     }
     return self;
 }
 
+- (void)queueCommand:(const struct arsdk_cmd * _Nonnull)command {
+    BOOL scheduleDelivery = NO;
+
+    os_unfair_lock_lock(&_batchLock);
+    if (_pendingCount == _pendingCapacity) {
+        // main queue is late, grow the slots; they will be kept for the next batches
+        size_t capacity = MAX(_pendingCapacity * 2, CMD_BATCH_INITIAL_CAPACITY);
+        struct arsdk_cmd *pending = realloc(_pending, capacity * sizeof(*_pending));
+        if (pending == NULL) {
+            // keep the queued commands, drop this one
+            os_unfair_lock_unlock(&_batchLock);
+            [ULog e:TAG msg:@"ArsdkCore: command dropped, batch growth failed: %s", strerror(ENOMEM)];
+            return;
+        }
+        memset(pending + _pendingCapacity, 0, (capacity - _pendingCapacity) * sizeof(*pending));
+        _pending = pending;
+        _pendingCapacity = capacity;
+    }
+    arsdk_cmd_copy(&_pending[_pendingCount++], command);
+    _maxDepth = MAX(_maxDepth, _pendingCount);
+    if (!_deliveryScheduled) {
+        _deliveryScheduled = YES;
+        scheduleDelivery = YES;
+    }
+    os_unfair_lock_unlock(&_batchLock);
+
+    if (scheduleDelivery) {
+        dispatch_block_t block = ^{
+            [self deliverCommands];
+        };
+        if (_batchMaxLatencyMs > 0) {
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)_batchMaxLatencyMs * NSEC_PER_MSEC),
+                           dispatch_get_main_queue(), block);
+        } else {
+            dispatch_async(dispatch_get_main_queue(), block);
+        }
+    }
+}
+
+- (void)deliverCommands {
+    os_unfair_lock_lock(&_batchLock);
+    struct arsdk_cmd *batch = _pending;
+    size_t batchCount = _pendingCount;
+    size_t batchCapacity = _pendingCapacity;
+    size_t maxDepth = _maxDepth;
+    _pending = _spare;
+    _pendingCapacity = _spareCapacity;
+    _pendingCount = 0;
+    _spare = NULL;
+    _spareCapacity = 0;
+    _maxDepth = 0;
+    _deliveryScheduled = NO;
+    os_unfair_lock_unlock(&_batchLock);
+
+    for (size_t i = 0; i < batchCount; i++) {
+        [_core passCommandToListeners:&batch[i] forDevice:_handle];
+        [_listener onCommandReceived:&batch[i]];
+        arsdk_cmd_clear(&batch[i]);
+    }
+    if (batchCount > 0) {
+        [_core recordCommandBatch:batchCount queueDepth:maxDepth];
+    }
+
+    os_unfair_lock_lock(&_batchLock);
+    _spare = batch;
+    _spareCapacity = batchCapacity;
+    os_unfair_lock_unlock(&_batchLock);
+}
+
+- (void)notifyLinkDown {
+    // deliver commands still batched before notifying the link loss
+    if (_batchMaxLatencyMs != ARSDK_CMD_BATCH_DISABLED) {
+        [self deliverCommands];
+    }
+    [_listener onLinkDown];
+}
+
+- (void)notifyDisconnected:(BOOL)removing {
+    // deliver commands still batched before notifying the disconnection
+    if (_batchMaxLatencyMs != ARSDK_CMD_BATCH_DISABLED) {
+        [self deliverCommands];
+    }
+    [_core deviceDisconnected:_handle];
+    [_listener onDisconnected:removing];
+}
+
+- (struct cmd_container *)acquireCommandContainer {
+    os_unfair_lock_lock(&_batchLock);
+    struct cmd_container *container = _freeContainers;
+    if (container != NULL) {
+        _freeContainers = container->next;
+        _freeContainerCount--;
+    }
+    os_unfair_lock_unlock(&_batchLock);
+
+    if (container == NULL) {
+        container = calloc(1, sizeof(*container));
+    }
+    container->next = NULL;
+    return container;
+}
+
+- (void)recycleCommandContainer:(struct cmd_container *)container {
+    os_unfair_lock_lock(&_batchLock);
+    if (_freeContainerCount < CMD_CONTAINER_MAX_FREE) {
+        container->next = _freeContainers;
+        _freeContainers = container;
+        _freeContainerCount++;
+        container = NULL;
+    }
+    os_unfair_lock_unlock(&_batchLock);
+    free(container);
+}
+
+- (void)dealloc {
+    for (size_t i = 0; i < _pendingCount; i++) {
+        arsdk_cmd_clear(&_pending[i]);
+    }
+    free(_pending);
+    free(_spare);
+    while (_freeContainers != NULL) {
+        struct cmd_container *container = _freeContainers;
+        _freeContainers = container->next;
+        free(container);
+    }
+}
+
+@end
+
+@interface ArsdkCommandReceiver ()
+
+/** Handler of the device receiving the commands */
+@property (nonatomic, strong) ArsdkCoreDeviceListenerHandler *handler;
+
+- (instancetype)initWithHandler:(ArsdkCoreDeviceListenerHandler * _Nonnull)handler;
+
 @end
 
 @implementation ArsdkCore (Devices)
@@ -144,8 +375,11 @@ short const ARSDK_INVALID_DEVICE_HANDLE = ARSDK_INVALID_HANDLE;
     if ([ULog d:TAG]) {
         [ULog d:TAG msg:@"connecting device handle %d", handle];
     }
+    int batchMaxLatencyMs = self.commandBatchMaxLatencyMs;
     [self dispatch:^{
-        ArsdkCoreDeviceListenerHandler *handler = [[ArsdkCoreDeviceListenerHandler alloc] initWithArsdkCore:self listener:deviceListener handle:handle];
+        ArsdkCoreDeviceListenerHandler *handler = [[ArsdkCoreDeviceListenerHandler alloc]
+                                                   initWithArsdkCore:self listener:deviceListener handle:handle
+                                                   batchMaxLatencyMs:batchMaxLatencyMs];
         struct arsdk_device *nativeDevice = arsdk_ctrl_get_device(self.ctrl, handle);
         if (nativeDevice ==  NULL) {
             [ULog e:TAG msg:@"ArsdkCore.connectDevice arsdk_ctrl_get_device: nativeDevice not found"];
@@ -244,11 +478,13 @@ short const ARSDK_INVALID_DEVICE_HANDLE = ARSDK_INVALID_HANDLE;
 - (void)createNoAckCmdLoop:(int16_t)handle periodMs:(int)period {
     [self assertCallerThread];
 
+    BOOL dedicatedThread = self.noAckCmdLoopDedicatedThread;
     [self dispatch:^{
 
         NoAckCommandLoop* pcmdLoop = [[NoAckCommandLoop alloc] initWithArsdkctrl:self.ctrl
                                                                     deviceHandle:handle
-                                                                        periodMs:(int)period];
+                                                                        periodMs:(int)period
+                                                                 dedicatedThread:dedicatedThread];
 
         struct arsdk_device *nativeDevice = arsdk_ctrl_get_device(self.ctrl, handle);
         if (nativeDevice ==  NULL) {
@@ -323,6 +559,27 @@ short const ARSDK_INVALID_DEVICE_HANDLE = ARSDK_INVALID_HANDLE;
     }];
 }
 
+- (void)getNoAckCmdLoopStats:(int16_t)handle completion:(void (^)(ArsdkNoAckLoopStats stats))completion {
+    [self assertCallerThread];
+
+    [self dispatch:^{
+        ArsdkNoAckLoopStats stats;
+        memset(&stats, 0, sizeof(stats));
+
+        struct arsdk_device *nativeDevice = arsdk_ctrl_get_device(self.ctrl, handle);
+        struct arsdk_cmd_itf *cmd_itf = nativeDevice != NULL ? arsdk_device_get_cmd_itf(nativeDevice) : NULL;
+        if (cmd_itf != NULL) {
+            NoAckCommandLoop* pcmdLoop = (__bridge NoAckCommandLoop*)arsdk_cmd_itf_get_osdata(cmd_itf);
+            if (pcmdLoop != nil) {
+                stats = pcmdLoop.stats;
+            }
+        }
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(stats);
+        });
+    }];
+}
+
 - (void)createTcpProxy:(int16_t)handle deviceType:(NSInteger)deviceType port:(uint16_t)port
             completion:(ArsdkTcpProxyCreationCompletion)completion {
     [self assertCallerThread];
@@ -438,8 +695,7 @@ static void disconnected (struct arsdk_device *nativeDevice, const struct arsdk_
 
     BOOL removing = info->state == ARSDK_DEVICE_STATE_REMOVING;
     dispatch_async(dispatch_get_main_queue(), ^{
-        [handler.core deviceDisconnected:handler.handle];
-        [handler.listener onDisconnected:removing];
+        [handler notifyDisconnected:removing];
     });
 }
 
@@ -460,24 +716,38 @@ static void link_status (struct arsdk_device *nativeDevice, const struct arsdk_d
     ArsdkCoreDeviceListenerHandler *handler = (__bridge ArsdkCoreDeviceListenerHandler *)(userdata);
     if (status == ARSDK_LINK_STATUS_KO) {
         dispatch_async(dispatch_get_main_queue(), ^{
-            [handler.listener onLinkDown];
+            [handler notifyLinkDown];
         });
     }
 }
 
 #pragma mark - commands callback impl
 
+/** Delivers a received command to the listeners, called on the main queue with a `struct cmd_container` */
+static void deliver_cmd(void *context) {
+    struct cmd_container *container = context;
+    ArsdkCoreDeviceListenerHandler *handler = (__bridge_transfer ArsdkCoreDeviceListenerHandler *)container->handler;
+    container->handler = NULL;
+
+    [handler.core passCommandToListeners:&container->cmd forDevice:handler.handle];
+    [handler.listener onCommandReceived:&container->cmd];
+    arsdk_cmd_clear(&container->cmd);
+    [handler recycleCommandContainer:container];
+}
+
 static void recv_cmd(struct arsdk_cmd_itf *itf, const struct arsdk_cmd *cmd, void *userdata) {
     ArsdkCoreDeviceListenerHandler *handler = (__bridge ArsdkCoreDeviceListenerHandler *)(userdata);
 
-    struct arsdk_cmd *cmdCpy = calloc(1, sizeof(*cmd));
-    arsdk_cmd_copy(cmdCpy, cmd);
-    dispatch_async(dispatch_get_main_queue(), ^{
-        [handler.core passCommandToListeners:cmdCpy forDevice:handler.handle];
-        [handler.listener onCommandReceived:cmdCpy];
-        arsdk_cmd_clear(cmdCpy);
-        free(cmdCpy);
-    });
+    if (handler.batchMaxLatencyMs != ARSDK_CMD_BATCH_DISABLED) {
+        [handler queueCommand:cmd];
+        return;
+    }
+
+    // container and handler reference are passed as a plain context to avoid allocating a block per command
+    struct cmd_container *container = [handler acquireCommandContainer];
+    arsdk_cmd_copy(&container->cmd, cmd);
+    container->handler = (__bridge_retained void *)handler;
+    dispatch_async_f(dispatch_get_main_queue(), container, &deliver_cmd);
 }
 
 static void cmd_sent_status(struct arsdk_cmd_itf *itf, const struct arsdk_cmd *cmd,
@@ -539,5 +809,43 @@ static void proxy_close_cb(struct arsdk_device_tcp_proxy *proxy, void *userdata)
     [arsdkProxy close];
 }
 
+- (ArsdkCommandReceiver *)commandReceiverForDevice:(int16_t)handle
+                                    deviceListener:(id<ArsdkCoreDeviceListener>)deviceListener {
+    ArsdkCoreDeviceListenerHandler *handler = [[ArsdkCoreDeviceListenerHandler alloc]
+                                               initWithArsdkCore:self listener:deviceListener handle:handle
+                                               batchMaxLatencyMs:self.commandBatchMaxLatencyMs];
+    return [[ArsdkCommandReceiver alloc] initWithHandler:handler];
+}
+
+@end
+
+@implementation ArsdkCommandReceiver
+
+- (instancetype)initWithHandler:(ArsdkCoreDeviceListenerHandler *)handler {
+    self = [super init];
+    if (self) {
+        _handler = handler;
+    }
+    return self;
+}
+
+- (void)receiveCommand:(const struct arsdk_cmd *)command {
+    recv_cmd(NULL, command, (__bridge void *)_handler);
+}
+
+- (void)linkDown {
+    ArsdkCoreDeviceListenerHandler *handler = _handler;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [handler notifyLinkDown];
+    });
+}
+
+- (void)disconnect:(BOOL)removing {
+    ArsdkCoreDeviceListenerHandler *handler = _handler;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [handler notifyDisconnected:removing];
+    });
+}
+
 @end
 #
@@ -144,9 +144,10 @@ static void flight_log_progress(struct arsdk_flight_log_itf *itf,
                              void *userdata) {
     FlightLogDownloadRequest* request = (__bridge FlightLogDownloadRequest*)(userdata);
     NSString* nspath = [NSString stringWithUTF8String:path];
-    dispatch_async(dispatch_get_main_queue(), ^{
+    // each progress reports a file, they are batched but never coalesced
+    [request postEvent:^{
         request.progressBlock(nspath, (ArsdkFlightLogStatus)status);
-    });
+    }];
 }
 
 static void flight_log_completed(struct arsdk_flight_log_itf *itf,
@@ -156,9 +157,9 @@ static void flight_log_completed(struct arsdk_flight_log_itf *itf,
                               void *userdata) {
     FlightLogDownloadRequest* request = (__bridge_transfer FlightLogDownloadRequest*)(userdata);
     request->_request = NULL;
-    dispatch_async(dispatch_get_main_queue(), ^{
+    [request postEvent:^{
         request.completionBlock((ArsdkFlightLogStatus)status);
-    });
+    }];
 }
 
 @end
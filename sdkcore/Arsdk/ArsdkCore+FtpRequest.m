@@ -122,6 +122,10 @@ static struct arsdk_ftp_itf *get_ftp_itf(struct arsdk_ctrl *ctrl, short device_h
     return self;
 }
 
+- (void)deliverProgress:(float)progress {
+    _progressBlock(progress);
+}
+
 - (void)cancel {
     [super cancel];
     // ignore request if already canceled
@@ -141,9 +145,7 @@ static void upload_progress(struct arsdk_ftp_itf *itf,
                             float percent,
                             void *userdata) {
     FtpUploadRequest* request = (__bridge FtpUploadRequest*)(userdata);
-    dispatch_async(dispatch_get_main_queue(), ^{
-        request.progressBlock(percent);
-    });
+    [request postProgress:percent];
 }
 
 static void upload_completed(struct arsdk_ftp_itf *itf,
@@ -153,9 +155,9 @@ static void upload_completed(struct arsdk_ftp_itf *itf,
                              void *userdata) {
     FtpUploadRequest* request = (__bridge_transfer FtpUploadRequest*)(userdata);
     request->_request = NULL;
-    dispatch_async(dispatch_get_main_queue(), ^{
+    [request postEvent:^{
         request.completionBlock((ArsdkFtpRequestStatus)status);
-    });
+    }];
 }
 
 @end
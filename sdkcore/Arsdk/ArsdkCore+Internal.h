@@ -39,8 +39,14 @@
 @property (nonatomic, strong) NSString * _Nonnull controllerDescriptor;
 /** Controller version, sent during connection */
 @property (nonatomic, strong) NSString * _Nonnull controllerVersion;
-/** ArsdkCoreDeviceCommandListener storage */
-@property (nonatomic, strong) NSMutableDictionary * _Nonnull commandListeners;
+/**
+ ArsdkCoreDeviceCommandListener storage, indexed by device handle.
+ Each entry is either an immutable array of the listeners of a connected device or `NSNull`. Trailing `NSNull` entries
+ are removed, so that the array does not extend past the highest connected handle.
+ */
+@property (nonatomic, strong) NSMutableArray * _Nonnull commandListeners;
+/** Backend type of added devices, by device handle. Only accessed from the main thread. */
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSNumber *> * _Nonnull deviceBackendTypes;
 
 /**
  Checks that current thread is the same than the one that called init
@@ -76,6 +82,14 @@
  */
 - (void)passCommandToListeners:(const struct arsdk_cmd * _Nonnull)command forDevice:(int16_t)handle;
 
+/**
+ Record a batch of received commands delivered to the main queue
+
+ @param size: number of commands in the batch
+ @param queueDepth: highest number of commands queued while this batch was accumulated
+ */
+- (void)recordCommandBatch:(NSUInteger)size queueDepth:(NSUInteger)queueDepth;
+
 /**
  Retrieves the pomp loop utility.
  
@@ -83,5 +97,15 @@
  */
 - (PompLoopUtil * _Nonnull)pompLoopUtil;
 
+/**
+ Retrieves the pomp loop utility on which a new video stream of a device must run.
+
+ Must be called on the thread that created the ArsdkCore.
+
+ @param handle: device handle
+ @return a dedicated stream loop if `streamLoopCount` allows it for this device, the arsdk loop otherwise
+ */
+- (PompLoopUtil * _Nonnull)streamLoopForDevice:(int16_t)handle;
+
 @end
 
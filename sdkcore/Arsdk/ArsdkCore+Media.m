@@ -455,6 +455,10 @@ static void download_thumbnail_completed(struct arsdk_media_itf *itf, struct ars
     return self;
 }
 
+- (void)deliverProgress:(float)progress {
+    _progressBlock(progress);
+}
+
 - (void)cancel {
     [super cancel];
     // ignore request if already canceled
@@ -472,9 +476,7 @@ static void download_thumbnail_completed(struct arsdk_media_itf *itf, struct ars
 static void download_progress(struct arsdk_media_itf *itf, struct arsdk_media_req_download *req,
                               float percent, void *userdata) {
     DownloadMediaRequest* request = (__bridge DownloadMediaRequest*)(userdata);
-    dispatch_async(dispatch_get_main_queue(), ^{
-        request.progressBlock(percent);
-    });
+    [request postProgress:percent];
 }
 
 static void download_completed(struct arsdk_media_itf *itf, struct arsdk_media_req_download *req,
@@ -486,9 +488,9 @@ static void download_completed(struct arsdk_media_itf *itf, struct arsdk_media_r
         fileUrl = [[NSURL alloc] initFileURLWithPath:filePath];
     }
     request->_request = NULL;
-    dispatch_async(dispatch_get_main_queue(), ^{
+    [request postEvent:^{
         request.completionBlock((ArsdkMediaStatus)status, fileUrl);
-    });
+    }];
 }
 
 @end
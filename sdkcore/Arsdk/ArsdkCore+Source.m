@@ -69,8 +69,39 @@ extern ULogTag *TAG;
 }
 
 - (int)open:(/*struct pdraw * */void*)ppdraw {
-    struct pdraw *pdraw = ppdraw;
+    __block int res = 0;
+    __block char *rtsp_url = NULL;
+
+    // the stream may run on a dedicated loop, devices must be accessed on the arsdk loop
+    [[_arsdkCore pompLoopUtil] dispatch_sync:^{
+        res = [self openOnArsdkLoop:ppdraw netUrl:&rtsp_url];
+    }];
+    if (res < 0) {
+        return res;
+    }
+
+    if (rtsp_url != NULL) {
+        // net stream, open it on the stream loop
+        res = pdraw_open_url(ppdraw, rtsp_url);
+        free(rtsp_url);
+        if (res < 0) {
+            [ULog e:TAG msg:@"ArsdkSource pdraw_open_url failed: %s", strerror(-res)];
+        }
+    }
+    return 0;
+}
+
+/**
+ Opens the source, must be called on the arsdk loop.
+
+ Streams over a mux backend are opened through a tcp proxy, on the arsdk loop. For net backends, the rtsp url to open
+ is returned, to be opened on the stream loop.
 
+ @param ppdraw: pdraw instance
+ @param netUrl: filled with the url of a net stream to open, must be freed by the caller
+ @return 0 if successful, a negative error code otherwise
+ */
+- (int)openOnArsdkLoop:(/*struct pdraw * */void*)ppdraw netUrl:(char **)netUrl {
     struct arsdk_device *device = arsdk_ctrl_get_device(_arsdkCore.ctrl, _deviceHandle);
     if (device == NULL) {
         [ULog e:TAG msg:@"ArsdkSource creation: nativeDevice not found"];
@@ -104,8 +135,7 @@ extern ULogTag *TAG;
                         res = -ENOMEM;
                         goto error;
                     }
-                    res = pdraw_open_url(pdraw, rtsp_url);
-                    free(rtsp_url);
+                    *netUrl = rtsp_url;
                     break;
                 default:
                     res = -ENODEV;
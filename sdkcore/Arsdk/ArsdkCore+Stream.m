@@ -59,7 +59,8 @@
                                       track:(NSString * _Nullable)track
                                    listener:(id<SdkCoreStreamListener> _Nonnull)listener {
     ArsdkSource *source = [[ArsdkSource alloc] initWithArsdkCore:arsdkCore deviceHandle:deviceHandle url:url];
-    return [super initWithPompLoopUtil:[arsdkCore pompLoopUtil] source:source track:track listener:listener];
+    return [super initWithPompLoopUtil:[arsdkCore streamLoopForDevice:deviceHandle] source:source track:track
+                              listener:listener];
 }
 
 @end
@@ -116,6 +116,10 @@ static struct arsdk_updater_itf *get_updater_itf(struct arsdk_ctrl *ctrl, short
     return self;
 }
 
+- (void)deliverProgress:(float)progress {
+    _progressBlock(progress);
+}
+
 - (void)cancel {
     [super cancel];
     // ignore request if already canceled
@@ -135,9 +139,7 @@ static void update_progress(struct arsdk_updater_itf *itf,
                             float percent,
                             void *userdata) {
     FirmwareUpdateRequest* request = (__bridge FirmwareUpdateRequest*)(userdata);
-    dispatch_async(dispatch_get_main_queue(), ^{
-        request.progressBlock(percent);
-    });
+    [request postProgress:percent];
 }
 
 static void update_completed(struct arsdk_updater_itf *itf,
@@ -147,9 +149,9 @@ static void update_completed(struct arsdk_updater_itf *itf,
                              void *userdata) {
     FirmwareUpdateRequest* request = (__bridge_transfer FirmwareUpdateRequest*)(userdata);
     request->_request = NULL;
-    dispatch_async(dispatch_get_main_queue(), ^{
+    [request postEvent:^{
         request.completionBlock((ArsdkUpdateStatus)status);
-    });
+    }];
 }
 
 @end
@@ -30,6 +30,7 @@
 #import <Foundation/Foundation.h>
 #import "ArsdkBackendType.h"
 #import "ArsdkApiCapabilities.h"
+#import "PompLoopUtil.h"
 
 /**
  ArsdkCore listener, notified when a device has been added/removed form arsdk
@@ -92,6 +93,39 @@ typedef NS_ENUM(NSInteger, ArsdkCmdLog) {
 
 extern ArsdkCmdLog arsdkCoreCmdLogLevel;
 
+/** Value of `commandBatchMaxLatencyMs` disabling received commands batching */
+extern int const ARSDK_CMD_BATCH_DISABLED;
+
+/** Number of buckets of the received commands batch size histogram */
+#define ARSDK_CMD_BATCH_HISTOGRAM_SIZE 6
+
+/**
+ Received commands batching statistics.
+
+ Aggregated for all connected devices. Only accessed from the main thread.
+ */
+@interface ArsdkCommandBatchStats : NSObject
+
+/** Number of batches delivered to the main queue */
+@property (nonatomic, assign, readonly) NSUInteger batchCount;
+/** Total number of commands delivered through batches */
+@property (nonatomic, assign, readonly) NSUInteger commandCount;
+/** Biggest batch delivered so far */
+@property (nonatomic, assign, readonly) NSUInteger maxBatchSize;
+/** Highest number of commands waiting in a device queue, measured on the pomp loop */
+@property (nonatomic, assign, readonly) NSUInteger maxQueueDepth;
+/**
+ Batch size histogram, with power of two buckets: 1, 2-3, 4-7, 8-15, 16-31 and 32+ commands.
+ */
+@property (nonatomic, strong, readonly) NSArray<NSNumber *> * _Nonnull batchSizeHistogram;
+
+/**
+ Resets all counters
+ */
+- (void)reset;
+
+@end
+
 /**
  Arsdk Controller
  Wrapper around arsdk-ng.
@@ -101,6 +135,47 @@ extern ArsdkCmdLog arsdkCoreCmdLogLevel;
 /** Native arsdk manager */
 @property (nonatomic, assign, readonly) struct arsdk_ctrl * _Nonnull ctrl;
 
+/**
+ Maximum time, in milliseconds, received commands may be kept on the pomp loop before being delivered to the main
+ queue.
+
+ When batching is enabled, commands received from a device are accumulated in preallocated slots and delivered in
+ a single main queue block, at most `commandBatchMaxLatencyMs` after the first command of the batch has been
+ received. `0` delivers as soon as the main queue is available, coalescing all commands received in the meantime.
+ Default is `ARSDK_CMD_BATCH_DISABLED`: each command is delivered by its own main queue block.
+
+ Only applies to devices connected after the value has been changed.
+ */
+@property (nonatomic, assign) int commandBatchMaxLatencyMs;
+
+/**
+ Whether NoAck command loops encode their commands on a dedicated high priority thread, instead of a timer of the
+ arsdk loop. Only applies to loops created after the value has been changed. Default is `NO`.
+ */
+@property (nonatomic, assign) BOOL noAckCmdLoopDedicatedThread;
+
+/**
+ Minimum interval, in milliseconds, between two progress notifications of a request, such as an upload or a download.
+
+ Progress values reported in between are coalesced, only the latest one is notified. Start, end and terminal states
+ of requests are always notified. `0` notifies the latest progress once per main queue turn. Only applies to requests
+ created after the value has been changed. Default is `100`.
+ */
+@property (nonatomic, assign) int progressNotificationIntervalMs;
+
+/** Received commands batching statistics */
+@property (nonatomic, strong, readonly) ArsdkCommandBatchStats * _Nonnull commandBatchStats;
+
+/**
+ Number of dedicated pomp loops running live video streams, instead of the arsdk loop. Each of these loops runs on
+ its own thread.
+
+ Streams are assigned to the dedicated loops in turn. Streams of devices connected through a usb mux backend always
+ run on the arsdk loop, which owns the mux. Only applies to streams created after the value has been changed.
+ Default is `0`: all streams run on the arsdk loop.
+ */
+@property (nonatomic, assign) NSUInteger streamLoopCount;
+
 /**
  Constructor
 
@@ -128,4 +203,11 @@ extern ArsdkCmdLog arsdkCoreCmdLogLevel;
  Dispatch in pomp loop
  */
 - (void)dispatch_sync:(void (^ _Nonnull)(void))block;
+
+/**
+ Gets the utilisation statistics of the arsdk loop, followed by those of the dedicated stream loops.
+
+ @return loops statistics
+ */
+- (NSArray<PompLoopStats *> * _Nonnull)loopStats;
 @end
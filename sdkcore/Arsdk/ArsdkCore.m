@@ -40,6 +40,61 @@ ULogTag *TAG;
 
 ArsdkCmdLog arsdkCoreCmdLogLevel = ArsdkCmdLogNone;
 
+int const ARSDK_CMD_BATCH_DISABLED = -1;
+
+@interface ArsdkCommandBatchStats ()
+
+/**
+ Record a delivered batch
+
+ @param size: number of commands in the batch
+ @param queueDepth: highest number of commands queued while this batch was accumulated
+ */
+- (void)recordBatch:(NSUInteger)size queueDepth:(NSUInteger)queueDepth;
+
+@end
+
+@implementation ArsdkCommandBatchStats {
+    /** Batch size histogram counters */
+    NSUInteger _histogram[ARSDK_CMD_BATCH_HISTOGRAM_SIZE];
+}
+
+- (NSArray<NSNumber *> *)batchSizeHistogram {
+    NSMutableArray *histogram = [[NSMutableArray alloc] initWithCapacity:ARSDK_CMD_BATCH_HISTOGRAM_SIZE];
+    for (int i = 0; i < ARSDK_CMD_BATCH_HISTOGRAM_SIZE; i++) {
+        [histogram addObject:@(_histogram[i])];
+    }
+    return histogram;
+}
+
+- (void)recordBatch:(NSUInteger)size queueDepth:(NSUInteger)queueDepth {
+    _batchCount++;
+    _commandCount += size;
+    _maxBatchSize = MAX(_maxBatchSize, size);
+    _maxQueueDepth = MAX(_maxQueueDepth, queueDepth);
+    int bucket = 0;
+    while (bucket < ARSDK_CMD_BATCH_HISTOGRAM_SIZE - 1 && (size >> (bucket + 1)) > 0) {
+        bucket++;
+    }
+    _histogram[bucket]++;
+}
+
+- (void)reset {
+    _batchCount = 0;
+    _commandCount = 0;
+    _maxBatchSize = 0;
+    _maxQueueDepth = 0;
+    memset(_histogram, 0, sizeof(_histogram));
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"batches: %lu commands: %lu maxBatch: %lu maxDepth: %lu histogram: %@",
+            (unsigned long)_batchCount, (unsigned long)_commandCount, (unsigned long)_maxBatchSize,
+            (unsigned long)_maxQueueDepth, [self.batchSizeHistogram componentsJoinedByString:@","]];
+}
+
+@end
+
 @interface ArsdkCore ()
 /** Array of managed backend controllers */
 @property (nonatomic, strong) NSArray* backendControllers;
@@ -49,6 +104,12 @@ ArsdkCmdLog arsdkCoreCmdLogLevel = ArsdkCmdLogNone;
 @property (nonatomic, strong) NSThread *callerThread;
 /** PompLoop Util for ArsdkCore */
 @property (nonatomic, strong) PompLoopUtil *pompLoopUtil;
+/** Dedicated stream loops, created on demand, up to `streamLoopCount` */
+@property (nonatomic, strong) NSMutableArray<PompLoopUtil *> *streamLoops;
+/** Index of the dedicated stream loop to assign to the next stream */
+@property (nonatomic, assign) NSUInteger nextStreamLoop;
+/** Whether the loops are running */
+@property (nonatomic, assign) BOOL started;
 @end
 
 /** pomp loop queue identifier */
@@ -80,7 +141,12 @@ static const void *const kLooperQueueIdentifier = &kLooperQueueIdentifier;
         _callerThread = [NSThread currentThread];
         _backendControllers = backendControllers;
         _listener = listener;
-        _commandListeners = [[NSMutableDictionary alloc] init];
+        _commandListeners = [[NSMutableArray alloc] init];
+        _commandBatchMaxLatencyMs = ARSDK_CMD_BATCH_DISABLED;
+        _commandBatchStats = [[ArsdkCommandBatchStats alloc] init];
+        _progressNotificationIntervalMs = 100;
+        _streamLoops = [[NSMutableArray alloc] init];
+        _deviceBackendTypes = [[NSMutableDictionary alloc] init];
 
         /* create the loop */
         self.pompLoopUtil = [[PompLoopUtil alloc] initWithName:@"arsdkcore.pomloop"];
@@ -139,6 +205,10 @@ error:
         [backendController start:self];
     }
     [self.pompLoopUtil runLoop];
+    for (PompLoopUtil *streamLoop in _streamLoops) {
+        [streamLoop runLoop];
+    }
+    _started = YES;
 }
 
 /**
@@ -149,6 +219,39 @@ error:
         [ULog d:TAG msg:@"stopping ArsdkCore"];
     }
     [self.pompLoopUtil stopRun];
+    // stream loops are kept, streams hold them weakly
+    for (PompLoopUtil *streamLoop in _streamLoops) {
+        [streamLoop stopRun];
+    }
+    _started = NO;
+}
+
+- (PompLoopUtil * _Nonnull)streamLoopForDevice:(int16_t)handle {
+    [self assertCallerThread];
+    // streams over a mux must run on the loop owning the mux
+    NSNumber *backendType = _deviceBackendTypes[@(handle)];
+    if (_streamLoopCount == 0 || backendType == nil || backendType.integerValue == ArsdkBackendTypeMux) {
+        return _pompLoopUtil;
+    }
+    NSUInteger index = _nextStreamLoop++ % _streamLoopCount;
+    if (index >= _streamLoops.count) {
+        NSString *name = [NSString stringWithFormat:@"arsdkcore.stream%lu", (unsigned long)index];
+        PompLoopUtil *streamLoop = [[PompLoopUtil alloc] initWithName:name dedicatedThread:YES];
+        if (_started) {
+            [streamLoop runLoop];
+        }
+        [_streamLoops addObject:streamLoop];
+        index = _streamLoops.count - 1;
+    }
+    return _streamLoops[index];
+}
+
+- (NSArray<PompLoopStats *> *)loopStats {
+    NSMutableArray *stats = [[NSMutableArray alloc] initWithObjects:[_pompLoopUtil stats], nil];
+    for (PompLoopUtil *streamLoop in _streamLoops) {
+        [stats addObject:[streamLoop stats]];
+    }
+    return stats;
 }
 
 /**
@@ -188,6 +291,7 @@ static void device_added(struct arsdk_device *nativeDevice, void *userdata)
     }
 
     dispatch_async(dispatch_get_main_queue(), ^{
+        self.deviceBackendTypes[@(handle)] = @(info->backend_type);
         [self.listener onDeviceAdded:[NSString stringWithUTF8String:info->id]
                                 type:info->type
                          backendType:(ArsdkBackendType)info->backend_type
@@ -215,6 +319,7 @@ static void device_removed(struct arsdk_device *nativeDevice, void *userdata)
     ArsdkBackendType backendType = (ArsdkBackendType)info->backend_type;
 
     dispatch_async(dispatch_get_main_queue(), ^{
+        [self.deviceBackendTypes removeObjectForKey:@(handle)];
         [self.listener onDeviceRemoved:deviceId
                                   type:deviceType
                            backendType:backendType
@@ -223,35 +328,62 @@ static void device_removed(struct arsdk_device *nativeDevice, void *userdata)
 }
 
 
+/**
+ Get the command listeners of a device
+
+ @param handle: the device handle
+ @return the listeners of the device, nil if the device is not connected
+ */
+- (NSArray *)commandListenersForDevice:(int16_t)handle
+{
+    NSUInteger index = (uint16_t)handle;
+    if (index >= _commandListeners.count)
+        return nil;
+
+    id listeners = _commandListeners[index];
+    return listeners != [NSNull null] ? listeners : nil;
+}
+
 - (void)deviceConnected:(int16_t)handle
 {
-    [self deviceDisconnected:handle];
-    NSNumber *key = @(handle);
-    NSMutableArray *arr = [[NSMutableArray alloc] init];
-    [self.commandListeners setObject:arr forKey:key];
+    NSUInteger index = (uint16_t)handle;
+    while (_commandListeners.count <= index) {
+        [_commandListeners addObject:[NSNull null]];
+    }
+    _commandListeners[index] = @[];
 }
 
 - (void)deviceDisconnected:(int16_t)handle
 {
-    NSNumber *key = @(handle);
-    [self.commandListeners removeObjectForKey:key];
+    NSUInteger index = (uint16_t)handle;
+    if (index < _commandListeners.count) {
+        _commandListeners[index] = [NSNull null];
+        // compact the array, so that it does not keep the size of the highest handle ever connected
+        while (_commandListeners.lastObject == [NSNull null]) {
+            [_commandListeners removeLastObject];
+        }
+    }
 }
 
 - (bool)addDeviceCommandListener:(id<ArsdkCoreDeviceCommandListener> _Nonnull)listener toDevice:(int16_t)handle
 {
-    NSNumber *key = @(handle);
-    NSMutableArray *arr = [self.commandListeners objectForKey:key];
+    NSArray *arr = [self commandListenersForDevice:handle];
     if (arr == nil)
         return NO;
 
-    [arr addObject:listener];
+    // listeners arrays are replaced rather than mutated, so that they can be enumerated while a listener is added
+    _commandListeners[(uint16_t)handle] = [arr arrayByAddingObject:listener];
     return YES;
 }
 
+- (void)recordCommandBatch:(NSUInteger)size queueDepth:(NSUInteger)queueDepth
+{
+    [_commandBatchStats recordBatch:size queueDepth:queueDepth];
+}
+
 - (void)passCommandToListeners:(const struct arsdk_cmd * _Nonnull)command forDevice:(int16_t)handle
 {
-    NSNumber *key = @(handle);
-    NSMutableArray *arr = [self.commandListeners objectForKey:key];
+    NSArray *arr = [self commandListenersForDevice:handle];
     if (arr == nil)
         return;
 
@@ -43,4 +43,31 @@
 
 - (void)cancel;
 
+/**
+ Posts a progress of the request, to be delivered on the main thread by `deliverProgress:`.
+
+ Progress values are coalesced: only the latest one is delivered, at most once per
+ `ArsdkCore.progressNotificationIntervalMs`. `0` and `100` are never coalesced.
+
+ @param progress: progress, in percent
+ */
+- (void)postProgress:(float)progress;
+
+/**
+ Posts an event of the request, such as a terminal state, to be executed on the main thread.
+
+ Events are never coalesced; they are delivered in order, after any progress posted before them. Events posted in a
+ row are delivered by a single main queue block.
+
+ @param event: event to execute on the main thread
+ */
+- (void)postEvent:(void (^ _Nonnull)(void))event;
+
+/**
+ Delivers a progress posted by `postProgress:`. Called on the main thread. Default implementation does nothing.
+
+ @param progress: progress, in percent
+ */
+- (void)deliverProgress:(float)progress;
+
 @end
@@ -28,13 +28,34 @@
 //    SUCH DAMAGE.
 
 #import "ArsdkRequest.h"
+#include <os/lock.h>
 
-@implementation ArsdkRequest
+@implementation ArsdkRequest {
+    /** Protects the pending progress and events, posted in the pomp loop thread and delivered on the main thread */
+    os_unfair_lock _lock;
+    /** Minimum interval between two progress deliveries, in nanoseconds */
+    uint64_t _progressIntervalNs;
+    /** Latest posted progress, valid if `_progressPending` is set */
+    float _pendingProgress;
+    /** Whether a posted progress has not been delivered yet */
+    bool _progressPending;
+    /** Whether a rate limited progress delivery is queued on the main queue */
+    bool _progressScheduled;
+    /** Monotonic time of the last progress delivery, in nanoseconds */
+    uint64_t _lastProgressNs;
+    /** Posted events, not delivered yet */
+    NSMutableArray<void (^)(void)> *_pendingEvents;
+    /** Whether an events delivery is queued on the main queue */
+    bool _eventsScheduled;
+}
 
 - (instancetype)initWithArsdkCore:(ArsdkCore*)arsdkCore {
     self = [super init];
     if (self) {
         _arsdkCore = arsdkCore;
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _progressIntervalNs = (uint64_t)MAX(arsdkCore.progressNotificationIntervalMs, 0) * NSEC_PER_MSEC;
+        _pendingEvents = [[NSMutableArray alloc] init];
     }
     return self;
 }
@@ -43,4 +64,93 @@
     _canceled = true;
 }
 
+- (void)postProgress:(float)progress {
+    if (progress <= 0 || progress >= 100) {
+        // never coalesce the start and the end of the request
+        [self postEvent:^{
+            [self deliverProgress:progress];
+        }];
+        return;
+    }
+    uint64_t now = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    os_unfair_lock_lock(&_lock);
+    _pendingProgress = progress;
+    _progressPending = true;
+    bool schedule = !_progressScheduled;
+    _progressScheduled = true;
+    uint64_t nextNs = _lastProgressNs + _progressIntervalNs;
+    os_unfair_lock_unlock(&_lock);
+
+    if (schedule) {
+        void (^deliver)(void) = ^{
+            os_unfair_lock_lock(&self->_lock);
+            self->_progressScheduled = false;
+            os_unfair_lock_unlock(&self->_lock);
+            [self deliverPending];
+        };
+        if (nextNs > now) {
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(nextNs - now)), dispatch_get_main_queue(),
+                           deliver);
+        } else {
+            dispatch_async(dispatch_get_main_queue(), deliver);
+        }
+    }
+}
+
+- (void)postEvent:(void (^)(void))event {
+    os_unfair_lock_lock(&_lock);
+    if (_progressPending) {
+        // progress posted before the event must be delivered before it
+        float progress = _pendingProgress;
+        _progressPending = false;
+        [_pendingEvents addObject:^{
+            [self deliverProgress:progress];
+        }];
+    }
+    [_pendingEvents addObject:event];
+    bool schedule = !_eventsScheduled;
+    _eventsScheduled = true;
+    os_unfair_lock_unlock(&_lock);
+
+    if (schedule) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            os_unfair_lock_lock(&self->_lock);
+            self->_eventsScheduled = false;
+            os_unfair_lock_unlock(&self->_lock);
+            [self deliverPending];
+        });
+    }
+}
+
+- (void)deliverProgress:(float)progress {
+}
+
+/**
+ Delivers pending events, then the pending progress, which is more recent than all of them.
+
+ Called on the main thread.
+ */
+- (void)deliverPending {
+    NSArray<void (^)(void)> *events = nil;
+    os_unfair_lock_lock(&_lock);
+    if (_pendingEvents.count > 0) {
+        events = _pendingEvents;
+        _pendingEvents = [[NSMutableArray alloc] init];
+    }
+    bool progressPending = _progressPending;
+    float progress = _pendingProgress;
+    _progressPending = false;
+    if (progressPending) {
+        _lastProgressNs = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    for (void (^event)(void) in events) {
+        event();
+    }
+    if (progressPending) {
+        [self deliverProgress:progress];
+    }
+}
+
 @end
@@ -1,4 +1,4 @@
-// Copyright (C) 2019 Parrot Drones SAS
+//    Copyright (C) 2019 Parrot Drones SAS
 //
 //    Redistribution and use in source and binary forms, with or without
 //    modification, are permitted provided that the following conditions
@@ -27,61 +27,46 @@
 //    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
 //    SUCH DAMAGE.
 
-import Foundation
+#import <Foundation/Foundation.h>
 
-/// A circular array that takes an encodable element
-struct BlackBoxCircularArray<T: Encodable>: Encodable {
-    /// Max size
-    let size: Int
-    /// Backing array
-    private var array: [T] = []
-    /// Writing head
-    private var head = 0
-    /// Whether the array has been fully written at least once
-    private var hasLooped = false
+/**
+ Streaming gzip file writer.
 
-    /// Output array
-    ///
-    /// Visibility is internal for testing purpose only
-    var readingArray: [T] {
-        if !hasLooped {
-            return array
-        } else {
-            // add to output the head to endIndex
-            var output = Array(array[head ..< size])
+ Written data is deflated chunk by chunk and each compressed chunk is appended to the file and fed to an incremental
+ md5 hash of the file content. Memory usage is bounded by the chunk size, whatever the amount of written data.
+ */
+@interface GzipFileWriter : NSObject
 
-            // add to output the beginning of array (which should be the last part in the output)
-            let endPart = Array(array[0 ..< head])
-            output.append(contentsOf: endPart)
+/** Md5 hash of the file content, available once the writer has been successfully finished, nil before */
+@property (nonatomic, readonly, nullable) NSString *md5;
 
-            return output
-        }
-    }
+/**
+ Constructor
 
-    /// Constructor
-    ///
-    /// - Parameter size: size of the circular array
-    init(size: Int) {
-        self.size = size
-    }
+ @param fileUrl url of the file to create, replaced if it exists
+ @param chunkSize size of the compressed chunks written to the file
+ @return a new writer, nil if the file could not be created
+ */
+- (instancetype _Nullable)initWithFileUrl:(NSURL *_Nonnull)fileUrl chunkSize:(size_t)chunkSize;
 
-    /// Appends a value to the circular array
-    ///
-    /// - Parameter value: the value to add
-    mutating func append(_ value: T) {
-        if !hasLooped {
-            array.append(value)
-        } else {
-            array[head] = value
-        }
-        head += 1
-        if head == size {
-            head = 0
-            hasLooped = true
-        }
-    }
+/**
+ Compresses data and writes it to the file
 
-    func encode(to encoder: Encoder) throws {
-        try readingArray.encode(to: encoder)
-    }
-}
+ @param data data to write
+ @return YES if data has been written, NO in case of error; the file is then deleted
+ */
+- (BOOL)write:(NSData *_Nonnull)data;
+
+/**
+ Writes the end of the compressed stream and closes the file
+
+ @return YES if the file has been successfully closed, NO in case of error; the file is then deleted
+ */
+- (BOOL)finish;
+
+/**
+ Closes and deletes the file
+ */
+- (void)abort;
+
+@end
@@ -0,0 +1,187 @@
+//    Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+#import "GzipFileWriter.h"
+#import <CommonCrypto/CommonCrypto.h>
+#include <zlib.h>
+
+@interface GzipFileWriter ()
+
+@property (nonatomic, strong) NSString *md5;
+
+@end
+
+@implementation GzipFileWriter {
+    /** deflate stream */
+    z_stream _stream;
+    /** whether the deflate stream has been initialized and not ended yet */
+    BOOL _streamOpened;
+    /** incremental md5 of the written compressed data */
+    CC_MD5_CTX _md5Ctx;
+    /** output file, NULL once closed */
+    FILE *_file;
+    /** output file url */
+    NSURL *_fileUrl;
+    /** compressed chunk buffer */
+    unsigned char *_chunk;
+    /** compressed chunk buffer size */
+    size_t _chunkSize;
+}
+
+- (instancetype)initWithFileUrl:(NSURL *)fileUrl chunkSize:(size_t)chunkSize {
+    self = [super init];
+    if (self) {
+        _fileUrl = fileUrl;
+        _chunkSize = chunkSize > 0 ? chunkSize : 16 * 1024;
+        _chunk = malloc(_chunkSize);
+        if (_chunk == NULL) {
+            return nil;
+        }
+
+        // request gzip header
+        _stream.zalloc = (alloc_func)Z_NULL;
+        _stream.zfree = (free_func)Z_NULL;
+        _stream.opaque = (voidpf)Z_NULL;
+        if (deflateInit2(&_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15+16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return nil;
+        }
+        _streamOpened = YES;
+
+        _file = fopen(fileUrl.fileSystemRepresentation, "wb");
+        if (_file == NULL) {
+            return nil;
+        }
+        CC_MD5_Init(&_md5Ctx);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self close];
+    free(_chunk);
+}
+
+- (BOOL)write:(NSData *)data {
+    if (_file == NULL) {
+        return NO;
+    }
+    const unsigned char *bytes = data.bytes;
+    NSUInteger remaining = data.length;
+    // avail_in is an uInt, feed very large data in several times
+    while (remaining > 0) {
+        uInt len = (uInt)MIN(remaining, (NSUInteger)UINT_MAX);
+        _stream.next_in = (Bytef *)bytes;
+        _stream.avail_in = len;
+        if (![self deflateWithFlush:Z_NO_FLUSH]) {
+            [self abort];
+            return NO;
+        }
+        bytes += len;
+        remaining -= len;
+    }
+    return YES;
+}
+
+- (BOOL)finish {
+    if (_file == NULL) {
+        return NO;
+    }
+    _stream.next_in = Z_NULL;
+    _stream.avail_in = 0;
+    if (![self deflateWithFlush:Z_FINISH] || fflush(_file) != 0) {
+        [self abort];
+        return NO;
+    }
+    if (![self close]) {
+        [[NSFileManager defaultManager] removeItemAtURL:_fileUrl error:nil];
+        return NO;
+    }
+
+    unsigned char md5Buffer[CC_MD5_DIGEST_LENGTH];
+    CC_MD5_Final(md5Buffer, &_md5Ctx);
+    NSMutableString *output = [NSMutableString stringWithCapacity:CC_MD5_DIGEST_LENGTH * 2];
+    for (int i = 0; i < CC_MD5_DIGEST_LENGTH; i++) {
+        [output appendFormat:@"%02x", md5Buffer[i]];
+    }
+    self.md5 = output;
+    return YES;
+}
+
+- (void)abort {
+    if (_file != NULL) {
+        [self close];
+        [[NSFileManager defaultManager] removeItemAtURL:_fileUrl error:nil];
+    }
+}
+
+/**
+ Deflates the pending input, writing each filled chunk to the file
+
+ @param flush deflate flush mode
+ @return YES if all the pending input has been deflated and written, NO in case of error
+ */
+- (BOOL)deflateWithFlush:(int)flush {
+    int ret;
+    do {
+        _stream.next_out = _chunk;
+        _stream.avail_out = (uInt)_chunkSize;
+        ret = deflate(&_stream, flush);
+        if (ret == Z_STREAM_ERROR) {
+            return NO;
+        }
+        size_t have = _chunkSize - _stream.avail_out;
+        if (have > 0) {
+            if (fwrite(_chunk, 1, have, _file) != have) {
+                return NO;
+            }
+            CC_MD5_Update(&_md5Ctx, _chunk, (CC_LONG)have);
+        }
+    } while (_stream.avail_out == 0);
+    return flush != Z_FINISH || ret == Z_STREAM_END;
+}
+
+/**
+ Ends the deflate stream and closes the file
+
+ @return YES if the file has been successfully closed
+ */
+- (BOOL)close {
+    if (_streamOpened) {
+        deflateEnd(&_stream);
+        _streamOpened = NO;
+    }
+    BOOL closed = YES;
+    if (_file != NULL) {
+        closed = fclose(_file) == 0;
+        _file = NULL;
+    }
+    return closed;
+}
+
+@end
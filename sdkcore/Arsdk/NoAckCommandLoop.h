@@ -50,6 +50,23 @@
                                deviceHandle:(short)deviceHandle
                                    periodMs:(int)period;
 
+/**
+ Constructor NoAckCommandLoop
+
+ In dedicated thread mode, commands are encoded on a high priority thread waking up at each tick deadline, then
+ handed to the arsdk loop to be sent. Otherwise, commands are encoded and sent by a timer of the arsdk loop.
+
+ @param ctrl arsdk ctrl instance
+ @param deviceHandle arsdk handle for the Device backend
+ @param period lopp period in ms
+ @param dedicatedThread `YES` to encode commands on a dedicated high priority thread
+ @return instance
+ */
+- (instancetype _Nonnull )initWithArsdkctrl:(struct arsdk_ctrl *_Nonnull)ctrl
+                               deviceHandle:(short)deviceHandle
+                                   periodMs:(int)period
+                            dedicatedThread:(BOOL)dedicatedThread;
+
 /**
  Set a  array of blocks to be executed continuously in the loop, each returning an ArsdkCommandEncoder
  These blocks `ArsdkCommandEncoder (^)(void)` are stored in NoAckStorage objects
@@ -64,4 +81,7 @@
 /** Ensure the loop is stopped and the ListOfEncoder is empty */
 - (void)reset;
 
+/** Loop timing statistics */
+@property (nonatomic, readonly) ArsdkNoAckLoopStats stats;
+
 @end
@@ -32,29 +32,178 @@
 #import <arsdkctrl/arsdkctrl.h>
 #import "Logger.h"
 #import "NoAckStorage.h"
+#include <stdatomic.h>
+#include <mach/mach_time.h>
+#include <os/lock.h>
 
 /** common loging tag */
 extern ULogTag *TAG;
 
-@interface NoAckCommandLoop()
+/**
+ Immutable table of NoAck command encoder blocks, built once each time the encoder list changes.
+ Blocks are retained by the table.
+ */
+struct encoder_table {
+    /** Number of encoder blocks */
+    size_t count;
+    /** Encoder blocks, `ArsdkCommandEncoder (^)(void)` */
+    const void *blocks[];
+};
+
+/**
+ Commands encoded by the dedicated thread, waiting to be sent by the arsdk loop.
+ */
+struct cmd_batch {
+    /** Scheduled time of the tick that encoded these commands, in microseconds */
+    uint64_t deadlineUs;
+    /** Number of encoded commands */
+    size_t count;
+    /** Number of allocated command slots */
+    size_t capacity;
+    /** Encoded commands */
+    struct arsdk_cmd cmds[];
+};
+
+/**
+ Creates an encoder table from an array of NoAck storages.
+
+ @param encoders: encoders to put in the table
+ @return the new table, NULL if the array is empty
+ */
+static struct encoder_table *encoder_table_new(NSArray<NoAckStorage *> *encoders) {
+    if (encoders.count == 0) {
+        return NULL;
+    }
+    struct encoder_table *table = malloc(sizeof(*table) + encoders.count * sizeof(table->blocks[0]));
+    if (table == NULL) {
+        return NULL;
+    }
+    table->count = 0;
+    for (NoAckStorage *storage in encoders) {
+        if (storage.encoderBlock != nil) {
+            table->blocks[table->count++] = (__bridge_retained const void *)storage.encoderBlock;
+        }
+    }
+    return table;
+}
+
+/**
+ Destroys an encoder table, releasing its blocks.
+
+ @param table: table to destroy, may be NULL
+ */
+static void encoder_table_destroy(struct encoder_table *table) {
+    if (table == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < table->count; i++) {
+        CFRelease(table->blocks[i]);
+    }
+    free(table);
+}
+
+/**
+ Clears all commands of a batch.
+
+ @param batch: batch to clear, may be NULL
+ */
+static void cmd_batch_clear(struct cmd_batch *batch) {
+    if (batch == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < batch->count; i++) {
+        arsdk_cmd_clear(&batch->cmds[i]);
+    }
+    batch->count = 0;
+}
 
-/** Array of NoAck command encoders */
-@property (atomic, strong) NSArray<NoAckStorage *> *encoders;
+/** Mach absolute time base */
+static mach_timebase_info_data_t s_timebase;
+
+/**
+ Gets current monotonic time.
+
+ @return monotonic time in microseconds
+ */
+static uint64_t monotonic_time_us(void) {
+    if (s_timebase.denom == 0) {
+        mach_timebase_info(&s_timebase);
+    }
+    return mach_absolute_time() * s_timebase.numer / s_timebase.denom / 1000;
+}
+
+/**
+ Blocks the calling thread until a given monotonic time.
+
+ @param deadlineUs: monotonic time, in microseconds, to wait for
+ */
+static void wait_until_us(uint64_t deadlineUs) {
+    if (s_timebase.denom == 0) {
+        mach_timebase_info(&s_timebase);
+    }
+    mach_wait_until(deadlineUs * 1000 * s_timebase.denom / s_timebase.numer);
+}
+
+@interface NoAckCommandLoop() {
+    /**
+     Encoder table published by `setEncoderList:`, not yet taken by the loop.
+     `ENCODER_TABLE_NONE` when no new table has been published since the loop took the previous one.
+     */
+    _Atomic(struct encoder_table *) _publishedTable;
+    /** Encoder table used by the loop, only accessed in the thread encoding the commands */
+    struct encoder_table *_table;
+    /** Device command interface, resolved on first send, cleared on reset */
+    struct arsdk_cmd_itf *_cmdItf;
+    /** Scheduled time of the next tick, in microseconds */
+    uint64_t _nextTickUs;
+    /** Lock protecting `_stats`, updated both by the dedicated thread and the arsdk loop */
+    os_unfair_lock _statsLock;
+    /** Timing statistics */
+    ArsdkNoAckLoopStats _stats;
+
+    /** Batch encoded by the dedicated thread, not sent yet */
+    _Atomic(struct cmd_batch *) _readyBatch;
+    /** Empty batch, ready to be filled by the dedicated thread */
+    _Atomic(struct cmd_batch *) _freeBatch;
+    /**
+     Flag set to request the current dedicated thread to exit. Owned by that thread, which frees it on exit; forgotten
+     by the loop once set.
+     */
+    atomic_bool *_threadStop;
+}
 
 /** device handle fot this pcmd loop */
 @property (nonatomic) int16_t device_handle;
 /** arsdk ctrl instance */
 @property (nonatomic) struct arsdk_ctrl *ctrl;
-/** loop timer */
+/** loop timer, in timer mode */
 @property (nonatomic) struct pomp_timer *timer;
+/** `YES` when the commands are encoded on a dedicated thread */
+@property (nonatomic) BOOL dedicatedThread;
+/** Dedicated thread, running while the loop is started, in dedicated thread mode */
+@property (nonatomic, strong) NSThread *thread;
+/** Semaphore signaled when the latest dedicated thread has exited */
+@property (nonatomic, strong) dispatch_semaphore_t threadExited;
+/**
+ Event signaled by the dedicated thread when a batch is ready. Attached to the arsdk loop while the thread is started,
+ destroyed by the thread when it exits
+ */
+@property (nonatomic) struct pomp_evt *batchEvent;
 
 /** period of the loop */
 @property (nonatomic) int periodMs;
 
 /** generate and send NoAck command */
 - (void)sendCommands;
+/** send the batch encoded by the dedicated thread */
+- (void)sendReadyBatch;
 @end
 
+/** Storage which address marks that no new table has been published in `_publishedTable` */
+static char encoder_table_none;
+/** Marker of `_publishedTable` meaning that no new table has been published */
+#define ENCODER_TABLE_NONE ((struct encoder_table *)&encoder_table_none)
+
 
 @implementation NoAckCommandLoop
 
@@ -68,6 +217,16 @@ static void pcmd_timer_cb(struct pomp_timer *timer, void *userdata) {
     }
 }
 
+/**
+ pomp event callback, called when the dedicated thread has encoded a batch
+ */
+static void pcmd_batch_evt_cb(struct pomp_evt *evt, void *userdata) {
+    NoAckCommandLoop* self = (__bridge NoAckCommandLoop *)(userdata);
+    if (self) {
+        [self sendReadyBatch];
+    }
+}
+
 /**
  Constructor NoAckCommandLoop
  @param ctrl arsdk ctrl instance
@@ -78,6 +237,22 @@ static void pcmd_timer_cb(struct pomp_timer *timer, void *userdata) {
 - (instancetype _Nonnull )initWithArsdkctrl:(struct arsdk_ctrl *_Nonnull)ctrl
                                deviceHandle:(short)deviceHandle
                                    periodMs:(int)period
+{
+    return [self initWithArsdkctrl:ctrl deviceHandle:deviceHandle periodMs:period dedicatedThread:NO];
+}
+
+/**
+ Constructor NoAckCommandLoop
+ @param ctrl arsdk ctrl instance
+ @param deviceHandle arsdk handle for the Device backend
+ @param period lopp period in ms
+ @param dedicatedThread `YES` to encode commands on a dedicated high priority thread
+ @return instance
+ */
+- (instancetype _Nonnull )initWithArsdkctrl:(struct arsdk_ctrl *_Nonnull)ctrl
+                               deviceHandle:(short)deviceHandle
+                                   periodMs:(int)period
+                            dedicatedThread:(BOOL)dedicatedThread
 {
     self = [super init];
     if (self) {
@@ -85,11 +260,30 @@ static void pcmd_timer_cb(struct pomp_timer *timer, void *userdata) {
         _timer = NULL;
         _ctrl = ctrl;
         _device_handle = deviceHandle;
-        _encoders = nil;
+        _dedicatedThread = dedicatedThread;
+        atomic_init(&_publishedTable, ENCODER_TABLE_NONE);
+        atomic_init(&_readyBatch, NULL);
+        atomic_init(&_freeBatch, NULL);
+        _threadStop = NULL;
+        _statsLock = OS_UNFAIR_LOCK_INIT;
+        _table = NULL;
+        _cmdItf = NULL;
     }
     return self;
 }
 
+- (void)dealloc {
+    struct encoder_table *published = atomic_exchange(&_publishedTable, ENCODER_TABLE_NONE);
+    if (published != ENCODER_TABLE_NONE) {
+        encoder_table_destroy(published);
+    }
+    encoder_table_destroy(_table);
+    struct cmd_batch *batch = atomic_exchange(&_readyBatch, NULL);
+    cmd_batch_clear(batch);
+    free(batch);
+    free(atomic_exchange(&_freeBatch, NULL));
+}
+
 /**
  Set a  array of blocks to be executed continuously in the loop, each returning an ArsdkCommandEncoder
  These blocks `ArsdkCommandEncoder (^)(void)` are stored in NoAckStorage objects
@@ -101,29 +295,92 @@ static void pcmd_timer_cb(struct pomp_timer *timer, void *userdata) {
  */
 - (void)setEncoderList:(NSArray<NoAckStorage *> *_Nullable)encoders
 {
-    self.encoders = encoders;
+    // publish the new table; a previous table not yet taken by the loop was never used and can be destroyed
+    struct encoder_table *table = encoder_table_new(encoders);
+    struct encoder_table *previous = atomic_exchange(&_publishedTable, table);
+    if (previous != ENCODER_TABLE_NONE) {
+        encoder_table_destroy(previous);
+    }
 
-    if (self.encoders.count && self.timer == nil) {
+    if (table != NULL && ![self isStarted]) {
         // start the loop
         [self start];
-    } else if (self.encoders.count == 0 && self.timer){
+    } else if (table == NULL && [self isStarted]){
         [self stop];
     }
 }
 
 /**
- Starts timer
+ Tells whether the loop is started
+
+ @return `YES` if the loop is started
+ */
+- (BOOL)isStarted {
+    return _timer != NULL || _thread != nil;
+}
+
+/**
+ Starts timer or dedicated thread
  */
 - (int)start {
+    if (_dedicatedThread) {
+        return [self startThread];
+    }
+    _nextTickUs = monotonic_time_us() + (uint64_t)self.periodMs * 1000;
     _timer = pomp_timer_new(arsdk_ctrl_get_loop(_ctrl), &pcmd_timer_cb, (__bridge void *)self);
     if (_timer == NULL)
         return -EINVAL;
-    int res = pomp_timer_set_periodic(_timer, self.periodMs, self.periodMs);
+    // the timer is re-armed on each tick, against absolute deadlines, so that delays do not accumulate
+    int res = pomp_timer_set(_timer, self.periodMs);
     return res;
 }
 
 /**
- Stops timer
+ Starts the dedicated thread
+ */
+- (int)startThread {
+    struct pomp_evt *event = pomp_evt_new();
+    atomic_bool *stop = malloc(sizeof(*stop));
+    if (event == NULL || stop == NULL) {
+        if (event != NULL) {
+            pomp_evt_destroy(event);
+        }
+        free(stop);
+        return -ENOMEM;
+    }
+    int res = pomp_evt_attach_to_loop(event, arsdk_ctrl_get_loop(_ctrl), &pcmd_batch_evt_cb, (__bridge void *)self);
+    if (res < 0) {
+        pomp_evt_destroy(event);
+        free(stop);
+        return res;
+    }
+    atomic_init(stop, false);
+    _batchEvent = event;
+    _threadStop = stop;
+
+    // a previous thread may still be finishing its last tick: the new thread waits for its exit, so that encoding
+    // state is never accessed by two threads
+    dispatch_semaphore_t previousExited = _threadExited;
+    dispatch_semaphore_t threadExited = dispatch_semaphore_create(0);
+    _threadExited = threadExited;
+    _thread = [[NSThread alloc] initWithBlock:^{
+        if (previousExited != nil) {
+            dispatch_semaphore_wait(previousExited, DISPATCH_TIME_FOREVER);
+        }
+        [self threadMainWithStop:stop event:event];
+        // the event has been detached from the loop when the stop was requested, nothing can use it anymore
+        pomp_evt_destroy(event);
+        free(stop);
+        dispatch_semaphore_signal(threadExited);
+    }];
+    _thread.name = @"com.parrot.arsdk.noack";
+    _thread.qualityOfService = NSQualityOfServiceUserInteractive;
+    [_thread start];
+    return 0;
+}
+
+/**
+ Stops timer or dedicated thread
  */
 - (void)stop {
     if (_timer) {
@@ -131,44 +388,248 @@ static void pcmd_timer_cb(struct pomp_timer *timer, void *userdata) {
         pomp_timer_destroy(_timer);
         _timer = NULL;
     }
+    if (_thread) {
+        [self stopThread];
+    }
+    ArsdkNoAckLoopStats stats = self.stats;
+    if (stats.ticks > 0) {
+        [ULog i:TAG msg:@"NoAckCommandLoop stopped, ticks: %llu late: %llu missed: %llu avg lateness: %lluus "
+         "max: %lluus max send latency: %lluus",
+         stats.ticks, stats.lateTicks, stats.missedTicks, stats.totalLatenessUs / stats.ticks,
+         stats.maxLatenessUs, stats.maxSendLatencyUs];
+    }
+}
+
+/**
+ Requests the dedicated thread to stop, without waiting for its exit.
+
+ The batch event is detached so that no batch is sent anymore; the thread destroys it, with its stop flag, when it
+ exits, at the latest on its next tick.
+ */
+- (void)stopThread {
+    pomp_evt_detach_from_loop(_batchEvent, arsdk_ctrl_get_loop(_ctrl));
+    _batchEvent = NULL;
+    atomic_store(_threadStop, true);
+    _threadStop = NULL;
+    _thread = nil;
 }
 
 - (void)reset {
     [self setEncoderList:nil];
+    // the command interface is destroyed with the device connection
+    _cmdItf = NULL;
+}
+
+- (ArsdkNoAckLoopStats)stats {
+    os_unfair_lock_lock(&_statsLock);
+    ArsdkNoAckLoopStats stats = _stats;
+    os_unfair_lock_unlock(&_statsLock);
+    return stats;
 }
 
 /**
- Generate and send NoAck commands
+ Records the lateness of the current tick, and computes the next tick scheduled time.
+
+ @return the scheduled time of the current tick, in microseconds
  */
-- (void)sendCommands {
+- (uint64_t)recordTick {
+    uint64_t now = monotonic_time_us();
+    uint64_t periodUs = (uint64_t)_periodMs * 1000;
+    uint64_t deadline = _nextTickUs;
+    uint64_t lateness = now > deadline ? now - deadline : 0;
+    uint64_t missed = 0;
+
+    // next deadline is one period after this one; deadlines that already elapsed are skipped
+    _nextTickUs += periodUs;
+    if (_nextTickUs <= now) {
+        missed = (now - _nextTickUs) / periodUs + 1;
+        _nextTickUs += missed * periodUs;
+    }
 
-    // get the list of encoders
-    // keep a strong reference
-    NSArray<NoAckStorage *> *encodersArray = self.encoders;
+    static const uint64_t bucketsUpperUs[NOACK_LOOP_HISTOGRAM_SIZE - 1] = {
+        1000, 2000, 5000, 10000, 20000, 50000
+    };
+    int bucket = 0;
+    while (bucket < NOACK_LOOP_HISTOGRAM_SIZE - 1 && lateness >= bucketsUpperUs[bucket]) {
+        bucket++;
+    }
 
-    struct arsdk_device *device = arsdk_ctrl_get_device(_ctrl, _device_handle);
-    if (device ==  NULL) {
-        [ULog e:TAG msg:@"NoAckCommandLoop.sendCommand arsdk_ctrl_get_device: device not found"];
-        return;
+    os_unfair_lock_lock(&_statsLock);
+    _stats.ticks++;
+    _stats.totalLatenessUs += lateness;
+    _stats.maxLatenessUs = MAX(_stats.maxLatenessUs, lateness);
+    if (lateness > periodUs / 2) {
+        _stats.lateTicks++;
+    }
+    _stats.missedTicks += missed;
+    _stats.histogram[bucket]++;
+    os_unfair_lock_unlock(&_statsLock);
+
+    return deadline;
+}
+
+/**
+ Records the latency between the scheduled time of a tick and the actual send of its commands.
+
+ @param deadlineUs: scheduled time of the tick, in microseconds
+ */
+- (void)recordSendForDeadline:(uint64_t)deadlineUs {
+    uint64_t now = monotonic_time_us();
+    uint64_t latency = now > deadlineUs ? now - deadlineUs : 0;
+    os_unfair_lock_lock(&_statsLock);
+    _stats.totalSendLatencyUs += latency;
+    _stats.maxSendLatencyUs = MAX(_stats.maxSendLatencyUs, latency);
+    os_unfair_lock_unlock(&_statsLock);
+}
+
+/**
+ Takes the latest published encoder table, if any.
+
+ Must be called by the thread encoding the commands.
+
+ @return the current encoder table, NULL if there is no encoder
+ */
+- (struct encoder_table *)currentTable {
+    struct encoder_table *published = atomic_exchange(&_publishedTable, ENCODER_TABLE_NONE);
+    if (published != ENCODER_TABLE_NONE) {
+        encoder_table_destroy(_table);
+        _table = published;
     }
+    return _table;
+}
+
+/**
+ Resolves the device command interface, if not already done.
+
+ Must be called in the arsdk loop.
 
-    struct arsdk_cmd_itf *cmd_itf = arsdk_device_get_cmd_itf(device);
-    if (cmd_itf ==  NULL) {
-        [ULog e:TAG msg:@"NoAckCommandLoop.sendCommand arsdk_device_get_cmd_itf: device not found"];
+ @return `YES` if the command interface is available
+ */
+- (BOOL)resolveCommandInterface {
+    if (_cmdItf == NULL) {
+        struct arsdk_device *device = arsdk_ctrl_get_device(_ctrl, _device_handle);
+        if (device ==  NULL) {
+            [ULog e:TAG msg:@"NoAckCommandLoop.sendCommand arsdk_ctrl_get_device: device not found"];
+            return NO;
+        }
+
+        _cmdItf = arsdk_device_get_cmd_itf(device);
+        if (_cmdItf ==  NULL) {
+            [ULog e:TAG msg:@"NoAckCommandLoop.sendCommand arsdk_device_get_cmd_itf: device not found"];
+            return NO;
+        }
+    }
+    return YES;
+}
+
+/**
+ Generate and send NoAck commands, in timer mode
+ */
+- (void)sendCommands {
+    uint64_t deadline = [self recordTick];
+
+    // re-arm the timer for the next absolute deadline
+    uint64_t now = monotonic_time_us();
+    uint32_t delayMs = _nextTickUs > now ? (uint32_t)((_nextTickUs - now + 999) / 1000) : 1;
+    pomp_timer_set(_timer, delayMs);
+
+    struct encoder_table *table = [self currentTable];
+    if (table == NULL) {
         return;
     }
-    for (NoAckStorage *storage in encodersArray) {
-        ArsdkCommandEncoder (^encoderBlock)(void) = storage.encoderBlock;
+
+    for (size_t i = 0; i < table->count; i++) {
+        ArsdkCommandEncoder (^encoderBlock)(void) = (__bridge ArsdkCommandEncoder (^)(void))table->blocks[i];
         struct arsdk_cmd command;
         ArsdkCommandEncoder encoder = encoderBlock();
         if (encoder) {
             int res = encoder(&command);
             if (res == 0) {
-                arsdk_cmd_itf_send(cmd_itf, &command, NULL, NULL);
+                // the command interface is only needed when there is a command to send
+                if ([self resolveCommandInterface]) {
+                    arsdk_cmd_itf_send(_cmdItf, &command, NULL, NULL);
+                }
                 arsdk_cmd_clear(&command);
             }
         }
     }
+    [self recordSendForDeadline:deadline];
+}
+
+/**
+ Dedicated thread main function: waits for each deadline, then encodes the commands and hands them to the arsdk loop
+
+ @param stop flag set when the thread must exit
+ @param event event to signal when a batch is ready
+ */
+- (void)threadMainWithStop:(atomic_bool *)stop event:(struct pomp_evt *)event {
+    _nextTickUs = monotonic_time_us() + (uint64_t)_periodMs * 1000;
+    while (!atomic_load(stop)) {
+        wait_until_us(_nextTickUs);
+        if (atomic_load(stop)) {
+            break;
+        }
+        uint64_t deadline = [self recordTick];
+
+        struct encoder_table *table = [self currentTable];
+        if (table == NULL) {
+            continue;
+        }
+
+        struct cmd_batch *batch = atomic_exchange(&_freeBatch, NULL);
+        if (batch == NULL || batch->capacity < table->count) {
+            free(batch);
+            batch = calloc(1, sizeof(*batch) + table->count * sizeof(batch->cmds[0]));
+            if (batch == NULL) {
+                continue;
+            }
+            batch->capacity = table->count;
+        }
+        batch->deadlineUs = deadline;
+        batch->count = 0;
+
+        for (size_t i = 0; i < table->count; i++) {
+            ArsdkCommandEncoder (^encoderBlock)(void) = (__bridge ArsdkCommandEncoder (^)(void))table->blocks[i];
+            ArsdkCommandEncoder encoder = encoderBlock();
+            if (encoder && encoder(&batch->cmds[batch->count]) == 0) {
+                batch->count++;
+            }
+        }
+
+        // a batch not sent yet is outdated, replace it
+        struct cmd_batch *outdated = atomic_exchange(&_readyBatch, batch);
+        if (outdated != NULL) {
+            cmd_batch_clear(outdated);
+            os_unfair_lock_lock(&_statsLock);
+            _stats.missedTicks++;
+            os_unfair_lock_unlock(&_statsLock);
+            free(atomic_exchange(&_freeBatch, outdated));
+        }
+        pomp_evt_signal(event);
+    }
+
+    // drop the batch that has not been sent, it must not be sent by a next thread
+    struct cmd_batch *batch = atomic_exchange(&_readyBatch, NULL);
+    cmd_batch_clear(batch);
+    free(atomic_exchange(&_freeBatch, batch));
+}
+
+/**
+ Sends the batch encoded by the dedicated thread. Called in the arsdk loop
+ */
+- (void)sendReadyBatch {
+    struct cmd_batch *batch = atomic_exchange(&_readyBatch, NULL);
+    if (batch == NULL) {
+        return;
+    }
+    if (batch->count == 0 || [self resolveCommandInterface]) {
+        for (size_t i = 0; i < batch->count; i++) {
+            arsdk_cmd_itf_send(_cmdItf, &batch->cmds[i], NULL, NULL);
+        }
+        [self recordSendForDeadline:batch->deadlineUs];
+    }
+    cmd_batch_clear(batch);
+    free(atomic_exchange(&_freeBatch, batch));
 }
 
 @end
@@ -29,11 +29,55 @@
 
 #import <Foundation/Foundation.h>
 
+/**
+ Utilisation statistics of a pomp loop, snapshot taken by `-[PompLoopUtil stats]`.
+ */
+@interface PompLoopStats: NSObject
+
+/** Name of the loop */
+@property (nonatomic, strong, readonly) NSString * _Nonnull name;
+/** Wall clock time, in seconds, covered by the statistics */
+@property (nonatomic, assign, readonly) NSTimeInterval elapsedTime;
+/** CPU time, in seconds, spent by the loop thread processing events and dispatched blocks */
+@property (nonatomic, assign, readonly) NSTimeInterval busyTime;
+/** Number of loop wake ups that processed events */
+@property (nonatomic, assign, readonly) NSUInteger wakeupCount;
+/** Number of blocks dispatched to the loop and executed */
+@property (nonatomic, assign, readonly) NSUInteger blockCount;
+/** Ratio of `busyTime` over `elapsedTime`, in range [0, 1] */
+@property (nonatomic, assign, readonly) double utilisation;
+/** Average time, in seconds, elapsed between the dispatch of a block and its execution */
+@property (nonatomic, assign, readonly) NSTimeInterval averageBlockLatency;
+/** Highest time, in seconds, elapsed between the dispatch of a block and its execution */
+@property (nonatomic, assign, readonly) NSTimeInterval maxBlockLatency;
+/**
+ Average number of dispatched blocks executed per wake up of a loop running on its own thread, `0` for loops running
+ on a dispatch queue, which executes blocks outside of the pomp loop
+ */
+@property (nonatomic, assign, readonly) double averageBlocksPerWakeup;
+/** Highest number of dispatched blocks executed in a single wake up of a loop running on its own thread */
+@property (nonatomic, assign, readonly) NSUInteger maxBlocksPerWakeup;
+
+@end
+
 /**
  Utility facilitating the use of a pomp_lomp
+
+ By default, the loop runs on a serial dispatch queue, re-enqueuing a loop iteration after each wake up, and
+ dispatched blocks are executed on that queue between iterations.
+
+ The loop can instead run on its own thread, blocking in the pomp loop. Blocks are then dispatched through a
+ lock-free task stack, drained by the loop thread each time it wakes up; only the first block dispatched to an empty
+ stack wakes the loop up.
  */
 @interface PompLoopUtil: NSObject
 
+/** Name of the loop, used in logs and statistics */
+@property (nonatomic, strong, readonly) NSString * _Nonnull name;
+
+/** Whether the loop runs on its own thread instead of a dispatch queue */
+@property (nonatomic, assign, readonly) BOOL dedicatedThread;
+
 /**
  Constructor
  @param name String Id used in Logs
@@ -41,6 +85,14 @@
  */
 - (instancetype _Nonnull)initWithName:(NSString * _Nullable)name;
 
+/**
+ Constructor
+ @param name String Id used in Logs
+ @param dedicatedThread whether the loop runs on its own thread instead of a dispatch queue
+ @return instancetype or NIL if error
+ */
+- (instancetype _Nonnull)initWithName:(NSString * _Nullable)name dedicatedThread:(BOOL)dedicatedThread;
+
 /**
  Run the Loop.
  The caller must be in the same thread as the one used during the init
@@ -56,6 +108,9 @@ The caller must be in the same thread as the one used during the init
 /**
  Queue a block to be executed in the loop thread
 
+ For a loop running on its own thread that is not running, because it has not been run yet or has been stopped, the
+ block and the blocks dispatched before it are executed on the caller thread, one at a time.
+
  @param block The block to execute.
  */
 - (void)dispatch:(void (^ _Nonnull)(void))block;
@@ -63,10 +118,31 @@ The caller must be in the same thread as the one used during the init
 /**
  Queue a block to be executed in the loop thread and wait until execution
 
+ When called from the loop thread, the block is executed immediately. The block is not executed, and a warning is
+ logged, if the loop has been stopped. For a loop running on its own thread that has not been run yet, the block and
+ the blocks dispatched before it are executed on the caller thread, one at a time, even when several threads
+ dispatch concurrently.
+
  @param block The block to execute.
  */
 - (void)dispatch_sync:(void (^ _Nonnull)(void))block;
 
+/**
+ Gets the utilisation statistics of the loop, since its creation or the last call to `resetStats`.
+
+ May be called from any thread.
+
+ @return a snapshot of the loop statistics
+ */
+- (PompLoopStats * _Nonnull)stats;
+
+/**
+ Resets the utilisation statistics of the loop.
+
+ May be called from any thread.
+ */
+- (void)resetStats;
+
 /**
  Retrieves the internal pomp loop
 
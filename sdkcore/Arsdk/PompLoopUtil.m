@@ -30,17 +30,91 @@
 #import "PompLoopUtil.h"
 #import "Logger.h"
 #include <libpomp.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <time.h>
 
 extern ULogTag* TAG;
 
+/** Raw loop statistics counters, converted to a `PompLoopStats` snapshot */
+struct pomp_loop_counters {
+    /** Wall clock time covered by the statistics, in nanoseconds */
+    uint64_t elapsedNs;
+    /** CPU time spent by the loop thread, in nanoseconds */
+    uint64_t busyNs;
+    /** Number of loop wake ups */
+    uint64_t wakeupCount;
+    /** Number of executed dispatched blocks */
+    uint64_t blockCount;
+    /** Sum of the dispatched blocks latencies, in nanoseconds */
+    uint64_t latencySumNs;
+    /** Highest dispatched block latency, in nanoseconds */
+    uint64_t latencyMaxNs;
+    /** Number of wake ups that executed dispatched blocks */
+    uint64_t drainCount;
+    /** Highest number of dispatched blocks executed in a single wake up */
+    uint64_t drainMaxBlocks;
+};
+
+@interface PompLoopStats ()
+
+/**
+ Constructor
+
+ @param name: loop name
+ @param counters: raw counters
+ */
+- (instancetype)initWithName:(NSString *)name counters:(const struct pomp_loop_counters *)counters;
+
+@end
+
+@implementation PompLoopStats
+
+- (instancetype)initWithName:(NSString *)name counters:(const struct pomp_loop_counters *)counters {
+    self = [super init];
+    if (self) {
+        _name = name;
+        _elapsedTime = counters->elapsedNs / 1e9;
+        _busyTime = counters->busyNs / 1e9;
+        _wakeupCount = (NSUInteger)counters->wakeupCount;
+        _blockCount = (NSUInteger)counters->blockCount;
+        _utilisation = counters->elapsedNs > 0 ? MIN(1.0, (double)counters->busyNs / counters->elapsedNs) : 0;
+        _averageBlockLatency = counters->blockCount > 0 ? counters->latencySumNs / 1e9 / counters->blockCount : 0;
+        _maxBlockLatency = counters->latencyMaxNs / 1e9;
+        _averageBlocksPerWakeup = counters->drainCount > 0 ? (double)counters->blockCount / counters->drainCount : 0;
+        _maxBlocksPerWakeup = (NSUInteger)counters->drainMaxBlocks;
+    }
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"%@: utilisation: %.1f%% busy: %.3fs elapsed: %.3fs wakeups: %lu blocks: %lu "
+            "latency: avg %.3fms max %.3fms blocks/wakeup: avg %.1f max %lu",
+            _name, _utilisation * 100, _busyTime, _elapsedTime, (unsigned long)_wakeupCount,
+            (unsigned long)_blockCount, _averageBlockLatency * 1000, _maxBlockLatency * 1000,
+            _averageBlocksPerWakeup, (unsigned long)_maxBlocksPerWakeup];
+}
+
+@end
+
+/** Block dispatched to a loop running on its own thread, element of the lock-free task stack */
+struct pomp_loop_task {
+    /** Next task in the stack, pushed before this one */
+    struct pomp_loop_task *next;
+    /** Retained block to execute */
+    void *block;
+    /** Monotonic time at which the task has been dispatched, in nanoseconds */
+    uint64_t dispatchNs;
+};
 
 @interface PompLoopUtil ()
 
-/** True when stop has been called */
-@property (nonatomic) bool stopped;
-/** True when runLoop has been called */
-@property (nonatomic) bool running;
-/** Dispatch queue running the pomp loop */
+/** True when stop has been called. May be read from any thread. */
+@property (atomic) bool stopped;
+/** True when runLoop has been called. May be read from any thread. */
+@property (atomic) bool running;
+/** Dispatch queue running the pomp loop, nil when the loop runs on its own thread */
 @property (nonatomic, strong) dispatch_queue_t queue;
 /** Pomp loop processor block */
 @property (nonatomic, strong) void (^loopProcess)(void);
@@ -50,13 +124,96 @@ extern ULogTag* TAG;
 @property (nonatomic, strong) NSThread *callerThread;
 /** Name for logs */
 @property (nonatomic, strong) NSString *name;
+/** Thread running the loop, when the loop runs on its own thread */
+@property (nonatomic, strong) NSThread *loopThread;
+/** Semaphore signaled when `loopThread` exits */
+@property (nonatomic, strong) dispatch_semaphore_t loopThreadExited;
 @end
 
-/** pomp loop queue identifier */
+/** pomp loop queue identifier, associated to the `PompLoopUtil` instance owning the queue */
 static const void *const kLooperQueueIdentifier = &kLooperQueueIdentifier;
 
+/**
+ Gets the CPU time consumed by the current thread.
+
+ @return thread CPU time, in nanoseconds
+ */
+static uint64_t thread_cpu_time_ns(void) {
+    return clock_gettime_nsec_np(CLOCK_THREAD_CPUTIME_ID);
+}
+
+/**
+ Gets the monotonic time.
+
+ @return monotonic time, in nanoseconds
+ */
+static uint64_t monotonic_time_ns(void) {
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+/**
+ Raises an atomic counter to a value, if lower.
+
+ @param counter: counter to update
+ @param value: value to store if greater than the counter
+ */
+static void atomic_store_max(_Atomic uint64_t *counter, uint64_t value) {
+    uint64_t current = atomic_load_explicit(counter, memory_order_relaxed);
+    while (current < value &&
+           !atomic_compare_exchange_weak_explicit(counter, &current, value, memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+}
+
+@implementation PompLoopUtil {
+    /** Monotonic time of the statistics start, in nanoseconds */
+    _Atomic uint64_t _statsStartNs;
+    /** CPU time spent by the loop thread since the statistics start, in nanoseconds */
+    _Atomic uint64_t _busyNs;
+    /** Number of loop wake ups since the statistics start */
+    _Atomic uint64_t _wakeupCount;
+    /** Number of executed dispatched blocks since the statistics start */
+    _Atomic uint64_t _blockCount;
+    /** Sum of the latencies of the executed dispatched blocks, in nanoseconds */
+    _Atomic uint64_t _latencySumNs;
+    /** Highest latency of an executed dispatched block, in nanoseconds */
+    _Atomic uint64_t _latencyMaxNs;
+    /** Number of wake ups that executed dispatched blocks, when the loop runs on its own thread */
+    _Atomic uint64_t _drainCount;
+    /** Highest number of dispatched blocks executed in a single wake up */
+    _Atomic uint64_t _drainMaxBlocks;
+    /** Tasks dispatched to the loop thread, most recent first. Pushed by any thread, drained by the loop thread. */
+    _Atomic(struct pomp_loop_task *) _tasks;
+    /** Backs `stopped` */
+    atomic_bool _stoppedFlag;
+    /** Backs `running` */
+    atomic_bool _runningFlag;
+    /**
+     Whether a loop thread is running and will drain the task stack at least once more. Cleared by the loop thread
+     before its final drain.
+     */
+    atomic_bool _threadAlive;
+    /** Serializes task stack drains, by the loop thread or by dispatching threads when no loop thread is running */
+    pthread_mutex_t _drainMutex;
+    /** Thread currently draining the task stack, NULL if none */
+    _Atomic(pthread_t) _drainingThread;
+}
 
-@implementation PompLoopUtil
+- (bool)stopped {
+    return atomic_load(&_stoppedFlag);
+}
+
+- (void)setStopped:(bool)stopped {
+    atomic_store(&_stoppedFlag, stopped);
+}
+
+- (bool)running {
+    return atomic_load(&_runningFlag);
+}
+
+- (void)setRunning:(bool)running {
+    atomic_store(&_runningFlag, running);
+}
 
 /**
  Retrieves the internal pomp loop
@@ -77,7 +234,17 @@ static const void *const kLooperQueueIdentifier = &kLooperQueueIdentifier;
  @param name String Id used in Logs
  @return instancetype or NIL if error
  */
-- (instancetype _Nonnull)initWithName:(NSString * _Nullable)name{
+- (instancetype _Nonnull)initWithName:(NSString * _Nullable)name {
+    return [self initWithName:name dedicatedThread:NO];
+}
+
+/**
+ Constructor
+ @param name String Id used in Logs
+ @param dedicatedThread whether the loop runs on its own thread instead of a dispatch queue
+ @return instancetype or NIL if error
+ */
+- (instancetype _Nonnull)initWithName:(NSString * _Nullable)name dedicatedThread:(BOOL)dedicatedThread {
     if (name.length == 0) {
         name = @"noname";
     }
@@ -89,17 +256,28 @@ static const void *const kLooperQueueIdentifier = &kLooperQueueIdentifier;
     self = [super init];
     if (self) {
         _callerThread = [NSThread currentThread];
+        _dedicatedThread = dedicatedThread;
+        atomic_init(&_tasks, NULL);
+        atomic_init(&_stoppedFlag, false);
+        atomic_init(&_runningFlag, false);
+        atomic_init(&_threadAlive, false);
+        atomic_init(&_drainingThread, NULL);
+        pthread_mutex_init(&_drainMutex, NULL);
+        [self resetStats];
         self.loop = pomp_loop_new();
         if (self.loop == NULL) {
             [ULog w:TAG msg:@"PompLoop %s.init", self.name.UTF8String];
-        } else {
+        } else if (!dedicatedThread) {
             NSString *queueName = [NSString stringWithFormat:@"com.parrot.pomploop.%@", name];
             self.queue = dispatch_queue_create(queueName.UTF8String, DISPATCH_QUEUE_SERIAL);
-            dispatch_queue_set_specific(self.queue, kLooperQueueIdentifier, (void *)kLooperQueueIdentifier, NULL);
+            dispatch_queue_set_specific(self.queue, kLooperQueueIdentifier, (__bridge void *)self, NULL);
             PompLoopUtil* __weak weakSelf = self;
             _loopProcess = ^{
                 if (weakSelf != nil) {
+                    // waiting does not consume CPU time, only event processing is accounted
+                    uint64_t start = thread_cpu_time_ns();
                     pomp_loop_wait_and_process(weakSelf.loop, -1);
+                    [weakSelf recordWakeup:thread_cpu_time_ns() - start];
                     if (weakSelf != nil && !weakSelf.stopped) {
                         dispatch_async(weakSelf.queue, weakSelf.loopProcess);
                     }
@@ -123,7 +301,12 @@ static const void *const kLooperQueueIdentifier = &kLooperQueueIdentifier;
     if ([ULog d:TAG]) {
         [ULog d:TAG msg:@"run Loop %s", self.name.UTF8String];
     }
-    dispatch_async(self.queue, self.loopProcess);
+    if (_dedicatedThread) {
+        self.running = true;
+        [self startLoopThread];
+    } else {
+        dispatch_async(self.queue, self.loopProcess);
+    }
 }
 
 /**
@@ -149,8 +332,14 @@ static const void *const kLooperQueueIdentifier = &kLooperQueueIdentifier;
  */
 - (void)dispatch:(void (^)(void))block {
     [self assertNotLooperQueue];
-    dispatch_async(self.queue, block);
-    pomp_loop_wakeup(self.loop);
+    if (_dedicatedThread) {
+        [self pushTask:block];
+        // like blocks dispatched to a queue loop that is not running, execute the task if there is no loop thread
+        [self drainTasksWithoutLoopThread];
+    } else {
+        dispatch_async(self.queue, [self accountedBlock:block]);
+        pomp_loop_wakeup(self.loop);
+    }
 }
 
 /**
@@ -159,14 +348,25 @@ static const void *const kLooperQueueIdentifier = &kLooperQueueIdentifier;
  @param block The block to execute.
  */
 - (void)dispatch_sync:(void (^)(void))block {
-    if (!self.stopped) {
-        [self assertNotLooperQueue];
-        
+    if ([self isLooperQueue]) {
+        block();
+    } else if (self.stopped) {
+        [ULog w:TAG msg:@"PompLoop %s dispatch_sync: loop stopped, block not executed", self.name.UTF8String];
+    } else if (_dedicatedThread) {
+        dispatch_semaphore_t done = dispatch_semaphore_create(0);
+        [self pushTask:^{
+            block();
+            dispatch_semaphore_signal(done);
+        }];
+        [self drainTasksWithoutLoopThread];
+        dispatch_semaphore_wait(done, DISPATCH_TIME_FOREVER);
+    } else {
         NSCondition *condition = [[NSCondition alloc] init];
-        
+        void (^accountedBlock)(void) = [self accountedBlock:block];
+
         [condition lock];
         dispatch_async(_queue, ^{
-            block();
+            accountedBlock();
             [condition lock];
             [condition signal];
             [condition unlock];
@@ -188,8 +388,205 @@ static const void *const kLooperQueueIdentifier = &kLooperQueueIdentifier;
         pomp_loop_destroy(_loop);
         _loop = nil;
     }
+    // release tasks left undrained
+    struct pomp_loop_task *task = atomic_exchange(&_tasks, NULL);
+    while (task != NULL) {
+        struct pomp_loop_task *next = task->next;
+        (void)(__bridge_transfer id)task->block;
+        free(task);
+        task = next;
+    }
+    pthread_mutex_destroy(&_drainMutex);
+}
+
+- (PompLoopStats *)stats {
+    struct pomp_loop_counters counters = {
+        .elapsedNs = monotonic_time_ns() - atomic_load(&_statsStartNs),
+        .busyNs = atomic_load(&_busyNs),
+        .wakeupCount = atomic_load(&_wakeupCount),
+        .blockCount = atomic_load(&_blockCount),
+        .latencySumNs = atomic_load(&_latencySumNs),
+        .latencyMaxNs = atomic_load(&_latencyMaxNs),
+        .drainCount = atomic_load(&_drainCount),
+        .drainMaxBlocks = atomic_load(&_drainMaxBlocks),
+    };
+    return [[PompLoopStats alloc] initWithName:_name counters:&counters];
+}
+
+- (void)resetStats {
+    atomic_store(&_busyNs, 0);
+    atomic_store(&_wakeupCount, 0);
+    atomic_store(&_blockCount, 0);
+    atomic_store(&_latencySumNs, 0);
+    atomic_store(&_latencyMaxNs, 0);
+    atomic_store(&_drainCount, 0);
+    atomic_store(&_drainMaxBlocks, 0);
+    atomic_store(&_statsStartNs, monotonic_time_ns());
+}
+
+/**
+ Starts the thread running the loop, waiting for the previous one to exit if the loop is restarted.
+ */
+- (void)startLoopThread {
+    if (_loopThreadExited != nil) {
+        dispatch_semaphore_wait(_loopThreadExited, DISPATCH_TIME_FOREVER);
+    }
+    dispatch_semaphore_t exited = dispatch_semaphore_create(0);
+    _loopThreadExited = exited;
+    atomic_store(&_threadAlive, true);
+    // the thread retains self until it exits, once the loop has been stopped
+    _loopThread = [[NSThread alloc] initWithBlock:^{
+        while (!self.stopped) {
+            // waiting does not consume CPU time, only event and task processing is accounted
+            uint64_t start = thread_cpu_time_ns();
+            pomp_loop_wait_and_process(self.loop, -1);
+            [self drainTasks];
+            [self recordWakeup:thread_cpu_time_ns() - start];
+        }
+        // tasks pushed from now on are executed by the dispatching thread, drain the ones pushed before
+        atomic_store(&self->_threadAlive, false);
+        [self drainTasks];
+        dispatch_semaphore_signal(exited);
+    }];
+    _loopThread.name = [NSString stringWithFormat:@"com.parrot.pomploop.%@", _name];
+    _loopThread.qualityOfService = NSQualityOfServiceUserInitiated;
+    [_loopThread start];
+}
+
+/**
+ Pushes a block to the task stack of the loop thread, waking the loop up if the stack was empty.
+
+ Lock-free, may be called from any thread.
+
+ @param block: block to execute on the loop thread
+ */
+- (void)pushTask:(void (^)(void))block {
+    struct pomp_loop_task *task = malloc(sizeof(*task));
+    task->block = (__bridge_retained void *)[block copy];
+    task->dispatchNs = monotonic_time_ns();
+    struct pomp_loop_task *head = atomic_load_explicit(&_tasks, memory_order_relaxed);
+    // sequentially consistent, so that a dispatch_sync caller checking `_threadAlive` after pushing its task and the
+    // loop thread draining after clearing it cannot both miss the task
+    do {
+        task->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&_tasks, &head, task, memory_order_seq_cst,
+                                                    memory_order_relaxed));
+    // only the first task pushed to an empty stack needs to wake the loop up, following ones are drained with it
+    if (head == NULL) {
+        pomp_loop_wakeup(_loop);
+    }
+}
+
+/**
+ Executes the tasks pushed to the task stack on the calling thread, if no loop thread will drain them.
+
+ The task has been pushed before checking the thread state, and the loop thread clears its state before its final
+ drain: either the loop thread executes the task, or there is no loop thread and it is executed here.
+ */
+- (void)drainTasksWithoutLoopThread {
+    // a task being drained by this thread cannot drain the stack again, tasks would execute out of order
+    if (!atomic_load(&_threadAlive) && atomic_load(&_drainingThread) != pthread_self()) {
+        [self drainTasks];
+    }
+}
+
+/**
+ Executes all tasks pushed to the task stack, in dispatch order.
+
+ Called on the loop thread, or on a dispatching thread when no loop thread is running. Drains are serialized, so that
+ tasks never execute concurrently.
+ */
+- (void)drainTasks {
+    pthread_mutex_lock(&_drainMutex);
+    struct pomp_loop_task *task = atomic_exchange_explicit(&_tasks, NULL, memory_order_seq_cst);
+    if (task == NULL) {
+        pthread_mutex_unlock(&_drainMutex);
+        return;
+    }
+    atomic_store(&_drainingThread, pthread_self());
+    // reverse the stack to execute tasks in dispatch order
+    struct pomp_loop_task *ordered = NULL;
+    uint64_t count = 0;
+    while (task != NULL) {
+        struct pomp_loop_task *next = task->next;
+        task->next = ordered;
+        ordered = task;
+        task = next;
+        count++;
+    }
+    atomic_fetch_add_explicit(&_drainCount, 1, memory_order_relaxed);
+    atomic_store_max(&_drainMaxBlocks, count);
+    while (ordered != NULL) {
+        struct pomp_loop_task *next = ordered->next;
+        [self recordLatency:monotonic_time_ns() - ordered->dispatchNs];
+        void (^block)(void) = (__bridge_transfer void (^)(void))ordered->block;
+        free(ordered);
+        block();
+        ordered = next;
+    }
+    atomic_store(&_drainingThread, NULL);
+    pthread_mutex_unlock(&_drainMutex);
 }
 
+/**
+ Wraps a block to account its latency and execution time in the loop statistics
+
+ @param block: block to wrap
+ @return a block executing `block` and accounting its latency and CPU time
+ */
+- (void (^)(void))accountedBlock:(void (^)(void))block {
+    PompLoopUtil* __weak weakSelf = self;
+    uint64_t dispatchNs = monotonic_time_ns();
+    return ^{
+        [weakSelf recordLatency:monotonic_time_ns() - dispatchNs];
+        uint64_t start = thread_cpu_time_ns();
+        block();
+        [weakSelf recordBusyTime:thread_cpu_time_ns() - start];
+    };
+}
+
+/**
+ Accounts processing time in the loop statistics
+
+ @param busyNs: CPU time spent, in nanoseconds
+ */
+- (void)recordBusyTime:(uint64_t)busyNs {
+    atomic_fetch_add_explicit(&_busyNs, busyNs, memory_order_relaxed);
+}
+
+/**
+ Accounts a loop wake up in the loop statistics
+
+ @param busyNs: CPU time spent processing the wake up, in nanoseconds
+ */
+- (void)recordWakeup:(uint64_t)busyNs {
+    [self recordBusyTime:busyNs];
+    atomic_fetch_add_explicit(&_wakeupCount, 1, memory_order_relaxed);
+}
+
+/**
+ Accounts the execution of a dispatched block in the loop statistics
+
+ @param latencyNs: time elapsed between the block dispatch and its execution, in nanoseconds
+ */
+- (void)recordLatency:(uint64_t)latencyNs {
+    atomic_fetch_add_explicit(&_blockCount, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&_latencySumNs, latencyNs, memory_order_relaxed);
+    atomic_store_max(&_latencyMaxNs, latencyNs);
+}
+
+/**
+ Checks whether code is running inside the pomp loop dispatch queue, or thread, of this instance
+
+ @return true if running in the loop queue or thread
+ */
+- (bool)isLooperQueue {
+    if (_dedicatedThread) {
+        return (_loopThread != nil && [NSThread currentThread] == _loopThread) ||
+            atomic_load(&_drainingThread) == pthread_self();
+    }
+    return dispatch_get_specific(kLooperQueueIdentifier) == (__bridge void *)self;
+}
 
 /**
  Checks that current thread is the same than the one that called init
@@ -203,14 +600,14 @@ static const void *const kLooperQueueIdentifier = &kLooperQueueIdentifier;
  Checks that code is running inside the pomp loop dispatch queue
  */
 - (void)assertLooperQueue {
-    NSAssert(dispatch_get_specific(kLooperQueueIdentifier) != NULL, @"Not in loop queue");
+    NSAssert([self isLooperQueue], @"Not in loop queue");
 }
 
 /**
  Checks that code is not running inside the pomp loop dispatch queue
  */
 - (void)assertNotLooperQueue {
-    NSAssert(dispatch_get_specific(kLooperQueueIdentifier) == NULL, @"Already in loop queue");
+    NSAssert(![self isLooperQueue], @"Already in loop queue");
 }
 
 @end
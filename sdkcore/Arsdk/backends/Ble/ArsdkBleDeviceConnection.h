@@ -35,6 +35,10 @@ struct arsdk_device_conn_cfg;
 struct arsdk_device_conn_internal_cbs;
 struct arsdk_device;
 struct pomp_loop;
+struct arsdk_transport;
+struct arsdk_transport_cbs;
+struct arsdk_transport_header;
+struct arsdk_transport_payload;
 
 @interface ArsdkBleDeviceConnection : NSObject
 @property (nonatomic, strong, readonly) CBPeripheral* peripheral;
@@ -51,4 +55,67 @@ struct pomp_loop;
 -(void)didConnect;
 -(void)didDisconnect;
 -(void)didFailToConnect;
+
+/**
+ Constructor of a connection without peripheral, for test harnesses.
+
+ Subclasses override `canWriteFrameForId:` and `writeFrame:forId:` to handle the sent frames.
+
+ @param loopUtil: pomp loop util running the transport loop
+ */
+-(instancetype)initWithLoopUtil:(PompLoopUtil*)loopUtil;
+
+/**
+ Creates and starts the transport of a connection without peripheral.
+
+ Must be called in the pomp loop thread.
+
+ @param cbs: transport callbacks, receiving the frames
+ @return 0 if successful, a negative errno otherwise
+ */
+-(int)startTransportWithCbs:(const struct arsdk_transport_cbs *)cbs;
+
+/**
+ Sends a frame.
+
+ Must be called in the pomp loop thread.
+
+ @param header: frame header
+ @param payload: frame payload
+ @param extraHeader: extra header to insert before the payload
+ @param extraHeaderLen: extra header length
+ @return 0 if successful, a negative errno otherwise
+ */
+-(int)sendDataWithHeader:(const struct arsdk_transport_header *)header
+                 payload:(const struct arsdk_transport_payload *)payload
+             extraHeader:(const void *)extraHeader
+          extraHeaderLen:(size_t)extraHeaderLen;
+
+/**
+ Tells whether a frame can be written on a channel.
+
+ Called in the pomp loop thread.
+
+ @param id: channel id
+ @return YES if a frame can be written on the channel
+ */
+-(BOOL)canWriteFrameForId:(uint8_t)id;
+
+/**
+ Writes a frame assembled by `sendDataWithHeader:payload:extraHeader:extraHeaderLen:`.
+
+ Called in the pomp loop thread.
+
+ @param data: frame to write
+ @param id: channel id to write the frame on
+ */
+-(void)writeFrame:(NSData*)data forId:(uint8_t)id;
+
+/**
+ Hands a received frame over to the pomp loop.
+
+ @param data: received frame
+ @param id: channel id the frame has been received on
+ */
+-(void)didReceiveValue:(NSData*)data forId:(uint8_t)id;
 @end
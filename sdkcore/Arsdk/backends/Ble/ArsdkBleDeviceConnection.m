@@ -34,6 +34,8 @@
 #include <arsdkctrl/arsdkctrl.h>
 #include <arsdkctrl/internal/arsdkctrl_internal.h>
 #import "Logger.h"
+#include <os/lock.h>
+#include <stdatomic.h>
 
 extern ULogTag* TAG;
 
@@ -44,11 +46,8 @@ extern ULogTag* TAG;
 @property (nonatomic, assign) struct arsdk_transport* transport;
 /** arsdk-ng connection callbacks */
 @property (nonatomic, assign) struct arsdk_device_conn_internal_cbs cbs;
-
--(int)sendDataWithHeader:(const struct arsdk_transport_header *)header
-                 payload:(const struct arsdk_transport_payload *)payload
-             extraHeader:(const void *)extraHeader
-          extraHeaderLen:(size_t)extraHeaderLen;
+/** pomp loop util running `loop` */
+@property (nonatomic, strong) PompLoopUtil *loopUtil;
 
 -(void)receiveData:(NSData*)data forId:(uint8_t)id;
 @end
@@ -64,6 +63,131 @@ extern ULogTag* TAG;
 
 // header [type/seq (8bits)] + 1 byte payload
 #define BLE_MIN_DATA_LEN                         3
+// header [type/seq (8bits)]
+#define BLE_HEADER_LEN                           2
+// size of pooled packets, bigger frames are allocated
+#define BLE_PACKET_SIZE                          512
+// maximum number of free packets kept in the tx pool
+#define BLE_TX_POOL_SIZE                         32
+// maximum number of payload buffers kept in the rx pool
+#define BLE_RX_POOL_SIZE                         8
+
+/** Pooled tx packet */
+struct ble_packet {
+    /** Next free packet */
+    struct ble_packet *next;
+    /** Packet data */
+    uint8_t data[BLE_PACKET_SIZE];
+};
+
+/**
+ Pool of tx packets.
+
+ Packets are handed to CoreBluetooth as no-copy NSData which give them back to the pool when deallocated, possibly
+ after the connection has been released: the pool is reference counted by its owner and its in flight packets.
+ */
+struct ble_packet_pool {
+    /** Protects `freeList` and `freeCount` */
+    os_unfair_lock lock;
+    /** Free packets */
+    struct ble_packet *freeList;
+    /** Number of free packets */
+    size_t freeCount;
+    /** Reference count */
+    atomic_int refcount;
+};
+
+/**
+ Creates a tx packet pool.
+
+ @return a new pool with a single reference, or NULL if out of memory
+ */
+static struct ble_packet_pool *ble_packet_pool_new(void) {
+    struct ble_packet_pool *pool = calloc(1, sizeof(*pool));
+    if (pool != NULL) {
+        pool->lock = OS_UNFAIR_LOCK_INIT;
+        atomic_init(&pool->refcount, 1);
+    }
+    return pool;
+}
+
+/**
+ Releases a reference on a tx packet pool, destroying it and its free packets when it was the last one.
+
+ @param pool: pool to release
+ */
+static void ble_packet_pool_unref(struct ble_packet_pool *pool) {
+    if (atomic_fetch_sub_explicit(&pool->refcount, 1, memory_order_acq_rel) == 1) {
+        while (pool->freeList != NULL) {
+            struct ble_packet *packet = pool->freeList;
+            pool->freeList = packet->next;
+            free(packet);
+        }
+        free(pool);
+    }
+}
+
+/**
+ Takes a packet from a tx packet pool, allocating it if the pool is empty.
+
+ The packet holds a reference on the pool until put back.
+
+ @param pool: pool to take the packet from
+ @return the packet data, or NULL if out of memory
+ */
+static uint8_t *ble_packet_pool_get(struct ble_packet_pool *pool) {
+    os_unfair_lock_lock(&pool->lock);
+    struct ble_packet *packet = pool->freeList;
+    if (packet != NULL) {
+        pool->freeList = packet->next;
+        pool->freeCount--;
+    }
+    os_unfair_lock_unlock(&pool->lock);
+    if (packet == NULL) {
+        packet = malloc(sizeof(*packet));
+        if (packet == NULL) {
+            return NULL;
+        }
+    }
+    atomic_fetch_add_explicit(&pool->refcount, 1, memory_order_relaxed);
+    return packet->data;
+}
+
+/**
+ Puts a packet back in its tx packet pool, or frees it if the pool is full.
+
+ Can be called from any thread.
+
+ @param pool: pool the packet has been taken from
+ @param data: packet data
+ */
+static void ble_packet_pool_put(struct ble_packet_pool *pool, void *data) {
+    struct ble_packet *packet = (struct ble_packet *)((uint8_t *)data - offsetof(struct ble_packet, data));
+    os_unfair_lock_lock(&pool->lock);
+    if (pool->freeCount < BLE_TX_POOL_SIZE) {
+        packet->next = pool->freeList;
+        pool->freeList = packet;
+        pool->freeCount++;
+        packet = NULL;
+    }
+    os_unfair_lock_unlock(&pool->lock);
+    free(packet);
+    ble_packet_pool_unref(pool);
+}
+
+/**
+ Gets the arsdk channel id carried by a characteristic uuid.
+
+ @param uuid: characteristic uuid, formatted as `xxxxxxID-...`
+ @return the channel id, or -1 if the uuid does not carry any
+ */
+static int ble_channel_id(CBUUID *uuid) {
+    NSData *data = uuid.data;
+    if (data.length < 4) {
+        return -1;
+    }
+    return ((const uint8_t *)data.bytes)[3];
+}
 
 /** arsk-ng transport callback */
 int transport_dispose(struct arsdk_transport *base) {
@@ -101,7 +225,18 @@ static const struct arsdk_transport_ops sTransportOps = {
 };
 
 
-@implementation ArsdkBleDeviceConnection
+@implementation ArsdkBleDeviceConnection {
+    /** Sender service characteristics, indexed by channel id */
+    NSArray<CBCharacteristic *> *_senderCharacteristics;
+    /** Channel id of receiver service characteristics, by characteristic */
+    NSMapTable<CBCharacteristic *, NSNumber *> *_receiverChannels;
+    /** Tx packet pool */
+    struct ble_packet_pool *_txPool;
+    /** Gives tx packets back to `_txPool` when their data is deallocated */
+    void (^_txPacketDeallocator)(void *bytes, NSUInteger length);
+    /** Payload buffers kept for reuse, only accessed in the pomp loop thread */
+    struct pomp_buffer *_rxPool[BLE_RX_POOL_SIZE];
+}
 
 /**
  Constructor
@@ -117,16 +252,77 @@ static const struct arsdk_transport_ops sTransportOps = {
         _device = device;
         _loop = loop;
         _arsdkCore = arsdkCore;
+        _loopUtil = arsdkCore.pompLoopUtil;
+        [self setupPools];
         _cbs.connecting(device, (__bridge struct arsdk_device_conn*)self, _cbs.userdata);
     }
     return self;
 }
 
+/**
+ Constructor of a connection without peripheral, for test harnesses.
+
+ @param loopUtil: pomp loop util running the transport loop
+ */
+-(instancetype)initWithLoopUtil:(PompLoopUtil*)loopUtil {
+    self = [super init];
+    if (self) {
+        _loopUtil = loopUtil;
+        _loop = loopUtil.internalPompLoop;
+        [self setupPools];
+    }
+    return self;
+}
+
+/**
+ Creates the tx packet pool
+ */
+-(void)setupPools {
+    _txPool = ble_packet_pool_new();
+    struct ble_packet_pool *pool = _txPool;
+    _txPacketDeallocator = ^(void *bytes, NSUInteger length) {
+        ble_packet_pool_put(pool, bytes);
+    };
+}
+
+/**
+ Creates and starts the transport of a connection without peripheral.
+
+ Must be called in the pomp loop thread.
+
+ @param cbs: transport callbacks, receiving the frames
+ @return 0 if successful, a negative errno otherwise
+ */
+-(int)startTransportWithCbs:(const struct arsdk_transport_cbs *)cbs {
+    int res = arsdk_transport_new((__bridge void*)self, &sTransportOps, _loop, 0, "ble", &_transport);
+    if (res == 0) {
+        res = arsdk_transport_set_cbs(_transport, cbs);
+    }
+    if (res == 0) {
+        res = arsdk_transport_start(_transport);
+    }
+    return res;
+}
+
+-(void)dealloc {
+    for (int i = 0; i < BLE_RX_POOL_SIZE; i++) {
+        if (_rxPool[i] != NULL) {
+            pomp_buffer_unref(_rxPool[i]);
+        }
+    }
+    if (_txPool != NULL) {
+        ble_packet_pool_unref(_txPool);
+    }
+}
+
 /**
  Stop connection
  */
 -(void)stop {
-    _cbs.disconnected(_device, (__bridge struct arsdk_device_conn*)self, _cbs.userdata);
+    // connections without peripheral have no connection callbacks
+    if (_cbs.disconnected != NULL) {
+        _cbs.disconnected(_device, (__bridge struct arsdk_device_conn*)self, _cbs.userdata);
+    }
     if (_transport) {
         int res = arsdk_transport_stop(_transport);
         if (res < 0) {
@@ -181,46 +377,123 @@ static const struct arsdk_transport_ops sTransportOps = {
                  payload:(const struct arsdk_transport_payload *)payload
              extraHeader:(const void *)extraHeader
           extraHeaderLen:(size_t)extraHeaderLen {
-    // create data to send
-    NSMutableData *data = [NSMutableData dataWithCapacity:2 + extraHeaderLen + payload->len];
-    // add type and seq nr from the header (id is not set as it defined by the property used to send the frame)
-    [data appendBytes:&(header->type) length:sizeof(uint8_t)];
-    [data appendBytes:&(header->seq) length:sizeof(uint8_t)];
-    // append extra header
-    [data appendBytes:extraHeader length:extraHeaderLen];
-    // append payload
-    [data appendBytes:payload->cdata length:payload->len];
-    // gets the characteristic for the requested channel id
-    CBCharacteristic* characteristic = _senderService.characteristics[header->id];
     // characteristic may be null if the device just drop the connection
-    if (characteristic) {
-        [_peripheral writeValue:data forCharacteristic:characteristic type:CBCharacteristicWriteWithoutResponse];
+    if (![self canWriteFrameForId:header->id]) {
+        return 0;
+    }
+    // assemble the frame in a pooled packet
+    size_t len = BLE_HEADER_LEN + extraHeaderLen + payload->len;
+    uint8_t *packet = len <= BLE_PACKET_SIZE ? ble_packet_pool_get(_txPool) : malloc(len);
+    if (packet == NULL) {
+        return -ENOMEM;
+    }
+    // add type and seq nr from the header (id is not set as it defined by the property used to send the frame)
+    packet[0] = header->type;
+    packet[1] = header->seq;
+    // append extra header and payload
+    memcpy(packet + BLE_HEADER_LEN, extraHeader, extraHeaderLen);
+    memcpy(packet + BLE_HEADER_LEN + extraHeaderLen, payload->cdata, payload->len);
+    NSData *data;
+    if (len <= BLE_PACKET_SIZE) {
+        data = [[NSData alloc] initWithBytesNoCopy:packet length:len deallocator:_txPacketDeallocator];
+    } else {
+        data = [[NSData alloc] initWithBytesNoCopy:packet length:len freeWhenDone:YES];
     }
+    [self writeFrame:data forId:header->id];
     return 0;
 }
 
+/**
+ Tells whether a frame can be written on a channel.
+
+ @param id: channel id
+ @return YES if the peripheral has a sender characteristic for the channel
+ */
+-(BOOL)canWriteFrameForId:(uint8_t)id {
+    return id < _senderCharacteristics.count;
+}
+
+/**
+ Writes a frame to the peripheral.
+
+ @param data: frame to write
+ @param id: channel id to write the frame on
+ */
+-(void)writeFrame:(NSData*)data forId:(uint8_t)id {
+    NSArray<CBCharacteristic *> *characteristics = _senderCharacteristics;
+    if (id < characteristics.count) {
+        [_peripheral writeValue:data forCharacteristic:characteristics[id] type:CBCharacteristicWriteWithoutResponse];
+    }
+}
+
+/**
+ Hands a received frame over to the pomp loop
+
+ @param data: received frame
+ @param id: channel id the frame has been received on
+ */
+-(void)didReceiveValue:(NSData*)data forId:(uint8_t)id {
+    if (data.length >= BLE_MIN_DATA_LEN) {
+        [_loopUtil dispatch:^{
+            [self receiveData:data forId:id];
+        }];
+    }
+}
+
+/**
+ Gets a buffer to copy a received payload into, from the pool if one is not used anymore.
+
+ Called in the pomp loop thread.
+
+ @param len: payload length
+ @param pooled: set to true if the buffer belongs to the pool, in which case the pool owns its only reference
+ @return an unshared buffer, or NULL if out of memory
+ */
+-(struct pomp_buffer *)rxBufferWithLength:(size_t)len pooled:(bool *)pooled {
+    if (len <= BLE_PACKET_SIZE) {
+        for (int i = 0; i < BLE_RX_POOL_SIZE; i++) {
+            if (_rxPool[i] == NULL) {
+                _rxPool[i] = pomp_buffer_new(BLE_PACKET_SIZE);
+            }
+            // a buffer that is not shared anymore has been released by arsdk
+            if (_rxPool[i] != NULL && !pomp_buffer_is_shared(_rxPool[i])) {
+                *pooled = true;
+                return _rxPool[i];
+            }
+        }
+    }
+    *pooled = false;
+    return pomp_buffer_new(len);
+}
+
 /**
  Process received data
  */
 -(void)receiveData:(NSData*)data forId:(uint8_t)id {
     struct arsdk_transport_header header;
     struct arsdk_transport_payload payload;
+    const uint8_t *bytes = data.bytes;
     // setup arsdk-ng header
     memset(&header, 0, sizeof(header));
     arsdk_transport_payload_init(&payload);
     // read type
-    [data getBytes:&header.type range:NSMakeRange(0, 1)];
+    header.type = bytes[0];
     header.id = id;
     // read seq number
-    [data getBytes:&header.seq range:NSMakeRange(1, 1)];
+    header.seq = bytes[1];
 
     // setup arsdk-ng payload
     void *bufdata = NULL;
-    size_t payloadLen = data.length-2;
-    struct pomp_buffer *buf = pomp_buffer_new_get_data(payloadLen, &bufdata);
-    if (buf) {
-        [data getBytes:bufdata range:NSMakeRange(2, payloadLen)];
+    size_t payloadLen = data.length - BLE_HEADER_LEN;
+    bool pooled = false;
+    struct pomp_buffer *buf = [self rxBufferWithLength:payloadLen pooled:&pooled];
+    if (buf && pomp_buffer_get_data(buf, &bufdata, NULL, NULL) == 0) {
+        memcpy(bufdata, bytes + BLE_HEADER_LEN, payloadLen);
         pomp_buffer_set_len(buf, payloadLen);
+        if (pooled) {
+            // the pool keeps its reference, the payload is released below
+            pomp_buffer_ref(buf);
+        }
         arsdk_transport_payload_init_with_buf(&payload, buf);
         int res = arsdk_transport_recv_data(_transport, &header, &payload);
         if (res < 0) {
@@ -228,7 +501,10 @@ static const struct arsdk_transport_ops sTransportOps = {
         }
         pomp_buffer_unref(buf);
     } else {
-        [ULog e:TAG msg:@"receiveData: error in pomp_buffer_new_get_data"];
+        if (buf && !pooled) {
+            pomp_buffer_unref(buf);
+        }
+        [ULog e:TAG msg:@"receiveData: error getting a payload buffer"];
     }
  }
 
@@ -255,12 +531,20 @@ static const struct arsdk_transport_ops sTransportOps = {
 -(void)peripheral:(CBPeripheral *)peripheral didDiscoverCharacteristicsForService:(CBService *)service error:(NSError *)error {
     NSString* servicePostfix = [service.UUID.UUIDString substringFromIndex:4];
     if (_senderService == nil && [servicePostfix hasPrefix:@ARCOMMAND_SENDING_SERVICE]) {
-        // _senderService: store sender service
+        // _senderService: store sender service and its characteristics, indexed by channel id
         _senderService = service;
+        _senderCharacteristics = [service.characteristics copy];
     } else if (_receiverService == nil && [servicePostfix hasPrefix:@ARCOMMAND_RECEIVING_SERVICE]) {
-        // _receiverService store it and register notification on all receiver characteristiques
+        // _receiverService store it, map its characteristics to their channel id and register notification on all
+        // receiver characteristiques
         _receiverService = service;
+        _receiverChannels = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsObjectPointerPersonality
+                                                  valueOptions:NSPointerFunctionsStrongMemory];
         for (CBCharacteristic* characteristic in _receiverService.characteristics) {
+            int channelId = ble_channel_id(characteristic.UUID);
+            if (channelId >= 0) {
+                [_receiverChannels setObject:@(channelId) forKey:characteristic];
+            }
             [_peripheral setNotifyValue:YES forCharacteristic:characteristic];
         }
     }
@@ -279,20 +563,13 @@ static const struct arsdk_transport_ops sTransportOps = {
 
 - (void)peripheral:(CBPeripheral *)peripheral didUpdateValueForCharacteristic:(CBCharacteristic *)characteristic
              error:(nullable NSError *)error {
-    NSData* data = [NSData dataWithData:characteristic.value];
     // gets the id from characteristique
-    NSScanner* scanner = [NSScanner scannerWithString:[characteristic.UUID.UUIDString
-                                                       substringWithRange:NSMakeRange(6, 2)]];
-    if (data.length >= BLE_MIN_DATA_LEN) {
-        unsigned int id =-1;
-        [scanner scanHexInt:&id];
-        if (id != -1) {
-            [_arsdkCore dispatch:^{
-                [self receiveData:data forId:id];
-            }];
-        } else {
-            [ULog w:TAG msg:@"ignoring characteristic update %s", characteristic.description.UTF8String];
-        }
+    NSNumber* id = [_receiverChannels objectForKey:characteristic];
+    if (id != nil) {
+        // characteristic value is immutable, it is replaced on each update
+        [self didReceiveValue:characteristic.value forId:id.unsignedCharValue];
+    } else {
+        [ULog w:TAG msg:@"ignoring characteristic update %s", characteristic.description.UTF8String];
     }
 }
 
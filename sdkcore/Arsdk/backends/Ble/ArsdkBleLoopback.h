@@ -0,0 +1,74 @@
+//    Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+#import <Foundation/Foundation.h>
+
+/**
+ BLE transport loopback harness.
+
+ Frames sent through a BLE device connection are looped back to its receive path instead of being written to a
+ peripheral, so that the framing cost of the BLE transport can be measured without any device.
+ */
+@interface ArsdkBleLoopback : NSObject
+
+/** Number of frames received during the last run */
+@property (nonatomic, readonly) NSUInteger receivedFrameCount;
+/**
+ Number of frames received during the last run that differ from the sent frame: type, channel id, sequence number or
+ payload bytes
+ */
+@property (nonatomic, readonly) NSUInteger corruptedFrameCount;
+/** Frames received per second during the last run */
+@property (nonatomic, readonly) double framesPerSecond;
+
+/**
+ Constructor
+
+ Starts a dedicated pomp loop and a loopback connection on it.
+
+ @return a new loopback harness, nil if the loopback transport could not be started
+ */
+- (instancetype _Nullable)init;
+
+/**
+ Sends frames and waits until they are all received.
+
+ @param frameCount number of frames to send
+ @param payloadSize size of each frame payload
+ @param timeout maximum time to wait for all frames to be received, in seconds
+ @return YES if all frames have been received before the timeout, NO otherwise
+ */
+- (BOOL)runWithFrameCount:(NSUInteger)frameCount payloadSize:(NSUInteger)payloadSize timeout:(NSTimeInterval)timeout;
+
+/**
+ Stops the loopback connection and its pomp loop.
+ */
+- (void)close;
+
+@end
@@ -0,0 +1,189 @@
+//    Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+#import "ArsdkBleLoopback.h"
+#import "ArsdkBleDeviceConnection.h"
+#include <arsdkctrl/arsdkctrl.h>
+#include <arsdkctrl/internal/arsdkctrl_internal.h>
+
+/** Channel id frames are sent on */
+#define LOOPBACK_CHANNEL_ID     10
+
+/** BLE connection looping back sent frames to its receive path instead of writing them to a peripheral */
+@interface ArsdkBleLoopbackConnection : ArsdkBleDeviceConnection
+@end
+
+@implementation ArsdkBleLoopbackConnection
+
+-(BOOL)canWriteFrameForId:(uint8_t)id {
+    return YES;
+}
+
+-(void)writeFrame:(NSData*)data forId:(uint8_t)id {
+    [self didReceiveValue:data forId:id];
+}
+
+@end
+
+@implementation ArsdkBleLoopback {
+    /** Pomp loop running the loopback transport */
+    PompLoopUtil *_loopUtil;
+    /** Loopback connection, nil once closed */
+    ArsdkBleDeviceConnection *_connection;
+    /** Number of frames expected in the current run, only accessed in the pomp loop thread */
+    NSUInteger _expectedFrames;
+    /** Number of frames received in the current run, only accessed in the pomp loop thread */
+    NSUInteger _receivedFrames;
+    /** Number of frames received altered in the current run, only accessed in the pomp loop thread */
+    NSUInteger _corruptedFrames;
+    /** Payload of the frames sent in the current run, only accessed in the pomp loop thread */
+    NSData *_payload;
+    /** Signaled when all expected frames have been received */
+    dispatch_semaphore_t _done;
+}
+
+/** transport callback, called when a frame has been looped back */
+static void loopback_recv_data(struct arsdk_transport *transport, const struct arsdk_transport_header *header,
+                               const struct arsdk_transport_payload *payload, void *userdata) {
+    ArsdkBleLoopback *self = (__bridge ArsdkBleLoopback *)userdata;
+    [self didReceiveFrame:header payload:payload];
+}
+
+/** transport callback */
+static void loopback_link_status(struct arsdk_transport *transport, enum arsdk_link_status status, void *userdata) {
+    // nothing to do, loopback link is always up
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _loopUtil = [[PompLoopUtil alloc] initWithName:@"arsdkble.loopback" dedicatedThread:YES];
+        [_loopUtil runLoop];
+        _connection = [[ArsdkBleLoopbackConnection alloc] initWithLoopUtil:_loopUtil];
+        __block int res = -EINVAL;
+        [_loopUtil dispatch_sync:^{
+            struct arsdk_transport_cbs cbs;
+            memset(&cbs, 0, sizeof(cbs));
+            cbs.userdata = (__bridge void *)self;
+            cbs.recv_data = &loopback_recv_data;
+            cbs.link_status = &loopback_link_status;
+            res = [self->_connection startTransportWithCbs:&cbs];
+        }];
+        if (res < 0) {
+            [self close];
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self close];
+}
+
+- (BOOL)runWithFrameCount:(NSUInteger)frameCount payloadSize:(NSUInteger)payloadSize timeout:(NSTimeInterval)timeout {
+    if (_connection == nil || frameCount == 0) {
+        return NO;
+    }
+    _done = dispatch_semaphore_create(0);
+    NSMutableData *payloadData = [NSMutableData dataWithLength:payloadSize];
+    uint8_t *payloadBytes = payloadData.mutableBytes;
+    for (NSUInteger i = 0; i < payloadSize; i++) {
+        payloadBytes[i] = (uint8_t)(i * 7 + 1);
+    }
+    NSTimeInterval start = [NSProcessInfo processInfo].systemUptime;
+    [_loopUtil dispatch:^{
+        self->_receivedFrames = 0;
+        self->_corruptedFrames = 0;
+        self->_expectedFrames = frameCount;
+        self->_payload = payloadData;
+        struct arsdk_transport_header header;
+        struct arsdk_transport_payload payload;
+        memset(&header, 0, sizeof(header));
+        header.type = ARSDK_TRANSPORT_DATA_TYPE_NOACK;
+        header.id = LOOPBACK_CHANNEL_ID;
+        arsdk_transport_payload_init(&payload);
+        payload.cdata = payloadData.bytes;
+        payload.len = payloadData.length;
+        for (NSUInteger i = 0; i < frameCount; i++) {
+            header.seq = (uint8_t)i;
+            [self->_connection sendDataWithHeader:&header payload:&payload extraHeader:NULL extraHeaderLen:0];
+        }
+    }];
+    BOOL received = dispatch_semaphore_wait(_done, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC)))
+        == 0;
+    NSTimeInterval elapsed = [NSProcessInfo processInfo].systemUptime - start;
+    __block NSUInteger receivedFrames = 0;
+    __block NSUInteger corruptedFrames = 0;
+    [_loopUtil dispatch_sync:^{
+        receivedFrames = self->_receivedFrames;
+        corruptedFrames = self->_corruptedFrames;
+        // stop counting frames of this run that could still be received
+        self->_expectedFrames = 0;
+    }];
+    _receivedFrameCount = receivedFrames;
+    _corruptedFrameCount = corruptedFrames;
+    _framesPerSecond = elapsed > 0 ? receivedFrames / elapsed : 0;
+    return received;
+}
+
+- (void)close {
+    if (_connection != nil) {
+        ArsdkBleDeviceConnection *connection = _connection;
+        _connection = nil;
+        [_loopUtil dispatch_sync:^{
+            [connection stop];
+        }];
+        [_loopUtil stopRun];
+    }
+}
+
+/**
+ Called in the pomp loop thread when a frame has been looped back
+
+ @param header: received frame header
+ @param payload: received frame payload
+ */
+- (void)didReceiveFrame:(const struct arsdk_transport_header *)header
+                payload:(const struct arsdk_transport_payload *)payload {
+    if (_expectedFrames == 0) {
+        return;
+    }
+    // frames are sent in order, with their index as sequence number
+    if (header->type != ARSDK_TRANSPORT_DATA_TYPE_NOACK || header->id != LOOPBACK_CHANNEL_ID ||
+        header->seq != (uint8_t)_receivedFrames || payload->len != _payload.length ||
+        memcmp(payload->cdata, _payload.bytes, payload->len) != 0) {
+        _corruptedFrames++;
+    }
+    if (++_receivedFrames == _expectedFrames) {
+        dispatch_semaphore_signal(_done);
+    }
+}
+
+@end
@@ -29,6 +29,7 @@
 
 #import <Foundation/Foundation.h>
 #import "ArsdkCore.h"
+#import "ArsdkMuxStats.h"
 
 // main loop timeout. Also define connection timeout. In seconds
 #define ARSDKMUX_LOOP_TIMEOUT       1
@@ -77,4 +78,13 @@ struct pomp_loop;
 
 -(void) close;
 
+/**
+ Gets the mux link counters.
+
+ Can be called from any thread.
+
+ @return a snapshot of the current counters
+ */
+- (ArsdkMuxStats *)stats;
+
 @end
@@ -29,12 +29,17 @@
 
 #import "ArsdkMux.h"
 #import "ArsdkCore+Internal.h"
-#import "PompBuffer.h"
 #import "Logger.h"
 #include <libmux.h>
+#include <os/lock.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <time.h>
 
 // input stream read size
 #define READ_BUFFER_SIZE       65536
+// maximum number of read buffers kept for reuse
+#define READ_BUFFER_POOL_SIZE  8
 
 extern ULogTag* TAG;
 
@@ -45,6 +50,152 @@ typedef NS_ENUM(NSUInteger, State) {
     StopRequested
 };
 
+/** Buffer handed over between the stream thread and the pomp loop */
+struct mux_buf_entry {
+    /** Referenced buffer */
+    struct pomp_buffer *buf;
+    /** Monotonic time at which the buffer has been queued, in nanoseconds */
+    uint64_t queuedNs;
+};
+
+/**
+ List of buffers handed over between threads.
+
+ Producer appends to a pending list under a lock, consumer swaps it with its own, emptied, list and processes it
+ without lock. Lists keep their storage, so steady state hand over does not allocate.
+ */
+struct mux_buf_list {
+    /** Buffers */
+    struct mux_buf_entry *entries;
+    /** Number of buffers */
+    size_t count;
+    /** Allocated capacity */
+    size_t capacity;
+};
+
+/**
+ Appends a buffer to a list, taking ownership of the caller reference.
+
+ @param list: list to append to
+ @param buf: buffer to append
+ @param queuedNs: buffer queue time
+ */
+static void mux_buf_list_append(struct mux_buf_list *list, struct pomp_buffer *buf, uint64_t queuedNs) {
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity > 0 ? list->capacity * 2 : 16;
+        list->entries = reallocf(list->entries, capacity * sizeof(*list->entries));
+        list->capacity = capacity;
+    }
+    list->entries[list->count].buf = buf;
+    list->entries[list->count].queuedNs = queuedNs;
+    list->count++;
+}
+
+/**
+ Releases all buffers of a list and its storage.
+
+ @param list: list to release
+ */
+static void mux_buf_list_clear(struct mux_buf_list *list) {
+    for (size_t i = 0; i < list->count; i++) {
+        pomp_buffer_unref(list->entries[i].buf);
+    }
+    free(list->entries);
+    memset(list, 0, sizeof(*list));
+}
+
+/**
+ Gets the monotonic time.
+
+ @return monotonic time, in nanoseconds
+ */
+static uint64_t mux_time_ns(void) {
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+}
+
+/**
+ Raises an atomic counter to a value, if lower.
+
+ @param counter: counter to update
+ @param value: value to store if greater than the counter
+ */
+static void mux_counter_max(_Atomic uint64_t *counter, uint64_t value) {
+    uint64_t current = atomic_load_explicit(counter, memory_order_relaxed);
+    while (current < value &&
+           !atomic_compare_exchange_weak_explicit(counter, &current, value, memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+}
+
+/** Mux link counters, updated by the stream thread and the pomp loop */
+struct mux_counters {
+    /** Monotonic time of the counters start, in nanoseconds */
+    _Atomic uint64_t startNs;
+    /** Bytes written to the output stream */
+    _Atomic uint64_t txBytes;
+    /** Buffers fully written to the output stream */
+    _Atomic uint64_t txBuffers;
+    /** Sum of the times between buffers queuing by the mux and their full write, in nanoseconds */
+    _Atomic uint64_t txLatencySumNs;
+    /** Highest time between a buffer queuing by the mux and its full write, in nanoseconds */
+    _Atomic uint64_t txLatencyMaxNs;
+    /** Bytes read from the input stream */
+    _Atomic uint64_t rxBytes;
+    /** Buffers read from the input stream */
+    _Atomic uint64_t rxBuffers;
+    /** Batches of read buffers decoded on the pomp loop */
+    _Atomic uint64_t rxBatches;
+    /** Biggest batch of read buffers */
+    _Atomic uint64_t rxBatchMax;
+    /** Sum of the times between buffers read and their decoding, in nanoseconds */
+    _Atomic uint64_t rxLatencySumNs;
+    /** Highest time between a buffer read and its decoding, in nanoseconds */
+    _Atomic uint64_t rxLatencyMaxNs;
+    /** Read buffers allocated because no pooled buffer was available, filling the pool is not a miss */
+    _Atomic uint64_t rxPoolMisses;
+};
+
+@implementation ArsdkMuxStats
+
+/**
+ Constructor
+
+ @param counters: counters to snapshot
+ */
+- (instancetype)initWithCounters:(struct mux_counters *)counters {
+    self = [super init];
+    if (self) {
+        uint64_t elapsedNs = mux_time_ns() - atomic_load(&counters->startNs);
+        uint64_t txBuffers = atomic_load(&counters->txBuffers);
+        uint64_t rxBuffers = atomic_load(&counters->rxBuffers);
+        _elapsedTime = elapsedNs / 1e9;
+        _txBytes = atomic_load(&counters->txBytes);
+        _txBufferCount = (NSUInteger)txBuffers;
+        _averageTxLatency = txBuffers > 0 ? atomic_load(&counters->txLatencySumNs) / 1e9 / txBuffers : 0;
+        _maxTxLatency = atomic_load(&counters->txLatencyMaxNs) / 1e9;
+        _rxBytes = atomic_load(&counters->rxBytes);
+        _rxBufferCount = (NSUInteger)rxBuffers;
+        _rxBatchCount = (NSUInteger)atomic_load(&counters->rxBatches);
+        _maxRxBatchSize = (NSUInteger)atomic_load(&counters->rxBatchMax);
+        _averageRxLatency = rxBuffers > 0 ? atomic_load(&counters->rxLatencySumNs) / 1e9 / rxBuffers : 0;
+        _maxRxLatency = atomic_load(&counters->rxLatencyMaxNs) / 1e9;
+        _rxPoolMissCount = (NSUInteger)atomic_load(&counters->rxPoolMisses);
+        _txThroughput = _elapsedTime > 0 ? _txBytes / _elapsedTime : 0;
+        _rxThroughput = _elapsedTime > 0 ? _rxBytes / _elapsedTime : 0;
+    }
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"tx: %llu bytes %lu buffers %.0f B/s latency avg %.3fms max %.3fms "
+            "rx: %llu bytes %lu buffers %lu batches (max %lu) %.0f B/s latency avg %.3fms max %.3fms "
+            "pool misses: %lu",
+            _txBytes, (unsigned long)_txBufferCount, _txThroughput, _averageTxLatency * 1000, _maxTxLatency * 1000,
+            _rxBytes, (unsigned long)_rxBufferCount, (unsigned long)_rxBatchCount, (unsigned long)_maxRxBatchSize,
+            _rxThroughput, _averageRxLatency * 1000, _maxRxLatency * 1000, (unsigned long)_rxPoolMissCount];
+}
+
+@end
 
 @interface ArsdkMux () <NSStreamDelegate>
 @property (nonatomic, weak) id<ArsdkMuxDelegate> delegate;
@@ -52,13 +203,35 @@ typedef NS_ENUM(NSUInteger, State) {
 @property (atomic) State state;
 @property (nonatomic) struct pomp_loop* pomp_loop;
 @property (nonatomic, strong) NSThread *streamThread;
-@property (nonatomic, strong) PompBufferQueue *bufferQueue;
 @property (nonatomic, strong) NSInputStream *inputStream;
 @property (nonatomic, strong) NSOutputStream *outputStream;
 @property (nonatomic, strong) NSRunLoop *runLoop;
 @end
 
-@implementation ArsdkMux
+@implementation ArsdkMux {
+    /** Protects `_txPending`, `_txWakeupScheduled`, `_rxPending` and `_rxDecodeScheduled` */
+    os_unfair_lock _lock;
+    /** Buffers queued by the mux, waiting to be handed over to the stream thread */
+    struct mux_buf_list _txPending;
+    /** Whether a write of the pending tx buffers is scheduled on the stream thread */
+    bool _txWakeupScheduled;
+    /** Buffers being written by the stream thread */
+    struct mux_buf_list _txWriting;
+    /** Index, in `_txWriting`, of the buffer being written */
+    size_t _txIndex;
+    /** Offset of the next byte to write in the buffer being written */
+    size_t _txOffset;
+    /** Read buffers, waiting to be decoded on the pomp loop */
+    struct mux_buf_list _rxPending;
+    /** Whether a decode of the pending rx buffers is dispatched on the pomp loop */
+    bool _rxDecodeScheduled;
+    /** Read buffers being decoded on the pomp loop */
+    struct mux_buf_list _rxDecoding;
+    /** Read buffers kept for reuse, only accessed by the stream thread */
+    struct pomp_buffer *_rxPool[READ_BUFFER_POOL_SIZE];
+    /** Mux link counters */
+    struct mux_counters _counters;
+}
 
 /**
  Constructor.
@@ -85,7 +258,8 @@ typedef NS_ENUM(NSUInteger, State) {
         _inputStream = inputStream;
         _outputStream = outputStream;
         _pomp_loop = pomp_loop;
-        _bufferQueue = [[PompBufferQueue alloc] init];
+        _lock = OS_UNFAIR_LOCK_INIT;
+        atomic_init(&_counters.startNs, mux_time_ns());
         _streamThread = [[NSThread alloc] initWithTarget:self selector:@selector(streamThreadRun) object:nil];
         _streamThread.name = @"ArsdkMux";
         [_streamThread start];
@@ -99,6 +273,10 @@ typedef NS_ENUM(NSUInteger, State) {
     }
 }
 
+- (ArsdkMuxStats *)stats {
+    return [[ArsdkMuxStats alloc] initWithCounters:&_counters];
+}
+
 #pragma streamThread
 
 /**
@@ -127,6 +305,7 @@ typedef NS_ENUM(NSUInteger, State) {
         }];
         _mux = nil;
     }
+    [ULog i:TAG msg:@"ArsdkMux stats %@", [self stats]];
     [self cleanUp];
 }
 
@@ -211,62 +390,193 @@ typedef NS_ENUM(NSUInteger, State) {
 }
 
 /**
- Queue a new buffer and trig write
+ Queues a buffer to write, waking the stream thread up if no write is scheduled yet.
+
+ Called in the pomp loop thread.
+
+ @param buf: buffer to write, the caller reference is kept until the buffer has been fully written
  */
-- (void)queueAndWriteBuffer:(PompBuffer*)buf {
-    [_bufferQueue queueBuffer:buf];
-    [self writeNextBuffer];
+- (void)queueBuffer:(struct pomp_buffer *)buf {
+    os_unfair_lock_lock(&_lock);
+    mux_buf_list_append(&_txPending, buf, mux_time_ns());
+    bool wakeup = !_txWakeupScheduled;
+    _txWakeupScheduled = true;
+    os_unfair_lock_unlock(&_lock);
+
+    if (wakeup) {
+        CFRunLoopRef runLoop = [self.runLoop getCFRunLoop];
+        CFRunLoopPerformBlock(runLoop, kCFRunLoopDefaultMode, ^{
+            [self writeNextBuffer];
+        });
+        CFRunLoopWakeUp(runLoop);
+    }
 }
 
 /**
- Write the next buffer of the queue
+ Write the queued buffers, from the current write position, until the output stream is full.
+
+ Called in the stream thread.
 */
 - (void)writeNextBuffer {
-    while (_bufferQueue.first != NULL && _outputStream.hasSpaceAvailable) {
-        // get first buffer data, compute size to write
-        NSData* data = [_bufferQueue.first getAsData];
-        NSUInteger pos = _bufferQueue.firstBufOffset;
-        NSUInteger len = data.length - pos;
-
-        NSInteger written = [_outputStream write:[data subdataWithRange:NSMakeRange(pos, len)].bytes maxLength:len];
-        if (written < 0) {
-            // error. Will be handled in the main handle event loop
-            return;
-        } else {
-            if (written != len) {
-                _bufferQueue.firstBufOffset += written;
-            } else {
-                [_bufferQueue dequeue];
+    while (_outputStream.hasSpaceAvailable) {
+        if (_txIndex == _txWriting.count) {
+            // all buffers written, take over the pending ones
+            _txWriting.count = 0;
+            _txIndex = 0;
+            os_unfair_lock_lock(&_lock);
+            struct mux_buf_list pending = _txPending;
+            _txPending = _txWriting;
+            _txWriting = pending;
+            _txWakeupScheduled = false;
+            os_unfair_lock_unlock(&_lock);
+            if (_txWriting.count == 0) {
+                return;
+            }
+        }
+
+        struct mux_buf_entry *entry = &_txWriting.entries[_txIndex];
+        const void *data = NULL;
+        size_t len = 0;
+        int res = pomp_buffer_get_cdata(entry->buf, &data, &len, NULL);
+        if (res < 0) {
+            [ULog e:TAG msg:@"ArsdkMux pomp_buffer_get_cdata %s", strerror(-res)];
+            len = 0;
+        }
+
+        NSInteger written = 0;
+        if (_txOffset < len) {
+            written = [_outputStream write:(const uint8_t *)data + _txOffset maxLength:len - _txOffset];
+            if (written < 0) {
+                // error. Will be handled in the main handle event loop
+                return;
             }
+            _txOffset += (size_t)written;
+            atomic_fetch_add_explicit(&_counters.txBytes, (uint64_t)written, memory_order_relaxed);
+        }
+        if (_txOffset >= len) {
+            uint64_t latencyNs = mux_time_ns() - entry->queuedNs;
+            atomic_fetch_add_explicit(&_counters.txBuffers, 1, memory_order_relaxed);
+            atomic_fetch_add_explicit(&_counters.txLatencySumNs, latencyNs, memory_order_relaxed);
+            mux_counter_max(&_counters.txLatencyMaxNs, latencyNs);
+            pomp_buffer_unref(entry->buf);
+            entry->buf = NULL;
+            _txIndex++;
+            _txOffset = 0;
+        } else if (written == 0) {
+            return;
+        }
+    }
+}
+
+/**
+ Gets a buffer to read into, from the pool if one is not used anymore.
+
+ Called in the stream thread.
+
+ @param pooled: set to true if the buffer belongs to the pool
+ @return a buffer with a single reference, owned by the pool if pooled
+ */
+- (struct pomp_buffer *)rxBuffer:(bool *)pooled {
+    for (int i = 0; i < READ_BUFFER_POOL_SIZE; i++) {
+        if (_rxPool[i] == NULL) {
+            // filling the pool is not a miss
+            _rxPool[i] = pomp_buffer_new(READ_BUFFER_SIZE);
+            *pooled = _rxPool[i] != NULL;
+            return _rxPool[i];
+        }
+        // a buffer that is not shared anymore has been decoded and released by the mux
+        if (!pomp_buffer_is_shared(_rxPool[i])) {
+            *pooled = true;
+            return _rxPool[i];
         }
     }
+    atomic_fetch_add_explicit(&_counters.rxPoolMisses, 1, memory_order_relaxed);
+    *pooled = false;
+    return pomp_buffer_new(READ_BUFFER_SIZE);
 }
 
 /**
- Read from the input stream
+ Read from the input stream, and hand the read buffers over to the pomp loop in a single batch.
+
+ Called in the stream thread.
  */
 - (void)read {
     while (_inputStream.hasBytesAvailable) {
+        bool pooled = false;
+        struct pomp_buffer *buf = [self rxBuffer:&pooled];
         void *data = NULL;
-        struct pomp_buffer *buf = pomp_buffer_new_get_data(READ_BUFFER_SIZE, &data);
+        if (buf == NULL || pomp_buffer_get_data(buf, &data, NULL, NULL) < 0) {
+            [ULog e:TAG msg:@"ArsdkMux failed to get a read buffer"];
+            return;
+        }
         NSInteger bytesRead = [_inputStream read:(uint8_t *)data maxLength:READ_BUFFER_SIZE];
+        if (bytesRead <= 0) {
+            if (!pooled) {
+                pomp_buffer_unref(buf);
+            }
+            // error. Will be handled in the main handle event loop
+            return;
+        }
         pomp_buffer_set_len(buf, (size_t)bytesRead);
-        [_arsdkCore dispatch:^{
-            int res = mux_decode(self->_mux, buf);
+        atomic_fetch_add_explicit(&_counters.rxBytes, (uint64_t)bytesRead, memory_order_relaxed);
+        atomic_fetch_add_explicit(&_counters.rxBuffers, 1, memory_order_relaxed);
+        if (pooled) {
+            // the pool keeps its reference, the pending list owns a new one
+            pomp_buffer_ref(buf);
+        }
+
+        os_unfair_lock_lock(&_lock);
+        mux_buf_list_append(&_rxPending, buf, mux_time_ns());
+        bool dispatch = !_rxDecodeScheduled;
+        _rxDecodeScheduled = true;
+        os_unfair_lock_unlock(&_lock);
+
+        if (dispatch) {
+            [_arsdkCore dispatch:^{
+                [self decodePendingBuffers];
+            }];
+        }
+    }
+}
+
+/**
+ Decode all buffers read since the last decode.
+
+ Called in the pomp loop thread.
+ */
+- (void)decodePendingBuffers {
+    os_unfair_lock_lock(&_lock);
+    struct mux_buf_list pending = _rxPending;
+    _rxPending = _rxDecoding;
+    _rxDecoding = pending;
+    _rxDecodeScheduled = false;
+    os_unfair_lock_unlock(&_lock);
+
+    atomic_fetch_add_explicit(&_counters.rxBatches, 1, memory_order_relaxed);
+    mux_counter_max(&_counters.rxBatchMax, _rxDecoding.count);
+    uint64_t now = mux_time_ns();
+    for (size_t i = 0; i < _rxDecoding.count; i++) {
+        struct mux_buf_entry *entry = &_rxDecoding.entries[i];
+        uint64_t latencyNs = now - entry->queuedNs;
+        atomic_fetch_add_explicit(&_counters.rxLatencySumNs, latencyNs, memory_order_relaxed);
+        mux_counter_max(&_counters.rxLatencyMaxNs, latencyNs);
+        if (_mux != NULL) {
+            int res = mux_decode(_mux, entry->buf);
             if (res != 0) {
                 [ULog e:TAG msg:@"ArsdkMux mux_decode %s", strerror(-res)];
             }
-            pomp_buffer_unref(buf);
-        }];
+        }
+        pomp_buffer_unref(entry->buf);
     }
+    _rxDecoding.count = 0;
 }
 
 // tx callback - called by the mux when there is data to write to the output stream
 // called in the pomp loop thread
 static int libmux_mux_ops_tx_callback(struct mux_ctx *ctx, struct pomp_buffer *buf, void *userdata) {
     ArsdkMux *this = (__bridge ArsdkMux *)(userdata);
-    [this performSelector:@selector(queueAndWriteBuffer:)
-                 onThread:this.streamThread withObject:[[PompBuffer alloc]init:buf] waitUntilDone:NO];
+    pomp_buffer_ref(buf);
+    [this queueBuffer:buf];
     return 0;
 }
 
@@ -277,5 +587,19 @@ static void libmux_mux_ops_release_callback(struct mux_ctx *ctx, void *userdata)
 - (void)dealloc
 {
     [self cleanUp];
+    mux_buf_list_clear(&_txPending);
+    // buffers before the write index have already been released
+    for (size_t i = _txIndex; i < _txWriting.count; i++) {
+        pomp_buffer_unref(_txWriting.entries[i].buf);
+    }
+    _txWriting.count = 0;
+    mux_buf_list_clear(&_txWriting);
+    mux_buf_list_clear(&_rxPending);
+    mux_buf_list_clear(&_rxDecoding);
+    for (int i = 0; i < READ_BUFFER_POOL_SIZE; i++) {
+        if (_rxPool[i] != NULL) {
+            pomp_buffer_unref(_rxPool[i]);
+        }
+    }
 }
 @end
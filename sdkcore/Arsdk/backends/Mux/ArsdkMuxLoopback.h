@@ -0,0 +1,85 @@
+//    Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+#import <Foundation/Foundation.h>
+#import "ArsdkMuxStats.h"
+
+@class ArsdkCore;
+
+/**
+ Mux stream pair harness.
+
+ Two muxes are connected back to back through bound stream pairs, so that their stream handling (in place writes,
+ partial writes and batched reads) can be checked without any device. Data is sent from the sending mux to the
+ receiving mux on a mux channel, both muxes run on the arsdk pomp loop.
+ */
+@interface ArsdkMuxLoopback : NSObject
+
+/** Link counters of the sending mux */
+@property (nonatomic, readonly) ArsdkMuxStats * _Nonnull senderStats;
+/** Link counters of the receiving mux */
+@property (nonatomic, readonly) ArsdkMuxStats * _Nonnull receiverStats;
+
+- (instancetype _Nonnull)init NS_UNAVAILABLE;
+
+/**
+ Constructor
+
+ Opens the stream pairs and starts both muxes. The arsdk pomp loop must be running.
+
+ @param arsdkCore arsdk core running the muxes pomp loop
+ @param bufferSize size of the bound stream pairs buffers, smaller buffers require more partial writes
+ @param completion called on the main thread once both muxes have started and the channel is open, with `YES`, or
+ when a mux failed to start, with `NO`
+ @return a new mux stream pair harness
+ */
+- (instancetype _Nonnull)initWithArsdkCore:(ArsdkCore * _Nonnull)arsdkCore streamBufferSize:(NSUInteger)bufferSize
+                                completion:(void (^ _Nonnull)(BOOL started))completion;
+
+/**
+ Sends data from the sending mux and waits until the receiving mux has received all of it.
+
+ Must not be called on the arsdk pomp loop.
+
+ @param data data to send
+ @param chunkSize size of the buffers encoded by the sending mux
+ @param holdDecoding whether to keep the arsdk pomp loop busy until the receiving mux has read all the data, so that
+ it is decoded in a single batch
+ @param timeout maximum time to wait for the data, in seconds
+ @return the received data, nil if the data could not be sent or has not been fully received before the timeout
+ */
+- (NSData * _Nullable)sendData:(NSData * _Nonnull)data chunkSize:(NSUInteger)chunkSize holdDecoding:(BOOL)holdDecoding
+                       timeout:(NSTimeInterval)timeout;
+
+/**
+ Closes the channel and both muxes.
+ */
+- (void)close;
+
+@end
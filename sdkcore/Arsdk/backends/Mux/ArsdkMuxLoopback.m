@@ -0,0 +1,241 @@
+//    Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+#import "ArsdkMuxLoopback.h"
+#import "ArsdkMux.h"
+#import "ArsdkCore+Internal.h"
+#import "Logger.h"
+#include <libmux.h>
+#include <libpomp.h>
+#include <time.h>
+#include <unistd.h>
+
+/** Mux channel data is sent on */
+#define LOOPBACK_CHANNEL_ID     100
+
+extern ULogTag* TAG;
+
+@interface ArsdkMuxLoopback () <ArsdkMuxDelegate>
+@end
+
+@implementation ArsdkMuxLoopback {
+    /** Arsdk core running the muxes pomp loop */
+    ArsdkCore *_arsdkCore;
+    /** Mux sending data, nil once closed */
+    ArsdkMux *_sender;
+    /** Mux receiving data, nil once closed */
+    ArsdkMux *_receiver;
+    /** Number of started muxes, only accessed in the main thread */
+    NSUInteger _startedCount;
+    /** Start completion, nil once called. Only accessed in the main thread */
+    void (^_completion)(BOOL started);
+    /** Whether the channel is open on both muxes, only accessed in the pomp loop thread */
+    BOOL _channelOpen;
+    /** Data received during the current send, only accessed in the pomp loop thread */
+    NSMutableData *_received;
+    /** Length of the data sent by the current send, only accessed in the pomp loop thread */
+    NSUInteger _expectedLength;
+    /** Signaled when all data of the current send has been received, only accessed in the pomp loop thread */
+    dispatch_semaphore_t _done;
+}
+
+/** mux channel callback, called in the pomp loop thread */
+static void loopback_channel_cb(struct mux_ctx *ctx, uint32_t chanid, enum mux_channel_event event,
+                                struct pomp_buffer *buf, void *userdata) {
+    ArsdkMuxLoopback *self = (__bridge ArsdkMuxLoopback *)userdata;
+    if (event == MUX_CHANNEL_DATA) {
+        [self didReceiveBuffer:buf];
+    }
+}
+
+- (instancetype)initWithArsdkCore:(ArsdkCore *)arsdkCore streamBufferSize:(NSUInteger)bufferSize
+                       completion:(void (^)(BOOL started))completion {
+    self = [super init];
+    if (self) {
+        _arsdkCore = arsdkCore;
+        _completion = completion;
+        CFReadStreamRef senderInput, receiverInput;
+        CFWriteStreamRef senderOutput, receiverOutput;
+        CFStreamCreateBoundPair(NULL, &receiverInput, &senderOutput, (CFIndex)bufferSize);
+        CFStreamCreateBoundPair(NULL, &senderInput, &receiverOutput, (CFIndex)bufferSize);
+        struct pomp_loop *loop = [arsdkCore.pompLoopUtil internalPompLoop];
+        _sender = [[ArsdkMux alloc] initWithDelegate:self arsdkCore:arsdkCore
+                                         inputStream:(__bridge_transfer NSInputStream *)senderInput
+                                        outputStream:(__bridge_transfer NSOutputStream *)senderOutput
+                                           pomp_loop:loop];
+        _receiver = [[ArsdkMux alloc] initWithDelegate:self arsdkCore:arsdkCore
+                                           inputStream:(__bridge_transfer NSInputStream *)receiverInput
+                                          outputStream:(__bridge_transfer NSOutputStream *)receiverOutput
+                                             pomp_loop:loop];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self close];
+}
+
+- (ArsdkMuxStats *)senderStats {
+    return [_sender stats];
+}
+
+- (ArsdkMuxStats *)receiverStats {
+    return [_receiver stats];
+}
+
+- (NSData *)sendData:(NSData *)data chunkSize:(NSUInteger)chunkSize holdDecoding:(BOOL)holdDecoding
+             timeout:(NSTimeInterval)timeout {
+    if (_sender == nil || data.length == 0 || chunkSize == 0) {
+        return nil;
+    }
+    dispatch_semaphore_t done = dispatch_semaphore_create(0);
+    uint64_t deadlineNs = clock_gettime_nsec_np(CLOCK_UPTIME_RAW) + (uint64_t)(timeout * NSEC_PER_SEC);
+    ArsdkMux *sender = _sender;
+    ArsdkMux *receiver = _receiver;
+    [_arsdkCore dispatch:^{
+        if (!self->_channelOpen) {
+            return;
+        }
+        self->_received = [NSMutableData dataWithCapacity:data.length];
+        self->_expectedLength = data.length;
+        self->_done = done;
+        uint64_t rxBytes = receiver.stats.rxBytes;
+        for (NSUInteger offset = 0; offset < data.length; offset += chunkSize) {
+            size_t len = MIN(chunkSize, data.length - offset);
+            struct pomp_buffer *buf = pomp_buffer_new_with_data((const uint8_t *)data.bytes + offset, len);
+            int res = buf != NULL ? mux_encode(sender.mux, LOOPBACK_CHANNEL_ID, buf) : -ENOMEM;
+            if (buf != NULL) {
+                pomp_buffer_unref(buf);
+            }
+            if (res < 0) {
+                [ULog e:TAG msg:@"ArsdkMuxLoopback mux_encode %s", strerror(-res)];
+                return;
+            }
+        }
+        if (holdDecoding) {
+            // mux headers are not accounted for, most of the data is read once the payload size has been read
+            uint64_t expectedRxBytes = rxBytes + data.length;
+            while (receiver.stats.rxBytes < expectedRxBytes &&
+                   clock_gettime_nsec_np(CLOCK_UPTIME_RAW) < deadlineNs) {
+                usleep(1000);
+            }
+        }
+    }];
+    uint64_t nowNs = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    int64_t remainingNs = deadlineNs > nowNs ? (int64_t)(deadlineNs - nowNs) : 0;
+    dispatch_semaphore_wait(done, dispatch_time(DISPATCH_TIME_NOW, remainingNs));
+    __block NSData *received = nil;
+    [_arsdkCore dispatch_sync:^{
+        if (self->_received.length == self->_expectedLength) {
+            received = self->_received;
+        }
+        self->_received = nil;
+        self->_expectedLength = 0;
+        self->_done = nil;
+    }];
+    return received;
+}
+
+- (void)close {
+    if (_sender != nil) {
+        ArsdkMux *sender = _sender;
+        ArsdkMux *receiver = _receiver;
+        _sender = nil;
+        _receiver = nil;
+        [_arsdkCore dispatch_sync:^{
+            if (self->_channelOpen) {
+                mux_channel_close(sender.mux, LOOPBACK_CHANNEL_ID);
+                mux_channel_close(receiver.mux, LOOPBACK_CHANNEL_ID);
+                self->_channelOpen = NO;
+            }
+        }];
+        [sender close];
+        [receiver close];
+    }
+}
+
+/**
+ Called in the pomp loop thread when data has been received on the channel
+
+ @param buf: received data
+ */
+- (void)didReceiveBuffer:(struct pomp_buffer *)buf {
+    const void *data = NULL;
+    size_t len = 0;
+    if (_received != nil && pomp_buffer_get_cdata(buf, &data, &len, NULL) == 0) {
+        [_received appendBytes:data length:len];
+        if (_received.length >= _expectedLength) {
+            dispatch_semaphore_signal(_done);
+        }
+    }
+}
+
+/**
+ Calls the start completion, if not called yet.
+
+ @param started: whether both muxes have started
+ */
+- (void)completeStart:(BOOL)started {
+    void (^completion)(BOOL) = _completion;
+    _completion = nil;
+    if (completion != nil) {
+        completion(started);
+    }
+}
+
+#pragma mark - ArsdkMuxDelegate
+
+- (void)muxDidStart {
+    if (++_startedCount < 2 || _sender == nil) {
+        return;
+    }
+    ArsdkMux *sender = _sender;
+    ArsdkMux *receiver = _receiver;
+    __block int res = 0;
+    [_arsdkCore dispatch_sync:^{
+        res = mux_channel_open(sender.mux, LOOPBACK_CHANNEL_ID, &loopback_channel_cb, (__bridge void *)self);
+        if (res == 0) {
+            res = mux_channel_open(receiver.mux, LOOPBACK_CHANNEL_ID, &loopback_channel_cb, (__bridge void *)self);
+            if (res < 0) {
+                mux_channel_close(sender.mux, LOOPBACK_CHANNEL_ID);
+            }
+        }
+        self->_channelOpen = res == 0;
+    }];
+    if (res < 0) {
+        [ULog e:TAG msg:@"ArsdkMuxLoopback mux_channel_open %s", strerror(-res)];
+    }
+    [self completeStart:res == 0];
+}
+
+- (void)muxDidFail {
+    [self completeStart:NO];
+}
+
+@end
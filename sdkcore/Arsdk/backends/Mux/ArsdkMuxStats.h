@@ -0,0 +1,66 @@
+//    Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+#import <Foundation/Foundation.h>
+
+/**
+ Snapshot of the mux link counters.
+ */
+@interface ArsdkMuxStats : NSObject
+
+/** Time since the mux creation, in seconds */
+@property (nonatomic, readonly) NSTimeInterval elapsedTime;
+/** Bytes written to the output stream */
+@property (nonatomic, readonly) uint64_t txBytes;
+/** Buffers fully written to the output stream */
+@property (nonatomic, readonly) NSUInteger txBufferCount;
+/** Average output throughput since the mux creation, in bytes per second */
+@property (nonatomic, readonly) double txThroughput;
+/** Average time between a buffer queuing by the mux and its full write, in seconds */
+@property (nonatomic, readonly) NSTimeInterval averageTxLatency;
+/** Highest time between a buffer queuing by the mux and its full write, in seconds */
+@property (nonatomic, readonly) NSTimeInterval maxTxLatency;
+/** Bytes read from the input stream */
+@property (nonatomic, readonly) uint64_t rxBytes;
+/** Buffers read from the input stream */
+@property (nonatomic, readonly) NSUInteger rxBufferCount;
+/** Average input throughput since the mux creation, in bytes per second */
+@property (nonatomic, readonly) double rxThroughput;
+/** Batches of read buffers handed over to the pomp loop */
+@property (nonatomic, readonly) NSUInteger rxBatchCount;
+/** Biggest batch of read buffers handed over to the pomp loop */
+@property (nonatomic, readonly) NSUInteger maxRxBatchSize;
+/** Average time between a buffer read and its decoding on the pomp loop, in seconds */
+@property (nonatomic, readonly) NSTimeInterval averageRxLatency;
+/** Highest time between a buffer read and its decoding on the pomp loop, in seconds */
+@property (nonatomic, readonly) NSTimeInterval maxRxLatency;
+/** Read buffers allocated because no pooled buffer was available, the buffers filling the pool are not counted */
+@property (nonatomic, readonly) NSUInteger rxPoolMissCount;
+
+@end
@@ -62,6 +62,24 @@ struct arsdk_cmd;
 
 - (void)removeDevice:(int16_t)handle;
 
+/**
+ Runs the arsdk loop and the stream loops, like ArsdkCore `start` does.
+ */
+- (void)startLoops;
+
+/**
+ Stops the arsdk loop and the stream loops, like ArsdkCore `stop` does.
+ */
+- (void)stopLoops;
+
+/**
+ Retrieves the pomp loop on which a new video stream of a device must run.
+
+ @param handle: device handle
+ @return a dedicated stream loop if `streamLoopCount` allows it for this device, the arsdk loop otherwise
+ */
+- (PompLoopUtil * _Nonnull)streamLoopForDevice:(int16_t)handle;
+
 - (void)deviceConnecting:(int16_t)handle;
 
 - (void)deviceConnected:(int16_t)handle;
@@ -77,6 +95,50 @@ struct arsdk_cmd;
 
 - (void)onCommandReceived:(int16_t)handle encoder:(int (^ _Nonnull)(struct arsdk_cmd * _Nonnull))encoder;
 
+/**
+ Encodes a command and appends it to the trace replayed by `replayCommandTrace:repeat:`.
+
+ @param encoder: encoder of the command to append
+ */
+- (void)appendCommandToTrace:(int (^ _Nonnull)(struct arsdk_cmd * _Nonnull))encoder;
+
+/**
+ Replays the recorded command trace to a connected device and counts the heap allocations made on the main thread
+ while receiving and delivering it.
+
+ Commands are injected in the ArsdkCore receive path of the device, see `commandReceiverForDevice:deviceListener:`,
+ and the main queue is drained after each replay of the trace.
+
+ @param handle: handle of the device to deliver the commands to
+ @param repeat: number of times the whole trace is replayed
+ @return mean number of heap allocations per delivered command
+ */
+- (double)replayCommandTrace:(int16_t)handle repeat:(NSUInteger)repeat;
+
+/**
+ Delivers the recorded command trace directly to the listener of a connected device and counts the heap allocations
+ made on the main thread while delivering it.
+
+ Gives the allocation cost of the device listener alone, to be compared with `replayCommandTrace:repeat:`.
+
+ @param handle: handle of the device to deliver the commands to
+ @param repeat: number of times the whole trace is delivered
+ @return mean number of heap allocations per delivered command
+ */
+- (double)deliverCommandTrace:(int16_t)handle repeat:(NSUInteger)repeat;
+
+/**
+ Injects the recorded command trace once in a command receiver, without waiting for the commands delivery.
+
+ @param receiver: receiver to inject the commands in, see `commandReceiverForDevice:deviceListener:`
+ */
+- (void)receiveCommandTrace:(ArsdkCommandReceiver * _Nonnull)receiver;
+
+/**
+ Clears the recorded command trace.
+ */
+- (void)clearCommandTrace;
+
 - (void)expect:(Expectation* _Nonnull)expectation;
 
 - (void)assertNoExpectationInFile:(NSString* _Nonnull)file atLine:(NSUInteger)line;
@@ -28,7 +28,29 @@
 //    SUCH DAMAGE.
 
 #import "MockArsdkCore.h"
+#import "ArsdkCore+Internal.h"
 #import <arsdkctrl/arsdkctrl.h>
+#import <pthread.h>
+#import <stdatomic.h>
+
+/** Type of the libmalloc logging hook, called for each allocation and deallocation */
+typedef void (malloc_logger_t)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result,
+                               uint32_t num_hot_frames_to_skip);
+/** libmalloc logging hook */
+extern malloc_logger_t *malloc_logger;
+/** Flag set in the malloc logger type of an allocation */
+#define MALLOC_LOG_TYPE_ALLOCATE 2
+
+/** Number of allocations made on the main thread since the allocation logger has been installed */
+static atomic_ulong mainThreadAllocations;
+
+/** Malloc logger counting allocations made on the main thread */
+static void count_allocations(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result,
+                              uint32_t num_hot_frames_to_skip) {
+    if ((type & MALLOC_LOG_TYPE_ALLOCATE) && pthread_main_np()) {
+        atomic_fetch_add_explicit(&mainThreadAllocations, 1, memory_order_relaxed);
+    }
+}
 
 @interface Device : NSObject
 @property (nonatomic) NSString* uid;
@@ -250,7 +272,12 @@
 
 @end
 
-@implementation MockArsdkCore
+@implementation MockArsdkCore {
+    /** Recorded command trace */
+    struct arsdk_cmd *_trace;
+    /** Number of commands in `_trace` */
+    size_t _traceCount;
+}
 
 /**
  Constructor
@@ -278,6 +305,15 @@
 - (void)start {
     [_expectQueue removeAllObjects];
     [_devices removeAllObjects];
+    [self.deviceBackendTypes removeAllObjects];
+}
+
+- (void)startLoops {
+    [super start];
+}
+
+- (void)stopLoops {
+    [super stop];
 }
 
 /**
@@ -363,6 +399,12 @@
     }
 }
 
+- (void)getNoAckCmdLoopStats:(int16_t)handle completion:(void (^)(ArsdkNoAckLoopStats))completion {
+    ArsdkNoAckLoopStats stats;
+    memset(&stats, 0, sizeof(stats));
+    completion(stats);
+}
+
 /**
  Stop piloting command loop
  */
@@ -532,6 +574,7 @@
     device.type = (int)type;
     device.backendType = backendType;
     [_devices setObject:device forKey:[NSNumber numberWithShort:handle]];
+    self.deviceBackendTypes[@(handle)] = @(backendType);
     [_listener onDeviceAdded:uid type:type backendType:backendType name:name
                          api:ArsdkApiCapabilitiesFull handle:handle];
 }
@@ -539,6 +582,7 @@
 - (void)removeDevice:(int16_t)handle {
     Device* device = [_devices objectForKey:[NSNumber numberWithShort:handle]];
     if (device) {
+        [self.deviceBackendTypes removeObjectForKey:@(handle)];
         [_listener onDeviceRemoved:device.uid type:device.type backendType:device.backendType handle:handle];
     }
 }
@@ -573,6 +617,85 @@
     }
 }
 
+- (void)appendCommandToTrace:(int (^)(struct arsdk_cmd *))encoder {
+    _trace = realloc(_trace, (_traceCount + 1) * sizeof(*_trace));
+    memset(&_trace[_traceCount], 0, sizeof(*_trace));
+    if (encoder(&_trace[_traceCount]) == 0) {
+        _traceCount++;
+    }
+}
+
+/** Main queue function raising the flag given as context */
+static void set_flag(void *context) {
+    *(bool *)context = true;
+}
+
+/** Runs the main run loop until all the blocks currently queued on the main queue have been executed */
+static void drain_main_queue(void) {
+    bool drained = false;
+    dispatch_async_f(dispatch_get_main_queue(), &drained, &set_flag);
+    while (!drained) {
+        CFRunLoopRunInMode(kCFRunLoopDefaultMode, 0, true);
+    }
+}
+
+- (double)replayCommandTrace:(int16_t)handle repeat:(NSUInteger)repeat {
+    id<ArsdkCoreDeviceListener> listener = [_devices objectForKey:[NSNumber numberWithShort:handle]].deviceListener;
+    if (listener == nil || _traceCount == 0 || repeat == 0) {
+        return 0;
+    }
+
+    ArsdkCommandReceiver *receiver = [self commandReceiverForDevice:handle deviceListener:listener];
+    atomic_store(&mainThreadAllocations, 0);
+    malloc_logger_t *previousLogger = malloc_logger;
+    malloc_logger = &count_allocations;
+    for (NSUInteger i = 0; i < repeat; i++) {
+        for (size_t j = 0; j < _traceCount; j++) {
+            [receiver receiveCommand:&_trace[j]];
+        }
+        drain_main_queue();
+    }
+    malloc_logger = previousLogger;
+    return (double)atomic_load(&mainThreadAllocations) / (double)(repeat * _traceCount);
+}
+
+- (double)deliverCommandTrace:(int16_t)handle repeat:(NSUInteger)repeat {
+    id<ArsdkCoreDeviceListener> listener = [_devices objectForKey:[NSNumber numberWithShort:handle]].deviceListener;
+    if (listener == nil || _traceCount == 0 || repeat == 0) {
+        return 0;
+    }
+
+    atomic_store(&mainThreadAllocations, 0);
+    malloc_logger_t *previousLogger = malloc_logger;
+    malloc_logger = &count_allocations;
+    for (NSUInteger i = 0; i < repeat; i++) {
+        for (size_t j = 0; j < _traceCount; j++) {
+            [listener onCommandReceived:&_trace[j]];
+        }
+    }
+    malloc_logger = previousLogger;
+    return (double)atomic_load(&mainThreadAllocations) / (double)(repeat * _traceCount);
+}
+
+- (void)receiveCommandTrace:(ArsdkCommandReceiver *)receiver {
+    for (size_t i = 0; i < _traceCount; i++) {
+        [receiver receiveCommand:&_trace[i]];
+    }
+}
+
+- (void)clearCommandTrace {
+    for (size_t i = 0; i < _traceCount; i++) {
+        arsdk_cmd_clear(&_trace[i]);
+    }
+    free(_trace);
+    _trace = NULL;
+    _traceCount = 0;
+}
+
+- (void)dealloc {
+    [self clearCommandTrace];
+}
+
 - (void)mockNonAckLoop:(int16_t)handle noAckType:(ArsdkNoAckCmdType)noAckType inFile:(NSString*)file
                 atLine:(NSUInteger)line {
     if ([[_devices objectForKey:[NSNumber numberWithShort:handle]] noAckCommandLoopExists] == NO) {
@@ -1,4 +1,4 @@
-// Copyright (C) 2019 Parrot Drones SAS
+//    Copyright (C) 2019 Parrot Drones SAS
 //
 //    Redistribution and use in source and binary forms, with or without
 //    modification, are permitted provided that the following conditions
@@ -27,35 +27,25 @@
 //    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
 //    SUCH DAMAGE.
 
-import XCTest
-@testable import ArsdkEngine
+#import <Foundation/Foundation.h>
 
-/// Circular array tests
-class BlackBoxCircularArrayTests: XCTestCase {
+/**
+ Video buffer holding a YUV frame with its PDRAW metadata, as delivered by a PDRAW sink, to feed frames copies and
+ references in tests.
+ */
+@interface MockVideoBuffer : NSObject
 
-    func testWhenNotLooped() {
-        var circularArray = BlackBoxCircularArray<Int>(size: 5)
-        circularArray.append(1)
-        circularArray.append(2)
-        circularArray.append(3)
-        assertThat(circularArray.readingArray, contains(1, 2, 3))
-    }
+/** Video buffer, can be cast to (struct vbuf_buffer*). */
+@property (nonatomic, assign, readonly) void * _Nonnull vbuf;
+/** Key of the PDRAW metadata in the buffer. */
+@property (nonatomic, assign, readonly) void * _Nonnull metaKey;
 
-    func testWhenLooped() {
-        var circularArray = BlackBoxCircularArray<Int>(size: 5)
-        circularArray.append(1)
-        circularArray.append(2)
-        circularArray.append(3)
-        circularArray.append(4)
-        circularArray.append(5)
-        circularArray.append(6)
-        circularArray.append(7)
-        assertThat(circularArray.readingArray, contains(3, 4, 5, 6, 7))
+/** Constructor.
 
-        circularArray.append(8)
-        circularArray.append(9)
-        circularArray.append(10)
-        circularArray.append(11)
-        assertThat(circularArray.readingArray, contains(7, 8, 9, 10, 11))
-    }
-}
+ @param size: frame size in bytes, split in 3 planes
+ @param fill: value written in each byte of the frame
+ @return the buffer, nil in case of allocation failure
+ */
+- (instancetype _Nullable)initWithSize:(size_t)size fill:(uint8_t)fill;
+
+@end
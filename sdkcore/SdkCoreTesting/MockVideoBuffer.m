@@ -0,0 +1,82 @@
+//    Copyright (C) 2019 Parrot Drones SAS
+//
+//    Redistribution and use in source and binary forms, with or without
+//    modification, are permitted provided that the following conditions
+//    are met:
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in
+//      the documentation and/or other materials provided with the
+//      distribution.
+//    * Neither the name of the Parrot Company nor the names
+//      of its contributors may be used to endorse or promote products
+//      derived from this software without specific prior written
+//      permission.
+//
+//    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+//    "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+//    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+//    FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+//    PARROT COMPANY BE LIABLE FOR ANY DIRECT, INDIRECT,
+//    INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+//    BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+//    OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+//    AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+//    OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+//    OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+//    SUCH DAMAGE.
+
+#include <video-buffers/vbuf_generic.h>
+#import <pdraw/pdraw.h>
+#import "MockVideoBuffer.h"
+
+/** Storage which address is the key of the PDRAW metadata in mock buffers. */
+static char s_meta_key;
+
+@implementation MockVideoBuffer
+
+- (instancetype _Nullable)initWithSize:(size_t)size fill:(uint8_t)fill {
+    self = [super init];
+    if (self) {
+        struct vbuf_cbs cbs;
+        int res = vbuf_generic_get_cbs(&cbs);
+        if (res < 0) {
+            return nil;
+        }
+        struct vbuf_buffer *vbuf = NULL;
+        res = vbuf_new(size, 0, &cbs, NULL, &vbuf);
+        if (res < 0 || vbuf == NULL) {
+            return nil;
+        }
+        _vbuf = vbuf;
+        _metaKey = &s_meta_key;
+
+        uint8_t *data = vbuf_get_data(vbuf);
+        memset(data, fill, size);
+        vbuf_set_size(vbuf, size);
+
+        struct pdraw_video_frame *frame = NULL;
+        res = vbuf_metadata_add(vbuf, _metaKey, 1, sizeof(*frame), (uint8_t **)&frame);
+        if (res < 0) {
+            return nil;
+        }
+        memset(frame, 0, sizeof(*frame));
+        frame->format = PDRAW_VIDEO_MEDIA_FORMAT_YUV;
+        frame->yuv.format = PDRAW_YUV_FORMAT_I420;
+        // I420 layout: luma plane, then 2 chroma planes of a quarter of its size
+        size_t lumaSize = size * 2 / 3;
+        frame->yuv.plane[0] = data;
+        frame->yuv.plane[1] = data + lumaSize;
+        frame->yuv.plane[2] = data + lumaSize + (size - lumaSize) / 2;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    if (_vbuf != NULL) {
+        vbuf_unref(_vbuf);
+    }
+}
+
+@end
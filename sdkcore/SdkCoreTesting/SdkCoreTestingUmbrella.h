@@ -34,6 +34,7 @@
 #include "Expectation.h"
 #include "ExpectedCmd.h"
 #include "CmdEncoder.h"
+#include "MockVideoBuffer.h"
 
 
 #endif /* SdkCoreTestingUmbrella_h */
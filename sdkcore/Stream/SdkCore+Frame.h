@@ -30,6 +30,38 @@
 #import <Foundation/Foundation.h>
 #import "ArsdkCore.h"
 
+/** Frame buffer pool counters. */
+typedef struct {
+    /** Number of frame copies served by a recycled buffer. */
+    uint64_t hits;
+    /** Number of frame copies that required a new buffer allocation. */
+    uint64_t misses;
+    /** Current size in bytes of all buffers allocated by the pool, in use or free. */
+    uint64_t residentBytes;
+    /** Highest value of `residentBytes`. */
+    uint64_t peakResidentBytes;
+} SdkCoreFramePoolStats;
+
+/**
+ Recycling pool of frame copy buffers.
+
+ Buffers are sorted in capacity classes, 8 per power of two interval; a frame copy reuses a free buffer of the class
+ matching the source frame size, and gives it back to the pool when the frame is deallocated. Pooled copies only carry
+ the PDRAW metadata of the source frame. Thread safe.
+ */
+@interface SdkCoreFramePool: NSObject
+
+/** Current pool counters. */
+@property (nonatomic, readonly) SdkCoreFramePoolStats stats;
+
+/** Constructor.
+
+ @param maxFreeBuffers: maximum number of free buffers kept in each capacity class
+ */
+- (instancetype _Nonnull)initWithMaxFreeBuffers:(unsigned int)maxFreeBuffers;
+
+@end
+
 /** Video frame. */
 @interface SdkCoreFrame: NSObject
 
@@ -47,4 +79,25 @@
  */
 - (instancetype _Nullable)initWithCopy:(void * _Nonnull)src metaKey:(void * _Nonnull)metaKey;
 
+/** Constructor.
+
+ @param src: pointer to frame to copy, (struct vbuf_buffer*)
+ @param metaKey: metadata key allowing to access PDRAW metadata stored in the provided frame
+ @param pool: pool providing the copy buffer, and to which it is given back when the frame is deallocated; `nil` to
+              allocate a new buffer
+ */
+- (instancetype _Nullable)initWithCopy:(void * _Nonnull)src metaKey:(void * _Nonnull)metaKey
+                                  pool:(SdkCoreFramePool * _Nullable)pool;
+
+/** Constructor.
+
+ The frame keeps a reference on the provided buffer instead of copying it; the buffer is given back to its owner
+ (usually a PDRAW buffer pool) when the frame is deallocated. Frame data must be considered read-only, and the frame
+ should be released as soon as possible since the owner pool may run out of buffers in the meantime.
+
+ @param src: pointer to frame to reference, (struct vbuf_buffer*)
+ @param metaKey: metadata key allowing to access PDRAW metadata stored in the provided frame
+ */
+- (instancetype _Nullable)initWithRef:(void * _Nonnull)src metaKey:(void * _Nonnull)metaKey;
+
 @end
@@ -31,6 +31,7 @@
 #import "SdkCore+Frame.h"
 #import "Logger.h"
 #import <pdraw/pdraw.h>
+#import <os/lock.h>
 
 /** Common loging tag. */
 extern ULogTag *TAG;
@@ -59,9 +60,228 @@ static void init_vbuf_generic_cbs()
     }
 }
 
+/** Number of capacity classes the pool keeps free buffers for. */
+#define POOL_CLASS_COUNT 8
+/** Hard limit of free buffers kept in each pool capacity class. */
+#define POOL_MAX_FREE_BUFFERS 8
+/** Number of capacity classes in each power of two interval, bounding the unused capacity of a buffer to 1/8. */
+#define POOL_CLASSES_PER_OCTAVE 8
+/** Smallest capacity step between two classes. */
+#define POOL_MIN_STEP 64
+
+/** Free buffers of a capacity class. */
+struct pool_class {
+    /** Capacity of the buffers, 0 if the class is unused */
+    size_t capacity;
+    /** Number of free buffers */
+    unsigned int count;
+    /** Free buffers */
+    struct vbuf_buffer *buffers[POOL_MAX_FREE_BUFFERS];
+};
+
+@interface SdkCoreFramePool()
+
+/**
+ Gets a buffer able to hold at least `size` bytes, either recycled or newly allocated.
+
+ @param size: required buffer size
+ @return the buffer, NULL in case of allocation failure
+ */
+- (struct vbuf_buffer * _Nullable)acquireBufferForSize:(size_t)size;
+
+/**
+ Gives a buffer back to the pool. The buffer is unreferenced if its capacity class is full.
+
+ @param buffer: buffer previously acquired from this pool
+ @param metaKey: key of the PDRAW metadata, the only metadata of pooled buffers, removed before recycling the buffer
+ */
+- (void)releaseBuffer:(struct vbuf_buffer * _Nonnull)buffer metaKey:(void * _Nullable)metaKey;
+
+@end
+
+@implementation SdkCoreFramePool {
+    /** Lock protecting the pool state */
+    os_unfair_lock _lock;
+    /** Free buffers, by capacity class */
+    struct pool_class _classes[POOL_CLASS_COUNT];
+    /** Maximum number of free buffers kept in each capacity class */
+    unsigned int _maxFreeBuffers;
+    /** Pool counters */
+    SdkCoreFramePoolStats _stats;
+}
+
+- (instancetype _Nonnull)initWithMaxFreeBuffers:(unsigned int)maxFreeBuffers {
+    self = [super init];
+    if (self) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _maxFreeBuffers = MIN(maxFreeBuffers, POOL_MAX_FREE_BUFFERS);
+    }
+    return self;
+}
+
+/**
+ Gets the capacity of the buffers able to hold a given size.
+
+ Capacities are multiples of a step which is 1/16 to 1/8 of the size, so that frames of a stream which size slightly
+ varies share buffers, while wasting at most 1/8 of each buffer.
+
+ @param size: size in bytes
+ @return the buffer capacity
+ */
+static size_t pool_capacity_for_size(size_t size)
+{
+    size_t step = POOL_MIN_STEP;
+    while (step * POOL_CLASSES_PER_OCTAVE * 2 <= size) {
+        step *= 2;
+    }
+    return (size + step - 1) / step * step;
+}
+
+/**
+ Gets the class of the free buffers of a given capacity.
+
+ @param classes: pool classes
+ @param capacity: buffers capacity
+ @param create: `true` to assign an unused class to the capacity if no class holds it yet
+ @return the class, NULL if not found
+ */
+static struct pool_class *pool_class_for_capacity(struct pool_class *classes, size_t capacity, bool create)
+{
+    struct pool_class *unused = NULL;
+    for (unsigned int i = 0; i < POOL_CLASS_COUNT; i++) {
+        if (classes[i].capacity == capacity) {
+            return &classes[i];
+        }
+        if (unused == NULL && classes[i].count == 0) {
+            unused = &classes[i];
+        }
+    }
+    if (create && unused != NULL) {
+        unused->capacity = capacity;
+        return unused;
+    }
+    return NULL;
+}
+
+- (struct vbuf_buffer * _Nullable)acquireBufferForSize:(size_t)size {
+    size_t capacity = pool_capacity_for_size(size);
+    struct vbuf_buffer *buffer = NULL;
+
+    os_unfair_lock_lock(&_lock);
+    struct pool_class *cls = pool_class_for_capacity(_classes, capacity, false);
+    if (cls != NULL && cls->count > 0) {
+        buffer = cls->buffers[--cls->count];
+        _stats.hits++;
+    } else {
+        _stats.misses++;
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    if (buffer != NULL) {
+        return buffer;
+    }
+
+    int res = vbuf_new(capacity, 0, &s_vbuf_generic_cbs, NULL, &buffer);
+    if (res < 0 || buffer == NULL) {
+        [ULog e:TAG msg:@"SdkCoreFramePool vbuf_new failed %d", res];
+        return NULL;
+    }
+
+    os_unfair_lock_lock(&_lock);
+    _stats.residentBytes += vbuf_get_capacity(buffer);
+    _stats.peakResidentBytes = MAX(_stats.peakResidentBytes, _stats.residentBytes);
+    os_unfair_lock_unlock(&_lock);
+    return buffer;
+}
+
+- (void)releaseBuffer:(struct vbuf_buffer * _Nonnull)buffer metaKey:(void * _Nullable)metaKey {
+    size_t capacity = vbuf_get_capacity(buffer);
+    BOOL recycled = NO;
+
+    // drop the previous frame metadata, it will be added again with the next frame
+    if (metaKey != NULL) {
+        vbuf_metadata_remove(buffer, metaKey);
+    }
+    vbuf_set_size(buffer, 0);
+
+    os_unfair_lock_lock(&_lock);
+    // a buffer which capacity has changed would never be reused
+    struct pool_class *cls = pool_capacity_for_size(capacity) == capacity ?
+        pool_class_for_capacity(_classes, capacity, true) : NULL;
+    if (cls != NULL && cls->count < _maxFreeBuffers) {
+        cls->buffers[cls->count++] = buffer;
+        recycled = YES;
+    } else {
+        _stats.residentBytes -= capacity;
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    if (!recycled) {
+        vbuf_unref(buffer);
+    }
+}
+
+- (SdkCoreFramePoolStats)stats {
+    os_unfair_lock_lock(&_lock);
+    SdkCoreFramePoolStats stats = _stats;
+    os_unfair_lock_unlock(&_lock);
+    return stats;
+}
+
+- (void)dealloc {
+    for (unsigned int cls = 0; cls < POOL_CLASS_COUNT; cls++) {
+        for (unsigned int i = 0; i < _classes[cls].count; i++) {
+            vbuf_unref(_classes[cls].buffers[i]);
+        }
+    }
+}
+
+@end
+
+/**
+ Copies the data and the PDRAW metadata of a buffer into a pooled buffer.
+
+ Other metadata are not copied, so that removing the PDRAW metadata leaves a recycled buffer without any metadata.
+
+ @param src: buffer to copy
+ @param dst: pooled buffer, able to hold the source data
+ @param metaKey: key of the PDRAW metadata
+ @return 0 in case of success, a negative errno otherwise
+ */
+static int pool_buffer_copy(struct vbuf_buffer *src, struct vbuf_buffer *dst, void *metaKey)
+{
+    size_t size = vbuf_get_size(src);
+    uint8_t *dst_data = vbuf_get_data(dst);
+    if (dst_data == NULL || vbuf_get_capacity(dst) < (ssize_t)size) {
+        return -EINVAL;
+    }
+    memcpy(dst_data, vbuf_get_cdata(src), size);
+    int res = vbuf_set_size(dst, size);
+    if (res < 0) {
+        return res;
+    }
+
+    unsigned int level = 0;
+    size_t len = 0;
+    uint8_t *src_meta = NULL;
+    uint8_t *dst_meta = NULL;
+    res = vbuf_metadata_get(src, metaKey, &level, &len, &src_meta);
+    if (res < 0) {
+        return res;
+    }
+    res = vbuf_metadata_add(dst, metaKey, level, len, &dst_meta);
+    if (res < 0) {
+        return res;
+    }
+    memcpy(dst_meta, src_meta, len);
+    return 0;
+}
+
 @interface SdkCoreFrame()
 /** Video buffer containing actual frame data. Unreferenced upon destroy. */
 @property (nonatomic, assign) struct vbuf_buffer *vbuf;
+/** Pool the copy buffer comes from, `nil` if the buffer is not pooled. */
+@property (nonatomic, strong) SdkCoreFramePool *pool;
 /** Key to PDRAW metadata in vbuf. */
 @property (nonatomic, assign) void * _Nullable metaKey;
 
@@ -74,6 +294,11 @@ static void init_vbuf_generic_cbs()
 @implementation SdkCoreFrame
 
 - (instancetype _Nullable)initWithCopy:(void * _Nonnull)src metaKey:(void * _Nonnull)metaKey {
+    return [self initWithCopy:src metaKey:metaKey pool:nil];
+}
+
+- (instancetype _Nullable)initWithCopy:(void * _Nonnull)src metaKey:(void * _Nonnull)metaKey
+                                  pool:(SdkCoreFramePool * _Nullable)pool {
     struct vbuf_buffer *srcbuff = (struct vbuf_buffer *)src;
     self = [super init];
     if (self) {
@@ -94,19 +319,28 @@ static void init_vbuf_generic_cbs()
             return nil;
         }
 
-        // create copy buffer
+        // create and fill copy buffer
         struct vbuf_buffer *vbuf = NULL;
-        res = vbuf_new(0, 0, &s_vbuf_generic_cbs, NULL, &vbuf);
-        if (vbuf == NULL) {
-            [ULog e:TAG msg:@"SdkCoreFrame vbuf_new failed %d", res];
-            return nil;
+        if (pool != nil) {
+            vbuf = [pool acquireBufferForSize:vbuf_get_size(srcbuff)];
+            if (vbuf == NULL) {
+                return nil;
+            }
+            self.pool = pool;
+            self.metaKey = metaKey;
+            self.vbuf = vbuf;
+            res = pool_buffer_copy(srcbuff, vbuf, metaKey);
+        } else {
+            res = vbuf_new(0, 0, &s_vbuf_generic_cbs, NULL, &vbuf);
+            if (vbuf == NULL) {
+                [ULog e:TAG msg:@"SdkCoreFrame vbuf_new failed %d", res];
+                return nil;
+            }
+            self.vbuf = vbuf;
+            res = vbuf_copy(srcbuff, vbuf);
         }
-        self.vbuf = vbuf;
-
-        // copy buffer
-        res = vbuf_copy(srcbuff, self.vbuf);
         if (res < 0) {
-            [ULog e:TAG msg:@"SdkCoreFrame vbuf_copy failed %d", res];
+            [ULog e:TAG msg:@"SdkCoreFrame copy failed %d", res];
             goto err_unref_copy;
         }
 
@@ -140,16 +374,61 @@ static void init_vbuf_generic_cbs()
     return self;
 
 err_unref_copy:
-    vbuf_unref(self.vbuf);
-    self.vbuf = NULL;
+    [self releaseBuffer];
 
     return nil;
 }
 
-- (void)dealloc {
+- (instancetype _Nullable)initWithRef:(void * _Nonnull)src metaKey:(void * _Nonnull)metaKey {
+    struct vbuf_buffer *srcbuff = (struct vbuf_buffer *)src;
+    self = [super init];
+    if (self) {
+        const uint8_t *src_data = vbuf_get_cdata(srcbuff);
+        if (src_data == NULL) {
+            [ULog e:TAG msg:@"SdkCoreFrame vbuf_get_cdata failed"];
+            return nil;
+        }
+
+        struct pdraw_video_frame *src_frame = NULL;
+        int res = vbuf_metadata_get(srcbuff, metaKey, NULL, NULL,
+                                    (uint8_t **) &src_frame);
+        if (res < 0 || src_frame == NULL) {
+            [ULog e:TAG msg:@"SdkCoreFrame (original metadata) vbuf_metadata_get failed : %d src_frame: %p", res, src_frame];
+            return nil;
+        }
+
+        res = vbuf_ref(srcbuff);
+        if (res < 0) {
+            [ULog e:TAG msg:@"SdkCoreFrame vbuf_ref failed %d", res];
+            return nil;
+        }
+        self.vbuf = srcbuff;
+
+        // plane pointers of the original metadata point into the referenced buffer, no need to fix them
+        self.metaKey = metaKey;
+        self.data = src_data;
+        self.len = vbuf_get_size(srcbuff);
+        self.pdrawFrame = (void *)src_frame;
+    }
+    return self;
+}
+
+/**
+ Releases the frame buffer, giving it back to its pool if any.
+ */
+- (void)releaseBuffer {
     if (_vbuf != NULL) {
-        vbuf_unref(_vbuf);
+        if (_pool != nil) {
+            [_pool releaseBuffer:_vbuf metaKey:_metaKey];
+        } else {
+            vbuf_unref(_vbuf);
+        }
+        _vbuf = NULL;
     }
 }
 
+- (void)dealloc {
+    [self releaseBuffer];
+}
+
 @end
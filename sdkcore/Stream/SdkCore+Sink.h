@@ -57,6 +57,36 @@ typedef NS_ENUM(NSInteger, SdkCoreSinkQueueFullPolicy) {
     SdkCoreSinkQueueFullPolicyDropNew = 1,
 };
 
+/** Int definition of the way frames are delivered to the sink listener. */
+typedef NS_ENUM(NSInteger, SdkCoreSinkFrameMode) {
+    /** Delivered frames are copies of the PDRAW buffers, that may be kept as long as needed. */
+    SdkCoreSinkFrameModeCopy = 0,
+
+    /**
+     Delivered frames reference the PDRAW buffers, without copy. Frames must be released quickly since PDRAW may run
+     out of buffers while they are retained.
+     */
+    SdkCoreSinkFrameModeReference = 1,
+};
+
+/** Sink frame counters. */
+typedef struct {
+    /** Number of frames popped from the PDRAW queue. */
+    uint64_t received;
+    /** Number of frames delivered to the sink listener. */
+    uint64_t delivered;
+    /** Number of frames skipped because a newer frame was available, in latest-only mode. */
+    uint64_t coalesced;
+    /** Number of frames that could not be delivered (frame creation failure). */
+    uint64_t dropped;
+    /** Sum of the latencies, in microseconds, between frame reception by PDRAW and delivery. */
+    uint64_t latencyTotalUs;
+    /** Highest latency, in microseconds, between frame reception by PDRAW and delivery. */
+    uint64_t latencyMaxUs;
+    /** Frame copy buffer pool counters, in copy mode. */
+    SdkCoreFramePoolStats pool;
+} SdkCoreSinkStats;
+
 /**
  Listener that will be called when events about the renderer are emitted by the native renderer object
  */
@@ -80,17 +110,41 @@ typedef NS_ENUM(NSInteger, SdkCoreSinkQueueFullPolicy) {
 /** Video sink. */
 @interface SdkCoreSink: NSObject
 
+/**
+ When `YES`, only the most recent frame available in the queue is delivered each time the sink is notified; older
+ frames are skipped and counted as coalesced. Default is `NO`, all queued frames are delivered in order.
+ */
+@property (atomic) BOOL latestOnly;
+
+/** Current frame counters. */
+@property (nonatomic, readonly) SdkCoreSinkStats stats;
+
+/**
+ Init sink.
+
+ @param queueSize: desired queue size
+ @param policy: desired queue policy
+ @param format: desired frame format
+ @param listener: Sink listener.
+ */
+- (instancetype _Nullable)initWithQueueSize:(unsigned int)queueSize
+                                     policy:(SdkCoreSinkQueueFullPolicy)policy
+                                     format:(SdkCoreSinkFrameFormat)format
+                                   listener:(id<SdkCoreSinkListener> _Nonnull)listener;
+
 /**
  Init sink.
 
  @param queueSize: desired queue size
  @param policy: desired queue policy
  @param format: desired frame format
+ @param frameMode: whether delivered frames are copies or references of the PDRAW buffers
  @param listener: Sink listener.
  */
 - (instancetype _Nullable)initWithQueueSize:(unsigned int)queueSize
                                      policy:(SdkCoreSinkQueueFullPolicy)policy
                                      format:(SdkCoreSinkFrameFormat)format
+                                  frameMode:(SdkCoreSinkFrameMode)frameMode
                                    listener:(id<SdkCoreSinkListener> _Nonnull)listener;
 /**
  Starts the sink.
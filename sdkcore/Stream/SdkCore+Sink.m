@@ -32,6 +32,8 @@
 #import "SdkCore+Sink.h"
 #import "Logger.h"
 #import <pdraw/pdraw.h>
+#import <os/lock.h>
+#include <time.h>
 
 /** Common loging tag. */
 extern ULogTag *TAG;
@@ -48,6 +50,9 @@ extern ULogTag *TAG;
 @property (nonatomic) unsigned int queueSize;
 @property (nonatomic) SdkCoreSinkQueueFullPolicy queuePolicy;
 @property (nonatomic) SdkCoreSinkFrameFormat frameFormat;
+@property (nonatomic) SdkCoreSinkFrameMode frameMode;
+/** Pool of frame copy buffers, `nil` in reference mode. */
+@property (nonatomic, strong) SdkCoreFramePool *framePool;
 
 /** Frame queue. */
 @property (nonatomic, assign) struct vbuf_queue *queue;
@@ -57,9 +62,12 @@ extern ULogTag *TAG;
 @property (nonatomic, weak) PompLoopUtil *pompLoopUtil;
 
 - (void)receivedFrameBuffer:(struct vbuf_buffer * _Nonnull)buffer;
+- (void)countReceivedFrame;
+- (void)countCoalescedFrame;
 
 @end
 
+static void release_frame_buffer(struct vbuf_buffer *buffer);
 
 /**
  Called back when a new frame has been pushed in the sink's queue.
@@ -74,16 +82,43 @@ static void pdraw_queue_push(struct pomp_evt *evt, void *userdata)
         [ULog e:TAG msg:@"SdkCoreSink pdraw_queue_push failed: %d", -EPROTO];
     }
 
+    // the event may have been notified several times before being processed, drain the whole queue
+    BOOL latestOnly = this.latestOnly;
+    struct vbuf_buffer *latest = NULL;
     struct vbuf_buffer *buffer = NULL;
-    int res = vbuf_queue_pop(this.queue, 0, &buffer);
-    if (res < 0 || buffer == NULL) {
+    int res;
+    while ((res = vbuf_queue_pop(this.queue, 0, &buffer)) == 0 && buffer != NULL) {
+        [this countReceivedFrame];
+        if (!latestOnly) {
+            [this receivedFrameBuffer:buffer];
+            release_frame_buffer(buffer);
+        } else {
+            if (latest != NULL) {
+                [this countCoalescedFrame];
+                release_frame_buffer(latest);
+            }
+            latest = buffer;
+        }
+        buffer = NULL;
+    }
+    if (res < 0 && res != -EAGAIN) {
         [ULog e:TAG msg:@"SdkCoreSink vbuf_queue_pop failed: %d", res];
-        return;
     }
 
-    [this receivedFrameBuffer:buffer];
+    if (latest != NULL) {
+        [this receivedFrameBuffer:latest];
+        release_frame_buffer(latest);
+    }
+}
+
+/**
+ Releases a frame buffer popped from the sink's queue.
 
-    res = vbuf_unref(buffer);
+ @param buffer: buffer to release
+ */
+static void release_frame_buffer(struct vbuf_buffer *buffer)
+{
+    int res = vbuf_unref(buffer);
     if (res < 0) {
         [ULog e:TAG msg:@"SdkCoreSink vbuf_unref failed: %d", res];
     }
@@ -113,17 +148,37 @@ static void pdraw_flush(struct pdraw *pdraw, struct pdraw_video_sink *sink,
     }
 }
 
-@implementation SdkCoreSink
+@implementation SdkCoreSink {
+    /** Lock protecting `_stats` */
+    os_unfair_lock _statsLock;
+    /** Frame counters */
+    SdkCoreSinkStats _stats;
+}
 
 - (instancetype _Nullable)initWithQueueSize:(unsigned int)queueSize
                                      policy:(SdkCoreSinkQueueFullPolicy)policy
                                      format:(SdkCoreSinkFrameFormat)format
                                    listener:(id<SdkCoreSinkListener> _Nonnull)listener {
+    return [self initWithQueueSize:queueSize policy:policy format:format frameMode:SdkCoreSinkFrameModeCopy
+                          listener:listener];
+}
+
+- (instancetype _Nullable)initWithQueueSize:(unsigned int)queueSize
+                                     policy:(SdkCoreSinkQueueFullPolicy)policy
+                                     format:(SdkCoreSinkFrameFormat)format
+                                  frameMode:(SdkCoreSinkFrameMode)frameMode
+                                   listener:(id<SdkCoreSinkListener> _Nonnull)listener {
     self = [super init];
     if (self) {
         self.queueSize = queueSize;
         self.queuePolicy = policy;
         self.frameFormat = format;
+        self.frameMode = frameMode;
+        if (frameMode == SdkCoreSinkFrameModeCopy) {
+            // enough buffers for a full queue plus the frames being processed by the listener
+            self.framePool = [[SdkCoreFramePool alloc] initWithMaxFreeBuffers:queueSize + 2];
+        }
+        _statsLock = OS_UNFAIR_LOCK_INIT;
 
         self.listener = listener;
     }
@@ -283,14 +338,74 @@ err_cleanup:
  @param buffer: recevied frame.
  */
 - (void)receivedFrameBuffer:(struct vbuf_buffer * _Nonnull)buffer {
-    SdkCoreFrame *frame = [[SdkCoreFrame alloc] initWithCopy:buffer metaKey:_psink];
+    SdkCoreFrame *frame = nil;
+    switch (_frameMode) {
+        case SdkCoreSinkFrameModeReference:
+            frame = [[SdkCoreFrame alloc] initWithRef:buffer metaKey:_psink];
+            break;
+        case SdkCoreSinkFrameModeCopy:
+        default:
+            frame = [[SdkCoreFrame alloc] initWithCopy:buffer metaKey:_psink pool:_framePool];
+            break;
+    }
 
     if (frame == nil) {
         [ULog e:TAG msg:@"SdkCoreSink receivedFrameBuffer failed: %d", -ENOMEM];
+        os_unfair_lock_lock(&_statsLock);
+        _stats.dropped++;
+        os_unfair_lock_unlock(&_statsLock);
         return;
     }
 
+    // latency between frame reception by PDRAW and delivery, both on the monotonic clock
+    uint64_t latencyUs = 0;
+    struct pdraw_video_frame *pdrawFrame = frame.pdrawFrame;
+    if (pdrawFrame != NULL && pdrawFrame->local_timestamp != 0) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        uint64_t nowUs = (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+        if (nowUs > pdrawFrame->local_timestamp) {
+            latencyUs = nowUs - pdrawFrame->local_timestamp;
+        }
+    }
+
+    os_unfair_lock_lock(&_statsLock);
+    _stats.delivered++;
+    _stats.latencyTotalUs += latencyUs;
+    _stats.latencyMaxUs = MAX(_stats.latencyMaxUs, latencyUs);
+    os_unfair_lock_unlock(&_statsLock);
+
     [self.listener onFrame: frame];
 }
 
+/**
+ Counts a frame popped from the queue.
+ Called in the Pomp thread
+ */
+- (void)countReceivedFrame {
+    os_unfair_lock_lock(&_statsLock);
+    _stats.received++;
+    os_unfair_lock_unlock(&_statsLock);
+}
+
+/**
+ Counts a frame skipped in latest-only mode.
+ Called in the Pomp thread
+ */
+- (void)countCoalescedFrame {
+    os_unfair_lock_lock(&_statsLock);
+    _stats.coalesced++;
+    os_unfair_lock_unlock(&_statsLock);
+}
+
+- (SdkCoreSinkStats)stats {
+    os_unfair_lock_lock(&_statsLock);
+    SdkCoreSinkStats stats = _stats;
+    os_unfair_lock_unlock(&_statsLock);
+    if (_framePool != nil) {
+        stats.pool = _framePool.stats;
+    }
+    return stats;
+}
+
 @end
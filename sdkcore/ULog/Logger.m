@@ -31,6 +31,8 @@
 #import <stdio.h>
 #import <asl.h>
 #import <pthread.h>
+#import <stdatomic.h>
+#import <time.h>
 #import <ulog.h>
 @import os.log;
 
@@ -138,10 +140,12 @@ static FILE *file;
         NSString *logPath = [self getLogPath];
         NSString *filePath = [self getLogFilePath:logPath];
         file = fopen([filePath UTF8String], "w+");
+        if (file == NULL) {
+            return nil;
+        }
 
         if ([ULog useUnifiedLogging]) {
-            // create dipatch queue for logging
-            fileLogQueue = dispatch_queue_create("com.parrot.ulog", nil);
+            file_writer_start();
         } else {
             int fd = fileno(file);
             asl_add_output_file(client, fd, FORMAT, ASL_TIME_FMT_LCL, ASL_FILTER_MASK_UPTO(ASL_LEVEL_DEBUG),
@@ -155,20 +159,19 @@ static FILE *file;
 
 + (void)stopFileRecord {
     if (file != NULL) {
-        if (![ULog useUnifiedLogging]) {
+        if ([ULog useUnifiedLogging]) {
+            file_writer_stop();
+        } else {
             int fd = fileno(file);
             asl_remove_log_file(client, fd);
+            fflush(file);
+            fclose(file);
+            file = NULL;
         }
-        fflush(file);
-        fclose(file);
-        file = NULL;
-        fileLogQueue = NULL;
     }
 }
 
-#pragma mark - unified logging
-
-static NSDateFormatter *dateFormatter;
+#pragma mark - file writer
 
 static const char * const priotab[8] = {
     " ", " ", "C", "E", "W", "N", "I", "D"
@@ -177,11 +180,188 @@ static const char * const priotab[8] = {
 /** dispatch queue used to log in file */
 static dispatch_queue_t fileLogQueue;
 
+/**
+ Log lines are pushed by the logging threads in a lock-free bounded ring of fixed size records, and written to the
+ file in batches by the file log queue, either periodically or as soon as the ring is half full. When the ring is
+ full, lines are dropped and the number of dropped lines is written to the file with the next batch.
+ */
+
+/** Number of records in the ring, must be a power of two */
+#define FILE_RING_SIZE 1024
+/** Number of pending records in the ring triggering an immediate write */
+#define FILE_RING_WATERMARK (FILE_RING_SIZE / 2)
+/** Maximum size of a recorded log message, including the terminating null byte. Longer messages are truncated */
+#define FILE_RECORD_MSG_SIZE 512
+/** Maximum size of a recorded tag name, including the terminating null byte */
+#define FILE_RECORD_TAG_SIZE 32
+/** Interval between two periodic writes, in milliseconds */
+#define FILE_WRITE_INTERVAL_MS 250
+/** Size of the file stream buffer */
+#define FILE_STREAM_BUFFER_SIZE (64 * 1024)
+
+/** A log line waiting to be written */
+struct log_record {
+    /** Sequence number, tells whether the record is free or ready to be written */
+    atomic_size_t seq;
+    /** Log time */
+    struct timespec ts;
+    /** Logging thread id */
+    uint64_t tid;
+    /** Log priority */
+    uint32_t prio;
+    /** Log tag name */
+    char tag[FILE_RECORD_TAG_SIZE];
+    /** Log message */
+    char msg[FILE_RECORD_MSG_SIZE];
+};
+
+/**
+ Whether logs are currently recorded in file, guarded by `fileRecordingLock`.
+
+ Logging threads hold the lock for reading while they push a line, so that once `file_writer_stop` has taken it for
+ writing, every line of the current file is in the ring and no line can be pushed until the next file is started.
+ */
+static bool fileRecording;
+/** Lock guarding `fileRecording` */
+static pthread_rwlock_t fileRecordingLock = PTHREAD_RWLOCK_INITIALIZER;
+/** Records ring, allocated on first record start and kept afterwards */
+static struct log_record *fileRing;
+/** Position of the next record to fill */
+static atomic_size_t fileRingHead;
+/** Position of the next record to write, only modified by the file log queue */
+static atomic_size_t fileRingTail;
+/** Number of lines dropped because the ring was full, since last write */
+static atomic_ulong fileDroppedLines;
+/** Source triggering a write when the ring watermark is reached */
+static dispatch_source_t fileWatermarkSource;
+/** Source triggering periodic writes */
+static dispatch_source_t fileTimerSource;
+/** Process identifier, written on each line */
+static int filePid;
+/** Second of the cached time prefix */
+static time_t filePrefixSecond = -1;
+/** Cached time prefix of the lines logged during `filePrefixSecond` */
+static char filePrefix[32];
+
+/** Push a log line in the ring. Called by any logging thread holding `fileRecordingLock`, never blocks */
+static void file_writer_push(uint32_t prio, const char *tag, const char *msg) {
+    size_t pos = atomic_load_explicit(&fileRingHead, memory_order_relaxed);
+    struct log_record *record;
+    for (;;) {
+        record = &fileRing[pos & (FILE_RING_SIZE - 1)];
+        size_t seq = atomic_load_explicit(&record->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&fileRingHead, &pos, pos + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // ring is full
+            atomic_fetch_add_explicit(&fileDroppedLines, 1, memory_order_relaxed);
+            return;
+        } else {
+            pos = atomic_load_explicit(&fileRingHead, memory_order_relaxed);
+        }
+    }
+
+    clock_gettime(CLOCK_REALTIME, &record->ts);
+    pthread_threadid_np(NULL, &record->tid);
+    record->prio = prio;
+    strlcpy(record->tag, tag, sizeof(record->tag));
+    strlcpy(record->msg, msg, sizeof(record->msg));
+    atomic_store_explicit(&record->seq, pos + 1, memory_order_release);
+
+    if (pos + 1 - atomic_load_explicit(&fileRingTail, memory_order_relaxed) == FILE_RING_WATERMARK) {
+        dispatch_source_merge_data(fileWatermarkSource, 1);
+    }
+}
+
+/** Write all ready records in the file. Called on the file log queue */
+static void file_writer_drain() {
+    if (file == NULL) {
+        return;
+    }
+    size_t tail = atomic_load_explicit(&fileRingTail, memory_order_relaxed);
+    for (;;) {
+        struct log_record *record = &fileRing[tail & (FILE_RING_SIZE - 1)];
+        if (atomic_load_explicit(&record->seq, memory_order_acquire) != tail + 1) {
+            break;
+        }
+        if (record->ts.tv_sec != filePrefixSecond) {
+            struct tm tm;
+            localtime_r(&record->ts.tv_sec, &tm);
+            strftime(filePrefix, sizeof(filePrefix), "%m-%d %H:%M:%S", &tm);
+            filePrefixSecond = record->ts.tv_sec;
+        }
+        fprintf(file, "%s.%03ld\t%d\t%llu\t%s\t%s:\t%s\n", filePrefix, record->ts.tv_nsec / NSEC_PER_MSEC, filePid,
+                record->tid, priotab[record->prio & 7], record->tag, record->msg);
+        atomic_store_explicit(&record->seq, tail + FILE_RING_SIZE, memory_order_release);
+        tail++;
+        atomic_store_explicit(&fileRingTail, tail, memory_order_relaxed);
+    }
+    unsigned long dropped = atomic_exchange_explicit(&fileDroppedLines, 0, memory_order_relaxed);
+    if (dropped > 0) {
+        fprintf(file, "%s\t%d\t\t%s\tulog:\t%lu lines dropped\n", filePrefix, filePid, priotab[ULOG_WARN], dropped);
+    }
+    fflush(file);
+}
+
+/**
+ Start writing recorded logs in `file`.
+
+ Write sources are created suspended on first start, resumed by each start and suspended by each stop, so that they
+ do not wake the file log queue up while no file is recorded.
+ */
+static void file_writer_start() {
+    filePid = [[NSProcessInfo processInfo] processIdentifier];
+    if (fileRing == NULL) {
+        fileRing = calloc(FILE_RING_SIZE, sizeof(*fileRing));
+        for (size_t i = 0; i < FILE_RING_SIZE; i++) {
+            atomic_init(&fileRing[i].seq, i);
+        }
+        fileWatermarkSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_DATA_OR, 0, 0, fileLogQueue);
+        dispatch_source_set_event_handler(fileWatermarkSource, ^{
+            file_writer_drain();
+        });
+        fileTimerSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, fileLogQueue);
+        dispatch_source_set_event_handler(fileTimerSource, ^{
+            file_writer_drain();
+        });
+    }
+    // the stream is only accessed on the file log queue once created
+    dispatch_sync(fileLogQueue, ^{
+        setvbuf(file, NULL, _IOFBF, FILE_STREAM_BUFFER_SIZE);
+    });
+    dispatch_source_set_timer(fileTimerSource, DISPATCH_TIME_NOW, FILE_WRITE_INTERVAL_MS * NSEC_PER_MSEC,
+                              FILE_WRITE_INTERVAL_MS * NSEC_PER_MSEC / 10);
+    dispatch_resume(fileWatermarkSource);
+    dispatch_resume(fileTimerSource);
+    pthread_rwlock_wrlock(&fileRecordingLock);
+    fileRecording = true;
+    pthread_rwlock_unlock(&fileRecordingLock);
+}
+
+/** Stop writing recorded logs, write the pending ones and close `file` */
+static void file_writer_stop() {
+    // waits for the lines being pushed, they are written in the closing file
+    pthread_rwlock_wrlock(&fileRecordingLock);
+    fileRecording = false;
+    pthread_rwlock_unlock(&fileRecordingLock);
+    dispatch_suspend(fileTimerSource);
+    dispatch_suspend(fileWatermarkSource);
+    dispatch_sync(fileLogQueue, ^{
+        file_writer_drain();
+        fclose(file);
+        file = NULL;
+    });
+}
+
+#pragma mark - unified logging
+
 static void unified_logging_init() {
     // create dipatch queue for logging
     fileLogQueue = dispatch_queue_create("com.parrot.file_logger", nil);
-    dateFormatter = [[NSDateFormatter alloc] init];
-    [dateFormatter setDateFormat:@"MM-dd HH:mm:ss.SSS"];
     ulog_set_write_func(&unified_logging_write_func);
 }
 
@@ -212,35 +392,11 @@ static void unified_logging_write_func(uint32_t prio, struct ulog_cookie *cookie
     }
 
     os_log_with_type(os_log, type, "%{public}s", buf);
-    if (file != NULL) {
-        char *local_buf = calloc(len, sizeof(char));
-        char *local_tag = calloc(cookie->namesize, sizeof(char));
-        if ((local_buf != NULL) && (local_tag != NULL)) {
-            // prepare the log parts before changing the thread
-            snprintf(local_buf, len, "%s", buf);
-            snprintf(local_tag, cookie->namesize, "%s", cookie->name);
-
-            uint64_t tid;
-            pthread_threadid_np(NULL, &tid);
-
-            NSDate *date = [NSDate date];
-            dispatch_async(fileLogQueue, ^(){
-                fprintf(file, "%s\t%d\t%llu\t%s\t%s:\t%s\n", [[dateFormatter stringFromDate:date] UTF8String],
-                        [[NSProcessInfo processInfo] processIdentifier],
-                        tid, priotab[prio], local_tag, local_buf);
-                fflush(file);
-                free(local_buf);
-                free(local_tag);
-            });
-        } else {
-            if (local_buf != NULL) {
-                free(local_buf);
-            }
-            if (local_tag != NULL) {
-                free(local_tag);
-            }
-        }
+    pthread_rwlock_rdlock(&fileRecordingLock);
+    if (fileRecording) {
+        file_writer_push(prio, cookie->name, buf);
     }
+    pthread_rwlock_unlock(&fileRecordingLock);
 }
 
 #pragma mark - asl logging
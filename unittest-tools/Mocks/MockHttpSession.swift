@@ -59,6 +59,32 @@ class MockHttpSession: HttpSessionCore {
         return task
     }
 
+    override func streamData(
+        request: URLRequest, didReceiveResponse: ((HTTPURLResponse) throws -> Void)? = nil,
+        didReceive: @escaping (Data) throws -> Void,
+        completion: @escaping (Result) -> Void) -> CancelableCore {
+
+        // the mocked response data is handed over in one piece, before completing the request
+        let task = MockDataTask(request: request) { result, data in
+            if case .success(let statusCode) = result, let data = data {
+                do {
+                    if let didReceiveResponse = didReceiveResponse {
+                        try didReceiveResponse(HTTPURLResponse(
+                            url: request.url!, statusCode: statusCode, httpVersion: nil, headerFields: nil)!)
+                    }
+                    try didReceive(data)
+                } catch let error {
+                    completion(.error(error))
+                    return
+                }
+            }
+            completion(result)
+        }
+        tasks.append(task)
+
+        return task
+    }
+
     override func sendData(
         request: URLRequest, method: HttpSessionCore.SendMethod,
         completion: @escaping (HttpSessionCore.Result, Data?) -> Void) -> CancelableCore {
@@ -80,6 +106,17 @@ class MockHttpSession: HttpSessionCore {
         return task
     }
 
+    override func downloadFile(
+        request: URLRequest, partialFileUrl: URL, destination: URL, progress: @escaping (Int) -> Void,
+        completion: @escaping (Result, URL?) -> Void) -> CancelableCore {
+
+        let task = MockDownloadTask(
+            request: request, destination: destination, progress: progress, completion: completion)
+        tasks.append(task)
+
+        return task
+    }
+
     override func downloadFile(
         streamDecoder: StreamDecoder, request: URLRequest, destination: URL,
         completion: @escaping (Result, URL?) -> Void) -> CancelableCore {
@@ -32,11 +32,15 @@ import GroundSdk
 
 class MockPersistentStore: PersistentStore, CustomStringConvertible {
 
-    var mockUserDefaults = MockUserDefaults()
+    var mockUserDefaults: MockUserDefaults
 
-    override init() {
-        super.init()
-        userDefaults = mockUserDefaults
+    var mockBackend: MockPersistentStoreBackend
+
+    init(mockBackend: MockPersistentStoreBackend = MockPersistentStoreBackend(),
+         mockUserDefaults: MockUserDefaults = MockUserDefaults()) {
+        self.mockBackend = mockBackend
+        self.mockUserDefaults = mockUserDefaults
+        super.init(backend: mockBackend, userDefaults: mockUserDefaults)
     }
 
     /// Create a new device dictionary
@@ -53,6 +57,40 @@ class MockPersistentStore: PersistentStore, CustomStringConvertible {
     }
 
     var description: String {
-        return mockUserDefaults.description
+        return content.description
+    }
+}
+
+/// In memory persistent store backend, counting entry loads and stores
+class MockPersistentStoreBackend: PersistentStoreBackend {
+
+    /// Stored entries, by type then by uid
+    var entries: [String: [String: [String: AnyObject]]] = [:]
+
+    /// Number of entries loaded
+    var loadCnt = 0
+
+    /// Number of entries stored or removed
+    var storeCnt = 0
+
+    /// Uids of the entries that fail to be stored
+    var failingUids: Set<String> = []
+
+    func entryUids(type: String) -> Set<String> {
+        return Set((entries[type] ?? [:]).keys)
+    }
+
+    func loadEntry(type: String, uid: String) -> [String: AnyObject]? {
+        loadCnt += 1
+        return entries[type]?[uid]
+    }
+
+    func storeEntry(type: String, uid: String, content: [String: AnyObject]?) -> Bool {
+        storeCnt += 1
+        guard !failingUids.contains(uid) else {
+            return false
+        }
+        entries[type, default: [:]][uid] = content
+        return true
     }
 }
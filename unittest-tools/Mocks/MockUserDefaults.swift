@@ -44,6 +44,11 @@ class MockUserDefaults: UserDefaults {
         return store[key]
     }
 
+    override func removeObject(forKey key: String) {
+        store[key] = nil
+        changeCnt += 1
+    }
+
     override var description: String {
         return store.description
     }